@@ -14,6 +14,7 @@
 
 /* ─── Debug Output ──────────────────────────────────────────────────────── */
 
+#define DBG_FILE_ID 5   /* tokenized-log file ID (see dbg.h) */
 #include "dbg.h"
 
 /* ─── Sensor Config ─────────────────────────────────────────────────────── */
@@ -52,8 +53,10 @@ static int batt_read(Reading *out, int max)
 
 extern uint16_t battRateSec;
 
+/* The ADC keeps no state across deep sleep — resume is the same no-op as init */
 const SensorDriver battDriver = {
-    "batt", batt_init, batt_is_alive, batt_read, &battRateSec
+    "batt", batt_init, batt_is_alive, batt_read, &battRateSec,
+    NULL, NULL, NULL, batt_init
 };
 
 #endif /* SENSOR_BATT */
@@ -3,6 +3,16 @@
  *
  * Reads via I2C (Adafruit_BME280 library).  Produces 3 readings per sample:
  * Temperature (°F), Pressure (hPa), Humidity (%).  Auto-reinit on disconnect.
+ *
+ * Runs the chip in forced mode (Bosch "weather monitoring" settings: 1x
+ * oversampling, filter off) and implements the two-phase driver API:
+ * start() triggers a conversion, poll_ready() checks the status register,
+ * collect() reads the compensated result — so the ~10 ms conversion never
+ * blocks the main loop.
+ *
+ * After deep sleep, resume() restores the chip's power-on-reset registers
+ * from RAM (address and calibration are kept in the Adafruit object)
+ * instead of repeating init()'s bus reset and full probe.
  */
 
 #ifdef SENSOR_BME280
@@ -14,6 +24,7 @@
 
 /* ─── Debug Output ──────────────────────────────────────────────────────── */
 
+#define DBG_FILE_ID 4   /* tokenized-log file ID (see dbg.h) */
 #include "dbg.h"
 
 /* ─── Sensor Config ─────────────────────────────────────────────────────── */
@@ -24,6 +35,24 @@
  */
 #define SENSOR_ID_BME280 0
 
+/* BME280 registers used for the non-blocking forced-mode handshake */
+#define BME280_REG_CTRL_HUM   0xF2
+#define BME280_REG_STATUS     0xF3
+#define BME280_REG_CTRL_MEAS  0xF4
+#define BME280_REG_CONFIG     0xF5
+#define BME280_STATUS_MEASURING 0x08
+#define BME280_STATUS_IM_UPDATE 0x01
+
+/* ctrl_hum: osrs_h=1x; config: standby n/a in forced mode, filter off */
+#define BME280_CTRL_HUM_X1    0x01
+#define BME280_CONFIG_DEFAULT 0x00
+
+/* Power-on NVM copy takes ~2 ms (datasheet start-up time) */
+#define BME280_RESUME_TIMEOUT_MS 5
+
+/* ctrl_meas: osrs_t=1x (001), osrs_p=1x (001), mode=forced (01) */
+#define BME280_CTRL_MEAS_FORCED ((1 << 5) | (1 << 2) | 0x01)
+
 /* ─── State ─────────────────────────────────────────────────────────────── */
 
 static Adafruit_BME280 bme;
@@ -44,6 +73,25 @@ static bool i2cProbe(uint8_t addr)
     return (Wire.endTransmission() == 0);
 }
 
+/* Write one register.  Returns true on I2C ACK. */
+static bool bmeWriteReg(uint8_t reg, uint8_t val)
+{
+    Wire.beginTransmission(bmeAddr);
+    Wire.write(reg);
+    Wire.write(val);
+    return (Wire.endTransmission() == 0);
+}
+
+/* Read one register.  Returns -1 on I2C failure. */
+static int bmeReadReg(uint8_t reg)
+{
+    Wire.beginTransmission(bmeAddr);
+    Wire.write(reg);
+    if (Wire.endTransmission() != 0) return -1;
+    if (Wire.requestFrom(bmeAddr, (uint8_t)1) != 1) return -1;
+    return Wire.read();
+}
+
 /* ─── SensorDriver Interface ───────────────────────────────────────────── */
 
 static int bme280_init(void)
@@ -60,8 +108,18 @@ static int bme280_init(void)
         bmeOk = bme.begin(0x77);
         if (bmeOk) bmeAddr = 0x77;
     }
-    if (!bmeOk) DBGLN("ERROR: BME280 not found on 0x76 or 0x77");
-    return bmeOk ? 1 : 0;
+    if (!bmeOk) {
+        DBGLN("ERROR: BME280 not found on 0x76 or 0x77");
+        return 0;
+    }
+
+    /* Forced mode: the chip sleeps between conversions we trigger */
+    bme.setSampling(Adafruit_BME280::MODE_FORCED,
+                    Adafruit_BME280::SAMPLING_X1,   /* temperature */
+                    Adafruit_BME280::SAMPLING_X1,   /* pressure    */
+                    Adafruit_BME280::SAMPLING_X1,   /* humidity    */
+                    Adafruit_BME280::FILTER_OFF);
+    return 1;
 }
 
 static int bme280_is_alive(void)
@@ -77,7 +135,45 @@ static int bme280_is_alive(void)
     return 1;
 }
 
-static int bme280_read(Reading *out, int max)
+static int bme280_resume(void)
+{
+    if (!bmeOk) return 0;
+
+    /* Wait for the chip to finish copying trimming data after power-on */
+    unsigned long t0 = millis();
+    int status;
+    while ((status = bmeReadReg(BME280_REG_STATUS)) < 0 ||
+           (status & BME280_STATUS_IM_UPDATE)) {
+        if (millis() - t0 >= BME280_RESUME_TIMEOUT_MS) {
+            DBGLN("ERROR: BME280 not ready after wake");
+            bmeOk = false;
+            return 0;
+        }
+    }
+
+    /* ctrl_hum only latches on the next ctrl_meas write, done by start() */
+    if (!bmeWriteReg(BME280_REG_CTRL_HUM, BME280_CTRL_HUM_X1) ||
+        !bmeWriteReg(BME280_REG_CONFIG, BME280_CONFIG_DEFAULT)) {
+        bmeOk = false;
+        return 0;
+    }
+    return 1;
+}
+
+static int bme280_start(void)
+{
+    if (!bmeOk) return 0;
+    return bmeWriteReg(BME280_REG_CTRL_MEAS, BME280_CTRL_MEAS_FORCED) ? 1 : 0;
+}
+
+static int bme280_poll_ready(void)
+{
+    int status = bmeReadReg(BME280_REG_STATUS);
+    if (status < 0) return 0;  /* bus error — conversion times out */
+    return (status & BME280_STATUS_MEASURING) ? 0 : 1;
+}
+
+static int bme280_collect(Reading *out, int max)
 {
     if (!bmeOk || max < 3) return 0;
 
@@ -113,12 +209,22 @@ static int bme280_read(Reading *out, int max)
     return 3;
 }
 
+/* Synchronous fallback: trigger, wait for the conversion, then collect */
+static int bme280_read(Reading *out, int max)
+{
+    if (!bmeOk || max < 3) return 0;
+    if (!bme.takeForcedMeasurement()) return 0;
+    return bme280_collect(out, max);
+}
+
 /* ─── Driver Instance ──────────────────────────────────────────────────── */
 
 extern uint16_t bme280RateSec;
 
 const SensorDriver bme280Driver = {
-    "bme280", bme280_init, bme280_is_alive, bme280_read, &bme280RateSec
+    "bme280", bme280_init, bme280_is_alive, bme280_read, &bme280RateSec,
+    bme280_start, bme280_poll_ready, bme280_collect, bme280_resume,
+    true, NULL  /* on Vext; resume() already waits out the start-up time */
 };
 
 #endif /* SENSOR_BME280 */
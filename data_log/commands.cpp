@@ -6,6 +6,9 @@
  * data_log.ino calls commandsInit() once from setup().
  */
 
+/* Tokenized-log file ID (see dbg.h) — before config.h, which includes it */
+#define DBG_FILE_ID 2
+
 #include "Arduino.h"
 #include "LoRaWan_APP.h"
 #include "commands.h"
@@ -13,6 +16,9 @@
 #include "config.h"
 #include "params.h"
 #include "led.h"
+#include "sensor_drv.h"   /* Vext hold for the NeoPixel */
+#include "gps_sensor.h"
+#include "flash_log.h"
 
 /* ─── Debug Output ──────────────────────────────────────────────────────── */
 
@@ -22,6 +28,11 @@
 
 char cmdResponseBuf[CMD_RESPONSE_BUF_SIZE];
 
+/* ─── Bulk Transfer Session ─────────────────────────────────────────────── */
+
+XferSession xferSession;
+static uint8_t xferNextId = 0;
+
 /* ─── Radio Config Helpers ──────────────────────────────────────────────── */
 
 void applyTxConfig(void)
@@ -50,48 +61,110 @@ void applyRxConfig(void)
  *   field, runtimePtr → runtime global. setparam updates cfg; rcfg_radio
  *   copies cfg → runtime via paramsApplyStaged().
  *
- *   Non-radio params (rxduty, bme280_rate, batt_rate) are immediate:
+ *   Non-radio params (rxduty, bme280_rate, sensor_slack, ...) are immediate:
  *   ptr → runtime global, runtimePtr = NULL. setparam updates runtime directly.
  *
- * Fields: name, type, ptr, runtimePtr, min, max, writable, onSet, cfgOffset
+ *   Live status values (batt_mv, rssi, uptime, packet counters, ...) are
+ *   read-only: either ptr → the counter, or a getter that computes the
+ *   value on access.  One getparams sweep returns them all, paged with the
+ *   stored params.
+ *
+ * Fields: name, type, ptr, runtimePtr, min, max, writable, onSet, cfgOffset, getter
  *   cfgOffset = offsetof(NodeConfig, field) for EEPROM-persisted params
  *   cfgOffset = CFG_OFFSET_NONE (0xFF) for read-only / non-persisted params
+ *   getter    = computes a virtual param's value (ptr = NULL), else NULL
  */
+static void getBattMv(void *out)
+{
+    uint16_t mv = getBatteryVoltage();
+    memcpy(out, &mv, sizeof(mv));
+}
+
+static void getUptimeSec(void *out)
+{
+    uint32_t sec = millis() / 1000;
+    memcpy(out, &sec, sizeof(sec));
+}
+
+/* "<name>_rate" row for a sensor_list.h entry; the rate global and its
+ * NodeConfig field share a name */
+#define SENSOR_RATE_PARAM(name, drv, nr, rate) \
+    { #name "_rate", PARAM_UINT16, &rate, NULL, 1, 32767, true, NULL, offsetof(NodeConfig, rate), NULL },
+
 static const uint16_t nodeVersion = NODE_VERSION;
 static const ParamDef paramTable[] = {
-    /* Per-sensor sample rate params (conditional on SENSOR_* defines) */
-#ifdef SENSOR_BATT
-    { "batt_rate",       PARAM_UINT16, &battRateSec,          NULL,            1, 32767, true,  NULL, offsetof(NodeConfig, battRateSec)      },
-#endif
-#ifdef SENSOR_BME280
-    { "bme280_rate",     PARAM_UINT16, &bme280RateSec,        NULL,            1, 32767, true,  NULL, offsetof(NodeConfig, bme280RateSec)    },
-#endif
+    { "autosleep",       PARAM_UINT16, &autoSleepSec,         NULL,            0, 32767, true,  NULL, offsetof(NodeConfig, autoSleepSec),      NULL },
+    { "batt_mv",         PARAM_UINT16, NULL,                  NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        getBattMv },
+    /* Per-sensor sample rate params: one per SENSOR_LIST entry in the build */
+    SENSOR_ENTRY_BATT(SENSOR_RATE_PARAM)
+    SENSOR_ENTRY_BME280(SENSOR_RATE_PARAM)
     /* Staged radio params: ptr → cfg, runtimePtr → runtime global */
-    { "bw",              PARAM_UINT8,  &cfg.bandwidth,        &loraBW,        0,    2, true,  NULL, offsetof(NodeConfig, bandwidth)        },
-    { "g2nfreq",         PARAM_UINT32, &cfg.g2nFrequencyHz,   &g2nFreqHz,     0,    0, true,  NULL, offsetof(NodeConfig, g2nFrequencyHz)   },
+    { "bw",              PARAM_UINT8,  &cfg.bandwidth,        &loraBW,        0,    2, true,  NULL, offsetof(NodeConfig, bandwidth),        NULL },
+    { "g2nfreq",         PARAM_UINT32, &cfg.g2nFrequencyHz,   &g2nFreqHz,     0,    0, true,  NULL, offsetof(NodeConfig, g2nFrequencyHz),   NULL },
     /* Immediate params: ptr → runtime global, runtimePtr = NULL */
 #ifdef SENSOR_GPS
-    { "gps_rate",        PARAM_UINT16, &gpsRateSec,           NULL,            1, 32767, true,  NULL, offsetof(NodeConfig, gpsRateSec)        },
+    { "gps_fast_kmh",    PARAM_UINT16, &gpsFastKmh,           NULL,            0,  500, true,  NULL, offsetof(NodeConfig, gpsFastKmh),        NULL },
+    { "gps_fast_rate",   PARAM_UINT16, &gpsFastRateSec,       NULL,            1, 32767, true,  NULL, offsetof(NodeConfig, gpsFastRateSec),    NULL },
+    { "gps_min_dist",    PARAM_UINT16, &gpsMinDistM,          NULL,            0, 10000, true,  NULL, offsetof(NodeConfig, gpsMinDistM),       NULL },
 #endif
-    { "jitter",          PARAM_UINT16, &broadcastAckJitterMs, NULL,            0, 2000, true,  NULL, offsetof(NodeConfig, broadcastAckJitterMs) },
-    { "n2gfreq",         PARAM_UINT32, &cfg.n2gFrequencyHz,   &n2gFreqHz,     0,    0, true,  NULL, offsetof(NodeConfig, n2gFrequencyHz)   },
+    SENSOR_ENTRY_GPS(SENSOR_RATE_PARAM)
+    { "health_rate",     PARAM_UINT16, &healthRateSec,        NULL,            0, 32767, true,  NULL, CFG_OFFSET_NONE,                        NULL },
+    { "jitter",          PARAM_UINT16, &broadcastAckJitterMs, NULL,            0, 2000, true,  NULL, offsetof(NodeConfig, broadcastAckJitterMs), NULL },
+    { "log_txdiv",       PARAM_UINT16, &logTxDiv,             NULL,            0, 1000, true,  NULL, offsetof(NodeConfig, logTxDiv),          NULL },
+    { "n2gfreq",         PARAM_UINT32, &cfg.n2gFrequencyHz,   &n2gFreqHz,     0,    0, true,  NULL, offsetof(NodeConfig, n2gFrequencyHz),   NULL },
     /* Read-only params: runtimePtr = NULL */
-    { "nodeid",          PARAM_STRING, nodeId,                NULL,            0,    0, false, NULL, CFG_OFFSET_NONE                        },
-    { "nodev",           PARAM_UINT16, (void *)&nodeVersion,  NULL,            0,    0, false, NULL, CFG_OFFSET_NONE                        },
-    { "rxduty",          PARAM_UINT8,  &rxDutyPercent,        NULL,            0,  100, true,  NULL, offsetof(NodeConfig, rxDutyPercent)     },
+    { "nodeid",          PARAM_STRING, nodeId,                NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "nodev",           PARAM_UINT16, (void *)&nodeVersion,  NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "rssi",            PARAM_INT16,  &lastRxRssi,           NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "rx_drop",         PARAM_UINT32, (void *)&rxQueue.dropped, NULL,          0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "rx_pkts",         PARAM_UINT32, &rxPackets,            NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "rxduty",          PARAM_UINT8,  &rxDutyPercent,        NULL,            0,  100, true,  NULL, offsetof(NodeConfig, rxDutyPercent),     NULL },
+    { "sensor_slack",    PARAM_UINT16, &sensorSlackSec,       NULL,            0, 3600, true,  NULL, offsetof(NodeConfig, sensorSlackSec),    NULL },
     /* Staged radio params (continued) */
-    { "sf",              PARAM_UINT8,  &cfg.spreadingFactor,  &spreadFactor,   7,   12, true,  NULL, offsetof(NodeConfig, spreadingFactor)   },
-    { "txpwr",           PARAM_INT8,   &cfg.txOutputPower,    &txPower,      -17,   22, true,  NULL, offsetof(NodeConfig, txOutputPower)     },
+    { "sf",              PARAM_UINT8,  &cfg.spreadingFactor,  &spreadFactor,   7,   12, true,  NULL, offsetof(NodeConfig, spreadingFactor),   NULL },
+    { "tx_pkts",         PARAM_UINT32, &txPackets,            NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
+    { "txpwr",           PARAM_INT8,   &cfg.txOutputPower,    &txPower,      -17,   22, true,  NULL, offsetof(NodeConfig, txOutputPower),     NULL },
+    /* Computed / live read-only params (continued) */
+    { "uptime",          PARAM_UINT32, NULL,                  NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        getUptimeSec },
+    { "wakes",           PARAM_UINT32, &wakeCount,            NULL,            0,    0, false, NULL, CFG_OFFSET_NONE,                        NULL },
 };
 static const int PARAM_COUNT = sizeof(paramTable) / sizeof(paramTable[0]);
 
+/* Copy staged radio params (cfg → runtime globals) and reconfigure the radio */
+static void applyStagedRadio(void)
+{
+    paramsApplyStaged(paramTable, PARAM_COUNT);
+    applyTxConfig();
+    applyRxConfig();
+}
+
+/* ─── After-ACK Actions ─────────────────────────────────────────────────── */
+
+/*
+ * Early-ACK commands that must not act while their ACK is still queued
+ * (retune the radio, reboot, deep sleep) leave the action here rather
+ * than wait for the radio; cmdAckTick() runs it once the TX queue has
+ * drained.
+ */
+#define ACK_THEN_RADIO  0x01    /* apply staged radio params */
+#define ACK_THEN_RESET  0x02    /* start the reset countdown */
+#define ACK_THEN_SLEEP  0x04    /* deep sleep for ackSleepSec */
+
+static uint8_t  ackThen     = 0;
+static uint32_t ackSleepSec = 0;
+
+bool cmdAckPending(void)
+{
+    return ackThen != 0;
+}
+
 /*
  * rcfg_radio handler: Apply staged radio config from cfg to runtime.
  *
  * Call this after setparam changes to radio params (bw, sf, txpwr, n2gfreq,
  * g2nfreq). Copies staged cfg.* fields to runtime globals (data-driven via
  * runtimePtr in param table) and reconfigures radio hardware.
- * Uses early_ack=true so ACK is sent before radio changes take effect.
+ * Uses early_ack=true; the radio changes once that ACK is out.
  */
 static void handleRcfgRadio(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
@@ -99,28 +172,35 @@ static void handleRcfgRadio(const char *cmd, char args[][CMD_MAX_ARG_LEN], int a
     (void)args;
     (void)arg_count;
 
-    /* Copy staged params (cfg → runtime globals) */
-    paramsApplyStaged(paramTable, PARAM_COUNT);
+    ackThen |= ACK_THEN_RADIO;
 
-    /* Apply to radio hardware */
-    applyTxConfig();
-    applyRxConfig();
-
-    /* Visual confirmation: 5x rapid red blink */
+    /* Visual confirmation: 5x rapid red blink (NeoPixel is on Vext).
+     * Queued — the tick loop plays it and drops the hold when done. */
+    sensorPowerHold(POWER_HOLD_LED, true);
     ledBlink(LED_RED, 5, 50);
 
     snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":\"applied\"}");
-    DBG("RCFG_RADIO: sf=%d bw=%d txpwr=%d n2g=%lu g2n=%lu\n",
-        spreadFactor, loraBW, txPower, n2gFreqHz, g2nFreqHz);
+    DBG("RCFG_RADIO: after ACK\n");
 }
 
 /* ─── Command Handlers ──────────────────────────────────────────────────── */
 
+/*
+ * Single-value status commands (batt, rssi, uptime) answer {"r":<value>}
+ * from the same read-only params getparams lists.
+ */
+static void replyParam(const char *name)
+{
+    int idx = paramFind(paramTable, PARAM_COUNT, name);
+    int n = snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":");
+    n += paramFmtValue(&paramTable[idx], cmdResponseBuf + n, CMD_RESPONSE_BUF_SIZE - n);
+    snprintf(cmdResponseBuf + n, CMD_RESPONSE_BUF_SIZE - n, "}");
+    DBG("%s: %s\n", name, cmdResponseBuf);
+}
+
 static void handleBatt(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
-    uint16_t mv = getBatteryVoltage();
-    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":%u}", (unsigned)mv);
-    DBG("BATT: %u mV\n", (unsigned)mv);
+    replyParam("batt_mv");
 }
 
 static void handlePing(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
@@ -161,23 +241,231 @@ static void handleBlink(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_c
     }
     DBG(" seconds=%.2f brightness=%d\n", seconds, brightness);
 
-    /* Turn on LED — tick loop will turn it off after the timer expires */
-    ledSetColorBrightness(color, brightness);
-    blinkActive = true;
-    blinkOffTime = millis() + (unsigned long)(seconds * 1000.0f);
+    /* Tick loop shows it, turns it off (and drops the Vext hold) when
+     * the time is up */
+    sensorPowerHold(POWER_HOLD_LED, true);
+    ledShowFor(color, brightness, (unsigned long)(seconds * 1000.0f));
 }
 
 static void handleRssi(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
-    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":%d}", (int)lastRxRssi);
-    DBG("RSSI: %d dBm\n", (int)lastRxRssi);
+    replyParam("rssi");
 }
 
 static void handleUptime(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
-    unsigned long uptimeSec = millis() / 1000;
-    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":%lu}", uptimeSec);
-    DBG("UPTIME: %lu s\n", uptimeSec);
+    replyParam("uptime");
+}
+
+static void handleWakeLat(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* last/max wake → first sensor TX latency (ms), n = wakes since boot */
+    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+             "{\"last\":%lu,\"max\":%lu,\"n\":%lu}",
+             (unsigned long)wakeTxLastMs, (unsigned long)wakeTxMaxMs,
+             (unsigned long)wakeCount);
+    DBG("WAKELAT: %s\n", cmdResponseBuf);
+}
+
+static void handleTxq(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* Queue depth now/high-water, sent/dropped/expired/timed-out packets,
+     * queued → TX done latency avg/last/max (ms) */
+    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+             "{\"d\":%u,\"dm\":%u,\"dr\":%lu,\"ex\":%lu,\"la\":%lu,\"ll\":%lu,"
+             "\"lm\":%lu,\"s\":%lu,\"to\":%lu}",
+             (unsigned)txQueue.depth, (unsigned)txQueue.maxDepth,
+             (unsigned long)txQueue.dropped, (unsigned long)txQueue.expired,
+             (unsigned long)txqLatAvgMs(&txQueue), (unsigned long)txQueue.latLastMs,
+             (unsigned long)txQueue.latMaxMs, (unsigned long)txQueue.sent,
+             (unsigned long)txQueue.timeouts);
+    DBG("TXQ: %s\n", cmdResponseBuf);
+}
+
+/*
+ * Node counters, sorted by key.  Parse failures by reason (pf_*), then
+ * per sensor <name>_if (reinit/resume failed) and <name>_rf (read
+ * failed or timed out).
+ */
+#define STATS_MAX_VALS (15 + 2 * SENSOR_MAX_DRIVERS)
+
+static void statPut(StatVal *v, int *n, const char *key, const char *suffix, uint32_t val)
+{
+    v[*n].key    = key;
+    v[*n].suffix = suffix;
+    v[*n].val    = val;
+    (*n)++;
+}
+
+static int statsSnapshot(StatVal *v)
+{
+    static const char *const parseKeys[PARSE_RESULT_COUNT] = {
+        NULL, "pf_len", "pf_type", "pf_nocmd", "pf_nocrc", "pf_nots", "pf_crc"
+    };
+    int n = 0;
+    statPut(v, &n, "dup",      NULL, nodeStats.dup);
+    statPut(v, &n, "loop_max", NULL, nodeStats.loopMaxMs);
+    statPut(v, &n, "notme",    NULL, nodeStats.notMe);
+    for (int i = PARSE_OK + 1; i < PARSE_RESULT_COUNT; i++)
+        statPut(v, &n, parseKeys[i], NULL, nodeStats.parseFail[i]);
+    statPut(v, &n, "rx",       NULL, rxPackets);
+    statPut(v, &n, "rx_drop",  NULL, rxQueue.dropped);
+    statPut(v, &n, "split",    NULL, nodeStats.splitPkts);
+    statPut(v, &n, "tx",       NULL, txPackets);
+    statPut(v, &n, "tx_to",    NULL, txQueue.timeouts);
+    statPut(v, &n, "unk",      NULL, nodeStats.unknownCmd);
+
+    const SensorSlot *s;
+    for (int i = 0; (s = sensorGetSlot(i)) != NULL; i++) {
+        statPut(v, &n, s->drv->name, "_if", s->initFails);
+        statPut(v, &n, s->drv->name, "_rf", s->readFails);
+    }
+    statsSort(v, n);
+    return n;
+}
+
+static void handleSensors(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* Per-driver alive / failed-reinit streak / quarantine / next probe */
+    sensorFmtHealth(millis(), cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    DBG("SENSORS: %s\n", cmdResponseBuf);
+}
+
+static void handleStats(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    StatVal v[STATS_MAX_VALS];
+    int n = statsSnapshot(v);
+    uint16_t hash = statsHash(v, n);
+    int start = 0;
+    if (arg_count >= 1 && !paramCursorParse(args[0], hash, n, &start)) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"stale cursor\"}");
+        return;
+    }
+    statsListAt(v, n, start, hash, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    DBG("STATS: %s\n", cmdResponseBuf);
+}
+
+/* Registry, for looking up per-command latency by name; set in commandsInit() */
+static const CommandRegistry *cmdReg = NULL;
+
+static void handleLat(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* No arg: p50/p99 µs per stage.  Stage name: its log2 histogram.
+     * Command name: that command's count, last and max turnaround (µs). */
+    int stage = arg_count >= 1 ? latStageByName(args[0]) : -1;
+    if (arg_count < 1) {
+        latFmtSummary(&latStats, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    } else if (stage >= 0) {
+        latFmtStage(&latStats, stage, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    } else {
+        int i;
+        for (i = 0; i < cmdReg->count; i++)
+            if (strcmp(cmdReg->handlers[i].cmd, args[0]) == 0) break;
+        if (i == cmdReg->count) {
+            snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                     "{\"e\":\"unknown stage or cmd\"}");
+            return;
+        }
+        const LatCmd *c = &latStats.cmd[i];
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                 "{\"l\":%lu,\"m\":%lu,\"n\":%lu}",
+                 (unsigned long)c->lastUs, (unsigned long)c->maxUs,
+                 (unsigned long)c->n);
+    }
+    DBG("LAT: %s\n", cmdResponseBuf);
+}
+
+#ifdef SENSOR_GPS
+static void handleGpsStat(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* Parser counters + UART ring overflow / high-water (bytes) */
+    GpsStats st;
+    gpsGetStats(&st);
+    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+             "{\"chars\":%lu,\"fail\":%lu,\"hw\":%u,\"ok\":%lu,\"ovf\":%lu,\"size\":%u}",
+             (unsigned long)st.chars, (unsigned long)st.failed,
+             (unsigned)st.ringHigh, (unsigned long)st.passed,
+             (unsigned long)st.overflows, (unsigned)st.ringSize);
+    DBG("GPSSTAT: %s\n", cmdResponseBuf);
+}
+#endif
+
+/* ─── Flash Log Handlers ────────────────────────────────────────────────── */
+
+static void handleLogStat(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* Record index range held (lo..hi-1), capacity, time span, row writes */
+    flogFmtStat(flashLogState(), cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    DBG("LOGSTAT: %s\n", cmdResponseBuf);
+}
+
+static void handleLogSum(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    if (arg_count < 2) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"usage: sid ch [from]\"}");
+        return;
+    }
+    uint32_t from = (arg_count >= 3) ? strtoul(args[2], NULL, 10) : 0;
+    flogFmtSum(flashLogState(), (uint8_t)atoi(args[0]), (uint8_t)atoi(args[1]),
+               from, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    DBG("LOGSUM: %s\n", cmdResponseBuf);
+}
+
+static void handleLogGet(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* Page through records from an absolute index (default: oldest) */
+    uint32_t from = (arg_count >= 1) ? strtoul(args[0], NULL, 10) : 0;
+    flogFmtGet(flashLogState(), from, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    DBG("LOGGET: %s\n", cmdResponseBuf);
+}
+
+/* ─── Bulk Transfer Handlers ────────────────────────────────────────────── */
+
+#define XFER_WINDOW_DEFAULT 8
+
+static void handleXOpen(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* xopen log [from] [window] — blocks follow this command's ACK */
+    if (arg_count < 1 || strcmp(args[0], "log") != 0) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"usage: log [from] [window]\"}");
+        return;
+    }
+    uint32_t from = (arg_count >= 2) ? strtoul(args[1], NULL, 10) : 0;
+    int window = (arg_count >= 3) ? atoi(args[2]) : XFER_WINDOW_DEFAULT;
+    if (window < 1) window = 1;
+    if (window > XFER_MAX_WINDOW) window = XFER_MAX_WINDOW;
+
+    uint8_t id = ++xferNextId;
+    from = flashLogXferOpen(&xferSession, id, from, (uint8_t)window);
+    snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+             "{\"b\":%u,\"i\":%lu,\"l\":%lu,\"n\":%u,\"w\":%u,\"x\":%u}",
+             (unsigned)XFER_BLOCK_BYTES, (unsigned long)from,
+             (unsigned long)xferSession.totalLen, (unsigned)xferSession.nBlocks,
+             (unsigned)xferSession.window, (unsigned)id);
+    DBG("XOPEN: %s\n", cmdResponseBuf);
+}
+
+static void handleXAck(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    /* xack id base missing — missing is a hex bitmap relative to base */
+    if (arg_count < 3) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"usage: id base missing\"}");
+        return;
+    }
+    uint8_t  id      = (uint8_t)atoi(args[0]);
+    uint16_t base    = (uint16_t)strtoul(args[1], NULL, 10);
+    uint32_t missing = strtoul(args[2], NULL, 16);
+
+    if (!xferAck(&xferSession, id, base, missing)) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"no session\"}");
+    } else if (!xferSession.active) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                 "{\"r\":\"done\",\"rx\":%lu,\"tx\":%lu}",
+                 (unsigned long)xferSession.resent, (unsigned long)xferSession.sent);
+    } else {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":\"ok\"}");
+    }
+    DBG("XACK: %s\n", cmdResponseBuf);
 }
 
 static void handleEcho(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
@@ -191,6 +479,26 @@ static void handleEcho(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_co
     DBG("ECHO: responding with %s\n", cmdResponseBuf);
 }
 
+/*
+ * Delayed reboot, run by the tick loop so RX/TX and sensors carry on
+ * while it counts down.  The countdown starts once the ACK is out; a
+ * second "reset" restarts it.
+ */
+static uint32_t resetDelayMs = 0;
+
+static void taskReset(SchedTask *t, uint32_t now)
+{
+    PT_BEGIN(t);
+    PT_WAIT_MS(t, now, resetDelayMs);
+    flashLogFlush();        /* keep the partially-filled log row */
+    dbgFlush();
+    delay(100);  /* let debug output flush */
+    NVIC_SystemReset();
+    PT_END(t);
+}
+
+SchedTask resetTask = SCHED_TASK("reset", taskReset, 0, false);
+
 static void handleReset(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
     /* Optional delay in seconds (default 0 = immediate, max 60) */
@@ -202,10 +510,8 @@ static void handleReset(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_c
     }
 
     DBG("RESET: rebooting in %.1f s...\n", seconds);
-    if (seconds > 0.0f)
-        sleepWdt((unsigned long)(seconds * 1000.0f));
-    delay(100);  /* let debug output flush */
-    NVIC_SystemReset();
+    resetDelayMs = (uint32_t)(seconds * 1000.0f);
+    ackThen |= ACK_THEN_RESET;
 }
 
 static void handleTestLed(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
@@ -221,11 +527,173 @@ static void handleTestLed(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg
         if (val >= 0 && val <= 255) brightness = (uint8_t)val;
     }
     DBG("TESTLED: cycling colors, %lums per step, brightness %d\n", delayMs, brightness);
-    ledTest(delayMs, brightness);
+    sensorPowerHold(POWER_HOLD_LED, true);
+    ledTest(delayMs, brightness);           /* played by the tick loop */
+}
+
+/* ─── Config Profiles ───────────────────────────────────────────────────── */
+
+/*
+ * profile                       → {"a":active,"p":[names],"t":revert_s}
+ * profile save <name>           → snapshot the current params into a slot
+ * profile del <name>
+ * profile <name> [revert_s]     → apply; with revert_s, runtime only and
+ *                                 the previous params come back after that
+ *
+ * Applying loads every param at once, staged radio params included; the
+ * radio itself is reconfigured by cmdAckTick() once the ACK has gone out
+ * on the old settings.  Without a revert the result is also saved, like
+ * setparam + rcfg_radio + savecfg in one command.
+ */
+static char          profileActive[CFG_PROFILE_NAME_MAX + 1] = "";
+static bool          profileRevertArmed  = false;
+static unsigned long profileRevertAt     = 0;
+static NodeConfig    profileRevertCfg;
+
+#define PROFILE_REVERT_MAX_SEC 86400
+
+/* Current params as a NodeConfig (staged radio params: their cfg values) */
+static void profileSnapshot(NodeConfig *c)
+{
+    *c = cfg;
+    paramsSyncToConfig(paramTable, PARAM_COUNT, c);
+}
+
+static void handleProfileList(void)
+{
+    int n = snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                     "{\"a\":\"%s\",\"p\":[", profileActive);
+    char name[CFG_PROFILE_NAME_MAX + 1];
+    bool first = true;
+    for (int i = 0; i < CFG_PROFILE_SLOTS; i++) {
+        if (!cfgProfileName(i, name)) continue;
+        n += snprintf(cmdResponseBuf + n, CMD_RESPONSE_BUF_SIZE - n,
+                      "%s\"%s\"", first ? "" : ",", name);
+        first = false;
+    }
+    if (profileRevertArmed)
+        snprintf(cmdResponseBuf + n, CMD_RESPONSE_BUF_SIZE - n, "],\"t\":%lu}",
+                 profileRevertDueIn(millis()) / 1000UL);   /* 0 once overdue */
+    else
+        snprintf(cmdResponseBuf + n, CMD_RESPONSE_BUF_SIZE - n, "]}");
 }
 
+static void handleProfile(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
+{
+    if (arg_count < 1) {
+        handleProfileList();
+        DBG("PROFILE: %s\n", cmdResponseBuf);
+        return;
+    }
+
+    bool isSave = strcmp(args[0], "save") == 0;
+    bool isDel  = strcmp(args[0], "del") == 0;
+    if (isSave || isDel) {
+        const char *name = arg_count >= 2 ? args[1] : "";
+        bool ok = false;
+        if (strcmp(name, "save") == 0 || strcmp(name, "del") == 0) {
+            /* reserved */
+        } else if (isSave) {
+            NodeConfig c;
+            profileSnapshot(&c);
+            ok = cfgProfileSave(name, &c);
+        } else {
+            ok = cfgProfileDelete(name);
+        }
+        if (ok)
+            snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"r\":\"%s\"}",
+                     isSave ? "saved" : "deleted");
+        else
+            snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"%s\"}",
+                     isSave ? "bad name or no free slot" : "no profile");
+        DBG("PROFILE: %s %s: %s\n", args[0], name, cmdResponseBuf);
+        return;
+    }
+
+    /* Apply: start from the current params so fields the profile predates
+     * keep their values */
+    NodeConfig c;
+    profileSnapshot(&c);
+    if (!cfgProfileLoad(args[0], &c)) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"no profile\"}");
+        return;
+    }
+
+    long revertSec = arg_count >= 2 ? atol(args[1]) : 0;
+    if (revertSec < 0) revertSec = 0;
+    if (revertSec > PROFILE_REVERT_MAX_SEC) revertSec = PROFILE_REVERT_MAX_SEC;
+
+    if (revertSec > 0) {
+        /* Trying profiles back to back still reverts to the original */
+        if (!profileRevertArmed) profileSnapshot(&profileRevertCfg);
+        profileRevertArmed = true;
+        profileRevertAt    = millis() + (unsigned long)revertSec * 1000UL;
+    } else {
+        profileRevertArmed = false;
+    }
+
+    int changed = paramsLoadFromConfig(paramTable, PARAM_COUNT, &c);
+    ackThen |= ACK_THEN_RADIO;
+    strncpy(profileActive, args[0], CFG_PROFILE_NAME_MAX);
+    profileActive[CFG_PROFILE_NAME_MAX] = '\0';
+
+    if (revertSec > 0) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                 "{\"n\":%d,\"r\":\"applied\",\"t\":%ld}", changed, revertSec);
+    } else {
+        paramsSyncToConfig(paramTable, PARAM_COUNT, &cfg);
+        cfgSave(&cfg);
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                 "{\"n\":%d,\"r\":\"applied\"}", changed);
+    }
+    DBG("PROFILE: %s\n", cmdResponseBuf);
+}
+
+bool cmdAckTick(unsigned long now)
+{
+    if (profileRevertArmed && (long)(now - profileRevertAt) >= 0) {
+        profileRevertArmed = false;
+        paramsLoadFromConfig(paramTable, PARAM_COUNT, &profileRevertCfg);
+        profileActive[0] = '\0';
+        ackThen |= ACK_THEN_RADIO;
+        DBG("PROFILE: reverted\n");
+    }
+    if (ackThen & ACK_THEN_RESET)
+        schedStart(&resetTask, now);
+    if (ackThen & ACK_THEN_SLEEP) {
+        TimerSetValue(&wakeUpTimer, ackSleepSec * 1000);
+        TimerStart(&wakeUpTimer);
+        deepSleepRequested = true;
+    }
+    bool radio = (ackThen & ACK_THEN_RADIO) != 0;
+    ackThen = 0;
+    if (!radio) return false;
+
+    Radio.Sleep();
+    applyStagedRadio();
+    Radio.SetChannel(g2nFreqHz);
+    DBG("RADIO: sf=%d bw=%d txpwr=%d n2g=%lu g2n=%lu\n",
+        spreadFactor, loraBW, txPower, n2gFreqHz, g2nFreqHz);
+    return true;
+}
+
+unsigned long profileRevertDueIn(unsigned long now)
+{
+    if (!profileRevertArmed) return SENSOR_NO_DEADLINE;
+    long left = (long)(profileRevertAt - now);
+    return left > 0 ? (unsigned long)left : 0;
+}
+
+/* Refused while a timed profile runs: it would persist the trial params */
 static void handleSaveCfg(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
+    if (profileRevertArmed) {
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
+                 "{\"e\":\"profile trial active\"}");
+        DBG("SAVECFG: %s\n", cmdResponseBuf);
+        return;
+    }
+
     /* Copy writable runtime params into the config struct via registry */
     paramsSyncToConfig(paramTable, PARAM_COUNT, &cfg);
 
@@ -264,11 +732,10 @@ static void handleSleep(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_c
         seconds = (uint32_t)val;
     }
 
-    TimerSetValue(&wakeUpTimer, seconds * 1000);
-    TimerStart(&wakeUpTimer);
-    deepSleepRequested = true;
+    ackSleepSec = seconds;
+    ackThen |= ACK_THEN_SLEEP;
 
-    DBG("SLEEP: %lu seconds\n", (unsigned long)seconds);
+    DBG("SLEEP: %lu seconds after ACK\n", (unsigned long)seconds);
 }
 
 static void handleRand(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
@@ -356,11 +823,40 @@ static void handleSetParam(const char *cmd, char args[][CMD_MAX_ARG_LEN], int ar
     DBG("SETPARAM: %s\n", cmdResponseBuf);
 }
 
+/* Table hashes stamped into list cursors; set in commandsInit() */
+static uint16_t paramTableHash = 0;
+static uint16_t cmdNameHash = 0;
+
+/*
+ * getparams / getcmds argument: none → first page, an 8-hex-char cursor
+ * from "n" → resume there, anything else → legacy page number.
+ * Returns false (with an error response) if the cursor is stale.
+ */
+static bool listStart(char args[][CMD_MAX_ARG_LEN], int arg_count,
+                      uint16_t hash, int count, int *start, int *page)
+{
+    *start = 0;
+    *page = -1;
+    if (arg_count < 1) return true;
+    if (paramCursorIsToken(args[0])) {
+        if (paramCursorParse(args[0], hash, count, start)) return true;
+        snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE, "{\"e\":\"stale cursor\"}");
+        return false;
+    }
+    *page = atoi(args[0]);
+    return true;
+}
+
 static void handleGetParams(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
-    int offset = 0;
-    if (arg_count >= 1) offset = atoi(args[0]);
-    paramsList(paramTable, PARAM_COUNT, offset, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    int start, page;
+    if (listStart(args, arg_count, paramTableHash, PARAM_COUNT, &start, &page)) {
+        if (page >= 0)
+            paramsList(paramTable, PARAM_COUNT, page, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+        else
+            paramsListAt(paramTable, PARAM_COUNT, start, paramTableHash,
+                         cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    }
     DBG("GETPARAMS: %s\n", cmdResponseBuf);
 }
 
@@ -389,9 +885,14 @@ static void buildCmdNameList(CommandRegistry *reg)
 
 static void handleGetCmds(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count)
 {
-    int offset = 0;
-    if (arg_count >= 1) offset = atoi(args[0]);
-    cmdsList(cmdNames, cmdNameCount, offset, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    int start, page;
+    if (listStart(args, arg_count, cmdNameHash, cmdNameCount, &start, &page)) {
+        if (page >= 0)
+            cmdsList(cmdNames, cmdNameCount, page, cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+        else
+            cmdsListAt(cmdNames, cmdNameCount, start, cmdNameHash,
+                       cmdResponseBuf, CMD_RESPONSE_BUF_SIZE);
+    }
     DBG("GETCMDS: %s\n", cmdResponseBuf);
 }
 
@@ -407,6 +908,14 @@ void commandsInit(CommandRegistry *reg)
     cmdRegister(reg, "getcmds",    handleGetCmds,   CMD_SCOPE_ANY, false);
     cmdRegister(reg, "getparam",   handleGetParam,  CMD_SCOPE_ANY, false);
     cmdRegister(reg, "getparams",  handleGetParams, CMD_SCOPE_ANY, false);
+#ifdef SENSOR_GPS
+    cmdRegister(reg, "gpsstat",    handleGpsStat,   CMD_SCOPE_ANY, false);
+#endif
+    cmdRegister(reg, "lat",        handleLat,       CMD_SCOPE_ANY, false);
+    cmdRegister(reg, "logget",     handleLogGet,    CMD_SCOPE_ANY, false);
+    cmdRegister(reg, "logstat",    handleLogStat,   CMD_SCOPE_ANY, false);
+    cmdRegister(reg, "logsum",     handleLogSum,    CMD_SCOPE_ANY, false);
+    cmdRegister(reg, "profile",    handleProfile,   CMD_SCOPE_PRIVATE, false);  /* late_ack: radio changes after ACK */
     cmdRegister(reg, "rand",       handleRand,      CMD_SCOPE_ANY, false);
     cmdRegister(reg, "rcfg_radio", handleRcfgRadio, CMD_SCOPE_PRIVATE, true);  /* early_ack: ACK before apply */
     cmdRegister(reg, "readadc",    handleReadAdc,   CMD_SCOPE_ANY, false);
@@ -415,10 +924,19 @@ void commandsInit(CommandRegistry *reg)
     cmdRegister(reg, "rssi",       handleRssi,      CMD_SCOPE_ANY, false);    /* late_ack: report RSSI of this packet */
     cmdRegister(reg, "sample",     handleSample,    CMD_SCOPE_ANY, true);
     cmdRegister(reg, "savecfg",    handleSaveCfg,   CMD_SCOPE_PRIVATE, false);
+    cmdRegister(reg, "sensors",    handleSensors,   CMD_SCOPE_ANY, false);
     cmdRegister(reg, "sleep",      handleSleep,     CMD_SCOPE_PRIVATE, true);   /* early_ack: ACK before sleep */
     cmdRegister(reg, "setparam",   handleSetParam,  CMD_SCOPE_PRIVATE, false);  /* late_ack: get error response */
+    cmdRegister(reg, "stats",      handleStats,     CMD_SCOPE_ANY, false);
     cmdRegister(reg, "testled",    handleTestLed,   CMD_SCOPE_ANY, true);
+    cmdRegister(reg, "txq",        handleTxq,       CMD_SCOPE_ANY, false);
     cmdRegister(reg, "uptime",     handleUptime,    CMD_SCOPE_ANY, false);     /* late_ack: include uptime in response */
+    cmdRegister(reg, "wakelat",    handleWakeLat,   CMD_SCOPE_ANY, false);
     cmdRegister(reg, "writegpio",  handleWriteGpio, CMD_SCOPE_PRIVATE, false);
+    cmdRegister(reg, "xack",       handleXAck,      CMD_SCOPE_PRIVATE, false);  /* late_ack: blocks follow the ACK */
+    cmdRegister(reg, "xopen",      handleXOpen,     CMD_SCOPE_PRIVATE, false);
     buildCmdNameList(reg);
+    cmdReg         = reg;
+    cmdNameHash    = cmdsTableHash(cmdNames, cmdNameCount);
+    paramTableHash = paramsTableHash(paramTable, PARAM_COUNT);
 }
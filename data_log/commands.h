@@ -11,11 +11,42 @@
 
 #include "packets.h"
 #include "config_types.h"
+#include "txqueue.h"
+#include "rxqueue.h"
+#include "stats.h"
+#include "latency.h"
+#include "sched.h"
 
 /* ─── Shared response buffer (defined in commands.cpp) ───────────────── */
 
 extern char cmdResponseBuf[CMD_RESPONSE_BUF_SIZE];
 
+/* ─── Bulk transfer session (defined in commands.cpp) ────────────────── */
+
+/* data_log.ino sends each queued round of blocks after the command's ACK */
+extern XferSession xferSession;
+
+/* ─── TX queue (defined in data_log.ino) ─────────────────────────────── */
+
+extern TxQueue txQueue;
+
+/* ─── RX queue (defined in data_log.ino) ─────────────────────────────── */
+
+extern RxQueue rxQueue;
+
+/* ─── Node counters (defined in data_log.ino) ────────────────────────── */
+
+extern NodeStats nodeStats;
+
+/* ─── Command turnaround histograms (defined in data_log.ino) ────────── */
+
+extern LatStats latStats;
+
+/* ─── Loop tasks ─────────────────────────────────────────────────────── */
+
+/* Delayed "reset": defined here, run by data_log.ino's loop scheduler */
+extern SchedTask resetTask;
+
 /* ─── Globals defined in data_log.ino, used by command handlers ──────── */
 
 extern NodeConfig    cfg;
@@ -30,11 +61,21 @@ extern uint16_t      broadcastAckJitterMs;
 extern uint16_t      bme280RateSec;
 extern uint16_t      battRateSec;
 extern uint16_t      gpsRateSec;
+extern uint16_t      gpsMinDistM;
+extern uint16_t      gpsFastKmh;
+extern uint16_t      gpsFastRateSec;
+extern uint16_t      logTxDiv;
+extern uint16_t      sensorSlackSec;
+extern uint16_t      autoSleepSec;
+extern uint16_t      healthRateSec;
 extern uint16_t      forceSampleCount;
-extern bool          blinkActive;
-extern unsigned long blinkOffTime;
 extern int16_t       lastRxRssi;
+extern uint32_t      rxPackets;
+extern uint32_t      txPackets;
 extern volatile bool deepSleepRequested;
+extern uint32_t      wakeCount;
+extern uint32_t      wakeTxLastMs;
+extern uint32_t      wakeTxMaxMs;
 extern TimerEvent_t  wakeUpTimer;
 
 /* ─── Public Interface ───────────────────────────────────────────────── */
@@ -45,6 +86,21 @@ extern TimerEvent_t  wakeUpTimer;
  */
 void commandsInit(CommandRegistry *reg);
 
+/*
+ * Run what commands left for after their ACK — radio reconfig (profile,
+ * rcfg_radio), the reset countdown, deep sleep — and restore the
+ * previous params when a timed profile expires.  Call from the tick loop
+ * while the TX queue is empty; returns true if the radio was
+ * reconfigured (it is left asleep on G2N — re-enter RX if listening).
+ */
+bool cmdAckTick(unsigned long now);
+
+/* True while an after-ACK action waits for the TX queue to drain */
+bool cmdAckPending(void);
+
+/* ms until a timed profile reverts, or SENSOR_NO_DEADLINE */
+unsigned long profileRevertDueIn(unsigned long now);
+
 /*
  * Apply TX/RX config using current runtime params.
  * Call from setup() after loading params from EEPROM.
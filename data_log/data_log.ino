@@ -3,6 +3,13 @@
 #include "hw.h"
 #include <Wire.h>
 
+/* ─── Debug Output ──────────────────────────────────────────────────────── */
+
+/* Tokenized-log file ID; this unit also owns the log ring (see dbg.h) */
+#define DBG_FILE_ID 1
+#define DBG_IMPL
+#include "dbg.h"
+
 /* ─── CMD/ACK Debug (must be before packets.h) ─────────────────────────── */
 
 #ifndef CMD_DEBUG
@@ -10,25 +17,27 @@
 #endif
 
 #if CMD_DEBUG
-  #define CDBG(fmt, ...) Serial.printf("[%lu] " fmt, millis(), ##__VA_ARGS__)
+  #define CDBG(fmt, ...) DBG_LOG("[%lu] " fmt, millis(), ##__VA_ARGS__)
 #else
   #define CDBG(fmt, ...) ((void)0)
 #endif
 
+/* CRC-32 tables are defined in this unit only (see crc32.h) */
+#define CRC32_IMPL
+
 #include "packets.h"
 #include "radio.h"
 #include "config.h"
 #include "commands.h"
 #include "sensor_drv.h"
-#include "bme280_sensor.h"
-#include "batt_sensor.h"
 #include "gps_sensor.h"
+#include "flash_log.h"
+#define LED_IMPL          /* the NeoPixel and its pattern queue live here */
 #include "led.h"
+#include "wdt.h"
 #include "innerWdt.h"
 
-/* ─── Debug Output ──────────────────────────────────────────────────────── */
-
-#include "dbg.h"
+/* ─── Serial ────────────────────────────────────────────────────────────── */
 
 /* When no debug output is compiled in, skip Serial entirely —
  * saves ~100-200µA from the idle UART peripheral. */
@@ -64,12 +73,81 @@
 
 #define TX_TIME_MS               200          /* Estimated TX time */
 
+/*
+ * TX queue (see txqueue.h): how long a packet may wait before it is
+ * dropped unsent, and how long the radio gets to report TX done.  An ACK
+ * the gateway has stopped waiting for only wastes airtime; a reading
+ * that waited this long is stale (the next cycle brings a fresh one).
+ */
+#ifndef TX_ACK_MAX_AGE_MS
+#define TX_ACK_MAX_AGE_MS        2000
+#endif
+
+#ifndef TX_DATA_MAX_AGE_MS
+#define TX_DATA_MAX_AGE_MS       10000
+#endif
+
+#define TX_TIMEOUT_MS            3000         /* no TX done: abandon packet */
+
+/*
+ * Two-phase sensors (see sensor_drv.h) due at the next cycle start are
+ * started this long before it, so results are ready for the TX slot.
+ * Covers a BME280 1x forced conversion (~10 ms) with plenty of margin.
+ */
+#ifndef SENSOR_PREFETCH_MS
+#define SENSOR_PREFETCH_MS       100
+#endif
+
+/*
+ * Tick-loop task periods.  Between passes the loop sleeps until the next
+ * one is due (or an interrupt comes in), so these set how often an idle
+ * node wakes.  The radio, sensor and LED tasks have no period: each
+ * sleeps until its own next deadline (the radio task also runs after
+ * every wake), and the LED task stops while no pattern is queued.
+ */
+#define WDT_TASK_MS              (WDT_FEED_INTERVAL_MS / 2)
+#define SENSOR_TASK_MS           10           /* poll_ready() interval while converting */
+#define GPS_TASK_MS              100          /* ring holds ~1 s of NMEA */
+#define RADIO_TASK_MAX_MS        1000         /* radio task reruns at least this often */
+#define IDLE_SLEEP_MIN_MS        2            /* shorter gaps are spun through */
+
+/*
+ * Autonomous deep sleep (autosleep param > 0): after each sample/TX/RX
+ * burst the node sleeps until the next sensor deadline or RX slot,
+ * whichever comes first.  Shorter gaps are spent awake in the tick loop —
+ * a deep-sleep round trip (Vext, I2C, radio) is not free.
+ */
+#ifndef AUTOSLEEP_MIN_MS
+#define AUTOSLEEP_MIN_MS         2000
+#endif
+
+/*
+ * Vext power gating: the peripheral rail is switched on only while a
+ * sensor on it is warming up or sampling, or the LED is lit.  Set to 0
+ * to keep Vext on permanently (except in deep sleep), as before.
+ */
+#ifndef VEXT_POWER_GATING
+#define VEXT_POWER_GATING        1
+#endif
+
+/*
+ * Health uplink: every health_rate seconds (0 = off) the node sends a
+ * compact summary of its counters as an ordinary sensor packet, so
+ * trouble shows up in the gateway's data without polling "stats".
+ * Runtime-only param (not saved); this sets its boot value.
+ */
+#ifndef HEALTH_RATE_SEC
+#define HEALTH_RATE_SEC          0
+#endif
+
+#define SENSOR_ID_HEALTH         5            /* sensor class ID for the health packet */
+
 #ifndef LED_BRIGHTNESS
 #define LED_BRIGHTNESS           128          /* 0-255, default brightness */
 #endif
 
 /* CRC-32, Reading, buildSensorPacket, CommandPacket, parseCommand,
- * buildAckPacket are all in packets.h */
+ * buildAckPacket, AckTemplate are all in packets.h */
 
 /* ─── Globals ────────────────────────────────────────────────────────────── */
 
@@ -88,9 +166,14 @@ uint16_t      broadcastAckJitterMs; /* Max jitter before ACK (0=off) */
 uint16_t      bme280RateSec;  /* BME280 sample interval (seconds) */
 uint16_t      battRateSec;    /* Battery sample interval (seconds) */
 uint16_t      gpsRateSec;    /* GPS sample interval (seconds) */
+uint16_t      gpsMinDistM;    /* GPS report movement threshold (m) */
+uint16_t      gpsFastKmh;     /* GPS fast-rate speed threshold (km/h, 0=off) */
+uint16_t      gpsFastRateSec; /* GPS sample interval while fast (seconds) */
+uint16_t      logTxDiv;       /* Uplink every Nth reading batch (0=log only) */
+uint16_t      sensorSlackSec; /* Sensor coalescing window (seconds) */
+uint16_t      autoSleepSec;   /* RX slot period in autonomous sleep (0=off) */
+uint16_t      healthRateSec = HEALTH_RATE_SEC; /* Health uplink period (0=off, not saved) */
 uint16_t      forceSampleCount = 0; /* >0: force all sensors to sample, decrement each cycle */
-bool          blinkActive  = false;
-unsigned long blinkOffTime = 0;
 
 /* Deep sleep state */
 TimerEvent_t wakeUpTimer;
@@ -99,6 +182,20 @@ static volatile bool inDeepSleep = false;
 
 static void onWakeUp(void) { inDeepSleep = false; }
 
+/* Idle sleep between tick-loop passes: the timer only has to wake the MCU */
+TimerEvent_t idleTimer;
+static void onIdleWake(void) { }
+
+/* Start of the last RX window — autosleep wakes for the next one */
+static unsigned long lastRxSlotStart = 0;
+
+/* Wake → first sensor TX latency (shared with commands.cpp "wakelat") */
+static unsigned long wakeTime    = 0;
+static bool          wakeTxArmed = false;  /* first TX since wake not yet timed */
+uint32_t      wakeCount    = 0;
+uint32_t      wakeTxLastMs = 0;
+uint32_t      wakeTxMaxMs  = 0;
+
 /* Last processed command ID for duplicate detection */
 static char lastCommandId[32] = "";
 
@@ -114,48 +211,151 @@ static inline unsigned long getRxWindowMs(void)
     return ((unsigned long)(CYCLE_PERIOD_MS - TX_TIME_MS) * rxDutyPercent) / 100;
 }
 
-/* RX state */
-static uint8_t rxBuffer[LORA_MAX_PAYLOAD + 1];
-static volatile int rxLen = 0;
-static volatile bool rxDone = false;
-static volatile bool txDone = false;
-int16_t lastRxRssi = 0;  /* RSSI of last received packet (shared with commands.cpp) */
+/* RX queue: onRxDone() → tick loop (shared with commands.cpp "rx_drop") */
+RxQueue rxQueue;
+int16_t lastRxRssi = 0;  /* RSSI of last handled packet (shared with commands.cpp) */
+uint32_t rxPackets = 0;  /* packets received / transmitted since boot (params) */
+uint32_t txPackets = 0;
+
+/* Drop/failure counters and loop latency (shared with commands.cpp "stats") */
+NodeStats nodeStats;
 
 /* Command registry */
 static CommandRegistry cmdRegistry;
 
-/* ─── Radio Callbacks ────────────────────────────────────────────────────── */
+/* Command turnaround: RX done → ACK TX done (shared with commands.cpp "lat") */
+LatStats latStats;
+static LatTrace    latTrace;
+static int8_t      latAckSlot = -1;   /* TX queue slot + seq of the traced ACK */
+static uint32_t    latAckSeq  = 0;
+static AckTemplate ackTemplate;       /* plain ACKs built without snprintf */
 
-static void onTxDone(void)
+/* TX queue (shared with commands.cpp "txq") */
+TxQueue txQueue;
+static volatile bool txDrained = false;   /* queue emptied: back to G2N */
+static bool txBulkHeld = false;           /* txFlush(): no new bulk blocks */
+
+/* Last bulk-transfer activity, for the idle timeout */
+static unsigned long xferLastMs = 0;
+
+/* ─── TX Queue ───────────────────────────────────────────────────────────── */
+
+/*
+ * Start the next queued packet if the radio is free.  Called from the
+ * tick loop and from onTxDone(), so queued packets follow each other
+ * without a gap.  Bulk-transfer blocks are built one at a time, only
+ * when nothing else is waiting, so ACKs and readings always go first.
+ */
+static void txPump(void)
 {
-    txDone = true;
+    if (txqBusy(&txQueue)) return;
+    unsigned long now = millis();
+
+    uint16_t blk;
+    if (txqEmpty(&txQueue) && !txBulkHeld && !cmdAckPending() &&
+        xferNext(&xferSession, &blk)) {
+        char pkt[LORA_MAX_PAYLOAD + 1];
+        int len = xferBuildBlock(&xferSession, blk, nodeId, pkt, sizeof(pkt));
+        if (len > 0)
+            txqPush(&txQueue, pkt, len, TXQ_PRIO_BULK, n2gFreqHz, now, 0, TX_DATA_MAX_AGE_MS);
+        xferLastMs = now;
+        if (!xferSession.round)
+            DBG("XFER %u: round queued, base %u/%u\n", (unsigned)xferSession.id,
+                (unsigned)xferSession.base, (unsigned)xferSession.nBlocks);
+    }
+
+    int slot = txqStart(&txQueue, now);
+    if (slot < 0) return;
+    TxqEntry *e = &txQueue.e[slot];
     Radio.Sleep();
+    Radio.SetChannel(e->freqHz);
+    Radio.Send(e->buf, e->len);
+    if (slot == latAckSlot && e->seq == latAckSeq) latMark(&latTrace, 3, micros());
 }
 
-static void onRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+/*
+ * Finish the packet on the air and start the next; when nothing is left
+ * the tick loop returns the radio to G2N.
+ */
+static void txAdvance(bool ok)
 {
-    DBG("RX: Got packet! size=%d rssi=%d snr=%d\n", size, rssi, snr);
-    CDBG("RX_PKT size=%d rssi=%d\n", size, rssi);
-    if (size > 0 && size <= LORA_MAX_PAYLOAD) {
-        memcpy(rxBuffer, payload, size);
-        rxLen = size;
-        rxDone = true;
-        lastRxRssi = rssi;
-
-        /* Try to print as string */
-        DBG("RX: Payload: %.*s\n", size, payload);
-
-        /* Also print first 32 bytes as hex for debugging */
-        DBGP("RX: Hex: ");
-        for (int i = 0; i < size && i < 32; i++) {
-            DBG("%02x ", payload[i]);
-        }
-        if (size > 32) DBGP("...");
-        DBGLN();
-    } else {
-        DBG("RX: Invalid size %d\n", size);
+    int slot = txQueue.inFlight;
+    if (slot >= 0 && slot == latAckSlot && txQueue.e[slot].seq == latAckSeq) {
+        if (ok) latFinish(&latStats, &latTrace, micros());
+        else    latAbort(&latTrace);
+        latAckSlot = -1;
     }
+
+    int prio = txqFinish(&txQueue, millis(), ok);
+    if (ok) txPackets++;
+    else    DBGLN("TX: timeout, packet abandoned");
+
+    if (prio == TXQ_PRIO_DATA && ok && wakeTxArmed) {
+        wakeTxArmed  = false;
+        wakeTxLastMs = millis() - wakeTime;
+        if (wakeTxLastMs > wakeTxMaxMs) wakeTxMaxMs = wakeTxLastMs;
+        DBG("Wake to first TX: %lu ms\n", (unsigned long)wakeTxLastMs);
+    }
+
     Radio.Sleep();
+    txPump();
+    if (!txqBusy(&txQueue)) txDrained = true;
+}
+
+/*
+ * Block until everything already queued is sent or dropped.  Only for
+ * deep sleep, which would lose the queue's contents; commands that must
+ * wait for their ACK defer the action instead (cmdAckTick()).
+ */
+static void txFlush(void)
+{
+    unsigned long start = millis();
+    unsigned long limit = broadcastAckJitterMs + TX_TIMEOUT_MS;
+    txBulkHeld = true;
+    while (!txqEmpty(&txQueue) && millis() - start < limit) {
+        Radio.IrqProcess();
+        feedInnerWdt();
+#ifdef SENSOR_GPS
+        gpsFeed();
+#endif
+        if (txqAirMs(&txQueue, millis()) > TX_TIMEOUT_MS) txAdvance(false);
+        txPump();
+        delay(1);
+    }
+    txBulkHeld = false;
+}
+
+/* Radio back to G2N after transmitting; listen again if the window is open */
+static void radioResumeRx(bool listening)
+{
+    Radio.Sleep();
+    Radio.SetChannel(g2nFreqHz);
+    if (listening) Radio.Rx(0);
+}
+
+/* ─── Radio Callbacks ────────────────────────────────────────────────────── */
+
+static void onTxDone(void)
+{
+    txAdvance(true);
+}
+
+static void onTxTimeout(void)
+{
+    txAdvance(false);
+}
+
+/*
+ * Queue the packet for the tick loop.  The radio stays in continuous RX,
+ * so a command arriving while this one is handled lands in the next slot.
+ * Timestamp and copy only: debug output (blocking Serial writes unless
+ * tokenized) comes from handleRxPacket(), and drops are counted by the
+ * queue.
+ */
+static void onRxDone(uint8_t *payload, uint16_t size, int16_t rssi, int8_t snr)
+{
+    uint32_t rxUs = micros();
+    if (rxqPush(&rxQueue, payload, size, rssi, snr, rxUs)) rxPackets++;
 }
 
 static void onRxTimeout(void)
@@ -164,68 +364,173 @@ static void onRxTimeout(void)
     Radio.Sleep();
 }
 
+/* Bad CRC or header: continuous RX carries on with the next packet */
 static void onRxError(void)
 {
     DBGLN("RX: Error");
-    Radio.Sleep();
 }
 
-/* ─── ACK + RX Resume Helper ─────────────────────────────────────────────── */
+/* ─── ACK Helper ─────────────────────────────────────────────────────────── */
 
 /*
- * Send an ACK buffer on N2G, wait for TX done, then switch back to G2N RX.
- * Used by handleRxPacket() to avoid repeating this pattern 3 times.
+ * Queue an ACK buffer for N2G, ahead of any sensor data.  Broadcast ACKs
+ * are held back by a random jitter so nodes don't collide; the loop
+ * keeps running meanwhile and the radio returns to G2N RX once sent.
  */
-static void sendAckAndResumeRx(const char *buf, int len, const char *label,
-                               bool addJitter = false)
+static void queueAck(const char *buf, int len, const char *label,
+                     bool addJitter = false)
 {
+    unsigned long holdMs = 0;
     if (addJitter && broadcastAckJitterMs > 0) {
-        unsigned long jitter = random(1, broadcastAckJitterMs);
-        DBG("Broadcast ACK jitter: %lums\n", jitter);
-        sleepWdt(jitter);
+        holdMs = random(1, broadcastAckJitterMs);
+        DBG("Broadcast ACK jitter: %lums\n", holdMs);
+    }
+    int slot = txqPush(&txQueue, buf, len, TXQ_PRIO_ACK, n2gFreqHz, millis(),
+                       holdMs, TX_ACK_MAX_AGE_MS);
+    if (slot < 0) {
+        DBG("%s dropped: TX queue full\n", label);
+        return;
+    }
+    /* The traced command's ACK: its TX start and done close the trace */
+    if (latTrace.marks == 2) {
+        latMark(&latTrace, 2, micros());
+        latAckSlot = (int8_t)slot;
+        latAckSeq  = txQueue.e[slot].seq;
     }
-    Radio.Sleep();
-    Radio.SetChannel(n2gFreqHz);
-    txDone = false;
-    Radio.Send((uint8_t *)buf, len);
     DBG("%s [%d bytes]\n", label, len);
     CDBG("ACK_TX %s bytes=%d\n", label, len);
+    txPump();
+}
 
-    unsigned long ackStart = millis();
-    while (!txDone && (millis() - ackStart) < 1000) {
-        Radio.IrqProcess();
-        feedInnerWdt();
-        delay(1);
+/* ─── Sensor TX Helper ───────────────────────────────────────────────────── */
+
+/*
+ * Pack readings[] into as many sensor packets as needed and queue each
+ * for N2G.  The first starts right away; the rest follow from onTxDone()
+ * with no gap.  Used at cycle start and for two-phase conversions that
+ * finish during the tick loop.
+ */
+static void sendReadings(const Reading *readings, int nRead)
+{
+    char pkt[LORA_MAX_PAYLOAD + 1];
+    int offset = 0;
+
+    while (offset < nRead) {
+        int nextOffset;
+        int pLen = sensorPack(nodeId, readings, nRead,
+                              offset, &nextOffset, pkt, sizeof(pkt));
+        if (pLen == 0) {
+            DBG("ERROR: reading \"%s\" alone exceeds max payload\n",
+                readings[offset].name);
+            offset = nextOffset;
+            continue;
+        }
+
+        if (txqPush(&txQueue, pkt, pLen, TXQ_PRIO_DATA, n2gFreqHz, millis(),
+                    0, TX_DATA_MAX_AGE_MS) < 0)
+            DBGLN("TX queue full: readings dropped");
+        else
+            DBG("Queued %d/%d readings [%d bytes]\n",
+                nextOffset - offset, nRead, pLen);
+        if (offset > 0) nodeStats.splitPkts++;
+        offset = nextOffset;
     }
-    Radio.Sleep();
-    Radio.SetChannel(g2nFreqHz);
-    Radio.Rx(0);
+    txPump();
+}
+
+/* ─── Health Uplink ─────────────────────────────────────────────────────── */
+
+static unsigned long lastHealthMs = 0;
+static bool          healthSent   = false;
+
+/*
+ * Every healthRateSec, queue the counters that matter most as one
+ * sensor packet (SENSOR_ID_HEALTH).  Not written to the flash log —
+ * it describes the node, not the environment.
+ */
+static void healthTick(unsigned long now)
+{
+    if (healthRateSec == 0) return;
+    if (healthSent && now - lastHealthMs < (unsigned long)healthRateSec * 1000UL) return;
+    lastHealthMs = now;
+    healthSent   = true;
+
+    uint32_t sensorFails = 0;
+    const SensorSlot *s;
+    for (int i = 0; (s = sensorGetSlot(i)) != NULL; i++)
+        sensorFails += s->readFails + s->initFails;
+
+    Reading r[] = {
+        { "loop_max",    SENSOR_ID_HEALTH, "ms", (double)nodeStats.loopMaxMs },
+        { "parse_fail",  SENSOR_ID_HEALTH, "",   (double)statsParseFails(&nodeStats) },
+        { "rx_drop",     SENSOR_ID_HEALTH, "",   (double)rxQueue.dropped },
+        { "sensor_fail", SENSOR_ID_HEALTH, "",   (double)sensorFails },
+        { "tx_timeout",  SENSOR_ID_HEALTH, "",   (double)txQueue.timeouts },
+    };
+    sendReadings(r, sizeof(r) / sizeof(r[0]));
+}
+
+/* ─── On-Device Log ──────────────────────────────────────────────────────── */
+
+/* Reading batches since boot, for log_txdiv thinning */
+static uint32_t readingBatches = 0;
+
+/*
+ * Append a batch of readings to the flash log and decide whether it is
+ * also uplinked: every logTxDiv-th batch is, none when logTxDiv is 0.
+ */
+static bool logReadings(const Reading *readings, int nRead)
+{
+    flashLogReadings(readings, nRead, millis());
+    if (logTxDiv == 0) return false;
+    return (readingBatches++ % logTxDiv) == 0;
 }
 
+/* ─── Bulk Transfer ─────────────────────────────────────────────────────── */
+
+/*
+ * A transfer the gateway stops acknowledging is dropped after this long,
+ * so it doesn't hold autosleep off indefinitely.  Its blocks are sent
+ * from the TX queue (txPump), after the ACK of the command that opened
+ * or acknowledged the round.
+ */
+#define XFER_IDLE_TIMEOUT_MS     60000
+
 /* ─── RX Packet Handler ─────────────────────────────────────────────────── */
 
 /*
- * Process a received packet from the RX buffer.
- * Parses command, handles dedup, sends ACK, dispatches handler,
- * and resumes RX on G2N.  Called from the tick loop when rxDone is set.
+ * Process one queued packet (NUL-terminated by rxqPush()).
+ * Parses command, handles dedup, queues the ACK and dispatches the
+ * handler; the radio returns to G2N RX once the ACK is sent.  Called from
+ * the tick loop for each packet in the RX queue.
  */
-static void handleRxPacket(void)
+static void handleRxPacket(RxqEntry *rx)
 {
-    DBGLN("RX: Processing received packet");
+    static uint32_t dropsSeen = 0;
+    if (rxQueue.dropped != dropsSeen) {
+        DBG("RX: %lu dropped, queue full\n", (unsigned long)(rxQueue.dropped - dropsSeen));
+        dropsSeen = rxQueue.dropped;
+    }
+    DBG("RX: Got packet! size=%d rssi=%d snr=%d\n", rx->len, rx->rssi, rx->snr);
+    CDBG("RX_PKT size=%d rssi=%d\n", rx->len, rx->rssi);
+    DBG("RX: Payload: %s\n", (const char *)rx->buf);
+    lastRxRssi = rx->rssi;
 
     /* Skip padding bytes - find first '{' character */
-    uint8_t *jsonStart = rxBuffer;
-    int jsonLen = rxLen;
-    for (int i = 0; i < rxLen && i < 8; i++) {
-        if (rxBuffer[i] == '{') {
-            jsonStart = &rxBuffer[i];
-            jsonLen = rxLen - i;
+    uint8_t *jsonStart = rx->buf;
+    int jsonLen = rx->len;
+    for (int i = 0; i < rx->len && i < 8; i++) {
+        if (rx->buf[i] == '{') {
+            jsonStart = &rx->buf[i];
+            jsonLen = rx->len - i;
             break;
         }
     }
 
     CommandPacket cmd;
-    if (!parseCommand(jsonStart, jsonLen, &cmd)) {
+    ParseResult pr = parseCommandResult(jsonStart, jsonLen, &cmd);
+    if (pr != PARSE_OK) {
+        nodeStats.parseFail[pr]++;
         DBGLN("RX: Not a command packet, continuing to listen...");
         CDBG("RX_DROP\n");
         return;
@@ -238,13 +543,21 @@ static void handleRxPacket(void)
         DBG("RX: Command not for us (node_id='%s', our id='%s')\n",
                       cmd.node_id, nodeId);
         CDBG("RX_NOTME node=%s\n", cmd.node_id);
+        nodeStats.notMe++;
         return;
     }
 
+    /* Trace this command's turnaround from its RX done */
+    latBegin(&latTrace, rx->rxUs);
+    latMark(&latTrace, 1, micros());
+    latAckSlot = -1;
+
+    /* Command timestamps are the gateway's clock — timestamp the log with it */
+    flashLogSetTime(cmd.timestamp, millis());
+
     /* Build command ID for dedup check */
-    char commandId[32];
-    snprintf(commandId, sizeof(commandId), "%u_%.4s",
-             cmd.timestamp, cmd.crc);
+    char commandId[16];
+    int commandIdLen = ackFmtId(commandId, cmd.timestamp, cmd.crc);
     bool isDuplicate = (strcmp(commandId, lastCommandId) == 0);
 
     DBG("CMD: %s (from %s, id=%s%s)\n",
@@ -257,6 +570,7 @@ static void handleRxPacket(void)
 
     /* Look up handler to check earlyAck flag */
     CommandHandler *handler = cmdLookup(&cmdRegistry, &cmd);
+    if (handler != NULL) latTrace.cmd = (int8_t)(handler - cmdRegistry.handlers);
     bool useEarlyAck = (handler != NULL && handler->earlyAck);
     /* Add jitter for ALL broadcast responses to prevent ACK collisions */
     bool is_broadcast = (cmd.node_id[0] == '\0');
@@ -264,17 +578,18 @@ static void handleRxPacket(void)
 
     /* For earlyAck handlers, send ACK before dispatch (and cache it) */
     if (useEarlyAck && !isDuplicate) {
-        lastAckLen = buildAckPacket(lastAckBuf, sizeof(lastAckBuf),
-                                    cmd.timestamp, cmd.crc, nodeId);
+        lastAckLen = ackTemplateBuild(&ackTemplate, lastAckBuf, sizeof(lastAckBuf),
+                                      commandId, commandIdLen);
         if (lastAckLen > 0)
-            sendAckAndResumeRx(lastAckBuf, lastAckLen, "ACK sent on N2G", addJitter);
+            queueAck(lastAckBuf, lastAckLen, "ACK sent on N2G", addJitter);
     }
 
     /* Dispatch to registered handlers (skip duplicates) */
     if (isDuplicate) {
         DBG("CMD: Duplicate %s, resending cached ACK\n", commandId);
+        nodeStats.dup++;
         if (lastAckLen > 0)
-            sendAckAndResumeRx(lastAckBuf, lastAckLen, "Cached ACK resent", addJitter);
+            queueAck(lastAckBuf, lastAckLen, "Cached ACK resent", addJitter);
     } else {
         /* New command - update dedup tracking */
         strncpy(lastCommandId, commandId, sizeof(lastCommandId) - 1);
@@ -288,19 +603,342 @@ static void handleRxPacket(void)
                               (char (*)[CMD_MAX_ARG_LEN])cmd.args,
                               cmd.arg_count);
         } else {
+            nodeStats.unknownCmd++;
             snprintf(cmdResponseBuf, CMD_RESPONSE_BUF_SIZE,
                      "{\"e\":\"unrecognized_cmd\"}");
         }
 
         /* For late-ACK handlers (and unrecognized), send ACK with response */
         if (!useEarlyAck) {
-            lastAckLen = buildAckPacketWithPayload(lastAckBuf, sizeof(lastAckBuf),
-                                                   cmd.timestamp, cmd.crc,
-                                                   nodeId, cmdResponseBuf);
+            if (cmdResponseBuf[0] == '\0')
+                lastAckLen = ackTemplateBuild(&ackTemplate, lastAckBuf, sizeof(lastAckBuf),
+                                              commandId, commandIdLen);
+            else
+                lastAckLen = buildAckPacketWithPayload(lastAckBuf, sizeof(lastAckBuf),
+                                                       cmd.timestamp, cmd.crc,
+                                                       nodeId, cmdResponseBuf);
             if (lastAckLen > 0)
-                sendAckAndResumeRx(lastAckBuf, lastAckLen, "ACK+payload sent on N2G", addJitter);
+                queueAck(lastAckBuf, lastAckLen, "ACK+payload sent on N2G", addJitter);
+        }
+    }
+}
+
+/* ─── Vext Rail ──────────────────────────────────────────────────────────── */
+
+/* Rail switch callback for the sensor power manager (see power_rail.h) */
+static void vextSet(bool on)
+{
+    if (on) {
+        digitalWrite(Vext, LOW);  /* power on external sensors (active-low) */
+        delay(1);                 /* let Vext rail stabilise */
+    } else {
+        Wire.end();               /* release I2C pins before the rail drops */
+#ifdef SENSOR_GPS
+        gpsSuspend();             /* stop the UART poll timer */
+#endif
+        digitalWrite(RGB, LOW);   /* don't back-power the NeoPixel */
+        digitalWrite(Vext, HIGH); /* power off external sensors */
+    }
+}
+
+/* Rail just came up: clear the NeoPixel before it latches garbage, restart I2C */
+static void vextPowered(void)
+{
+    ledInit();
+    Wire.begin();
+}
+
+/* ─── Deep Sleep ─────────────────────────────────────────────────────────── */
+
+/*
+ * Shut down peripherals and sleep until wakeUpTimer fires.  The caller
+ * must have started wakeUpTimer.  Returns to loop() rather than
+ * re-running setup(): RAM is retained, so scheduler deadlines and driver
+ * state carry over.  Vext stays off on wake — the sensor power manager
+ * brings it back (and warm-resumes the sensors) when one is due.
+ */
+static void deepSleep(void)
+{
+    /* Let queued packets go out first */
+    txFlush();
+    inDeepSleep = true;
+
+    /* Shut down everything for minimum current (~3.5µA target) */
+    wdtDisable();
+    Radio.Sleep();
+    ledOff();
+    if (ledBusy()) {
+        ledStop();
+        sensorPowerHold(POWER_HOLD_LED, false);
+    }
+    DBG("Entering deep sleep...\n");
+    dbgFlush();
+    SERIAL_END();
+    sensorPowerOff(millis()); /* Vext off: I2C released, GPS poll stopped */
+
+    while (inDeepSleep) {
+        lowPowerHandler();  /* CPU deep sleep — wakes on RTC timer */
+    }
+
+    /* Restore MCU-side peripherals after wakeup */
+    statsLoopPause(&nodeStats);
+    wakeTime = millis();
+    SERIAL_BEGIN();
+    wdtEnable();
+    wakeCount++;
+    wakeTxArmed = true;
+    Radio.SetChannel(n2gFreqHz);
+    DBG("Woke up from deep sleep\n");
+}
+
+/* Arm wakeUpTimer for ms and deep sleep (autonomous path). */
+static void enterDeepSleep(unsigned long ms)
+{
+    TimerSetValue(&wakeUpTimer, ms);
+    TimerStart(&wakeUpTimer);
+    deepSleep();
+}
+
+/*
+ * How long autosleep may sleep from now: until the next sensor deadline
+ * or RX slot, whichever is sooner.  Returns 0 (stay awake) when autosleep
+ * is off, work is still in flight (conversions, LED blink, forced
+ * samples, an operator sleep, a bulk transfer, queued TX), or the gap is
+ * below AUTOSLEEP_MIN_MS.
+ */
+static unsigned long autoSleepMs(unsigned long now)
+{
+    if (autoSleepSec == 0) return 0;
+    if (sensorPending() > 0 || sensorPowerBusy() || ledBusy() || resetTask.active ||
+        forceSampleCount > 0 || deepSleepRequested ||
+        xferSession.active || !txqEmpty(&txQueue)) return 0;
+
+    unsigned long slotMs  = (unsigned long)autoSleepSec * 1000UL;
+    unsigned long sinceRx = now - lastRxSlotStart;
+    unsigned long untilRx = (sinceRx < slotMs) ? slotMs - sinceRx : 0;
+
+    unsigned long ms = sensorNextDueIn(now);
+    if (untilRx < ms) ms = untilRx;
+    unsigned long untilRevert = profileRevertDueIn(now);
+    if (untilRevert < ms) ms = untilRevert;
+    return (ms >= AUTOSLEEP_MIN_MS) ? ms : 0;
+}
+
+/* ─── Loop Tasks ─────────────────────────────────────────────────────────── */
+
+/*
+ * The tick loop runs these in order (shared/sched.h).  Each does a
+ * short slice of work and returns; the loop itself only decides when
+ * the cycle ends.  Tasks run in the order they're added in setup().
+ */
+Scheduler loopSched;
+
+/* Per-cycle state, set by loop() before the tick loop */
+static struct {
+    unsigned long start;
+    unsigned long rxDeadline;   /* RX window closes */
+    unsigned long slackMs;      /* sensor coalescing window */
+    bool          listening;    /* RX window open */
+    bool          prefetched;   /* next cycle's slow conversions started */
+} cycle;
+
+static void taskWdt(SchedTask *t, uint32_t now)
+{
+    feedInnerWdt();
+}
+
+/* ms until the radio task has timed work: RX window close, TX timeout,
+ * a held packet's start, a profile revert.  RX/TX done wake it sooner. */
+static unsigned long radioDueIn(unsigned long now)
+{
+    unsigned long ms = RADIO_TASK_MAX_MS;
+    if (cycle.listening) {
+        long left = (long)(cycle.rxDeadline - now);
+        if (left < 0) left = 0;
+        if ((unsigned long)left < ms) ms = (unsigned long)left;
+    }
+    if (txqBusy(&txQueue)) {
+        unsigned long air  = txqAirMs(&txQueue, now);
+        unsigned long left = air <= TX_TIMEOUT_MS ? TX_TIMEOUT_MS - air + 1 : 0;
+        if (left < ms) ms = left;
+    } else {
+        unsigned long q = txqDueIn(&txQueue, now);
+        if (q < ms) ms = q;
+    }
+    unsigned long revert = profileRevertDueIn(now);
+    if (revert < ms) ms = revert;
+    return ms;
+}
+
+/* Radio IRQs, received commands, TX queue, RX window: after every wake,
+ * and when one of its deadlines comes up */
+static void taskRadio(SchedTask *t, uint32_t now)
+{
+    Radio.IrqProcess();
+
+    /* Handle every received packet, oldest first; the radio is still
+     * listening (or sending an ACK) meanwhile */
+    RxqEntry *rx;
+    while ((rx = rxqPeek(&rxQueue)) != NULL) {
+        handleRxPacket(rx);
+        rxqPop(&rxQueue);
+    }
+
+    /* TX queue: start what's ready, abandon a packet the radio never finished */
+    if (txqAirMs(&txQueue, millis()) > TX_TIMEOUT_MS) txAdvance(false);
+    txPump();
+    if (txDrained) {
+        txDrained = false;
+        radioResumeRx(cycle.listening);
+    }
+
+    /* ACK out: radio retune, reset, sleep; timed profiles revert */
+    if (txqEmpty(&txQueue) && cmdAckTick(millis()) && cycle.listening) Radio.Rx(0);
+
+    /* Stop radio after RX window expires */
+    if (cycle.listening && (long)(millis() - cycle.rxDeadline) >= 0) {
+        DBGLN("RX: Window closed");
+        CDBG("RX_CLOSE\n");
+        if (!txqBusy(&txQueue)) Radio.Sleep();
+        cycle.listening = false;
+    }
+
+    schedSleep(t, millis(), radioDueIn(millis()));
+}
+
+#ifdef SENSOR_GPS
+static void taskGps(SchedTask *t, uint32_t now)
+{
+    gpsFeed();
+}
+#endif
+
+/* Vext, two-phase conversions, prefetch */
+static void taskSensors(SchedTask *t, uint32_t now)
+{
+    /* Power Vext up for warm-ups, down once nothing needs it */
+    sensorPowerTick(millis(), cycle.slackMs);
+
+    /* Two-phase conversions started this cycle: send when finished */
+    if (sensorPending() > 0) {
+        Reading readings[SENSOR_MAX_READINGS];
+        int nLate = sensorCollect(millis(), readings, SENSOR_MAX_READINGS);
+        if (nLate > 0 && logReadings(readings, nLate))
+            sendReadings(readings, nLate);
+    }
+
+    /* Start slow conversions ahead of the next cycle's TX slot */
+    if (!cycle.prefetched &&
+        millis() - cycle.start >= CYCLE_PERIOD_MS - SENSOR_PREFETCH_MS) {
+        sensorPrefetch(millis(), SENSOR_PREFETCH_MS, cycle.slackMs);
+        cycle.prefetched = true;
+    }
+
+    /* Conversions only say when they're done if asked: poll them.  Else
+     * wake for the next deadline or warm-up, or the prefetch point.  A
+     * sensor already due waits for the cycle-start sensorPoll(), which
+     * wakes this task again. */
+    unsigned long in = SENSOR_TASK_MS;
+    if (sensorPending() == 0) {
+        in = sensorNextDueIn(millis());
+        if (in == 0 || in > CYCLE_PERIOD_MS) in = CYCLE_PERIOD_MS;
+        if (!cycle.prefetched) {
+            long left = (long)(cycle.start + CYCLE_PERIOD_MS -
+                               SENSOR_PREFETCH_MS - millis());
+            if (left < 0) left = 0;
+            if ((unsigned long)left < in) in = (unsigned long)left;
         }
     }
+    schedSleep(t, millis(), in);
+}
+
+/* LED patterns (blink, rcfg_radio, testled): wakes for each step, drops
+ * the Vext hold once the last one has played, then stops until ledWake() */
+static void taskLed(SchedTask *t, uint32_t now)
+{
+    if (ledTick(now) == LED_SEQ_DONE) {
+        sensorPowerHold(POWER_HOLD_LED, false);
+        sensorPowerTick(now, cycle.slackMs);
+    }
+
+    uint32_t in = ledDueIn(now);
+    if (in == LED_SEQ_NO_DEADLINE) schedStop(t);
+    else                           schedSleep(t, now, in);
+}
+
+/* Abandoned transfer: gateway stopped acknowledging */
+static void taskXfer(SchedTask *t, uint32_t now)
+{
+    flashLogTick(now);      /* bound what a crash can take from the log */
+    if (xferSession.active && now - xferLastMs >= XFER_IDLE_TIMEOUT_MS) {
+        DBG("XFER %u: idle, closed\n", (unsigned)xferSession.id);
+        xferSession.active = false;
+    }
+}
+
+static SchedTask wdtTask     = SCHED_TASK("wdt",     taskWdt,     WDT_TASK_MS, true);
+static SchedTask radioTask   = SCHED_TASK("radio",   taskRadio,   0,    true);
+#ifdef SENSOR_GPS
+static SchedTask gpsTask     = SCHED_TASK("gps",     taskGps,     GPS_TASK_MS, true);
+#endif
+static SchedTask sensorsTask = SCHED_TASK("sensors", taskSensors, 0,    true);
+static SchedTask ledTask     = SCHED_TASK("led",     taskLed,     0,    false);
+static SchedTask xferTask    = SCHED_TASK("xfer",    taskXfer,    1000, true);
+
+static void loopTasksInit(unsigned long now)
+{
+    schedInit(&loopSched);
+    schedAdd(&loopSched, &wdtTask, now);
+    schedAdd(&loopSched, &radioTask, now);
+#ifdef SENSOR_GPS
+    schedAdd(&loopSched, &gpsTask, now);
+#endif
+    schedAdd(&loopSched, &sensorsTask, now);
+    schedAdd(&loopSched, &ledTask, now);
+    schedAdd(&loopSched, &xferTask, now);
+    schedAdd(&loopSched, &resetTask, now);   /* commands.cpp, idle until "reset" */
+}
+
+/* ledOnQueue hook: a handler queued a pattern.  Raise the rail for the
+ * LED hold now rather than at the sensor task's next wake. */
+static void ledWake(void)
+{
+    sensorPowerTick(millis(), cycle.slackMs);
+    schedStart(&ledTask, millis());
+}
+
+/*
+ * Nothing to do until the next task deadline or queued packet: sleep
+ * until then, or until an interrupt (radio DIO1, the GPS poll timer
+ * while Vext is up) ends it sooner.  The radio task runs after every wake, since an RX or
+ * TX done leaves it work that no deadline announces.
+ *
+ * While the UART is in use (GPS, debug output) the CPU only halts and
+ * the clocks keep running; otherwise it enters deep sleep.
+ */
+static void loopIdle(unsigned long now)
+{
+    unsigned long ms = schedNextDueIn(&loopSched, now);
+    if (!txqBusy(&txQueue)) {
+        unsigned long q = txqDueIn(&txQueue, now);
+        if (q < ms) ms = q;
+    }
+    unsigned long inCycle = now - cycle.start;
+    unsigned long cycleLeft = inCycle < CYCLE_PERIOD_MS ? CYCLE_PERIOD_MS - inCycle : 0;
+    if (cycleLeft < ms) ms = cycleLeft;
+
+    if (ms >= IDLE_SLEEP_MIN_MS) {
+        statsLoopPause(&nodeStats);     /* asleep, not stalled */
+        TimerSetValue(&idleTimer, ms);
+        TimerStart(&idleTimer);
+#if defined(SENSOR_GPS) || DEBUG || CMD_DEBUG
+        CySysPmSleep();
+#else
+        lowPowerHandler();
+#endif
+        TimerStop(&idleTimer);
+    }
+    schedWake(&radioTask, millis());
 }
 
 /* ─── setup / loop ───────────────────────────────────────────────────────── */
@@ -323,7 +961,7 @@ void setup(void)
     /* Load config from EEPROM (or compile-time defaults on first boot).
      * When UPDATE_CFG=1, compile-time values are written to EEPROM.
      * Node ID is in a separate unversioned EEPROM region — survives
-     * CFG_VERSION bumps.  Use WRITE_NODE_ID=abXX to set it. */
+     * firmware updates.  Use WRITE_NODE_ID=abXX to set it. */
     cfgLoad(&cfg);
     cfgLoadNodeId(nodeId);
 #ifdef WRITE_NODE_ID
@@ -340,21 +978,31 @@ void setup(void)
     bme280RateSec = cfg.bme280RateSec;
     battRateSec   = cfg.battRateSec;
     gpsRateSec    = cfg.gpsRateSec;
+    gpsMinDistM   = cfg.gpsMinDistM;
+    gpsFastKmh    = cfg.gpsFastKmh;
+    gpsFastRateSec = cfg.gpsFastRateSec;
+    logTxDiv      = cfg.logTxDiv;
+    sensorSlackSec = cfg.sensorSlackSec;
+    autoSleepSec  = cfg.autoSleepSec;
+
+    /* Sensor drivers — the build's SENSOR_LIST (sensor_list.h) */
+    sensorInitAll();
 
-    /* Sensor drivers — register enabled sensors, then init all */
-#ifdef SENSOR_BME280
-    sensorRegister(&bme280Driver);
-#endif
-#ifdef SENSOR_BATT
-    sensorRegister(&battDriver);
-#endif
-#ifdef SENSOR_GPS
-    sensorRegister(&gpsDriver);
+    /* Resume the on-device sample log where it left off */
+    flashLogInit();
+
+    /* Vext is already on (above); from here the power manager owns it */
+    sensorPowerInit(vextSet, vextPowered, millis());
+#if !VEXT_POWER_GATING
+    sensorPowerHold(POWER_HOLD_ALWAYS, true);
 #endif
-    sensorInitAll();
 
-    /* LoRa — register callbacks */
+    /* LoRa — TX/RX queues, then register callbacks */
+    txqInit(&txQueue);
+    rxqInit(&rxQueue);
+    statsInit(&nodeStats);
     radioEvents.TxDone = onTxDone;
+    radioEvents.TxTimeout = onTxTimeout;
     radioEvents.RxDone = onRxDone;
     radioEvents.RxTimeout = onRxTimeout;
     radioEvents.RxError = onRxError;
@@ -378,14 +1026,20 @@ void setup(void)
     /* Command registry */
     cmdRegistryInit(&cmdRegistry, nodeId);
     commandsInit(&cmdRegistry);
+    ackTemplateInit(&ackTemplate, nodeId);
+    latInit(&latStats);
+    loopTasksInit(millis());
+    ledOnQueue = ledWake;
 
     /* Watchdog timer — resets MCU if main loop stalls (~4s timeout).
      * feedInnerWdt() must be called in every busy-wait loop. */
     wdtEnable();
     TimerInit(&wakeUpTimer, onWakeUp);
+    TimerInit(&idleTimer, onIdleWake);
 
     DBG("Initialization complete for Node: %s (v%u, tx=%ddBm, rxduty=%d%%)\n",
         nodeId, (unsigned)NODE_VERSION, txPower, rxDutyPercent);
+    dbgFlush();
 }
 
 void loop(void)
@@ -393,32 +1047,7 @@ void loop(void)
     /* ── Deep sleep: shut down peripherals, enter lowest-power mode ── */
     if (deepSleepRequested) {
         deepSleepRequested = false;
-        inDeepSleep = true;
-
-        /* Shut down everything for minimum current (~3.5µA target) */
-        wdtDisable();
-        Radio.Sleep();
-        ledOff();
-        DBG("Entering deep sleep...\n");
-        SERIAL_END();
-        Wire.end();             /* disable I2C peripheral */
-        digitalWrite(Vext, HIGH); /* power off external sensors (active-low) */
-
-        while (inDeepSleep) {
-            lowPowerHandler();  /* CPU deep sleep — wakes on RTC timer */
-        }
-
-        /* Restore peripherals after wakeup */
-        digitalWrite(Vext, LOW);  /* power on external sensors */
-        delay(1);                 /* let Vext rail stabilise */
-        Wire.begin();             /* restart I2C bus */
-        SERIAL_BEGIN();
-#ifdef SENSOR_GPS
-        Serial.begin(9600);  /* re-init GPS UART after deep sleep */
-#endif
-        wdtEnable();
-        Radio.SetChannel(n2gFreqHz);
-        DBG("Woke up from deep sleep\n");
+        deepSleep();
         return;  /* start fresh cycle — sensors reinit via is_alive() */
     }
 
@@ -435,95 +1064,43 @@ void loop(void)
         DBG("Force sample: %u remaining\n", (unsigned)forceSampleCount);
     }
 
-    /* ── Poll sensors — each driver checks its own interval ── */
+    /* ── Poll sensors — due drivers plus any within the slack window ── */
+    unsigned long slackMs = (unsigned long)sensorSlackSec * 1000UL;
     Reading readings[SENSOR_MAX_READINGS];
-    int nRead = sensorPoll(cycleStart, readings, SENSOR_MAX_READINGS);
+    int nRead = sensorPoll(cycleStart, slackMs, readings, SENSOR_MAX_READINGS);
 
-    if (nRead > 0) {
-        /* ── Build and send sensor packets ── */
-        char pkt[LORA_MAX_PAYLOAD + 1];
-        int offset = 0;
-
-        while (offset < nRead) {
-            int nextOffset;
-            int pLen = sensorPack(nodeId, readings, nRead,
-                                  offset, &nextOffset, pkt, sizeof(pkt));
-            if (pLen == 0) {
-                DBG("ERROR: reading \"%s\" alone exceeds max payload\n",
-                    readings[offset].name);
-                offset = nextOffset;
-                continue;
-            }
-
-            /* Send and wait for TX completion */
-            txDone = false;
-            Radio.Send((uint8_t *)pkt, pLen);
-            DBG("Sent %d/%d readings [%d bytes]\n",
-                nextOffset - offset, nRead, pLen);
-
-            unsigned long txStart = millis();
-            while (!txDone && (millis() - txStart) < 3000) {
-                Radio.IrqProcess();
-                feedInnerWdt();
-                delay(1);
-            }
-
-            offset = nextOffset;
-            if (offset < nRead)
-                delay(100);   /* brief gap between split packets */
-        }
-    }
+    if (nRead > 0 && logReadings(readings, nRead)) sendReadings(readings, nRead);
+    schedWake(&sensorsTask, millis());  /* collect what it started, rail off */
+    healthTick(cycleStart);
+    DBG("Next sensor due in %lu ms\n", sensorNextDueIn(millis()));
 
     /* ── Tick loop: RX + housekeeping until cycle ends ── */
     unsigned long rxWindowMs = getRxWindowMs();
-    unsigned long rxDeadline = cycleStart + TX_TIME_MS + rxWindowMs;
-    bool radioListening = false;
+    cycle.start      = cycleStart;
+    cycle.rxDeadline = cycleStart + TX_TIME_MS + rxWindowMs;
+    cycle.slackMs    = slackMs;
+    cycle.listening  = false;
+    cycle.prefetched = false;
 
     /* Start RX on G2N if duty cycle allows */
     if (rxWindowMs > 0) {
         DBG("Opening RX window for %lu ms on G2N (%.1f MHz)...\n",
                       rxWindowMs, g2nFreqHz / 1e6);
         CDBG("RX_OPEN dur=%lums\n", rxWindowMs);
-        Radio.Sleep();
-        Radio.SetChannel(g2nFreqHz);
-        rxDone = false;
-        rxLen = 0;
-        Radio.Rx(0);
-        radioListening = true;
+        /* Readings still on the air: RX starts when the queue drains */
+        if (!txqBusy(&txQueue)) radioResumeRx(true);
+        cycle.listening = true;
+        lastRxSlotStart = cycleStart;
     } else {
         DBGLN("RX disabled (rxDutyPercent=0)");
-        Radio.Sleep();
+        if (!txqBusy(&txQueue)) Radio.Sleep();
     }
 
-    while (millis() - cycleStart < CYCLE_PERIOD_MS) {
-        Radio.IrqProcess();
-        feedInnerWdt();
-#ifdef SENSOR_GPS
-        gpsFeed();
-#endif
-
-        /* Handle received packet */
-        if (rxDone) {
-            handleRxPacket();
-            rxDone = false;
-            rxLen = 0;
-            /* onRxDone() calls Radio.Sleep(); re-enter RX if window still open */
-            if (radioListening) Radio.Rx(0);
-        }
+    unsigned long sleepMs = 0;
 
-        /* Stop radio after RX window expires */
-        if (radioListening && millis() >= rxDeadline) {
-            DBGLN("RX: Window closed");
-            CDBG("RX_CLOSE\n");
-            Radio.Sleep();
-            radioListening = false;
-        }
-
-        /* Non-blocking blink: turn off LED when timer expires */
-        if (blinkActive && millis() >= blinkOffTime) {
-            ledOff();
-            blinkActive = false;
-        }
+    while (millis() - cycleStart < CYCLE_PERIOD_MS) {
+        statsLoopMark(&nodeStats, millis());
+        schedRun(&loopSched, millis());
 
         /* Fast-cycle if more forced samples are pending */
         if (forceSampleCount > 0) {
@@ -531,10 +1108,26 @@ void loop(void)
             break;
         }
 
-        delay(1);
+        /* Autosleep: burst finished — sleep until the next deadline */
+        if (!cycle.listening) {
+            sleepMs = autoSleepMs(millis());
+            if (sleepMs > 0) break;
+        }
+
+        /* Idle: send queued debug records (tokenized builds only), then
+         * sleep until something is due */
+        dbgDrain(DBG_DRAIN_BYTES);
+        loopIdle(millis());
     }
 
-    /* Ensure clean state for next cycle */
-    if (radioListening) Radio.Sleep();
-    Radio.SetChannel(n2gFreqHz);
+    /* Ensure clean state for next cycle (a packet on the air finishes first) */
+    if (!txqBusy(&txQueue)) {
+        if (cycle.listening) Radio.Sleep();
+        Radio.SetChannel(n2gFreqHz);
+    }
+
+    if (sleepMs > 0) {
+        DBG("Autosleep: %lu ms\n", sleepMs);
+        enterDeepSleep(sleepMs);
+    }
 }
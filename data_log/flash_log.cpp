@@ -0,0 +1,119 @@
+/*
+ * flash_log.cpp — On-device sample log in spare flash
+ *
+ * Binds the log ring in flash_log.h to the ASR650x flash: rows are
+ * programmed with CySysFlashWriteRow() (erase + program of one 256-byte
+ * row) and read back through the memory-mapped flash window.
+ *
+ * The region must lie above the end of the sketch image and below the
+ * EEPROM emulation area at the top of flash (FLASH_LOG_LIMIT).  The end
+ * is checked here; `make flash-check`, run after every compile, checks
+ * the start against the linked image.  Override FLASH_LOG_BASE /
+ * FLASH_LOG_ROWS from the Makefile if the sketch grows into it.
+ */
+
+#include "Arduino.h"
+
+/* ─── Debug Output ──────────────────────────────────────────────────────── */
+
+#define DBG_FILE_ID 6   /* tokenized-log file ID (see dbg.h) */
+#include "dbg.h"
+
+#include "flash_log.h"
+
+/* ─── Flash Region ──────────────────────────────────────────────────────── */
+
+#ifndef FLASH_LOG_BASE
+#define FLASH_LOG_BASE  0x18000     /* 96 KB into the 128 KB part */
+#endif
+
+#ifndef FLASH_LOG_ROWS
+#define FLASH_LOG_ROWS  64          /* 16 KB → 960 records */
+#endif
+
+#ifndef FLASH_LOG_LIMIT
+#define FLASH_LOG_LIMIT 0x1C000     /* top 16 KB left to EEPROM emulation */
+#endif
+
+#if (FLASH_LOG_BASE % FLOG_ROW_SIZE) != 0
+#error "FLASH_LOG_BASE must be row-aligned"
+#endif
+
+#if FLASH_LOG_BASE + FLASH_LOG_ROWS * FLOG_ROW_SIZE > FLASH_LOG_LIMIT
+#error "Flash log runs into the EEPROM emulation (FLASH_LOG_LIMIT)"
+#endif
+
+/* ─── State ─────────────────────────────────────────────────────────────── */
+
+static FlashLog flog;
+
+/* Source for the open bulk transfer, if any */
+static FlogXferSrc xferSrc;
+
+/* ─── Row Callbacks ─────────────────────────────────────────────────────── */
+
+static bool flashRowWrite(uint16_t row, const FlogRow *data)
+{
+    uint32_t rowNum = (FLASH_LOG_BASE / FLOG_ROW_SIZE) + row;
+    return CySysFlashWriteRow(rowNum, (const uint8_t *)data) == CY_SYS_FLASH_SUCCESS;
+}
+
+static void flashRowRead(uint16_t row, FlogRow *data)
+{
+    const uint8_t *src = (const uint8_t *)(CY_FLASH_BASE + FLASH_LOG_BASE)
+                         + (uint32_t)row * FLOG_ROW_SIZE;
+    memcpy(data, src, FLOG_ROW_SIZE);
+}
+
+/* ─── Public API ────────────────────────────────────────────────────────── */
+
+void flashLogInit(void)
+{
+    flogInit(&flog, flashRowWrite, flashRowRead, FLASH_LOG_ROWS);
+    DBG("Flash log: %lu..%lu of %lu records\n",
+        (unsigned long)flogLo(&flog), (unsigned long)flogHi(&flog),
+        (unsigned long)flogCapacity(&flog));
+}
+
+void flashLogReadings(const Reading *readings, int count, unsigned long now)
+{
+    uint8_t ch = 0;
+    for (int i = 0; i < count; i++) {
+        /* Drivers emit their readings contiguously, in a fixed order */
+        ch = (i > 0 && readings[i].sid == readings[i - 1].sid) ? ch + 1 : 0;
+        flogAppend(&flog, now, (uint8_t)readings[i].sid, ch, readings[i].value);
+    }
+}
+
+void flashLogSetTime(uint32_t unixSec, unsigned long now)
+{
+    flogSetTime(&flog, unixSec, now);
+}
+
+void flashLogFlush(void)
+{
+    flogFlush(&flog);
+}
+
+void flashLogTick(unsigned long now)
+{
+    flogFlushStale(&flog, now, FLOG_FLUSH_MS);
+}
+
+const FlashLog *flashLogState(void)
+{
+    return &flog;
+}
+
+uint32_t flashLogXferOpen(XferSession *s, uint8_t id, uint32_t from, uint8_t window)
+{
+    if (from < flogLo(&flog)) from = flogLo(&flog);
+    if (from > flogHi(&flog)) from = flogHi(&flog);
+    xferSrc.log  = &flog;
+    xferSrc.from = from;
+
+    /* Snapshot the range now; records logged meanwhile wait for the next one */
+    uint32_t bytes = (flogHi(&flog) - from) * FLOG_REC_SIZE;
+    xferOpen(s, id, bytes, window, flogXferFill, &xferSrc);
+    return from;
+}
@@ -0,0 +1,504 @@
+/*
+ * flash_log.h — Log-structured sample ring in spare flash
+ *
+ * Every reading returned by the sensor poller is appended as a compact
+ * 16-byte record, independent of whether it is also uplinked, so the node
+ * can sample at high resolution locally and the history can be pulled
+ * back later over LoRa (logstat / logsum / logget).
+ *
+ * Layout: the log region is a ring of FLOG_ROW_SIZE flash rows.  Each row
+ * is a 16-byte header (magic, row sequence number, record count, CRC-32
+ * of the records) plus FLOG_RECS_PER_ROW records.  Rows are filled in RAM
+ * and programmed when full, always at the next slot.  A row still filling
+ * is also programmed once its oldest record is FLOG_FLUSH_MS old (and
+ * before a reboot), bounding what an unplanned reset can lose; it is then
+ * closed and the next record starts a new row at the next slot.  So every
+ * slot is programmed once per pass around the ring, and a torn write only
+ * ever hits the row being written, never records already in flash.  The
+ * price is that a flushed row's unused tail is a gap in the index.
+ *
+ * Records are addressed by an absolute index (row seq × FLOG_RECS_PER_ROW
+ * + slot) that keeps counting across wraps and reboots, so a download can
+ * resume where it left off.  On boot the region is scanned and a new row
+ * is started after the highest valid sequence number.  A row whose header
+ * or CRC doesn't check out (blank, torn write, old layout) is skipped, as
+ * are the gaps.
+ *
+ * Records in the RAM row survive deep sleep but not a reset; call
+ * flogFlush() before a deliberate reboot, and flogFlushStale() regularly
+ * for the rest.
+ *
+ * The hardware is reached through two row callbacks supplied by the
+ * sketch, so the logic is static inline with no Arduino deps and can be
+ * tested natively against a RAM-backed region.
+ */
+
+#ifndef FLASH_LOG_H
+#define FLASH_LOG_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdio.h>
+
+#include "packets.h"
+
+/* ─── Layout ───────────────────────────────────────────────────────────── */
+
+#define FLOG_ROW_SIZE       256         /* ASR650x flash row (program unit) */
+#define FLOG_REC_SIZE       16
+#define FLOG_RECS_PER_ROW   15          /* (256 − 16-byte header) / 16      */
+#define FLOG_MAGIC          0x474F4C44UL  /* "DLOG" */
+
+/* Record flags */
+#define FLOG_F_EPOCH        0x01        /* t is Unix seconds, else s since boot */
+
+/* Oldest an unprogrammed record may get before its row is flushed */
+#ifndef FLOG_FLUSH_MS
+#define FLOG_FLUSH_MS       600000UL    /* 10 min */
+#endif
+
+/* Command timestamps below this aren't wall-clock time (2017-07-14) */
+#define FLOG_EPOCH_MIN      1500000000UL
+
+typedef struct {
+    uint32_t t;         /* sample time, see FLOG_F_EPOCH                  */
+    uint8_t  sid;       /* sensor class ID (Reading.sid)                  */
+    uint8_t  ch;        /* reading index within that sensor's output      */
+    uint8_t  flags;     /* FLOG_F_*                                       */
+    uint8_t  rsvd;
+    double   v;
+} FlogRec;
+
+typedef struct {
+    uint32_t magic;     /* FLOG_MAGIC                                     */
+    uint32_t seq;       /* row sequence number, monotonic                 */
+    uint16_t nrec;      /* records used, 1..FLOG_RECS_PER_ROW             */
+    uint16_t rsvd;
+    uint32_t crc;       /* CRC-32 of rec[0 .. nrec-1]                     */
+} FlogRowHdr;
+
+typedef struct {
+    FlogRowHdr hdr;
+    FlogRec    rec[FLOG_RECS_PER_ROW];
+} FlogRow;
+
+typedef char flog_row_size_check[(sizeof(FlogRow) == FLOG_ROW_SIZE) ? 1 : -1];
+
+/* ─── Log State ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    bool     (*write)(uint16_t row, const FlogRow *data); /* program a row  */
+    void     (*read)(uint16_t row, FlogRow *data);        /* read a row     */
+    uint16_t   rows;          /* ring size in rows (≥ 2)                    */
+    FlogRow    cur;           /* head row being filled (cur.hdr.seq is set) */
+    bool       dirty;         /* cur has records not yet programmed         */
+    uint32_t   dirtySince;    /* millis() of the oldest of them             */
+    uint32_t   loSeq;         /* oldest row still in flash                  */
+    uint32_t   rowWrites;     /* rows programmed since boot                 */
+    uint32_t   writeErrors;
+    uint32_t   epochBase;     /* Unix time at millis() == 0, once synced    */
+    bool       synced;
+} FlashLog;
+
+/* Summary of one channel over a range of records */
+typedef struct {
+    uint32_t n;
+    double   min;
+    double   max;
+    double   sum;
+    uint32_t t0;              /* time of first / last matching record */
+    uint32_t t1;
+} FlogSum;
+
+/* ─── Internal ─────────────────────────────────────────────────────────── */
+
+static inline uint32_t flogRowCrc(const FlogRow *row)
+{
+    return crc32_compute((const char *)row->rec,
+                         (size_t)row->hdr.nrec * sizeof(FlogRec));
+}
+
+static inline bool flogRowValid(const FlogRow *row)
+{
+    return row->hdr.magic == FLOG_MAGIC &&
+           row->hdr.nrec >= 1 && row->hdr.nrec <= FLOG_RECS_PER_ROW &&
+           row->hdr.crc == flogRowCrc(row);
+}
+
+static inline void flogStartRow(FlashLog *l, uint32_t seq)
+{
+    memset(&l->cur, 0, sizeof(l->cur));
+    l->cur.hdr.magic = FLOG_MAGIC;
+    l->cur.hdr.seq   = seq;
+    l->dirty = false;
+
+    /* The slot this row will occupy no longer holds readable data */
+    if (seq >= l->rows && l->loSeq < seq - l->rows + 1)
+        l->loSeq = seq - l->rows + 1;
+}
+
+/* ─── Functions ────────────────────────────────────────────────────────── */
+
+/* Scan the region and position the head after the newest valid row. */
+static inline void flogInit(FlashLog *l,
+                            bool (*write)(uint16_t, const FlogRow *),
+                            void (*read)(uint16_t, FlogRow *),
+                            uint16_t rows)
+{
+    memset(l, 0, sizeof(*l));
+    l->write = write;
+    l->read  = read;
+    l->rows  = rows;
+
+    FlogRow row;
+    bool     any = false;
+    uint32_t hi = 0, lo = 0;
+    for (uint16_t i = 0; i < rows; i++) {
+        read(i, &row);
+        if (!flogRowValid(&row) || row.hdr.seq % rows != i) continue;
+        if (!any || row.hdr.seq > hi) hi = row.hdr.seq;
+        if (!any || row.hdr.seq < lo) lo = row.hdr.seq;
+        any = true;
+    }
+
+    if (!any) {
+        flogStartRow(l, 0);
+        return;
+    }
+
+    l->loSeq = lo;
+    flogStartRow(l, hi + 1);
+}
+
+/*
+ * Program the head row if it holds records, and start the next one: a
+ * slot is never programmed twice in a pass.  Returns false on a write
+ * error (the row's records are lost).
+ */
+static inline bool flogFlush(FlashLog *l)
+{
+    if (!l->dirty) return true;
+
+    l->cur.hdr.crc = flogRowCrc(&l->cur);
+    bool ok = l->write((uint16_t)(l->cur.hdr.seq % l->rows), &l->cur);
+    l->rowWrites++;
+    if (!ok) l->writeErrors++;
+    flogStartRow(l, l->cur.hdr.seq + 1);
+    return ok;
+}
+
+/*
+ * Program the head row if its oldest unwritten record is maxAgeMs old.
+ * Returns true if a row was programmed.
+ */
+static inline bool flogFlushStale(FlashLog *l, unsigned long nowMs, uint32_t maxAgeMs)
+{
+    if (!l->dirty || (uint32_t)nowMs - l->dirtySince < maxAgeMs) return false;
+    flogFlush(l);
+    return true;
+}
+
+/*
+ * Clock: seconds since boot until a Unix time is learned (e.g. from a
+ * command timestamp).  Implausible times are ignored.
+ */
+static inline void flogSetTime(FlashLog *l, uint32_t unixSec, unsigned long nowMs)
+{
+    if (unixSec < FLOG_EPOCH_MIN) return;
+    l->epochBase = unixSec - (uint32_t)(nowMs / 1000UL);
+    l->synced    = true;
+}
+
+/* Append one record.  A full head row is programmed (see flogFlush). */
+static inline void flogAppend(FlashLog *l, unsigned long nowMs,
+                              uint8_t sid, uint8_t ch, double v)
+{
+    FlogRec *r = &l->cur.rec[l->cur.hdr.nrec++];
+    r->t     = (uint32_t)(nowMs / 1000UL) + (l->synced ? l->epochBase : 0);
+    r->sid   = sid;
+    r->ch    = ch;
+    r->flags = l->synced ? FLOG_F_EPOCH : 0;
+    r->rsvd  = 0;
+    r->v     = v;
+    if (!l->dirty) l->dirtySince = (uint32_t)nowMs;
+    l->dirty = true;
+
+    if (l->cur.hdr.nrec == FLOG_RECS_PER_ROW) flogFlush(l);
+}
+
+/* First and one-past-last absolute record index currently held. */
+static inline uint32_t flogLo(const FlashLog *l)
+{
+    return l->loSeq * FLOG_RECS_PER_ROW;
+}
+
+static inline uint32_t flogHi(const FlashLog *l)
+{
+    return l->cur.hdr.seq * FLOG_RECS_PER_ROW + l->cur.hdr.nrec;
+}
+
+static inline uint32_t flogCapacity(const FlashLog *l)
+{
+    return (uint32_t)l->rows * FLOG_RECS_PER_ROW;
+}
+
+/*
+ * Visit records from absolute index `from` (clamped to the oldest) to the
+ * head, one flash row read per row.  The callback returns false to stop.
+ * Gaps and rows lost to corruption are skipped.  Returns the next
+ * unvisited index.
+ */
+static inline uint32_t flogForEach(const FlashLog *l, uint32_t from,
+                                   bool (*cb)(uint32_t idx, const FlogRec *r, void *ctx),
+                                   void *ctx)
+{
+    if (from < flogLo(l)) from = flogLo(l);
+
+    uint32_t hi = flogHi(l);
+    FlogRow row;
+    while (from < hi) {
+        uint32_t seq = from / FLOG_RECS_PER_ROW;
+        const FlogRow *src = &l->cur;
+        if (seq != l->cur.hdr.seq) {
+            l->read((uint16_t)(seq % l->rows), &row);
+            if (!flogRowValid(&row) || row.hdr.seq != seq) {
+                from = (seq + 1) * FLOG_RECS_PER_ROW;
+                continue;
+            }
+            src = &row;
+        }
+        for (uint32_t i = from % FLOG_RECS_PER_ROW; i < src->hdr.nrec; i++, from++) {
+            if (!cb(from, &src->rec[i], ctx)) return from;
+        }
+        from = (seq + 1) * FLOG_RECS_PER_ROW;
+    }
+    return hi;
+}
+
+/* Copy record idx.  Returns false if it is no longer held, was lost, or
+ * falls in a gap. */
+static inline bool flogGetRec(const FlashLog *l, uint32_t idx, FlogRec *out)
+{
+    if (idx < flogLo(l) || idx >= flogHi(l)) return false;
+
+    uint32_t seq = idx / FLOG_RECS_PER_ROW;
+    uint32_t i   = idx % FLOG_RECS_PER_ROW;
+    if (seq == l->cur.hdr.seq) {
+        *out = l->cur.rec[i];
+        return true;
+    }
+    FlogRow row;
+    l->read((uint16_t)(seq % l->rows), &row);
+    if (!flogRowValid(&row) || row.hdr.seq != seq || i >= row.hdr.nrec) return false;
+    *out = row.rec[i];
+    return true;
+}
+
+/*
+ * XferFill source over the raw records from index `from` (ctx points to
+ * a FlogXferSrc).  Records are copied as stored (16 bytes, little-endian,
+ * IEEE double); a gap, or a record lost since the transfer opened, reads
+ * as zeros.
+ */
+typedef struct {
+    const FlashLog *log;
+    uint32_t        from;
+} FlogXferSrc;
+
+static inline int flogXferFill(uint32_t offset, uint8_t *buf, int len, void *ctx)
+{
+    const FlogXferSrc *src = (const FlogXferSrc *)ctx;
+    int done = 0;
+    while (done < len) {
+        uint32_t pos = offset + (uint32_t)done;
+        FlogRec r;
+        if (!flogGetRec(src->log, src->from + pos / FLOG_REC_SIZE, &r))
+            memset(&r, 0, sizeof(r));
+        uint32_t in = pos % FLOG_REC_SIZE;
+        int n = (int)(FLOG_REC_SIZE - in);
+        if (n > len - done) n = len - done;
+        memcpy(buf + done, (const uint8_t *)&r + in, (size_t)n);
+        done += n;
+    }
+    return done;
+}
+
+/* ─── Summary ──────────────────────────────────────────────────────────── */
+
+typedef struct {
+    FlogSum *s;
+    uint8_t  sid;
+    uint8_t  ch;
+} FlogSumCtx;
+
+static inline bool flogSumVisit(uint32_t idx, const FlogRec *r, void *ctx)
+{
+    (void)idx;
+    FlogSumCtx *c = (FlogSumCtx *)ctx;
+    if (r->sid != c->sid || r->ch != c->ch) return true;
+
+    FlogSum *s = c->s;
+    if (s->n == 0) {
+        s->min = s->max = r->v;
+        s->t0 = r->t;
+    }
+    if (r->v < s->min) s->min = r->v;
+    if (r->v > s->max) s->max = r->v;
+    s->sum += r->v;
+    s->t1 = r->t;
+    s->n++;
+    return true;
+}
+
+/* min / max / sum / count of one sensor channel from absolute index `from`. */
+static inline void flogSummary(const FlashLog *l, uint8_t sid, uint8_t ch,
+                               uint32_t from, FlogSum *out)
+{
+    memset(out, 0, sizeof(*out));
+    FlogSumCtx c = { out, sid, ch };
+    flogForEach(l, from, flogSumVisit, &c);
+}
+
+/* ─── JSON Responses (sorted keys) ─────────────────────────────────────── */
+
+/*
+ *   {"cap":1440,"hi":312,"lo":0,"t0":1760000000,"t1":1760003000,"wr":20}
+ * t0/t1 are the times of the oldest and newest record (0 when empty).
+ */
+typedef struct { uint32_t t; bool seen; } FlogTimeCtx;
+
+static inline bool flogFirstVisit(uint32_t idx, const FlogRec *r, void *ctx)
+{
+    (void)idx;
+    FlogTimeCtx *c = (FlogTimeCtx *)ctx;
+    c->t = r->t;
+    c->seen = true;
+    return false;
+}
+
+static inline bool flogLastVisit(uint32_t idx, const FlogRec *r, void *ctx)
+{
+    flogFirstVisit(idx, r, ctx);
+    return true;
+}
+
+static inline int flogFmtStat(const FlashLog *l, char *buf, int bufSize)
+{
+    uint32_t t0 = 0, t1 = 0;
+    if (flogHi(l) > flogLo(l)) {
+        FlogTimeCtx c = { 0, false };
+        flogForEach(l, flogLo(l), flogFirstVisit, &c);
+        t0 = c.t;
+        /* Newest record: in the head row, or the row flushed before it */
+        c.seen = false;
+        uint32_t lastSeq = l->cur.hdr.seq - (l->cur.hdr.nrec ? 0 : 1);
+        flogForEach(l, lastSeq * FLOG_RECS_PER_ROW, flogLastVisit, &c);
+        t1 = c.seen ? c.t : 0;
+    }
+    int n = snprintf(buf, (size_t)bufSize,
+                     "{\"cap\":%lu,\"hi\":%lu,\"lo\":%lu,\"t0\":%lu,\"t1\":%lu,\"wr\":%lu}",
+                     (unsigned long)flogCapacity(l), (unsigned long)flogHi(l),
+                     (unsigned long)flogLo(l), (unsigned long)t0,
+                     (unsigned long)t1, (unsigned long)l->rowWrites);
+    return (n > 0 && n < bufSize) ? n : 0;
+}
+
+/*
+ *   {"avg":21.5,"max":23.1,"min":20.2,"n":240,"t0":...,"t1":...}
+ */
+static inline int flogFmtSum(const FlashLog *l, uint8_t sid, uint8_t ch,
+                             uint32_t from, char *buf, int bufSize)
+{
+    FlogSum s;
+    flogSummary(l, sid, ch, from, &s);
+
+    char avg[24], mn[24], mx[24];
+    fmtVal(avg, sizeof(avg), s.n ? s.sum / s.n : 0.0);
+    fmtVal(mn,  sizeof(mn),  s.min);
+    fmtVal(mx,  sizeof(mx),  s.max);
+    int n = snprintf(buf, (size_t)bufSize,
+                     "{\"avg\":%s,\"max\":%s,\"min\":%s,\"n\":%lu,\"t0\":%lu,\"t1\":%lu}",
+                     avg, mx, mn, (unsigned long)s.n,
+                     (unsigned long)s.t0, (unsigned long)s.t1);
+    return (n > 0 && n < bufSize) ? n : 0;
+}
+
+/*
+ * Records from `from` as [t,sid,ch,v] tuples, greedy-packed:
+ *   {"i":300,"m":1,"r":[[1760003000,0,0,21.5],[1760003000,0,1,1013.2]]}
+ * "i" is the first index returned (≥ the oldest held), "m":1 if more
+ * remain after the last one — fetch again from i + len(r).  A page stops
+ * at a gap so that stays true.
+ */
+typedef struct {
+    char    *buf;
+    int      cap;
+    int      pos;
+    uint32_t first;
+    uint32_t count;
+} FlogGetCtx;
+
+static inline bool flogGetVisit(uint32_t idx, const FlogRec *r, void *ctx)
+{
+    FlogGetCtx *c = (FlogGetCtx *)ctx;
+    if (c->count && idx != c->first + c->count) return false;  /* gap */
+    char v[24], item[64];
+    fmtVal(v, sizeof(v), r->v);
+    int len = snprintf(item, sizeof(item), "%s[%lu,%u,%u,%s]",
+                       c->count ? "," : "", (unsigned long)r->t,
+                       (unsigned)r->sid, (unsigned)r->ch, v);
+    if (c->pos + len + 2 >= c->cap) return false;   /* room for ]} + null */
+    memcpy(c->buf + c->pos, item, (size_t)len);
+    c->pos += len;
+    if (c->count == 0) c->first = idx;
+    c->count++;
+    return true;
+}
+
+static inline int flogFmtGet(const FlashLog *l, uint32_t from, char *buf, int bufSize)
+{
+    char body[LORA_MAX_PAYLOAD];
+    if (from < flogLo(l)) from = flogLo(l);
+
+    /* Reserve the prefix: {"i":4294967295,"m":1,"r":[ = 27 */
+    int bodyCap = bufSize - 27;
+    if (bodyCap > (int)sizeof(body)) bodyCap = (int)sizeof(body);
+    if (bodyCap <= 2) return 0;
+
+    FlogGetCtx c = { body, bodyCap, 0, from, 0 };
+    uint32_t next = flogForEach(l, from, flogGetVisit, &c);
+    body[c.pos] = '\0';
+
+    int n = snprintf(buf, (size_t)bufSize, "{\"i\":%lu,\"m\":%d,\"r\":[%s]}",
+                     (unsigned long)c.first, next < flogHi(l) ? 1 : 0, body);
+    return (n > 0 && n < bufSize) ? n : 0;
+}
+
+/* ─── Sketch Interface (flash_log.cpp) ─────────────────────────────────── */
+
+/* Scan the flash region and resume the log.  Call once from setup(). */
+void flashLogInit(void);
+
+/* Append readings; ch is each reading's index within its sensor's group. */
+void flashLogReadings(const Reading *readings, int count, unsigned long now);
+
+/* Learn wall-clock time (Unix seconds) for subsequent records. */
+void flashLogSetTime(uint32_t unixSec, unsigned long now);
+
+/* Program the partially-filled head row (before a reboot). */
+void flashLogFlush(void);
+
+/* Program the head row once it holds a record FLOG_FLUSH_MS old.  Call
+ * from the tick loop. */
+void flashLogTick(unsigned long now);
+
+const FlashLog *flashLogState(void);
+
+/*
+ * Open a bulk transfer of the records from `from` up to the current head.
+ * Returns the first record index actually covered (clamped to the oldest).
+ */
+uint32_t flashLogXferOpen(XferSession *s, uint8_t id, uint32_t from, uint8_t window);
+
+#endif /* FLASH_LOG_H */
@@ -0,0 +1,197 @@
+/*
+ * gps_motion.h — Motion-aware GPS reporting (fixed-point, no libm)
+ *
+ * Decides, per GPS sample, whether the position is worth a packet and how
+ * long to wait before the next sample:
+ *
+ *   - Displacement from the last *reported* fix is computed with an
+ *     equirectangular approximation in 1e-7 degree integers (cos(lat)
+ *     from a 5° Q15 table, linearly interpolated).  Under gps_min_dist
+ *     the report is suppressed.
+ *   - Speed between consecutive *samples* above gps_fast_kmh switches the
+ *     interval to gps_fast_rate.
+ *   - Each consecutive stationary sample doubles the interval, up to
+ *     8 × gps_rate, so a parked asset powers the GPS a fraction as often.
+ *     Any movement snaps back to gps_rate.
+ *   - A stationary position is still reported every
+ *     GPS_MOTION_KEEPALIVE_MS so the gateway knows the node is alive.
+ *
+ * Equirectangular error is well under 1% at the distances involved
+ * (metres to a few km).  Static inline with no Arduino deps so it can be
+ * tested natively.
+ */
+
+#ifndef GPS_MOTION_H
+#define GPS_MOTION_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ─── Tuning ───────────────────────────────────────────────────────────── */
+
+#define GPS_MOTION_STILL_MAX_SHIFT  3       /* back off to 2^3 × gps_rate */
+#define GPS_MOTION_KEEPALIVE_MS     (6UL * 60UL * 60UL * 1000UL)
+
+/* 1e-7 degree of latitude (or of longitude at the equator) in cm × 1e4 */
+#define GPS_MOTION_CM_PER_E7_X1E4   11132
+
+/* ─── State ────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    bool          haveRef;      /* a position has been reported         */
+    int32_t       refLat;       /* last reported fix, 1e-7 deg          */
+    int32_t       refLon;
+    unsigned long refTime;
+    bool          havePrev;     /* previous sample, for speed           */
+    int32_t       prevLat;
+    int32_t       prevLon;
+    unsigned long prevTime;
+    uint32_t      speedCms;     /* last sample-to-sample speed, cm/s    */
+    uint32_t      distCm;       /* last displacement from the reference */
+    uint8_t       stillCount;   /* consecutive stationary samples       */
+    bool          fast;         /* speed above the fast threshold       */
+} GpsMotion;
+
+/* ─── Fixed-Point Geometry ─────────────────────────────────────────────── */
+
+/* cos(lat) in Q15 (32768 = 1.0) */
+static inline uint16_t gpsMotionCosQ15(int32_t lat_e7)
+{
+    static const uint16_t tbl[19] = {
+        32768, 32643, 32270, 31651, 30792, 29698, 28378, 26842, 25102, 23170,
+        21063, 18795, 16384, 13848, 11207,  8481,  5690,  2856,     0
+    };
+    uint32_t a = (lat_e7 < 0) ? (uint32_t)(-(int64_t)lat_e7) : (uint32_t)lat_e7;
+    if (a >= 900000000UL) return 0;
+
+    uint32_t idx = a / 50000000UL;                  /* 5° steps */
+    uint32_t rem = (a % 50000000UL) / 1000UL;       /* 0..49999 */
+    uint32_t drop = (uint32_t)(tbl[idx] - tbl[idx + 1]) * rem / 50000UL;
+    return (uint16_t)(tbl[idx] - drop);
+}
+
+static inline uint32_t gpsMotionIsqrt(uint64_t v)
+{
+    uint64_t res = 0;
+    uint64_t bit = (uint64_t)1 << 62;
+    while (bit > v) bit >>= 2;
+    while (bit) {
+        if (v >= res + bit) {
+            v  -= res + bit;
+            res = (res >> 1) + bit;
+        } else {
+            res >>= 1;
+        }
+        bit >>= 2;
+    }
+    return (uint32_t)res;
+}
+
+/* Ground distance between two fixes, centimetres */
+static inline uint32_t gpsMotionDistCm(int32_t lat1, int32_t lon1,
+                                       int32_t lat2, int32_t lon2)
+{
+    int64_t dLat = (int64_t)lat2 - lat1;
+    int64_t dLon = (int64_t)lon2 - lon1;
+    if (dLon >  1800000000LL) dLon -= 3600000000LL;   /* across the antimeridian */
+    if (dLon < -1800000000LL) dLon += 3600000000LL;
+
+    int32_t midLat = (int32_t)(((int64_t)lat1 + lat2) / 2);
+    int64_t y = dLat * GPS_MOTION_CM_PER_E7_X1E4 / 10000;
+    int64_t x = dLon * GPS_MOTION_CM_PER_E7_X1E4 / 10000
+                * gpsMotionCosQ15(midLat) / 32768;
+
+    /* Clamp so the squares fit: ~1000 km is "far" for every caller */
+    const int64_t lim = 100000000LL;
+    if (y >  lim) y =  lim;
+    if (y < -lim) y = -lim;
+    if (x >  lim) x =  lim;
+    if (x < -lim) x = -lim;
+    return gpsMotionIsqrt((uint64_t)(x * x + y * y));
+}
+
+/* ─── Functions ────────────────────────────────────────────────────────── */
+
+static inline void gpsMotionInit(GpsMotion *m)
+{
+    m->haveRef    = false;
+    m->refLat     = 0;
+    m->refLon     = 0;
+    m->refTime    = 0;
+    m->havePrev   = false;
+    m->prevLat    = 0;
+    m->prevLon    = 0;
+    m->prevTime   = 0;
+    m->speedCms   = 0;
+    m->distCm     = 0;
+    m->stillCount = 0;
+    m->fast       = false;
+}
+
+/*
+ * Feed a fresh fix taken at `now`.  Returns true if it should be
+ * reported (first fix, moved at least minDistM, or keep-alive due).
+ * minDistM = 0 reports every fix; fastKmh = 0 disables fast mode.
+ */
+static inline bool gpsMotionUpdate(GpsMotion *m, int32_t lat, int32_t lon,
+                                   unsigned long now, uint16_t minDistM,
+                                   uint16_t fastKmh)
+{
+    /* Speed since the previous sample */
+    if (m->havePrev && now != m->prevTime) {
+        uint64_t d = gpsMotionDistCm(m->prevLat, m->prevLon, lat, lon);
+        m->speedCms = (uint32_t)(d * 1000ULL / (now - m->prevTime));
+    }
+    m->havePrev = true;
+    m->prevLat  = lat;
+    m->prevLon  = lon;
+    m->prevTime = now;
+
+    /* km/h → cm/s: × 100000 / 3600 */
+    m->fast = fastKmh > 0 && m->speedCms >= (uint32_t)fastKmh * 250UL / 9UL;
+
+    if (!m->haveRef) {
+        m->distCm = 0;
+        m->haveRef = true;
+        m->refLat = lat;
+        m->refLon = lon;
+        m->refTime = now;
+        m->stillCount = 0;
+        return true;
+    }
+
+    m->distCm = gpsMotionDistCm(m->refLat, m->refLon, lat, lon);
+    bool moved = m->distCm >= (uint32_t)minDistM * 100UL;
+
+    if (moved || m->fast) {
+        m->stillCount = 0;
+    } else if (m->stillCount < 255) {
+        m->stillCount++;
+    }
+
+    if (moved || now - m->refTime >= GPS_MOTION_KEEPALIVE_MS) {
+        m->refLat  = lat;
+        m->refLon  = lon;
+        m->refTime = now;
+        return true;
+    }
+    return false;
+}
+
+/*
+ * Sample interval to use next: fastSec while moving fast, otherwise
+ * baseSec doubled per stationary sample (capped), clamped to 32767.
+ */
+static inline uint16_t gpsMotionIntervalSec(const GpsMotion *m,
+                                            uint16_t baseSec, uint16_t fastSec)
+{
+    if (m->fast && fastSec > 0 && fastSec < baseSec)
+        return fastSec;
+
+    uint8_t shift = m->stillCount;
+    if (shift > GPS_MOTION_STILL_MAX_SHIFT) shift = GPS_MOTION_STILL_MAX_SHIFT;
+    uint32_t sec = (uint32_t)baseSec << shift;
+    return (uint16_t)(sec > 32767 ? 32767 : sec);
+}
+
+#endif /* GPS_MOTION_H */
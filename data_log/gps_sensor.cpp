@@ -7,17 +7,34 @@
  *
  * Unlike instant-read sensors (BME280, battery), GPS requires continuous UART
  * feeding.  gpsFeed() must be called from the main loop every cycle; the
- * driver's read() returns cached data from the last valid fix.
+ * driver's read() returns the last fix held by the shared GPS service
+ * (gps_service.h / nmea.h, also used by range_test).
  *
  * Produces 4 readings per sample: alt, lat, lng, sats (sensor class ID 4).
  * Returns 0 readings if no valid GPS fix has been acquired.
+ *
+ * The module sits on the switched Vext rail, powered only around samples.
+ * Parser state and last-fix time survive in RAM while it is off; resume()
+ * only re-opens the UART and restarts the silence timer, and warmup_ms()
+ * picks a hot or cold start lead from the age of the last fix.
+ *
+ * Motion gating (gps_motion.h): a fix within gps_min_dist of the last
+ * reported one is sampled but not sent, and each stationary sample
+ * doubles the interval (up to 8 × gps_rate) — with Vext gating that is
+ * what powers the GPS down for a parked asset.  Above gps_fast_kmh the
+ * interval drops to gps_fast_rate.  The scheduler reads the effective
+ * interval from gpsEffRateSec.
+ *
+ * With GPS_UBX=1 the module speaks UBX binary in power save mode and is
+ * put into backup after each sample (see gps_service.h / ubx.h).
  */
 
 #ifdef SENSOR_GPS
 
 #include "Arduino.h"
-#include <TinyGPS++.h>
+#include "gps_service.h"
 #include "gps_sensor.h"
+#include "gps_motion.h"
 
 /* ─── Sensor Config ─────────────────────────────────────────────────────── */
 
@@ -27,60 +44,102 @@
  */
 #define SENSOR_ID_GPS 4
 
-#define GPS_BAUD 9600
+/* Don't report a fix older than this (e.g. the pre-sleep fix after a wake) */
+#define GPS_FIX_MAX_AGE_MS  5000
+
+/*
+ * Power-up → first usable fix (NEO-6M TTFF: hot ~1 s, warm/cold ~27 s).
+ * A hot start needs the backed-up ephemeris, valid for a couple of hours
+ * after the last fix.
+ */
+#define GPS_HOT_START_MAX_AGE_MS  (2UL * 60UL * 60UL * 1000UL)
+#define GPS_WARMUP_HOT_MS         2000
+#define GPS_WARMUP_COLD_MS        30000
 
-/* If no UART chars arrive for this long, consider GPS disconnected */
-#define GPS_UART_TIMEOUT_MS 2000
+/*
+ * UBX mode: backup sleep ends this long plus a hot start before the next
+ * sample is due (covers sensor_slack pulling the sample early).  Shorter
+ * gaps aren't worth the restart.
+ */
+#define GPS_UBX_WAKE_MARGIN_MS    5000
+#define GPS_UBX_MIN_SLEEP_MS      10000
 
 /* ─── State ─────────────────────────────────────────────────────────────── */
 
-static TinyGPSPlus gps;
+static GpsService gps;
+static GpsMotion  motion;
 
-/* Cached GPS values (last valid fix) */
-static double   cachedLat  = 0.0;
-static double   cachedLon  = 0.0;
-static double   cachedAlt  = 0.0;
-static uint32_t cachedSats = 0;
-static unsigned long lastValidGpsTime = 0;
+/* Interval the scheduler uses: gps_rate adjusted for motion */
+static uint16_t gpsEffRateSec;
 
-/* UART activity tracking */
-static unsigned long lastGpsChars    = 0;
-static unsigned long lastGpsCharTime = 0;
+extern uint16_t gpsRateSec;
+extern uint16_t gpsMinDistM;
+extern uint16_t gpsFastKmh;
+extern uint16_t gpsFastRateSec;
 
 /* ─── SensorDriver Interface ───────────────────────────────────────────── */
 
 static int gps_init(void)
 {
-    Serial.begin(GPS_BAUD);
+    gpsServiceBegin(&gps);
+    gpsMotionInit(&motion);
+    gpsEffRateSec = gpsRateSec;
     return 1;  /* UART always available — cannot probe GPS module directly */
 }
 
 static int gps_is_alive(void)
 {
     /* If we've never seen any chars, assume still initializing (cold start) */
-    if (lastGpsCharTime == 0)
+    if (gps.lastCharTime == 0)
         return 1;
 
     /* UART went silent — GPS module may be disconnected */
-    if ((millis() - lastGpsCharTime) >= GPS_UART_TIMEOUT_MS)
-        return 0;
+    return gpsServiceUartActive(&gps) ? 1 : 0;
+}
 
+static int gps_resume(void)
+{
+    /* Module was unpowered — fresh UART timeout window rather than
+     * declaring it dead because nothing arrived during sleep. */
+    gpsServiceResume(&gps);
     return 1;
 }
 
+static unsigned long gps_warmup_ms(void)
+{
+    return (gpsFixAgeMs() < GPS_HOT_START_MAX_AGE_MS)
+        ? GPS_WARMUP_HOT_MS : GPS_WARMUP_COLD_MS;
+}
+
 static int gps_read(Reading *out, int max)
 {
     if (max < 4) return 0;
 
-    /* Only report readings when we have a valid fix */
-    if (!gps.location.isValid())
-        return 0;
-
-    out[0] = { "alt",  SENSOR_ID_GPS, "m",   cachedAlt              };
-    out[1] = { "lat",  SENSOR_ID_GPS, "deg", cachedLat              };
-    out[2] = { "lng",  SENSOR_ID_GPS, "deg", cachedLon              };
-    out[3] = { "sats", SENSOR_ID_GPS, "",    (double)cachedSats     };
+    /* No valid, current fix yet — stay due and retry next poll */
+    if (!gpsServiceHasFix(&gps) || gpsServiceFixAgeMs(&gps) > GPS_FIX_MAX_AGE_MS) {
+        gpsEffRateSec = gpsMotionIntervalSec(&motion, gpsRateSec, gpsFastRateSec);
+        return SENSOR_READ_WAIT;
+    }
 
+    bool report = gpsMotionUpdate(&motion, gps.parser.fix.lat_e7,
+                                  gps.parser.fix.lon_e7, millis(),
+                                  gpsMinDistM, gpsFastKmh);
+    gpsEffRateSec = gpsMotionIntervalSec(&motion, gpsRateSec, gpsFastRateSec);
+
+#if GPS_UBX
+    /* Sample taken — park the module in backup until shortly before the
+     * next one (no-op in effect if the Vext rail drops anyway) */
+    unsigned long sleepMs = (unsigned long)gpsEffRateSec * 1000UL;
+    if (sleepMs > GPS_WARMUP_HOT_MS + GPS_UBX_WAKE_MARGIN_MS + GPS_UBX_MIN_SLEEP_MS)
+        gpsServiceSleep(&gps, sleepMs - GPS_WARMUP_HOT_MS - GPS_UBX_WAKE_MARGIN_MS);
+#endif
+
+    if (!report) return SENSOR_READ_NONE;   /* hasn't moved */
+
+    out[0] = { "alt",  SENSOR_ID_GPS, "m",   gpsServiceAltM(&gps)         };
+    out[1] = { "lat",  SENSOR_ID_GPS, "deg", gpsServiceLat(&gps)          };
+    out[2] = { "lng",  SENSOR_ID_GPS, "deg", gpsServiceLon(&gps)          };
+    out[3] = { "sats", SENSOR_ID_GPS, "",    (double)gpsServiceSats(&gps) };
     return 4;
 }
 
@@ -88,37 +147,35 @@ static int gps_read(Reading *out, int max)
 
 void gpsFeed(void)
 {
-    /* Drain serial buffer into TinyGPS++ parser */
-    while (Serial.available() > 0)
-        gps.encode(Serial.read());
-
-    /* Track UART activity */
-    unsigned long currentChars = gps.charsProcessed();
-    if (currentChars > lastGpsChars) {
-        lastGpsChars    = currentChars;
-        lastGpsCharTime = millis();
-    }
+    gpsServiceFeed(&gps);
+}
 
-    /* Cache valid GPS data */
-    if (gps.location.isValid()) {
-        cachedLat = gps.location.lat();
-        cachedLon = gps.location.lng();
-        lastValidGpsTime = millis();
-    }
-    if (gps.altitude.isValid()) {
-        cachedAlt = gps.altitude.meters();
-    }
-    if (gps.satellites.isValid()) {
-        cachedSats = gps.satellites.value();
-    }
+unsigned long gpsFixAgeMs(void)
+{
+    return gpsServiceFixAgeMs(&gps);    /* 0xFFFFFFFF == GPS_FIX_AGE_NONE */
 }
 
-/* ─── Driver Instance ──────────────────────────────────────────────────── */
+void gpsSuspend(void)
+{
+    gpsServiceSuspend(&gps);
+}
 
-extern uint16_t gpsRateSec;
+void gpsGetStats(GpsStats *st)
+{
+    st->chars     = gps.parser.chars;
+    st->passed    = gps.parser.passed;
+    st->failed    = gps.parser.failed;
+    st->overflows = gps.ring.overflows;
+    st->ringHigh  = gps.ring.highWater;
+    st->ringSize  = ringCapacity(&gps.ring);
+}
+
+/* ─── Driver Instance ──────────────────────────────────────────────────── */
 
 const SensorDriver gpsDriver = {
-    "gps", gps_init, gps_is_alive, gps_read, &gpsRateSec
+    "gps", gps_init, gps_is_alive, gps_read, &gpsEffRateSec,
+    NULL, NULL, NULL, gps_resume,
+    true, gps_warmup_ms
 };
 
 #endif /* SENSOR_GPS */
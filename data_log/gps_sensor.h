@@ -10,11 +10,39 @@
 extern const SensorDriver gpsDriver;
 
 /*
- * Feed GPS UART data into TinyGPS++ parser.
- * Call from main loop every cycle — GPS requires continuous NMEA feeding
- * to maintain a fix, unlike instant I2C/ADC reads.
+ * Feed buffered GPS UART data into the parser.
+ * Call from main loop every cycle and from long busy-waits — GPS requires
+ * continuous feeding to maintain a fix, unlike instant I2C/ADC reads.  A
+ * timer interrupt buffers bytes in between, so gaps of a few seconds are
+ * harmless.
  */
 void gpsFeed(void);
+
+/*
+ * Milliseconds since the last valid fix, or GPS_FIX_AGE_NONE if there has
+ * never been one.  Survives deep sleep — a recent fix means the module's
+ * backed-up ephemeris is still usable and it should hot start.
+ */
+#define GPS_FIX_AGE_NONE 0xFFFFFFFFUL
+unsigned long gpsFixAgeMs(void);
+
+/*
+ * Stop the UART poll timer when the Vext rail goes down (it would wake
+ * the MCU every few ms).  The sensor power manager's resume() restarts
+ * it on power-up.
+ */
+void gpsSuspend(void);
+
+/* Parser and UART ring counters, for the gpsstat command */
+typedef struct {
+    uint32_t chars;         /* bytes parsed                          */
+    uint32_t passed;        /* sentences / frames with good checksum */
+    uint32_t failed;        /* checksum failures                     */
+    uint32_t overflows;     /* bytes dropped, ring full              */
+    uint16_t ringHigh;      /* ring high-water mark (bytes)          */
+    uint16_t ringSize;      /* ring capacity (bytes)                 */
+} GpsStats;
+void gpsGetStats(GpsStats *st);
 #endif
 
 #endif /* GPS_SENSOR_H */
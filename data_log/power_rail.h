@@ -0,0 +1,98 @@
+/*
+ * power_rail.h — Switched peripheral power rail (Vext) bookkeeping
+ *
+ * The HTCC-AB01 powers its external peripherals (BME280, NEO-6M GPS,
+ * NeoPixel) from the Vext rail.  A PowerRail tracks whether the rail is
+ * on, who is holding it up, and how long it has been powered, and drives
+ * the hardware through two callbacks supplied by the sketch:
+ *
+ *   set(on)   — switch the rail (and tear down / restore bus pins)
+ *   powered() — rail just came up: restart I2C/UART, clear the NeoPixel
+ *
+ * Sensor demand is computed by the slot scheduler in sensor_drv.h; this
+ * header only owns the switch.  Non-sensor users (LED blink, "always on"
+ * builds) take a hold bit so the rail stays up while they need it.
+ *
+ * Static inline with no Arduino deps so it can be exercised natively.
+ */
+
+#ifndef POWER_RAIL_H
+#define POWER_RAIL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ─── Hold Bits ────────────────────────────────────────────────────────── */
+
+#define POWER_HOLD_LED     0x01  /* NeoPixel is lit (blink, testled)       */
+#define POWER_HOLD_ALWAYS  0x80  /* gating disabled at build time          */
+
+/* ─── Rail State ───────────────────────────────────────────────────────── */
+
+typedef struct {
+    void        (*set)(bool on);    /* drive the rail switch               */
+    void        (*powered)(void);   /* post power-up bus/device restore    */
+    bool          on;
+    bool          demand;           /* sensors wanted it on at last update */
+    uint8_t       holds;            /* POWER_HOLD_* bits                   */
+    unsigned long on_since;         /* millis() of the last power-up       */
+    unsigned long on_ms;            /* accumulated on-time, completed runs */
+    uint32_t      on_count;         /* power-ups since boot                */
+} PowerRail;
+
+/* ─── Functions ────────────────────────────────────────────────────────── */
+
+/*
+ * Initialise rail bookkeeping.  `on` reflects the hardware state at the
+ * time of the call (setup() powers Vext early so the NeoPixel can be
+ * cleared); no callback is invoked.
+ */
+static inline void powerRailInit(PowerRail *r, void (*set)(bool),
+                                 void (*powered)(void), bool on,
+                                 unsigned long now)
+{
+    r->set      = set;
+    r->powered  = powered;
+    r->on       = on;
+    r->demand   = false;
+    r->holds    = 0;
+    r->on_since = now;
+    r->on_ms    = 0;
+    r->on_count = on ? 1 : 0;
+}
+
+/*
+ * Switch the rail if `want` differs from its current state.  Returns
+ * true if the rail changed state (callers then update their consumers).
+ */
+static inline bool powerRailSwitch(PowerRail *r, bool want, unsigned long now)
+{
+    if (want == r->on) return false;
+
+    if (want) {
+        if (r->set) r->set(true);
+        if (r->powered) r->powered();
+        r->on_since = now;
+        r->on_count++;
+    } else {
+        if (r->set) r->set(false);
+        r->on_ms += now - r->on_since;
+    }
+    r->on = want;
+    return true;
+}
+
+/* Set or clear a hold bit.  Takes effect at the next demand update. */
+static inline void powerRailHold(PowerRail *r, uint8_t bit, bool hold)
+{
+    if (hold) r->holds |= bit;
+    else      r->holds &= (uint8_t)~bit;
+}
+
+/* Total time the rail has been on, including the current run. */
+static inline unsigned long powerRailOnMs(const PowerRail *r, unsigned long now)
+{
+    return r->on_ms + (r->on ? now - r->on_since : 0);
+}
+
+#endif /* POWER_RAIL_H */
@@ -1,92 +1,131 @@
 /*
  * sensor_drv.cpp — Sensor driver registry and polling logic
  *
- * Manages an array of registered SensorDriver slots.  Each slot tracks
- * the driver's alive state and last-TX timestamp independently, enabling
- * per-sensor sample intervals.
+ * Manages one slot per SensorDriver in the build's SENSOR_LIST
+ * (sensor_list.h), in a table fixed at compile time.  Each slot tracks
+ * the driver's alive state, next-due deadline and in-flight conversion
+ * independently, enabling per-sensor sample intervals.  The scheduling
+ * logic lives in sensor_drv.h (static inline) so it can be unit-tested.
+ *
+ * Also owns the switched Vext rail: it is powered only while some sensor
+ * on it is warming up, sampling or converting (or a hold is taken).
  */
 
 #include "Arduino.h"
-#include "sensor_drv.h"
 
 /* ─── Debug Output ──────────────────────────────────────────────────────── */
 
+#define DBG_FILE_ID 3   /* tokenized-log file ID (see dbg.h) */
 #include "dbg.h"
 
+/* Route sensor_drv.h's slot-logic debug output through DBG */
+#define SDBG DBG
+
+#include "sensor_drv.h"
+#include "bme280_sensor.h"
+#include "batt_sensor.h"
+#include "gps_sensor.h"
+
 /* ─── Registry State ────────────────────────────────────────────────────── */
 
-static struct {
-    SensorDriver  drv;
-    unsigned long last_tx_time;
-    bool          alive;
-} slots[SENSOR_MAX_DRIVERS];
+/* Driver table in flash, expanded from SENSOR_LIST */
+#define SENSOR_TABLE_ENTRY(name, drv, nr, rate)  &drv,
+static const SensorDriver *const sensorTable[SENSOR_MAX_DRIVERS] = {
+    SENSOR_LIST(SENSOR_TABLE_ENTRY)
+};
+
+static SensorSlot slots[SENSOR_MAX_DRIVERS];
 
-static int slotCount = 0;
+static const int slotCount = SENSOR_LIST_COUNT;
+
+static PowerRail rail;
 
 /* ─── Public API ────────────────────────────────────────────────────────── */
 
-void sensorRegister(const SensorDriver *drv)
+void sensorInitAll(void)
 {
-    if (slotCount >= SENSOR_MAX_DRIVERS) {
-        DBG("ERROR: sensor registry full, cannot add '%s'\n", drv->name);
-        return;
+    for (int i = 0; i < slotCount; i++) {
+        sensorSlotInit(&slots[i], sensorTable[i]);
+        slots[i].alive = (slots[i].drv->init() != 0);
+        DBG("Sensor '%s': %s%s\n", slots[i].drv->name,
+            slots[i].alive ? "OK" : "FAIL",
+            sensorSlotIsAsync(&slots[i]) ? " (two-phase)" : "");
     }
-    slots[slotCount].drv         = *drv;
-    slots[slotCount].last_tx_time = 0;
-    slots[slotCount].alive        = false;
-    slotCount++;
 }
 
-void sensorInitAll(void)
+int sensorPoll(unsigned long now, unsigned long slackMs,
+               Reading *out, int maxReadings)
 {
-    for (int i = 0; i < slotCount; i++) {
-        slots[i].alive = (slots[i].drv.init() != 0);
-        DBG("Sensor '%s': %s\n", slots[i].drv.name,
-            slots[i].alive ? "OK" : "FAIL");
-    }
+    sensorSlotsPowerUpdate(slots, slotCount, &rail, now, slackMs);
+    return sensorSlotsPoll(slots, slotCount, now, slackMs, out, maxReadings);
 }
 
-int sensorPoll(unsigned long now, Reading *out, int maxReadings)
+int sensorCollect(unsigned long now, Reading *out, int maxReadings)
 {
-    int total = 0;
-
-    for (int i = 0; i < slotCount && total < maxReadings; i++) {
-        /* Determine interval from runtime global (via pointer) */
-        uint16_t interval = slots[i].drv.interval_sec
-                          ? *slots[i].drv.interval_sec : 5;
-        if (interval == 0) interval = 1;
-        unsigned long intervalMs = (unsigned long)interval * 1000UL;
-
-        bool due = (slots[i].last_tx_time == 0) ||
-                   (now - slots[i].last_tx_time >= intervalMs);
-        if (!due) continue;
-
-        /* Check alive, attempt reinit if not */
-        if (!slots[i].alive || !slots[i].drv.is_alive()) {
-            DBG("Sensor '%s' not available — attempting reinit...\n",
-                slots[i].drv.name);
-            slots[i].alive = (slots[i].drv.init() != 0);
-            if (!slots[i].alive) {
-                DBG("ERROR: '%s' reinit failed, skipping\n",
-                    slots[i].drv.name);
-                continue;
-            }
-        }
-
-        int nRead = slots[i].drv.read(out + total, maxReadings - total);
-        if (nRead > 0) {
-            total += nRead;
-            slots[i].last_tx_time = now;
-        } else {
-            DBG("ERROR: '%s' read failed, skipping\n", slots[i].drv.name);
-        }
-    }
+    return sensorSlotsCollect(slots, slotCount, now, out, maxReadings);
+}
 
-    return total;
+void sensorPrefetch(unsigned long now, unsigned long leadMs,
+                    unsigned long slackMs)
+{
+    sensorSlotsPrefetch(slots, slotCount, now, leadMs, slackMs);
+}
+
+int sensorPending(void)
+{
+    return sensorSlotsPending(slots, slotCount);
+}
+
+const SensorSlot *sensorGetSlot(int i)
+{
+    return (i >= 0 && i < slotCount) ? &slots[i] : NULL;
+}
+
+int sensorFmtHealth(unsigned long now, char *buf, int bufSize)
+{
+    return sensorSlotsFmtHealth(slots, slotCount, now, buf, bufSize);
+}
+
+unsigned long sensorNextDueIn(unsigned long now)
+{
+    return sensorSlotsNextDueIn(slots, slotCount, now);
 }
 
 void sensorResetTimers(void)
 {
+    sensorSlotsReset(slots, slotCount);
+}
+
+/* ─── Power Gating ──────────────────────────────────────────────────────── */
+
+void sensorPowerInit(void (*set)(bool), void (*powered)(void),
+                     unsigned long now)
+{
+    powerRailInit(&rail, set, powered, true, now);
     for (int i = 0; i < slotCount; i++)
-        slots[i].last_tx_time = 0;
+        slots[i].ready_at = now + sensorSlotWarmupMs(&slots[i]);
+}
+
+void sensorPowerTick(unsigned long now, unsigned long slackMs)
+{
+    sensorSlotsPowerUpdate(slots, slotCount, &rail, now, slackMs);
+}
+
+void sensorPowerHold(uint8_t bit, bool hold)
+{
+    powerRailHold(&rail, bit, hold);
+    /* Holders need the rail now; releasing waits for the next update */
+    if (hold) sensorSlotsPowerSet(slots, slotCount, &rail, true, millis());
+}
+
+void sensorPowerOff(unsigned long now)
+{
+    sensorSlotsPowerSet(slots, slotCount, &rail, false, now);
+    DBG("Vext off: %lu power-ups, %lu ms on since boot\n",
+        (unsigned long)rail.on_count, powerRailOnMs(&rail, now));
+}
+
+bool sensorPowerBusy(void)
+{
+    return rail.on && rail.demand;
 }
@@ -4,18 +4,67 @@
  * Defines the SensorDriver vtable, a registry for plug-and-play sensor
  * types, and the sensorPack() helper for building LoRa sensor packets.
  * Each sensor type (BME280, battery, etc.) implements a SensorDriver and
- * registers it at startup.  The main loop calls sensorPoll() each cycle.
+ * has an entry in sensor_list.h, which builds the registry at compile
+ * time from the SENSORS list.  The main loop calls sensorPoll() each cycle.
+ *
+ * The slot scheduling logic (SensorSlot + sensorSlots*()) is static inline
+ * with no Arduino deps so it can be exercised natively with mock drivers.
  */
 
 #ifndef SENSOR_DRV_H
 #define SENSOR_DRV_H
 
+#include <stdbool.h>
 #include "packets.h"
+#include "power_rail.h"
+#include "sensor_list.h"
+
+/* ─── Debug (no-op unless defined before include) ─────────────────────────── */
+#ifndef SDBG
+#define SDBG(fmt, ...) ((void)0)
+#endif
 
 /* ─── Limits ───────────────────────────────────────────────────────────── */
 
+/*
+ * Exactly the build's sensors (sensor_list.h).  Native tests build with
+ * no SENSOR_* flags and get room for their mock drivers instead.
+ */
+#if SENSOR_LIST_COUNT > 0
+#define SENSOR_MAX_DRIVERS  SENSOR_LIST_COUNT
+#define SENSOR_MAX_READINGS SENSOR_LIST_READINGS
+#else
 #define SENSOR_MAX_DRIVERS  4
 #define SENSOR_MAX_READINGS 12
+#endif
+
+/*
+ * Give up on a two-phase conversion if poll_ready() has not reported
+ * completion within this long (sensor hung or unplugged mid-conversion).
+ */
+#ifndef SENSOR_CONVERT_TIMEOUT_MS
+#define SENSOR_CONVERT_TIMEOUT_MS 2000
+#endif
+
+/*
+ * Dead-sensor backoff.  A failed reinit reschedules the slot one
+ * interval out, doubling with each further failure up to
+ * SENSOR_BACKOFF_MAX_MS (or the interval, if longer).  After
+ * SENSOR_QUARANTINE_FAILS in a row the sensor is quarantined: probed
+ * only every SENSOR_QUARANTINE_MS.  A probe that succeeds (sensor
+ * plugged back in) clears it; the "sample" command probes at once.
+ */
+#ifndef SENSOR_BACKOFF_MAX_MS
+#define SENSOR_BACKOFF_MAX_MS     600000UL     /* 10 min */
+#endif
+
+#ifndef SENSOR_QUARANTINE_FAILS
+#define SENSOR_QUARANTINE_FAILS   8
+#endif
+
+#ifndef SENSOR_QUARANTINE_MS
+#define SENSOR_QUARANTINE_MS      3600000UL    /* 1 h */
+#endif
 
 /* ─── Driver Interface ─────────────────────────────────────────────────── */
 
@@ -24,41 +73,577 @@
  * interval_sec points to the runtime global for that sensor's sample
  * interval (e.g. &bme280RateSec), so setparam changes take effect
  * immediately without rebooting.
+ *
+ * Two-phase drivers (optional): sensors with a slow conversion (BME280
+ * forced mode, ADC settling) set start/poll_ready/collect so the poller
+ * can kick off a conversion and come back for the result later instead
+ * of blocking in read().  Leave all three NULL for a synchronous driver;
+ * read() is then used as before.
+ *
+ * Warm resume (optional): after deep sleep the Vext rail has been off, so
+ * sensor registers are back at power-on defaults but everything the
+ * driver holds in RAM (calibration, addresses, fix history) survived.
+ * resume() re-applies just the register setup and skips the bus reset
+ * and probe done by init().  Drivers without it are re-initialised.
+ *
+ * Power gating (optional): drivers with on_rail set are powered from the
+ * switched Vext rail, which is only turned on for their sample windows.
+ * warmup_ms() is how long after power-up the first sample is usable
+ * (e.g. GPS hot vs cold start); NULL means immediately.  Power-up runs
+ * the same resume() path as a wake from deep sleep.
+ *
+ * read() returning SENSOR_READ_WAIT means "no data yet" (e.g. GPS
+ * without a fix): the slot stays due and is retried next poll.
+ * SENSOR_READ_NONE means the sample was taken but isn't worth reporting
+ * (e.g. GPS hasn't moved): the slot is rescheduled as if it had produced
+ * readings.  0 is a failed read, counted in readFails.
  */
+#define SENSOR_READ_NONE (-1)
+#define SENSOR_READ_WAIT (-2)
+
 typedef struct {
     const char *name;                       /* "bme280", "batt"              */
     int  (*init)(void);                     /* 1=ok, 0=fail                  */
     int  (*is_alive)(void);                 /* 1=available, 0=not            */
     int  (*read)(Reading *out, int max);    /* fill readings, return count   */
     uint16_t *interval_sec;                 /* → runtime global (seconds)    */
+    int  (*start)(void);                    /* begin conversion, 1=ok 0=fail */
+    int  (*poll_ready)(void);               /* 1=result ready, 0=busy        */
+    int  (*collect)(Reading *out, int max); /* fetch result, return count    */
+    int  (*resume)(void);                   /* warm restart, 1=ok 0=fail     */
+    bool on_rail;                           /* powered from switched Vext    */
+    unsigned long (*warmup_ms)(void);       /* power-up → usable (ms)        */
 } SensorDriver;
 
-/* ─── Registry API ─────────────────────────────────────────────────────── */
+/* ─── Slot State ───────────────────────────────────────────────────────── */
+
+typedef enum {
+    SENSOR_PHASE_IDLE = 0,      /* nothing in flight                       */
+    SENSOR_PHASE_CONVERTING     /* start() issued, waiting on poll_ready() */
+} SensorPhase;
 
 /*
- * Register a sensor driver.  Call from setup() for each enabled sensor.
- * The SensorDriver struct is copied — the original can be const.
+ * Per-driver bookkeeping.  The registry in sensor_drv.cpp owns an array
+ * of these, one per SENSOR_LIST entry; tests build their own around
+ * mock drivers.  Drivers are referenced, not copied, so they must have
+ * static storage.
+ *
+ * next_due is an absolute millis() deadline compared with signed
+ * differences, so it stays correct across the 49-day rollover.
  */
-void sensorRegister(const SensorDriver *drv);
+typedef struct {
+    const SensorDriver *drv;    /* in the const driver table (flash)       */
+    unsigned long next_due;     /* millis() deadline of the next sample    */
+    unsigned long start_time;   /* millis() when start() was issued        */
+    uint8_t       phase;        /* SensorPhase                             */
+    bool          scheduled;    /* false = never sampled / forced: due now */
+    bool          alive;
+    bool          powered;      /* rail up (always true when !on_rail)     */
+    unsigned long ready_at;     /* millis() when warm-up completes         */
+    uint32_t      readFails;    /* read/start/collect failed or timed out  */
+    uint32_t      initFails;    /* reinit or warm resume failed            */
+    uint8_t       failStreak;   /* reinits failed in a row (backoff step)  */
+} SensorSlot;
+
+/* sensorNextDueIn() result when no sensor is registered */
+#define SENSOR_NO_DEADLINE  0xFFFFFFFFUL
 
-/* Call init() on all registered drivers.  Call once from setup(). */
+/* ─── Registry API ─────────────────────────────────────────────────────── */
+
+/*
+ * Set up a slot for every driver in SENSOR_LIST and call its init().
+ * Call once from setup().
+ */
 void sensorInitAll(void);
 
 /*
- * Poll all registered sensors.  For each driver whose interval has
- * elapsed: check is_alive (reinit if needed), call read(), append
- * readings to out[].  Returns total reading count (0 = nothing due).
+ * Poll all registered sensors.  When at least one driver has reached its
+ * deadline, every driver due within slackMs is sampled along with it so
+ * their readings share one packet, and all of them are rescheduled from
+ * `now` (which keeps them in phase from then on).  Sampling means
+ * checking is_alive (reinit if needed), then calling read() (synchronous
+ * drivers) or start() (two-phase drivers).  Conversions that have
+ * finished since the last call are collected as well.
+ * Appends readings to out[] and returns the total count (0 = nothing
+ * ready).  Never waits on a conversion.
  *
  * `now` should be millis() at cycle start.
  */
-int sensorPoll(unsigned long now, Reading *out, int maxReadings);
+int sensorPoll(unsigned long now, unsigned long slackMs,
+               Reading *out, int maxReadings);
+
+/*
+ * Collect finished two-phase conversions without starting new ones.
+ * Call from the tick loop while sensorPending() > 0.
+ */
+int sensorCollect(unsigned long now, Reading *out, int maxReadings);
+
+/*
+ * Start conversions on two-phase drivers that the sensorPoll() at
+ * now + leadMs will sample (same slack rule), so their results are
+ * ready by then.  Synchronous drivers are left alone.
+ */
+void sensorPrefetch(unsigned long now, unsigned long leadMs,
+                    unsigned long slackMs);
+
+/* Number of two-phase conversions currently in flight. */
+int sensorPending(void);
+
+/* Registered slot i (name and failure counters), or NULL past the last. */
+const SensorSlot *sensorGetSlot(int i);
+
+/* Per-driver health for the "sensors" command (see sensorSlotsFmtHealth). */
+int sensorFmtHealth(unsigned long now, char *buf, int bufSize);
+
+
+/*
+ * Milliseconds from now until the earliest sensor deadline (0 = something
+ * is already due).  Returns SENSOR_NO_DEADLINE if no driver is registered.
+ * Lets the main loop sleep until the next sample is needed.
+ */
+unsigned long sensorNextDueIn(unsigned long now);
 
 /*
  * Reset all sensor timers so every driver fires on the next sensorPoll().
- * Called when a forced sample is requested via the "sample" command.
+ * Called when a forced sample is requested via the "sample" command;
+ * backed-off and quarantined sensors are probed again too.
  */
 void sensorResetTimers(void);
 
+/*
+ * Switched-rail power gating.  sensorPowerInit() takes the sketch's rail
+ * callbacks (see power_rail.h); the rail is assumed on at the call, as
+ * setup() leaves it.  sensorPoll() updates the rail itself; call
+ * sensorPowerTick() from the tick loop so warm-ups start on time.
+ * sensorPowerOff() cuts the rail regardless of holds (deep sleep); the
+ * next update brings it back if still needed.  sensorPowerBusy() is true
+ * while sensors (not just holds) keep the rail up.
+ */
+void sensorPowerInit(void (*set)(bool), void (*powered)(void),
+                     unsigned long now);
+void sensorPowerTick(unsigned long now, unsigned long slackMs);
+void sensorPowerHold(uint8_t bit, bool hold);
+void sensorPowerOff(unsigned long now);
+bool sensorPowerBusy(void);
+
+/* ─── Slot Scheduling (static inline, testable natively) ───────────────── */
+
+static inline void sensorSlotInit(SensorSlot *slot, const SensorDriver *drv)
+{
+    slot->drv        = drv;
+    slot->next_due   = 0;
+    slot->start_time = 0;
+    slot->phase      = SENSOR_PHASE_IDLE;
+    slot->scheduled  = false;
+    slot->alive      = false;
+    slot->powered    = true;
+    slot->ready_at   = 0;
+    slot->readFails  = 0;
+    slot->initFails  = 0;
+    slot->failStreak = 0;
+}
+
+static inline bool sensorSlotIsAsync(const SensorSlot *slot)
+{
+    return slot->drv->start && slot->drv->poll_ready && slot->drv->collect;
+}
+
+static inline unsigned long sensorSlotIntervalMs(const SensorSlot *slot)
+{
+    /* Determine interval from runtime global (via pointer) */
+    uint16_t interval = slot->drv->interval_sec ? *slot->drv->interval_sec : 5;
+    if (interval == 0) interval = 1;
+    return (unsigned long)interval * 1000UL;
+}
+
+/*
+ * True if the slot's deadline falls at or before now + windowMs.
+ * An unscheduled slot (never sampled, or timers reset) is always due.
+ */
+static inline bool sensorSlotDue(const SensorSlot *slot, unsigned long now,
+                                 unsigned long windowMs)
+{
+    if (!slot->scheduled) return true;
+    return (long)((now + windowMs) - slot->next_due) >= 0;
+}
+
+static inline unsigned long sensorSlotWarmupMs(const SensorSlot *slot)
+{
+    return slot->drv->warmup_ms ? slot->drv->warmup_ms() : 0;
+}
+
+/* True once the slot's sensor is powered and warmed up. */
+static inline bool sensorSlotReady(const SensorSlot *slot, unsigned long now)
+{
+    if (!slot->drv->on_rail) return true;
+    return slot->powered && (long)(now - slot->ready_at) >= 0;
+}
+
+/*
+ * Milliseconds until the slot next needs the CPU, 0 if already due:
+ * its deadline, or for an unpowered rail sensor the start of its
+ * warm-up, or for a warming one the end of its warm-up if later.
+ */
+static inline unsigned long sensorSlotDueIn(const SensorSlot *slot,
+                                            unsigned long now)
+{
+    long wait = 0;
+    if (slot->scheduled) {
+        wait = (long)(slot->next_due - now);
+        if (slot->drv->on_rail && !slot->powered)
+            wait -= (long)sensorSlotWarmupMs(slot);
+    }
+    if (slot->drv->on_rail && slot->powered) {
+        long warm = (long)(slot->ready_at - now);
+        if (warm > wait) wait = warm;
+    }
+    return wait > 0 ? (unsigned long)wait : 0;
+}
+
+/* Next deadline is one interval after the (possibly future) sample time. */
+static inline void sensorSlotReschedule(SensorSlot *slot,
+                                        unsigned long sampleTime)
+{
+    slot->next_due  = sampleTime + sensorSlotIntervalMs(slot);
+    slot->scheduled = true;
+}
+
+static inline bool sensorSlotQuarantined(const SensorSlot *slot)
+{
+    return slot->failStreak >= SENSOR_QUARANTINE_FAILS;
+}
+
+/* Wait before the next reinit after failStreak failures in a row */
+static inline unsigned long sensorSlotBackoffMs(const SensorSlot *slot)
+{
+    unsigned long interval = sensorSlotIntervalMs(slot);
+    if (sensorSlotQuarantined(slot))
+        return interval > SENSOR_QUARANTINE_MS ? interval : SENSOR_QUARANTINE_MS;
+
+    unsigned long cap = interval > SENSOR_BACKOFF_MAX_MS ? interval : SENSOR_BACKOFF_MAX_MS;
+    unsigned long ms  = interval;
+    for (int i = 1; i < slot->failStreak && ms < cap; i++) ms <<= 1;
+    return ms < cap ? ms : cap;
+}
+
+/*
+ * Check alive, attempt reinit if not.  Returns true if usable.  A
+ * failed reinit pushes the slot's deadline out by the backoff, so a
+ * dead sensor neither wakes the node nor powers the rail in between.
+ */
+static inline bool sensorSlotEnsureAlive(SensorSlot *slot, unsigned long now)
+{
+    if (slot->alive && slot->drv->is_alive()) return true;
+
+    SDBG("Sensor '%s' not available — attempting reinit...\n", slot->drv->name);
+    slot->alive = (slot->drv->init() != 0);
+    if (!slot->alive) {
+        slot->initFails++;
+        if (slot->failStreak < 255) slot->failStreak++;
+        slot->next_due  = now + sensorSlotBackoffMs(slot);
+        slot->scheduled = true;
+        SDBG("ERROR: '%s' reinit failed (%u in a row), retry in %lu s%s\n",
+             slot->drv->name, (unsigned)slot->failStreak,
+             sensorSlotBackoffMs(slot) / 1000UL,
+             sensorSlotQuarantined(slot) ? " (quarantined)" : "");
+    } else if (slot->failStreak > 0) {
+        SDBG("Sensor '%s' back after %u failed reinits\n", slot->drv->name,
+             (unsigned)slot->failStreak);
+        slot->failStreak = 0;
+    }
+    return slot->alive;
+}
+
+/*
+ * Advance an in-flight conversion.  Appends readings to out[] once
+ * poll_ready() reports completion; abandons the conversion after
+ * SENSOR_CONVERT_TIMEOUT_MS.  Returns readings appended.
+ */
+static inline int sensorSlotCollect(SensorSlot *slot, unsigned long now,
+                                    Reading *out, int max)
+{
+    if (slot->phase != SENSOR_PHASE_CONVERTING) return 0;
+
+    if (!slot->drv->poll_ready()) {
+        if (now - slot->start_time >= SENSOR_CONVERT_TIMEOUT_MS) {
+            SDBG("ERROR: '%s' conversion timed out\n", slot->drv->name);
+            slot->readFails++;
+            slot->phase = SENSOR_PHASE_IDLE;
+            slot->alive = false;  /* force reinit on next due poll */
+        }
+        return 0;
+    }
+
+    slot->phase = SENSOR_PHASE_IDLE;
+    int nRead = slot->drv->collect(out, max);
+    if (nRead <= 0) {
+        SDBG("ERROR: '%s' collect failed\n", slot->drv->name);
+        slot->readFails++;
+        return 0;
+    }
+    return nRead;
+}
+
+/*
+ * Kick off a conversion on a two-phase slot and reschedule it from
+ * sampleTime, so prefetching ahead of the poll does not shift the
+ * sampling phase earlier every interval.
+ */
+static inline bool sensorSlotStart(SensorSlot *slot, unsigned long now,
+                                   unsigned long sampleTime)
+{
+    if (!slot->drv->start()) {
+        SDBG("ERROR: '%s' start failed, skipping\n", slot->drv->name);
+        slot->readFails++;
+        return false;
+    }
+    slot->phase      = SENSOR_PHASE_CONVERTING;
+    slot->start_time = now;
+    sensorSlotReschedule(slot, sampleTime);
+    return true;
+}
+
+/*
+ * True if any idle, ready slot has reached its deadline by `at` — i.e. a
+ * poll at that time will sample something.  Slack alone never triggers a
+ * sample; it only lets near-due slots join one that is really due.
+ */
+static inline bool sensorSlotsAnyDue(const SensorSlot *slots, int count,
+                                     unsigned long at)
+{
+    for (int i = 0; i < count; i++)
+        if (slots[i].phase == SENSOR_PHASE_IDLE &&
+            sensorSlotReady(&slots[i], at) && sensorSlotDue(&slots[i], at, 0))
+            return true;
+    return false;
+}
+
+/*
+ * One poll pass over slots[]: collect finished conversions, then, if any
+ * slot is due, start (two-phase) or read (synchronous) every slot due
+ * within slackMs.  A two-phase slot whose result is already available
+ * right after start() is collected in the same pass.  Returns total
+ * readings appended.
+ */
+static inline int sensorSlotsPoll(SensorSlot *slots, int count,
+                                  unsigned long now, unsigned long slackMs,
+                                  Reading *out, int maxReadings)
+{
+    int  total = 0;
+    bool group = sensorSlotsAnyDue(slots, count, now);
+
+    for (int i = 0; i < count && total < maxReadings; i++) {
+        SensorSlot *s = &slots[i];
+
+        if (s->phase == SENSOR_PHASE_CONVERTING) {
+            total += sensorSlotCollect(s, now, out + total, maxReadings - total);
+            continue;
+        }
+
+        if (!group || !sensorSlotReady(s, now)) continue;
+        if (!sensorSlotDue(s, now, slackMs)) continue;
+        if (!sensorSlotEnsureAlive(s, now)) continue;
+
+        if (sensorSlotIsAsync(s)) {
+            if (sensorSlotStart(s, now, now))
+                total += sensorSlotCollect(s, now, out + total, maxReadings - total);
+            continue;
+        }
+
+        int nRead = s->drv->read(out + total, maxReadings - total);
+        if (nRead > 0) {
+            total += nRead;
+            sensorSlotReschedule(s, now);
+        } else if (nRead == SENSOR_READ_NONE) {
+            sensorSlotReschedule(s, now);
+        } else if (nRead == SENSOR_READ_WAIT) {
+            continue;                       /* still due, not a failure */
+        } else {
+            SDBG("ERROR: '%s' read failed, skipping\n", s->drv->name);
+            s->readFails++;
+        }
+    }
+
+    return total;
+}
+
+/* Collect-only pass: never starts or reads a slot. */
+static inline int sensorSlotsCollect(SensorSlot *slots, int count,
+                                     unsigned long now,
+                                     Reading *out, int maxReadings)
+{
+    int total = 0;
+    for (int i = 0; i < count && total < maxReadings; i++)
+        total += sensorSlotCollect(&slots[i], now, out + total, maxReadings - total);
+    return total;
+}
+
+/*
+ * Start the two-phase slots that the poll at now + leadMs will sample,
+ * using the same any-due + slack rule as sensorSlotsPoll().  They are
+ * rescheduled from the poll time so they stay in phase with the
+ * synchronous slots sampled there.
+ */
+static inline void sensorSlotsPrefetch(SensorSlot *slots, int count,
+                                       unsigned long now, unsigned long leadMs,
+                                       unsigned long slackMs)
+{
+    unsigned long pollAt = now + leadMs;
+    if (!sensorSlotsAnyDue(slots, count, pollAt)) return;
+
+    for (int i = 0; i < count; i++) {
+        SensorSlot *s = &slots[i];
+        if (!sensorSlotIsAsync(s) || s->phase != SENSOR_PHASE_IDLE) continue;
+        if (!s->scheduled) continue;  /* first sample: leave to poll */
+        if (!sensorSlotReady(s, now)) continue;
+        if (!sensorSlotDue(s, pollAt, slackMs)) continue;
+        if (!sensorSlotEnsureAlive(s, now)) continue;
+        sensorSlotStart(s, now, pollAt);
+    }
+}
+
+static inline int sensorSlotsPending(const SensorSlot *slots, int count)
+{
+    int n = 0;
+    for (int i = 0; i < count; i++)
+        if (slots[i].phase == SENSOR_PHASE_CONVERTING) n++;
+    return n;
+}
+
+/* Earliest deadline across slots[], as ms from now (see sensorNextDueIn). */
+static inline unsigned long sensorSlotsNextDueIn(const SensorSlot *slots,
+                                                 int count, unsigned long now)
+{
+    unsigned long best = SENSOR_NO_DEADLINE;
+    for (int i = 0; i < count; i++) {
+        unsigned long d = sensorSlotDueIn(&slots[i], now);
+        if (d < best) best = d;
+    }
+    return best;
+}
+
+/*
+ * Per-driver health, in registration order:
+ *   {"s":[{"a":1,"f":0,"n":"bme280","q":0,"w":42},...]}
+ * a = alive, f = reinits failed in a row, q = quarantined, w = seconds
+ * until the slot next samples (or probes, when dead).  Drivers that
+ * don't fit are left off and flagged with "t":1.
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int sensorSlotsFmtHealth(const SensorSlot *slots, int count,
+                                       unsigned long now, char *buf, int bufSize)
+{
+    const int closeMax = 9;     /* ],"t":1} + null */
+    if (bufSize < 6 + closeMax) return 0;
+
+    int pos = snprintf(buf, bufSize, "{\"s\":[");
+    bool cut = false;
+    for (int i = 0; i < count; i++) {
+        const SensorSlot *s = &slots[i];
+        char item[64];
+        int len = snprintf(item, sizeof(item),
+                           "%s{\"a\":%d,\"f\":%u,\"n\":\"%s\",\"q\":%d,\"w\":%lu}",
+                           i > 0 ? "," : "", s->alive ? 1 : 0,
+                           (unsigned)s->failStreak, s->drv->name,
+                           sensorSlotQuarantined(s) ? 1 : 0,
+                           sensorSlotDueIn(s, now) / 1000UL);
+        if (len <= 0 || len >= (int)sizeof(item) || pos + len + closeMax > bufSize) {
+            cut = true;
+            break;
+        }
+        memcpy(buf + pos, item, len);
+        pos += len;
+    }
+    pos += snprintf(buf + pos, bufSize - pos, "]%s}", cut ? ",\"t\":1" : "");
+    return pos;
+}
+
+/*
+ * Bring a slot back after deep sleep.  A conversion in flight when the
+ * rail dropped is lost — the slot goes idle and keeps its deadline, so
+ * the next poll restarts it.  Dead slots stay dead (init on next due).
+ */
+static inline void sensorSlotResume(SensorSlot *slot)
+{
+    slot->phase = SENSOR_PHASE_IDLE;
+    if (!slot->alive) return;
+
+    if (!slot->drv->resume) {
+        slot->alive = false;  /* no warm path — full init on next due poll */
+        return;
+    }
+    slot->alive = (slot->drv->resume() != 0);
+    if (!slot->alive) {
+        slot->initFails++;
+        SDBG("ERROR: '%s' resume failed, will reinit\n", slot->drv->name);
+    }
+}
+
+static inline void sensorSlotsResume(SensorSlot *slots, int count)
+{
+    for (int i = 0; i < count; i++)
+        sensorSlotResume(&slots[i]);
+}
+
+/* ─── Power Gating (static inline, testable natively) ──────────────────── */
+
+/*
+ * Decide whether the switched rail must be on and switch it.  A rail
+ * slot demands power while converting, once due within its warm-up lead,
+ * or when it is due within slackMs of a group that is due now (so it can
+ * join that packet — sensors with warm-up need it powered before then
+ * to be included).  Holds keep the rail on regardless.
+ *
+ * On power-up every rail slot is resumed (registers are at power-on
+ * defaults) and its warm-up clock starts.  On power-down rail slots are
+ * marked unpowered and any conversion is dropped.
+ */
+static inline void sensorSlotsPowerSet(SensorSlot *slots, int count,
+                                       PowerRail *rail, bool on,
+                                       unsigned long now)
+{
+    if (!powerRailSwitch(rail, on, now)) return;
+
+    for (int i = 0; i < count; i++) {
+        SensorSlot *s = &slots[i];
+        if (!s->drv->on_rail) continue;
+        if (on) {
+            s->powered  = true;
+            s->ready_at = now + sensorSlotWarmupMs(s);
+            sensorSlotResume(s);
+        } else {
+            s->powered = false;
+            s->phase   = SENSOR_PHASE_IDLE;
+        }
+    }
+}
+
+static inline void sensorSlotsPowerUpdate(SensorSlot *slots, int count,
+                                          PowerRail *rail, unsigned long now,
+                                          unsigned long slackMs)
+{
+    bool group  = sensorSlotsAnyDue(slots, count, now);
+    bool demand = false;
+
+    for (int i = 0; i < count && !demand; i++) {
+        const SensorSlot *s = &slots[i];
+        if (!s->drv->on_rail) continue;
+        demand = s->phase == SENSOR_PHASE_CONVERTING ||
+                 sensorSlotDue(s, now, sensorSlotWarmupMs(s)) ||
+                 (group && sensorSlotDue(s, now, slackMs));
+    }
+
+    rail->demand = demand;
+    sensorSlotsPowerSet(slots, count, rail, demand || rail->holds != 0, now);
+}
+
+/* Mark every slot unscheduled so the next poll samples all of them. */
+static inline void sensorSlotsReset(SensorSlot *slots, int count)
+{
+    for (int i = 0; i < count; i++)
+        slots[i].scheduled = false;
+}
+
 /* ─── Packet Packing Helper ────────────────────────────────────────────── */
 
 /*
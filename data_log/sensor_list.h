@@ -0,0 +1,62 @@
+/*
+ * sensor_list.h — The build's sensor table, from the SENSORS list
+ *
+ * make turns SENSORS in node_config.mk into -DSENSOR_<NAME>=1 flags; this
+ * header turns those into one X-macro entry per sensor in the build:
+ *
+ *   X(name, driver, maxReadings, rateVar)
+ *
+ *   name         driver name; its sample-rate param is "<name>_rate"
+ *   driver       the driver's const SensorDriver
+ *   maxReadings  most readings one sample appends
+ *   rateVar      runtime rate global, also the NodeConfig field it saves to
+ *
+ * The slot array, the readings buffers, the stats snapshot and the rate
+ * params are all expanded from these entries, so they are sized for
+ * exactly the sensors built in.  SENSOR_LIST is registration order.
+ *
+ * To add a sensor: write its driver, add a SENSOR_ENTRY_<NAME> below,
+ * append it to SENSOR_LIST and place its rate param in commands.cpp's
+ * (sorted) param table with SENSOR_ENTRY_<NAME>(SENSOR_RATE_PARAM).
+ *
+ * Macros only, no Arduino deps.
+ */
+
+#ifndef SENSOR_LIST_H
+#define SENSOR_LIST_H
+
+/* ─── Entries ────────────────────────────────────────────────────────────── */
+
+#ifdef SENSOR_BME280
+#define SENSOR_ENTRY_BME280(X)  X(bme280, bme280Driver, 3, bme280RateSec)
+#else
+#define SENSOR_ENTRY_BME280(X)
+#endif
+
+#ifdef SENSOR_BATT
+#define SENSOR_ENTRY_BATT(X)    X(batt,   battDriver,   1, battRateSec)
+#else
+#define SENSOR_ENTRY_BATT(X)
+#endif
+
+#ifdef SENSOR_GPS
+#define SENSOR_ENTRY_GPS(X)     X(gps,    gpsDriver,    4, gpsRateSec)
+#else
+#define SENSOR_ENTRY_GPS(X)
+#endif
+
+#define SENSOR_LIST(X) \
+    SENSOR_ENTRY_BME280(X) \
+    SENSOR_ENTRY_BATT(X) \
+    SENSOR_ENTRY_GPS(X)
+
+/* ─── Derived Sizes ──────────────────────────────────────────────────────── */
+
+/* Plain integer sums, usable in #if as well as array sizes */
+#define SENSOR_LIST_ONE_(name, drv, nr, rate)       + 1
+#define SENSOR_LIST_READINGS_(name, drv, nr, rate)  + (nr)
+
+#define SENSOR_LIST_COUNT     (0 SENSOR_LIST(SENSOR_LIST_ONE_))
+#define SENSOR_LIST_READINGS  (0 SENSOR_LIST(SENSOR_LIST_READINGS_))
+
+#endif /* SENSOR_LIST_H */
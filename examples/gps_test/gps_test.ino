@@ -18,6 +18,7 @@
 
 #include "Arduino.h"
 #include "HT_SSD1306Wire.h"
+#define LED_IMPL        /* the NeoPixel instance lives in this unit (see led.h) */
 #include "led.h"
 #include <TinyGPS++.h>
 
@@ -12,9 +12,12 @@ NODE_VERSION     = 1
 # ─── Build Options ──────────────────────────────────────────────────────
 DEBUG            = 0           # 0=quiet, 1=Serial.printf debug output
 CMD_DEBUG        = 0           # 0=quiet, 1=command/ACK debug trace
+DBG_TOKENIZE     = 0           # 1=binary debug tokens (make dbglog decodes)
 LED_BRIGHTNESS   = 16          # 0-255, NeoPixel brightness
 LED_ORDER        = GRB         # NeoPixel color order
 CYCLE_PERIOD_MS  = 5000        # Main loop cycle time (ms)
+AUTOSLEEP_SEC_DEFAULT = 0      # Deep sleep between bursts, wake to listen every N s (0=off)
+HEALTH_RATE_SEC  = 0           # Health uplink every N s (0=off, see "stats")
 
 # ─── Radio Defaults ─────────────────────────────────────────────────────
 LORAWAN_REGION   = 9                # 9=US915 (see Makefile for full list)
@@ -37,6 +40,25 @@ BME280_RATE_SEC_DEFAULT = 30
 BATT_RATE_SEC_DEFAULT   = 60
 GPS_RATE_SEC_DEFAULT    = 60
 
+# NEO-6M protocol: 0=NMEA, 1=UBX binary (NAV-POSLLH/SOL only, power save,
+# backup between samples — less UART traffic and GPS current)
+GPS_UBX                 = 0
+
+# GPS motion: skip reports within GPS_MIN_DIST_M of the last one (parked
+# assets back off up to 8x gps_rate); sample every GPS_FAST_RATE_SEC above
+# GPS_FAST_KMH (0 = off)
+GPS_MIN_DIST_M_DEFAULT    = 25
+GPS_FAST_KMH_DEFAULT      = 20
+GPS_FAST_RATE_SEC_DEFAULT = 10
+
+# On-device flash log: every reading is logged; uplink only every Nth
+# batch of readings (1 = all, 0 = log only, pull history with logget)
+LOG_TXDIV_DEFAULT = 1
+
+# Sensors due within this many seconds of one that is due are sampled
+# together and share a packet (0 = strict per-sensor intervals)
+SENSOR_SLACK_SEC_DEFAULT = 5
+
 # ─── One-Time Setup (uncomment, upload once, then re-comment) ──────────
 # WRITE_NODE_ID    = ab01        # Writes node ID to EEPROM
 # UPDATE_CFG       = 1           # Forces compile-time defaults to EEPROM
@@ -1,11 +1,24 @@
 #include "Arduino.h"
 #include "LoRaWan_APP.h"
 #include "hw.h"
+
+#define CRC32_IMPL      /* CRC-32 tables live in this unit (see crc32.h) */
 #include "packets.h"
 #include "radio.h"
+#define LED_IMPL        /* the NeoPixel instance lives in this unit (see led.h) */
 #include "led.h"
 #include "HT_SSD1306Wire.h"
-#include <TinyGPS++.h>
+
+/* Handling a command blocks for up to ~4 s (TX waits, 1 s LED hold) with
+ * nothing feeding the GPS — ~4 KB of full NMEA */
+#ifndef GPS_RING_SIZE
+#if GPS_UBX
+#define GPS_RING_SIZE 512
+#else
+#define GPS_RING_SIZE 4096
+#endif
+#endif
+#include "gps_service.h"
 
 /* ─── Debug Output ──────────────────────────────────────────────────────── */
 
@@ -45,8 +58,6 @@
  */
 #define SENSOR_ID_GPS            4
 
-#define GPS_BAUD                 9600
-
 /*
  * GPS_LED: show GPS status on NeoPixel (green=fix, yellow=acquiring).
  * Default off to avoid clashing with red ping-received blink.
@@ -71,7 +82,7 @@
 /* SSD1306 OLED 128x64, I2C addr 0x3C, no reset pin */
 static SSD1306Wire oled(0x3c, 500000, SDA, SCL, GEOMETRY_128_64, -1);
 
-static TinyGPSPlus gps;
+static GpsService gps;
 
 /* ─── Radio State ───────────────────────────────────────────────────────── */
 
@@ -93,18 +104,6 @@ static int           packetCount = 0;
 static int16_t       lastDisplayRssi = 0;
 static unsigned long lastRxTime = 0;
 
-/* Cached GPS values (last valid fix) */
-static double   cachedLat  = 0.0;
-static double   cachedLon  = 0.0;
-static double   cachedAlt  = 0.0;
-static uint32_t cachedSats = 0;
-static unsigned long lastValidGpsTime = 0;
-
-/* GPS UART activity tracking */
-static unsigned long lastGpsChars = 0;
-static unsigned long lastGpsCharTime = 0;
-#define GPS_UART_TIMEOUT_MS 2000  /* no uart if no chars for 2s */
-
 /* Display modes */
 enum DisplayMode { DISP_FULL, DISP_BIG_RSSI, DISP_OFF };
 static DisplayMode displayMode = DISP_FULL;
@@ -141,15 +140,14 @@ static void updateDisplayFull(void)
     oled.drawString(0, 0, buf);
 
     /* Line 2: Packet count + satellites + raw ADC (for calibration) */
-    snprintf(buf, sizeof(buf), "Pkts:%d Sat:%lu A:%d", packetCount, cachedSats, rawPotValue);
+    snprintf(buf, sizeof(buf), "Pkts:%d Sat:%u A:%d", packetCount,
+             gpsServiceSats(&gps), rawPotValue);
     oled.drawString(0, 13, buf);
 
     /* Line 3: GPS status - check if UART is active */
-    bool uartActive = (lastGpsCharTime > 0) &&
-                      ((millis() - lastGpsCharTime) < GPS_UART_TIMEOUT_MS);
-    if (!uartActive) {
+    if (!gpsServiceUartActive(&gps)) {
         snprintf(buf, sizeof(buf), "GPS: no uart");
-    } else if (gps.location.isValid()) {
+    } else if (gpsServiceHasFix(&gps)) {
         snprintf(buf, sizeof(buf), "GPS: fix");
     } else {
         snprintf(buf, sizeof(buf), "GPS: acquiring");
@@ -157,8 +155,8 @@ static void updateDisplayFull(void)
     oled.drawString(0, 26, buf);
 
     /* Line 4: Time since last valid GPS fix */
-    if (lastValidGpsTime > 0) {
-        unsigned long gpsAgo = (millis() - lastValidGpsTime) / 1000;
+    if (gps.lastFixTime > 0) {
+        unsigned long gpsAgo = gpsServiceFixAgeMs(&gps) / 1000;
         snprintf(buf, sizeof(buf), "Last fix: %lus", gpsAgo);
     } else {
         snprintf(buf, sizeof(buf), "Last fix: --");
@@ -166,8 +164,8 @@ static void updateDisplayFull(void)
     oled.drawString(0, 39, buf);
 
     /* Line 5: Lat/lon or placeholder */
-    if (lastValidGpsTime > 0) {
-        snprintf(buf, sizeof(buf), "%.4f, %.4f", cachedLat, cachedLon);
+    if (gps.lastFixTime > 0) {
+        snprintf(buf, sizeof(buf), "%.4f, %.4f", gpsServiceLat(&gps), gpsServiceLon(&gps));
     } else {
         snprintf(buf, sizeof(buf), "--, --");
     }
@@ -325,7 +323,7 @@ void setup(void)
     /* USER button for display mode toggle */
     pinMode(USER_KEY, INPUT);
 
-    Serial.begin(GPS_BAUD);        /* NEO-6M GPS on hardware UART (no Serial1 on AB01) */
+    gpsServiceBegin(&gps);         /* NEO-6M GPS on hardware UART (no Serial1 on AB01) */
 
     /* OLED splash screen */
     oled.init();
@@ -370,9 +368,9 @@ void loop(void)
 {
     /* GPS status LED (off by default, enable with GPS_LED=1) */
 #if GPS_LED
-    if (gps.location.isValid())
+    if (gpsServiceHasFix(&gps))
         ledSetColor(LED_GREEN);
-    else if (lastGpsCharTime > 0 && (millis() - lastGpsCharTime) < GPS_UART_TIMEOUT_MS)
+    else if (gpsServiceUartActive(&gps))
         ledSetColor(LED_YELLOW);
     else
         ledSetColor(LED_OFF);
@@ -381,15 +379,7 @@ void loop(void)
 #endif
 
     /* ── Feed GPS ── */
-    while (Serial.available() > 0)
-        gps.encode(Serial.read());
-
-    /* Track GPS UART activity */
-    unsigned long currentChars = gps.charsProcessed();
-    if (currentChars > lastGpsChars) {
-        lastGpsChars = currentChars;
-        lastGpsCharTime = millis();
-    }
+    gpsServiceFeed(&gps);
 
     /* ── Listen on G2N for commands ── */
     Radio.Sleep();
@@ -403,29 +393,8 @@ void loop(void)
     while ((millis() - listenStart) < CYCLE_PERIOD_MS) {
         Radio.IrqProcess();
 
-        /* Keep feeding GPS while listening */
-        while (Serial.available() > 0)
-            gps.encode(Serial.read());
-
-        /* Track GPS UART activity */
-        unsigned long currentChars = gps.charsProcessed();
-        if (currentChars > lastGpsChars) {
-            lastGpsChars = currentChars;
-            lastGpsCharTime = millis();
-        }
-
-        /* Cache valid GPS readings (last known good position) */
-        if (gps.location.isValid()) {
-            cachedLat = gps.location.lat();
-            cachedLon = gps.location.lng();
-            lastValidGpsTime = millis();
-        }
-        if (gps.altitude.isValid()) {
-            cachedAlt = gps.altitude.meters();
-        }
-        if (gps.satellites.isValid()) {
-            cachedSats = gps.satellites.value();
-        }
+        /* Keep feeding GPS while listening (parser keeps the last fix) */
+        gpsServiceFeed(&gps);
 
         /* Check USER button for display mode toggle */
         bool buttonState = digitalRead(USER_KEY);
@@ -513,10 +482,10 @@ void loop(void)
             strncpy(lastCommandId, commandId, sizeof(lastCommandId) - 1);
             lastCommandId[sizeof(lastCommandId) - 1] = '\0';
 
-            double lat  = cachedLat;
-            double lon  = cachedLon;
-            double alt  = cachedAlt;
-            double sats = (double)cachedSats;
+            double lat  = gpsServiceLat(&gps);
+            double lon  = gpsServiceLon(&gps);
+            double alt  = gpsServiceAltM(&gps);
+            double sats = (double)gpsServiceSats(&gps);
             double rssi = (double)rxRssi;
 
             Reading readings[] = {
@@ -566,7 +535,8 @@ void loop(void)
     /* ── Update display every cycle ── */
     updateDisplay();
 
-    DBG("GPS: chars=%lu ok=%lu fail=%lu fix=%s sats=%lu\n",
-        gps.charsProcessed(), gps.passedChecksum(), gps.failedChecksum(),
-        gps.location.isValid() ? "yes" : "no", gps.satellites.value());
+    DBG("GPS: chars=%lu ok=%lu fail=%lu fix=%s sats=%u\n",
+        (unsigned long)gps.parser.chars, (unsigned long)gps.parser.passed,
+        (unsigned long)gps.parser.failed,
+        gpsServiceHasFix(&gps) ? "yes" : "no", gpsServiceSats(&gps));
 }
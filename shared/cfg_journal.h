@@ -0,0 +1,321 @@
+/*
+ * cfg_journal.h — Append-only TLV journal for persistent config fields
+ *
+ * Instead of rewriting the whole NodeConfig struct on every save, each
+ * changed field is appended as a small CRC-protected record keyed by a
+ * stable field ID.  On boot the journal is replayed in order, so the last
+ * record for each ID wins.  When the region fills up it is compacted:
+ * rewritten from scratch with one record per field.
+ *
+ * Because fields are keyed by ID rather than by struct offset, the struct
+ * layout can change freely between firmware versions:
+ *   - a new field has no record yet and keeps its compile-time default
+ *   - a removed field's ID is unknown and its records are skipped
+ *   - a field whose size changed is skipped (its record length no longer
+ *     matches) and falls back to the default
+ * so a firmware update never discards the values that are still valid.
+ *
+ * Region layout:
+ *   [CFGJ_MAGIC][CFGJ_FORMAT] record record ... 0xFF 0xFF ...
+ *   record = [id][len][value: len bytes][crc8 over id, len, value]
+ *
+ * Everything past the last record is kept erased (0xFF) — compaction
+ * fills it — so replay stops at the first 0xFF id.  A record that fails
+ * its CRC (torn write) also ends replay, and the next save compacts so
+ * no stale bytes are left behind the tail.
+ *
+ * IDs 0x00 and 0xFF are reserved, and CFGJ_ID_NAME labels a journal that
+ * holds a named snapshot (config profiles).  Never renumber or reuse an ID.
+ *
+ * The storage is reached through byte read/write callbacks (the sketch
+ * binds them to the EEPROM emulation and commits afterwards), so the logic
+ * is static inline with no Arduino deps and can be tested natively.
+ */
+
+#ifndef CFG_JOURNAL_H
+#define CFG_JOURNAL_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Format ───────────────────────────────────────────────────────────── */
+
+#define CFGJ_MAGIC        0xCA      /* Distinct from the legacy CFG_MAGIC   */
+#define CFGJ_FORMAT       1         /* Record encoding, not struct layout   */
+#define CFGJ_HDR_SIZE     2
+#define CFGJ_REC_OVERHEAD 3         /* id + len + crc8                      */
+#define CFGJ_MAX_VALUE    8
+#define CFGJ_ERASED       0xFF
+#define CFGJ_ID_NAME      0xFE      /* Label record, value = name bytes     */
+
+#define CFGJ_MAX_FIELDS   32        /* Presence is tracked in a uint32_t    */
+
+/* Persisted field: stable ID → location in the in-RAM struct */
+typedef struct {
+    uint8_t id;
+    uint8_t offset;
+    uint8_t size;
+} CfgjField;
+
+typedef uint8_t (*CfgjRead)(uint16_t addr);
+typedef void    (*CfgjWrite)(uint16_t addr, uint8_t val);
+
+/* ─── Journal State ────────────────────────────────────────────────────── */
+
+typedef struct {
+    CfgjRead  read;
+    CfgjWrite write;
+    uint16_t  base;         /* first byte of the region                     */
+    uint16_t  size;         /* region size in bytes                         */
+    uint16_t  tail;         /* offset of the next record, from base         */
+    uint16_t  records;      /* valid records found by the last scan         */
+    bool      formatted;    /* header present                               */
+    bool      clean;        /* everything past tail is erased               */
+} CfgJournal;
+
+/* ─── CRC-8 ────────────────────────────────────────────────────────────── */
+
+/* CRC-8, polynomial 0x07 (ATM HEC), bitwise — records are a few bytes */
+static inline uint8_t cfgjCrc8(uint8_t crc, uint8_t b)
+{
+    crc ^= b;
+    for (int i = 0; i < 8; i++)
+        crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+    return crc;
+}
+
+/* ─── Scanning ─────────────────────────────────────────────────────────── */
+
+static inline const CfgjField *cfgjFindField(const CfgjField *fields, int count, uint8_t id)
+{
+    for (int i = 0; i < count; i++)
+        if (fields[i].id == id) return &fields[i];
+    return NULL;
+}
+
+/*
+ * Walk the records in order, calling cb(id, value, len, ctx) for each one
+ * whose CRC checks out.  Updates tail / records / clean.
+ */
+typedef void (*CfgjVisit)(uint8_t id, const uint8_t *value, uint8_t len, void *ctx);
+
+static inline void cfgjScan(CfgJournal *j, CfgjVisit cb, void *ctx)
+{
+    j->tail      = CFGJ_HDR_SIZE;
+    j->records   = 0;
+    j->clean     = true;
+    j->formatted = j->size > CFGJ_HDR_SIZE
+                   && j->read(j->base) == CFGJ_MAGIC
+                   && j->read((uint16_t)(j->base + 1)) == CFGJ_FORMAT;
+    if (!j->formatted) return;
+
+    uint16_t pos = CFGJ_HDR_SIZE;
+    while (pos + CFGJ_REC_OVERHEAD <= j->size) {
+        uint8_t id = j->read((uint16_t)(j->base + pos));
+        if (id == CFGJ_ERASED) break;
+
+        uint8_t len = j->read((uint16_t)(j->base + pos + 1));
+        if (id == 0 || len > CFGJ_MAX_VALUE
+            || pos + CFGJ_REC_OVERHEAD + len > j->size) {
+            j->clean = false;
+            break;
+        }
+
+        uint8_t value[CFGJ_MAX_VALUE];
+        uint8_t crc = cfgjCrc8(cfgjCrc8(0, id), len);
+        for (uint8_t i = 0; i < len; i++) {
+            value[i] = j->read((uint16_t)(j->base + pos + 2 + i));
+            crc = cfgjCrc8(crc, value[i]);
+        }
+        if (crc != j->read((uint16_t)(j->base + pos + 2 + len))) {
+            j->clean = false;       /* torn write: stop, compact on next save */
+            break;
+        }
+
+        if (cb) cb(id, value, len, ctx);
+        j->records++;
+        pos = (uint16_t)(pos + CFGJ_REC_OVERHEAD + len);
+    }
+    j->tail = pos;
+}
+
+static inline void cfgjInit(CfgJournal *j, CfgjRead read, CfgjWrite write,
+                            uint16_t base, uint16_t size)
+{
+    j->read  = read;
+    j->write = write;
+    j->base  = base;
+    j->size  = size;
+    cfgjScan(j, NULL, NULL);
+}
+
+/* ─── Replay ───────────────────────────────────────────────────────────── */
+
+typedef struct {
+    const CfgjField *fields;
+    int              count;
+    uint8_t         *image;
+    uint16_t         applied;
+    uint32_t         present;   /* bit i: fields[i] has a record */
+} CfgjReplayCtx;
+
+static inline void cfgjReplayVisit(uint8_t id, const uint8_t *value, uint8_t len, void *ctx)
+{
+    CfgjReplayCtx *r = (CfgjReplayCtx *)ctx;
+    const CfgjField *f = cfgjFindField(r->fields, r->count, id);
+    if (!f || f->size != len) return;       /* removed or resized field */
+    memcpy(r->image + f->offset, value, len);
+    r->applied++;
+    r->present |= 1UL << (f - r->fields);
+}
+
+/*
+ * Overlay every journaled field onto *image (which should already hold
+ * defaults).  Returns the number of records applied, or -1 if the region
+ * holds no journal.
+ */
+static inline int cfgjReplay(CfgJournal *j, const CfgjField *fields, int count, void *image)
+{
+    CfgjReplayCtx r = { fields, count, (uint8_t *)image, 0, 0 };
+    cfgjScan(j, cfgjReplayVisit, &r);
+    return j->formatted ? (int)r.applied : -1;
+}
+
+/*
+ * Copy fields from an image laid out per `from` into one laid out per
+ * `to`, matching by ID (and size).  Used to import a pre-journal struct.
+ * Returns the number of fields copied.
+ */
+static inline int cfgjImport(const CfgjField *from, int nFrom, const void *src,
+                             const CfgjField *to, int nTo, void *dst)
+{
+    int copied = 0;
+    for (int i = 0; i < nFrom; i++) {
+        const CfgjField *f = cfgjFindField(to, nTo, from[i].id);
+        if (!f || f->size != from[i].size) continue;
+        memcpy((uint8_t *)dst + f->offset, (const uint8_t *)src + from[i].offset, f->size);
+        copied++;
+    }
+    return copied;
+}
+
+/* ─── Writing ──────────────────────────────────────────────────────────── */
+
+static inline uint16_t cfgjPut(CfgJournal *j, uint16_t pos, uint8_t id,
+                               const uint8_t *value, uint8_t len)
+{
+    uint8_t crc = cfgjCrc8(cfgjCrc8(0, id), len);
+    j->write((uint16_t)(j->base + pos), id);
+    j->write((uint16_t)(j->base + pos + 1), len);
+    for (uint8_t i = 0; i < len; i++) {
+        j->write((uint16_t)(j->base + pos + 2 + i), value[i]);
+        crc = cfgjCrc8(crc, value[i]);
+    }
+    j->write((uint16_t)(j->base + pos + 2 + len), crc);
+    return (uint16_t)(pos + CFGJ_REC_OVERHEAD + len);
+}
+
+/*
+ * Rewrite the region: header, one record per field, rest erased.
+ * Returns false if the fields don't fit.
+ */
+static inline bool cfgjCompact(CfgJournal *j, const CfgjField *fields, int count,
+                               const void *image)
+{
+    uint16_t need = CFGJ_HDR_SIZE;
+    for (int i = 0; i < count; i++)
+        need = (uint16_t)(need + CFGJ_REC_OVERHEAD + fields[i].size);
+    if (need > j->size) return false;
+
+    j->write(j->base, CFGJ_MAGIC);
+    j->write((uint16_t)(j->base + 1), CFGJ_FORMAT);
+    uint16_t pos = CFGJ_HDR_SIZE;
+    for (int i = 0; i < count; i++)
+        pos = cfgjPut(j, pos, fields[i].id,
+                      (const uint8_t *)image + fields[i].offset, fields[i].size);
+    for (uint16_t p = pos; p < j->size; p++)
+        j->write((uint16_t)(j->base + p), CFGJ_ERASED);
+
+    j->tail      = pos;
+    j->records   = (uint16_t)count;
+    j->formatted = true;
+    j->clean     = true;
+    return true;
+}
+
+/*
+ * Persist *image: append a record for every field whose journaled value
+ * differs from it (or has none yet).  Compacts instead when the journal is
+ * missing, damaged, or too full for the changes.
+ *
+ * Returns the number of bytes written (0 = unchanged, nothing to commit),
+ * or -1 if the fields don't fit in the region at all.
+ */
+static inline int cfgjSave(CfgJournal *j, const CfgjField *fields, int count,
+                           const void *image)
+{
+    const uint8_t *img = (const uint8_t *)image;
+
+    /* What the journal currently holds */
+    uint8_t stored[256 + CFGJ_MAX_VALUE];
+    CfgjReplayCtx r = { fields, count, stored, 0, 0 };
+    cfgjScan(j, cfgjReplayVisit, &r);
+
+    if (!j->formatted || !j->clean)
+        return cfgjCompact(j, fields, count, image) ? (int)j->size : -1;
+
+    uint16_t need = 0;
+    for (int i = 0; i < count; i++) {
+        const CfgjField *f = &fields[i];
+        if ((r.present & (1UL << i))
+            && memcmp(stored + f->offset, img + f->offset, f->size) == 0)
+            continue;
+        need = (uint16_t)(need + CFGJ_REC_OVERHEAD + f->size);
+    }
+    if (need == 0) return 0;
+
+    if (j->tail + need > j->size)
+        return cfgjCompact(j, fields, count, image) ? (int)j->size : -1;
+
+    for (int i = 0; i < count; i++) {
+        const CfgjField *f = &fields[i];
+        if ((r.present & (1UL << i))
+            && memcmp(stored + f->offset, img + f->offset, f->size) == 0)
+            continue;
+        j->tail = cfgjPut(j, j->tail, f->id, img + f->offset, f->size);
+        j->records++;
+    }
+    return need;
+}
+
+/* ─── Labels ───────────────────────────────────────────────────────────── */
+
+/* Append a label record (≤ CFGJ_MAX_VALUE chars) after the fields */
+static inline bool cfgjPutName(CfgJournal *j, const char *name)
+{
+    size_t len = strlen(name);
+    if (len == 0 || len > CFGJ_MAX_VALUE) return false;
+    if (j->tail + CFGJ_REC_OVERHEAD + len > j->size) return false;
+    j->tail = cfgjPut(j, j->tail, CFGJ_ID_NAME, (const uint8_t *)name, (uint8_t)len);
+    j->records++;
+    return true;
+}
+
+static inline void cfgjNameVisit(uint8_t id, const uint8_t *value, uint8_t len, void *ctx)
+{
+    if (id != CFGJ_ID_NAME) return;
+    char *name = (char *)ctx;
+    memcpy(name, value, len);
+    name[len] = '\0';
+}
+
+/* Read the label into name[CFGJ_MAX_VALUE + 1].  False if none. */
+static inline bool cfgjName(CfgJournal *j, char *name)
+{
+    name[0] = '\0';
+    cfgjScan(j, cfgjNameVisit, name);
+    return j->formatted && name[0] != '\0';
+}
+
+#endif /* CFG_JOURNAL_H */
@@ -2,16 +2,19 @@
  * config.h — EEPROM-backed persistent configuration for CubeCell HTCC-AB01
  *
  * EEPROM layout (768 bytes available):
- *   Bytes 0-16:  NodeIdentity — unversioned node ID (survives CFG_VERSION bumps)
- *   Bytes 17+:   NodeConfig   — versioned tunable params (resets on version change)
+ *   Bytes 0-16:    NodeIdentity — unversioned node ID (survives firmware updates)
+ *   Bytes 17-479:  Config journal — tunable params as TLV records by field ID
+ *   Bytes 480-767: Profile slots — named config snapshots
  *
  * Workflow:
  *   1. Compile-time #defines provide defaults (overridable via Makefile -D flags)
- *   2. cfgLoad() reads NodeConfig from EEPROM offset 17
- *   3. If cfgVersion doesn't match, compile-time defaults are used
+ *   2. cfgLoad() replays the journal over the defaults; fields the journal
+ *      doesn't know yet keep their defaults (see cfg_journal.h)
+ *   3. A pre-journal struct image (CFG_VERSION 4-8) is imported instead, once
  *   4. cfgLoadNodeId() reads node ID from EEPROM offset 0 (independent of config)
  *   5. WRITE_NODE_ID compile flag writes node ID to EEPROM on boot (one-time)
  *   6. UPDATE_CFG=1 forces config to compile-time defaults (does not touch node ID)
+ *   7. Named profiles are full snapshots in fixed slots at the top of EEPROM
  *
  * Requires radio.h to be included first (for DEFAULT_TX_POWER).
  */
@@ -67,6 +70,30 @@
 #define GPS_RATE_SEC_DEFAULT     60                 /* GPS sample interval (s) */
 #endif
 
+#ifndef GPS_MIN_DIST_M_DEFAULT
+#define GPS_MIN_DIST_M_DEFAULT   25                 /* Skip GPS reports closer than this (m) */
+#endif
+
+#ifndef GPS_FAST_KMH_DEFAULT
+#define GPS_FAST_KMH_DEFAULT     20                 /* Speed for fast GPS rate (km/h), 0=off */
+#endif
+
+#ifndef GPS_FAST_RATE_SEC_DEFAULT
+#define GPS_FAST_RATE_SEC_DEFAULT 10                /* GPS sample interval while fast (s) */
+#endif
+
+#ifndef LOG_TXDIV_DEFAULT
+#define LOG_TXDIV_DEFAULT        1                  /* Uplink every Nth reading batch, 0=log only */
+#endif
+
+#ifndef SENSOR_SLACK_SEC_DEFAULT
+#define SENSOR_SLACK_SEC_DEFAULT 5                  /* Sample early to share a packet (s) */
+#endif
+
+#ifndef AUTOSLEEP_SEC_DEFAULT
+#define AUTOSLEEP_SEC_DEFAULT    0                  /* Autonomous deep sleep RX slot (s), 0=off */
+#endif
+
 #ifndef BROADCAST_ACK_JITTER_DEFAULT
 #define BROADCAST_ACK_JITTER_DEFAULT 1000           /* ms, 0 to disable */
 #endif
@@ -131,7 +158,7 @@ static inline bool cfgSaveNodeId(const char *id)
     return true;
 }
 
-/* ─── Versioned Config (EEPROM offset 17) ─────────────────────────────────── */
+/* ─── Config Journal (EEPROM offset 17) ───────────────────────────────────── */
 
 /* Populate a NodeConfig from compile-time #defines. */
 static inline void cfgDefaults(NodeConfig *c)
@@ -148,63 +175,94 @@ static inline void cfgDefaults(NodeConfig *c)
     c->bme280RateSec   = BME280_RATE_SEC_DEFAULT;
     c->battRateSec     = BATT_RATE_SEC_DEFAULT;
     c->gpsRateSec      = GPS_RATE_SEC_DEFAULT;
+    c->sensorSlackSec  = SENSOR_SLACK_SEC_DEFAULT;
+    c->autoSleepSec    = AUTOSLEEP_SEC_DEFAULT;
+    c->gpsMinDistM     = GPS_MIN_DIST_M_DEFAULT;
+    c->gpsFastKmh      = GPS_FAST_KMH_DEFAULT;
+    c->gpsFastRateSec  = GPS_FAST_RATE_SEC_DEFAULT;
+    c->logTxDiv        = LOG_TXDIV_DEFAULT;
+}
+
+/* ─── Journal Storage ─────────────────────────────────────────────────────── */
+
+static inline uint8_t cfgEepromRead(uint16_t addr)
+{
+    return EEPROM.read(addr);
+}
+
+static inline void cfgEepromWrite(uint16_t addr, uint8_t val)
+{
+    EEPROM.write(addr, val);
 }
 
 /*
- * Save *c to EEPROM at CFG_EEPROM_OFFSET.  Reads back the current contents
- * first and only writes when they differ (no unnecessary wear).
+ * Save *c to the config journal.  Only fields whose journaled value
+ * differs are appended; the region is compacted when it fills up.
  *
  * Returns true if a flash write occurred.
  */
 static inline bool cfgSave(NodeConfig *c)
 {
-    NodeConfig existing;
-    EEPROM.get(CFG_EEPROM_OFFSET, existing);
-    if (memcmp(&existing, c, sizeof(NodeConfig)) == 0) {
+    CfgJournal j;
+    cfgjInit(&j, cfgEepromRead, cfgEepromWrite, CFG_JOURNAL_OFFSET, CFG_JOURNAL_SIZE);
+
+    int written = cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, c);
+    if (written < 0) {
+        DBG("[CFG] save: fields don't fit in %u bytes\n", (unsigned)CFG_JOURNAL_SIZE);
+        return false;
+    }
+    if (written == 0) {
         DBG("[CFG] save: unchanged, skip write\n");
         return false;
     }
 
-    EEPROM.put(CFG_EEPROM_OFFSET, *c);
     EEPROM.commit();
-    DBG("[CFG] save: wrote %u bytes to EEPROM offset %u\n",
-        (unsigned)sizeof(NodeConfig), (unsigned)CFG_EEPROM_OFFSET);
+    DBG("[CFG] save: wrote %d bytes, journal %u/%u bytes, %u records\n",
+        written, j.tail, j.size, j.records);
     return true;
 }
 
 /*
  * Load configuration from EEPROM into *c.
  *
- * Initialises the EEPROM subsystem (covers both NodeIdentity and NodeConfig
- * regions).  Returns true if EEPROM contained a valid config, false if
- * defaults were used.
+ * Initialises the EEPROM subsystem (covers both NodeIdentity and the
+ * journal).  Starts from compile-time defaults and overlays every journaled
+ * field; with no journal, a struct image from older firmware (CFG_VERSION
+ * 4-8) is imported field by field (it is converted on the next save).  Returns
+ * true if EEPROM contained a config, false if only defaults were used.
  *
  * When UPDATE_CFG == 1 the struct is always populated from compile-time
- * #defines and written to EEPROM (only if the bytes actually differ).
+ * #defines and written to EEPROM (only the fields that actually differ).
  */
 static inline bool cfgLoad(NodeConfig *c)
 {
-    EEPROM.begin(CFG_EEPROM_OFFSET + sizeof(NodeConfig));
-    EEPROM.get(CFG_EEPROM_OFFSET, *c);
+    EEPROM.begin(EEPROM_SIZE);
+    cfgDefaults(c);
 
-    bool valid = (c->magic == CFG_MAGIC && c->cfgVersion == CFG_VERSION);
+    CfgJournal j;
+    cfgjInit(&j, cfgEepromRead, cfgEepromWrite, CFG_JOURNAL_OFFSET, CFG_JOURNAL_SIZE);
+    int applied = cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, c);
+    bool valid = applied >= 0;
 
-    if (!valid) {
-        /* First boot, blank EEPROM, or struct layout changed — use defaults.
-         * Don't write to EEPROM; the user must opt in with UPDATE_CFG=1. */
-        if (c->magic != CFG_MAGIC)
-            DBG("[CFG] load: magic mismatch (0x%02X != 0x%02X)\n",
-                c->magic, CFG_MAGIC);
-        if (c->cfgVersion != CFG_VERSION)
-            DBG("[CFG] load: version mismatch (%u != %u)\n",
-                c->cfgVersion, CFG_VERSION);
-
-        /* Reset to defaults, invalid content in EEPROM */
-        DBG("[CFG] load: using compile-time defaults\n");
-        cfgDefaults(c);
+    if (valid) {
+        DBG("[CFG] load: %d records from journal (%u/%u bytes)%s\n",
+            applied, j.tail, j.size, j.clean ? "" : ", damaged tail");
     } else {
-        /* Content loaded from EEPROM valid */
-        DBG("[CFG] load: valid config from EEPROM (v%u)\n", c->cfgVersion);
+        /* Pre-journal firmware: import its struct image */
+        uint8_t legacy[CFG_LEGACY_MAX_SIZE];
+        for (int i = 0; i < CFG_LEGACY_MAX_SIZE; i++)
+            legacy[i] = EEPROM.read(CFG_EEPROM_OFFSET + i);
+        int n = cfgLegacyImport(legacy, c);
+        if (n >= 0) {
+            DBG("[CFG] load: imported %d fields from v%u config\n", n, legacy[1]);
+            valid = true;
+        }
+    }
+
+    if (!valid) {
+        /* First boot or blank EEPROM.  Don't write to EEPROM; the user
+         * must opt in with savecfg or UPDATE_CFG=1. */
+        DBG("[CFG] load: no config in EEPROM, using compile-time defaults\n");
     }
 
 #if UPDATE_CFG
@@ -216,4 +274,87 @@ static inline bool cfgLoad(NodeConfig *c)
     return valid;
 }
 
+/* ─── Profiles (EEPROM offset 480) ────────────────────────────────────────── */
+
+/*
+ * A profile is a named NodeConfig snapshot: each slot is a compacted
+ * journal (one record per field, same IDs as the live config) followed by
+ * a label record, so profiles saved by older firmware load the same way
+ * the live config does.
+ */
+static inline void cfgProfileSlot(CfgJournal *j, int slot)
+{
+    cfgjInit(j, cfgEepromRead, cfgEepromWrite,
+             (uint16_t)(CFG_PROFILE_OFFSET + slot * CFG_PROFILE_SLOT_SIZE),
+             CFG_PROFILE_SLOT_SIZE);
+}
+
+/* Slot holding `name`, or -1 */
+static inline int cfgProfileFind(const char *name)
+{
+    char label[CFG_PROFILE_NAME_MAX + 1];
+    for (int i = 0; i < CFG_PROFILE_SLOTS; i++) {
+        CfgJournal j;
+        cfgProfileSlot(&j, i);
+        if (cfgjName(&j, label) && strcmp(label, name) == 0) return i;
+    }
+    return -1;
+}
+
+/* Slot i's name into name[CFG_PROFILE_NAME_MAX + 1]; false if empty */
+static inline bool cfgProfileName(int slot, char *name)
+{
+    CfgJournal j;
+    cfgProfileSlot(&j, slot);
+    return cfgjName(&j, name);
+}
+
+/*
+ * Overlay profile `name` onto *c.  Fields the profile doesn't hold (added
+ * since it was saved) keep their current values.  False if no such profile.
+ */
+static inline bool cfgProfileLoad(const char *name, NodeConfig *c)
+{
+    int slot = cfgProfileFind(name);
+    if (slot < 0) return false;
+    CfgJournal j;
+    cfgProfileSlot(&j, slot);
+    return cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, c) >= 0;
+}
+
+/*
+ * Store *c as profile `name`, replacing a profile of the same name or
+ * taking the first free slot.  False if the name is invalid or all slots
+ * are taken.
+ */
+static inline bool cfgProfileSave(const char *name, const NodeConfig *c)
+{
+    size_t len = strlen(name);
+    if (len == 0 || len > CFG_PROFILE_NAME_MAX) return false;
+
+    int slot = cfgProfileFind(name);
+    char label[CFG_PROFILE_NAME_MAX + 1];
+    for (int i = 0; slot < 0 && i < CFG_PROFILE_SLOTS; i++)
+        if (!cfgProfileName(i, label)) slot = i;
+    if (slot < 0) return false;
+
+    CfgJournal j;
+    cfgProfileSlot(&j, slot);
+    if (!cfgjCompact(&j, cfgFields, CFG_FIELD_COUNT, c) || !cfgjPutName(&j, name))
+        return false;
+    EEPROM.commit();
+    DBG("[CFG] profile \"%s\" saved to slot %d (%u bytes)\n", name, slot, j.tail);
+    return true;
+}
+
+static inline bool cfgProfileDelete(const char *name)
+{
+    int slot = cfgProfileFind(name);
+    if (slot < 0) return false;
+    EEPROM.write(CFG_PROFILE_OFFSET + slot * CFG_PROFILE_SLOT_SIZE, CFGJ_ERASED);
+    EEPROM.commit();
+    DBG("[CFG] profile \"%s\" deleted from slot %d\n", name, slot);
+    return true;
+}
+
 #endif /* CONFIG_H */
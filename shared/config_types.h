@@ -7,9 +7,14 @@
  * EEPROM layout:
  *   Byte 0:      NODE_ID_MAGIC (0x4E)  — "has node ID been written?"
  *   Bytes 1-16:  nodeId[16]            — unversioned, permanent
- *   Byte 17:     CFG_MAGIC (0xCF)      — "has config been written?"
- *   Byte 18:     cfgVersion (4)        — "is the layout current?"
- *   Bytes 19+:   config fields         — versioned, can grow
+ *   Bytes 17-479:  config journal      — TLV records keyed by field ID
+ *                                        (see cfg_journal.h)
+ *   Bytes 480-767: profile slots       — 3 × 96B named snapshots, each a
+ *                                        compacted journal plus a label
+ *
+ * Older firmware stored NodeConfig itself at byte 17 (CFG_MAGIC, then
+ * cfgVersion); that image is imported once on the first boot after the
+ * update.
  */
 
 #ifndef CONFIG_TYPES_H
@@ -18,6 +23,8 @@
 #include <stdint.h>
 #include <stddef.h>
 
+#include "cfg_journal.h"
+
 /* ─── Node Identity (bytes 0-16, unversioned) ────────────────────────────── */
 
 #define NODE_ID_MAGIC 0x4E        /* Sentinel — "has node ID been written?" */
@@ -30,10 +37,22 @@ typedef struct __attribute__((packed)) {
 #define NODEID_REGION_SIZE  sizeof(NodeIdentity)   /* 17 */
 #define CFG_EEPROM_OFFSET   NODEID_REGION_SIZE     /* NodeConfig starts here */
 
-/* ─── Versioned Config (bytes 17+, resets on CFG_VERSION bump) ───────────── */
+/* ─── Config (bytes 17+, journaled by field ID) ──────────────────────────── */
+
+#define EEPROM_SIZE         768
 
+#define CFG_PROFILE_SLOTS     3
+#define CFG_PROFILE_SLOT_SIZE 96
+#define CFG_PROFILE_NAME_MAX  CFGJ_MAX_VALUE
+#define CFG_PROFILE_OFFSET    (EEPROM_SIZE - CFG_PROFILE_SLOTS * CFG_PROFILE_SLOT_SIZE)
+
+#define CFG_JOURNAL_OFFSET  CFG_EEPROM_OFFSET
+#define CFG_JOURNAL_SIZE    (CFG_PROFILE_OFFSET - CFG_JOURNAL_OFFSET)
+
+/* Legacy whole-struct image header.  Frozen: NodeConfig changes no longer
+ * need a version bump, just a new field ID below. */
 #define CFG_MAGIC       0xCF      /* Sentinel — "has config been written?"  */
-#define CFG_VERSION     4         /* Bump when NodeConfig fields change     */
+#define CFG_VERSION     8         /* Last whole-struct layout (import only) */
 
 typedef struct __attribute__((packed)) NodeConfig {
     uint8_t  magic;              /*  1B — CFG_MAGIC when written            */
@@ -48,6 +67,128 @@ typedef struct __attribute__((packed)) NodeConfig {
     uint16_t bme280RateSec;      /*  2B — BME280 sample interval (seconds)  */
     uint16_t battRateSec;        /*  2B — Battery sample interval (seconds) */
     uint16_t gpsRateSec;         /*  2B — GPS sample interval (seconds)     */
-} NodeConfig;                    /* 22B at offset 17                        */
+    uint16_t sensorSlackSec;     /*  2B — Sensor coalescing window (seconds) */
+    uint16_t autoSleepSec;       /*  2B — Autosleep RX slot period (0=off)  */
+    uint16_t gpsMinDistM;        /*  2B — GPS report movement threshold (m) */
+    uint16_t gpsFastKmh;         /*  2B — GPS fast-rate speed (km/h, 0=off) */
+    uint16_t gpsFastRateSec;     /*  2B — GPS interval while fast (seconds) */
+    uint16_t logTxDiv;           /*  2B — Uplink every Nth batch (0=log only) */
+} NodeConfig;                    /* 34B in RAM; magic/cfgVersion not stored */
+
+/*
+ * Stable journal IDs for the persisted NodeConfig fields.  Append new
+ * fields with the next free ID; never renumber or reuse one (a retired
+ * field's ID stays reserved so old records are ignored, not misread).
+ */
+#define CFG_ID_TX_POWER       1
+#define CFG_ID_RX_DUTY        2
+#define CFG_ID_SF             3
+#define CFG_ID_BW             4
+#define CFG_ID_N2G_FREQ       5
+#define CFG_ID_G2N_FREQ       6
+#define CFG_ID_ACK_JITTER     7
+#define CFG_ID_BME280_RATE    8
+#define CFG_ID_BATT_RATE      9
+#define CFG_ID_GPS_RATE       10
+#define CFG_ID_SENSOR_SLACK   11
+#define CFG_ID_AUTOSLEEP      12
+#define CFG_ID_GPS_MIN_DIST   13
+#define CFG_ID_GPS_FAST_KMH   14
+#define CFG_ID_GPS_FAST_RATE  15
+#define CFG_ID_LOG_TXDIV      16
+
+#define CFG_FIELD(id, f) \
+    { id, (uint8_t)offsetof(NodeConfig, f), (uint8_t)sizeof(((NodeConfig *)0)->f) }
+
+static const CfgjField cfgFields[] = {
+    CFG_FIELD(CFG_ID_TX_POWER,      txOutputPower),
+    CFG_FIELD(CFG_ID_RX_DUTY,       rxDutyPercent),
+    CFG_FIELD(CFG_ID_SF,            spreadingFactor),
+    CFG_FIELD(CFG_ID_BW,            bandwidth),
+    CFG_FIELD(CFG_ID_N2G_FREQ,      n2gFrequencyHz),
+    CFG_FIELD(CFG_ID_G2N_FREQ,      g2nFrequencyHz),
+    CFG_FIELD(CFG_ID_ACK_JITTER,    broadcastAckJitterMs),
+    CFG_FIELD(CFG_ID_BME280_RATE,   bme280RateSec),
+    CFG_FIELD(CFG_ID_BATT_RATE,     battRateSec),
+    CFG_FIELD(CFG_ID_GPS_RATE,      gpsRateSec),
+    CFG_FIELD(CFG_ID_SENSOR_SLACK,  sensorSlackSec),
+    CFG_FIELD(CFG_ID_AUTOSLEEP,     autoSleepSec),
+    CFG_FIELD(CFG_ID_GPS_MIN_DIST,  gpsMinDistM),
+    CFG_FIELD(CFG_ID_GPS_FAST_KMH,  gpsFastKmh),
+    CFG_FIELD(CFG_ID_GPS_FAST_RATE, gpsFastRateSec),
+    CFG_FIELD(CFG_ID_LOG_TXDIV,     logTxDiv),
+};
+
+#define CFG_FIELD_COUNT  (int)(sizeof(cfgFields) / sizeof(cfgFields[0]))
+
+typedef char cfg_field_count_check[(CFG_FIELD_COUNT <= CFGJ_MAX_FIELDS) ? 1 : -1];
+
+/* A profile slot holds every field (magic/cfgVersion aside) plus its label */
+typedef char cfg_profile_slot_check[
+    (CFGJ_HDR_SIZE + (sizeof(NodeConfig) - 2) + CFGJ_REC_OVERHEAD * (CFG_FIELD_COUNT + 1)
+     + CFG_PROFILE_NAME_MAX <= CFG_PROFILE_SLOT_SIZE) ? 1 : -1];
+
+/*
+ * Where the same fields sat in the whole-struct images older firmware
+ * wrote, for the one-time import.  Every layout from CFG_VERSION 4 (the
+ * last released one, 22 bytes) to 8 only appended fields, so each
+ * version's map is a prefix of this one; the version byte picks how much
+ * of it applies.  Frozen — do not update when NodeConfig changes.
+ */
+static const CfgjField cfgLegacyFields[] = {
+    { CFG_ID_TX_POWER,       2, 1 },            /* v4 */
+    { CFG_ID_RX_DUTY,        3, 1 },
+    { CFG_ID_SF,             4, 1 },
+    { CFG_ID_BW,             5, 1 },
+    { CFG_ID_N2G_FREQ,       6, 4 },
+    { CFG_ID_G2N_FREQ,      10, 4 },
+    { CFG_ID_ACK_JITTER,    14, 2 },
+    { CFG_ID_BME280_RATE,   16, 2 },
+    { CFG_ID_BATT_RATE,     18, 2 },
+    { CFG_ID_GPS_RATE,      20, 2 },
+    { CFG_ID_SENSOR_SLACK,  22, 2 },            /* v5 */
+    { CFG_ID_AUTOSLEEP,     24, 2 },            /* v6 */
+    { CFG_ID_GPS_MIN_DIST,  26, 2 },            /* v7 */
+    { CFG_ID_GPS_FAST_KMH,  28, 2 },
+    { CFG_ID_GPS_FAST_RATE, 30, 2 },
+    { CFG_ID_LOG_TXDIV,     32, 2 },            /* v8 */
+};
+
+typedef struct {
+    uint8_t version;            /* cfgVersion byte of the image           */
+    uint8_t fields;             /* leading cfgLegacyFields entries it has */
+    uint8_t size;               /* image bytes, magic/cfgVersion included */
+} CfgLegacyLayout;
+
+static const CfgLegacyLayout cfgLegacyLayouts[] = {
+    { 4, 10, 22 },
+    { 5, 11, 24 },
+    { 6, 12, 26 },
+    { 7, 15, 32 },
+    { CFG_VERSION, 16, 34 },
+};
+
+#define CFG_LEGACY_MAX_SIZE  34
+
+/* Layout for an image's version byte, or NULL if it isn't one we import */
+static inline const CfgLegacyLayout *cfgLegacyLayout(uint8_t version)
+{
+    for (size_t i = 0; i < sizeof(cfgLegacyLayouts) / sizeof(cfgLegacyLayouts[0]); i++)
+        if (cfgLegacyLayouts[i].version == version) return &cfgLegacyLayouts[i];
+    return NULL;
+}
+
+/*
+ * Import a whole-struct image (starting at its magic byte, at least
+ * CFG_LEGACY_MAX_SIZE bytes readable) into *c.  Returns the fields
+ * copied, or -1 if img isn't a known legacy image.
+ */
+static inline int cfgLegacyImport(const uint8_t *img, NodeConfig *c)
+{
+    if (img[0] != CFG_MAGIC) return -1;
+    const CfgLegacyLayout *l = cfgLegacyLayout(img[1]);
+    if (!l) return -1;
+    return cfgjImport(cfgLegacyFields, l->fields, img, cfgFields, CFG_FIELD_COUNT, c);
+}
 
 #endif /* CONFIG_TYPES_H */
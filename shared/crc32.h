@@ -0,0 +1,210 @@
+/*
+ * crc32.h — CRC-32 engine with selectable table strategies
+ *
+ * Standard CRC-32 (ISO 3309 / ITU-T V.42) — identical to Python
+ * zlib.crc32().  Bit-reversed polynomial 0xEDB88320.
+ *
+ * Strategies (pick with -DCRC32_STRATEGY=...):
+ *   CRC32_BYTE    1 KB table in flash, one lookup per byte (MCU default)
+ *   CRC32_NIBBLE  64-byte table, two lookups per byte, for flash-starved
+ *                 builds
+ *   CRC32_SLICE4  4 KB of RAM tables, 4 bytes per step
+ *   CRC32_SLICE8  8 KB of RAM tables, 8 bytes per step (host default;
+ *                 the slicing tables are too big for the AB01's 16 KB RAM)
+ *
+ * The byte and nibble tables are generated by the preprocessor, so no
+ * hand-typed constants and no startup cost; the slicing tables are
+ * derived from the byte table on first use.
+ *
+ * The tables are defined exactly once: one translation unit per program
+ * defines CRC32_IMPL before including this header (directly or through
+ * packets.h); every other unit just references them.
+ *   data_log.ino, range_test.ino, tests/test_main.c
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef CRC32_H
+#define CRC32_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/* ─── Strategy Selection ───────────────────────────────────────────────── */
+
+#define CRC32_BYTE    1
+#define CRC32_NIBBLE  2
+#define CRC32_SLICE4  3
+#define CRC32_SLICE8  4
+
+#ifndef CRC32_STRATEGY
+#if defined(__arm__) || defined(__thumb__)
+#define CRC32_STRATEGY CRC32_BYTE
+#else
+#define CRC32_STRATEGY CRC32_SLICE8
+#endif
+#endif
+
+#if CRC32_STRATEGY < CRC32_BYTE || CRC32_STRATEGY > CRC32_SLICE8
+#error "CRC32_STRATEGY must be CRC32_BYTE, CRC32_NIBBLE, CRC32_SLICE4 or CRC32_SLICE8"
+#endif
+
+/* ─── Table Generation ─────────────────────────────────────────────────── */
+
+#define CRC32_POLY 0xEDB88320u
+
+/* One bit of the reflected shift register; S8 is a whole byte */
+#define CRC32_S1(c) (((c) >> 1) ^ (CRC32_POLY & (0u - ((c) & 1u))))
+#define CRC32_S2(c) CRC32_S1(CRC32_S1(c))
+#define CRC32_S4(c) CRC32_S2(CRC32_S2(c))
+#define CRC32_S8(c) CRC32_S4(CRC32_S4(c))
+
+#define CRC32_R4(n)  CRC32_S8((n) + 0u), CRC32_S8((n) + 1u), \
+                     CRC32_S8((n) + 2u), CRC32_S8((n) + 3u)
+#define CRC32_R16(n) CRC32_R4((n) + 0u), CRC32_R4((n) + 4u), \
+                     CRC32_R4((n) + 8u), CRC32_R4((n) + 12u)
+#define CRC32_R64(n) CRC32_R16((n) + 0u),  CRC32_R16((n) + 16u), \
+                     CRC32_R16((n) + 32u), CRC32_R16((n) + 48u)
+
+#define CRC32_N4(n)  CRC32_S4((n) + 0u), CRC32_S4((n) + 1u), \
+                     CRC32_S4((n) + 2u), CRC32_S4((n) + 3u)
+
+/* ─── Tables ───────────────────────────────────────────────────────────── */
+
+#if CRC32_STRATEGY == CRC32_SLICE4 && !defined(CRC32_ALL_STRATEGIES)
+#define CRC32_SLICES 4
+#else
+#define CRC32_SLICES 8
+#endif
+
+extern const uint32_t CRC32_TABLE[256];
+extern const uint32_t CRC32_NIBBLE_TABLE[16];
+extern uint32_t       crc32SliceTable[CRC32_SLICES][256];
+extern uint8_t        crc32SliceReady;
+
+#ifdef CRC32_IMPL
+
+/* CRC32_ALL_STRATEGIES (benchmarks) keeps every table in the build */
+#if CRC32_STRATEGY != CRC32_NIBBLE || defined(CRC32_ALL_STRATEGIES)
+const uint32_t CRC32_TABLE[256] = {
+    CRC32_R64(0u), CRC32_R64(64u), CRC32_R64(128u), CRC32_R64(192u)
+};
+#endif
+
+#if CRC32_STRATEGY == CRC32_NIBBLE || defined(CRC32_ALL_STRATEGIES)
+const uint32_t CRC32_NIBBLE_TABLE[16] = {
+    CRC32_N4(0u), CRC32_N4(4u), CRC32_N4(8u), CRC32_N4(12u)
+};
+#endif
+
+#if CRC32_STRATEGY >= CRC32_SLICE4 || defined(CRC32_ALL_STRATEGIES)
+uint32_t crc32SliceTable[CRC32_SLICES][256];
+uint8_t  crc32SliceReady = 0;
+#endif
+
+#endif /* CRC32_IMPL */
+
+/* ─── Per-Strategy Updates ─────────────────────────────────────────────── */
+
+/*
+ * All take and return the finished CRC (zlib convention), so
+ * crc32_update(crc32_update(0, a, n), b, m) == CRC of a followed by b.
+ */
+
+static inline uint32_t crc32_update_byte(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (len--)
+        crc = CRC32_TABLE[(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+static inline uint32_t crc32_update_nibble(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    crc = ~crc;
+    while (len--) {
+        crc ^= *p++;
+        crc = CRC32_NIBBLE_TABLE[crc & 0x0Fu] ^ (crc >> 4);
+        crc = CRC32_NIBBLE_TABLE[crc & 0x0Fu] ^ (crc >> 4);
+    }
+    return ~crc;
+}
+
+/* Table k: CRC of byte n followed by k zero bytes */
+static inline void crc32SliceInit(void)
+{
+    for (int n = 0; n < 256; n++) crc32SliceTable[0][n] = CRC32_TABLE[n];
+    for (int k = 1; k < CRC32_SLICES; k++)
+        for (int n = 0; n < 256; n++) {
+            uint32_t c = crc32SliceTable[k - 1][n];
+            crc32SliceTable[k][n] = CRC32_TABLE[c & 0xFFu] ^ (c >> 8);
+        }
+    crc32SliceReady = 1;
+}
+
+/* Little-endian word load that works on any host byte order/alignment */
+static inline uint32_t crc32Load32(const uint8_t *p)
+{
+    return (uint32_t)p[0] | ((uint32_t)p[1] << 8) |
+           ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint32_t crc32_update_slice4(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    const uint32_t (*t)[256] = (const uint32_t (*)[256])crc32SliceTable;
+    if (!crc32SliceReady) crc32SliceInit();
+    crc = ~crc;
+    for (; len >= 4; len -= 4, p += 4) {
+        uint32_t w = crc ^ crc32Load32(p);
+        crc = t[3][w & 0xFFu] ^ t[2][(w >> 8) & 0xFFu] ^
+              t[1][(w >> 16) & 0xFFu] ^ t[0][w >> 24];
+    }
+    while (len--)
+        crc = t[0][(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+static inline uint32_t crc32_update_slice8(uint32_t crc, const void *data, size_t len)
+{
+    const uint8_t *p = (const uint8_t *)data;
+    const uint32_t (*t)[256] = (const uint32_t (*)[256])crc32SliceTable;
+    if (!crc32SliceReady) crc32SliceInit();
+    crc = ~crc;
+    for (; len >= 8; len -= 8, p += 8) {
+        uint32_t w = crc ^ crc32Load32(p);
+        uint32_t v = crc32Load32(p + 4);
+        crc = t[7][w & 0xFFu] ^ t[6][(w >> 8) & 0xFFu] ^
+              t[5][(w >> 16) & 0xFFu] ^ t[4][w >> 24] ^
+              t[3][v & 0xFFu] ^ t[2][(v >> 8) & 0xFFu] ^
+              t[1][(v >> 16) & 0xFFu] ^ t[0][v >> 24];
+    }
+    while (len--)
+        crc = t[0][(crc ^ *p++) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+/* ─── Public API ───────────────────────────────────────────────────────── */
+
+/* Continue a CRC over more data; start with crc = 0 */
+static inline uint32_t crc32_update(uint32_t crc, const void *data, size_t len)
+{
+#if CRC32_STRATEGY == CRC32_NIBBLE
+    return crc32_update_nibble(crc, data, len);
+#elif CRC32_STRATEGY == CRC32_SLICE4
+    return crc32_update_slice4(crc, data, len);
+#elif CRC32_STRATEGY == CRC32_SLICE8
+    return crc32_update_slice8(crc, data, len);
+#else
+    return crc32_update_byte(crc, data, len);
+#endif
+}
+
+static inline uint32_t crc32_compute(const char *data, size_t len)
+{
+    return crc32_update(0, data, len);
+}
+
+#endif /* CRC32_H */
@@ -2,8 +2,40 @@
  * dbg.h — Shared debug output macros
  *
  * Controlled by the DEBUG compile-time flag (Makefile: DEBUG=0 or DEBUG=1).
- * Uses Serial.printf — do NOT include in sketches that use Serial for
- * other purposes (e.g., range_test uses Serial for GPS).
+ * Uses Serial — do NOT include in sketches that use Serial for other
+ * purposes (e.g., range_test uses Serial for GPS).
+ *
+ * Two back ends, picked with DBG_TOKENIZE:
+ *
+ *   0 (default)  DBG() is Serial.printf: readable on any serial monitor,
+ *                but each call blocks on the 115200-baud UART (~87 µs
+ *                per character) and every format string sits in flash.
+ *
+ *   1            Tokenized: a call site pushes its 16-bit ID and its
+ *                arguments, binary-packed, into a RAM ring — a few µs,
+ *                safe in the radio callbacks.  The loop drains the ring
+ *                to Serial at its idle point (dbgDrain) and before deep
+ *                sleep or reset (dbgFlush).  Format strings go to the
+ *                non-loaded .dbgfmt ELF section: kept in the .elf for
+ *                the host, never flashed.  Decode with
+ *                  tools/dbgdecode.py build/data_log/data_log.ino.elf /dev/ttyUSB0
+ *
+ * Call-site ID = DBG_FILE_ID << 11 | __COUNTER__.  Every translation unit
+ * that includes this header defines a unique DBG_FILE_ID (1-31) first:
+ *   1 data_log.ino   2 commands.cpp   3 sensor_drv.cpp
+ *   4 bme280_sensor.cpp   5 batt_sensor.cpp   6 flash_log.cpp
+ * ID 0 is reserved for the "records dropped" marker.  One unit per
+ * program defines DBG_IMPL to own the ring (data_log.ino).
+ *
+ * Tokenized arguments: integers (≤ 32 bits) and pointers-to-char only,
+ * packed as 4 bytes LE / float / length-prefixed string (truncated to
+ * DBG_STR_MAX).  DBGLN()/DBGP() take string literals.
+ *
+ * Wire frame: A5 len id_lo id_hi args[len] sum, where sum is the low
+ * byte of len + id + args.
+ *
+ * The ring/frame layer below is static inline with no Arduino deps so it
+ * can be tested natively; the Serial glue is C++ only.
  *
  * Named dbg.h (not debug.h) to avoid collision with CubeCell core's
  * board/inc/debug.h which is on the include path.
@@ -12,15 +44,240 @@
 #ifndef DBG_H
 #define DBG_H
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "ringbuf.h"
+
 #ifndef DEBUG
 #define DEBUG 1
 #endif
 
+#ifndef DBG_TOKENIZE
+#define DBG_TOKENIZE 0
+#endif
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#ifndef DBG_RING_SIZE
+#define DBG_RING_SIZE      512      /* power of two; ~30 typical records   */
+#endif
+
+#ifndef DBG_DRAIN_BYTES
+#define DBG_DRAIN_BYTES    64       /* per idle pass: ~5.5 ms of UART      */
+#endif
+
+#define DBG_ARGS_MAX       40       /* packed argument bytes per record    */
+#define DBG_STR_MAX        24       /* string argument bytes kept          */
+#define DBG_FRAME_SYNC     0xA5
+#define DBG_FRAME_MAX      (DBG_ARGS_MAX + 5)
+#define DBG_ID_DROPPED     0        /* args: u32 records lost              */
+
+/* ─── Argument Packing ───────────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t buf[DBG_ARGS_MAX];
+    uint8_t len;
+    uint8_t full;       /* an argument didn't fit: the rest are left off */
+} DbgArgs;
+
+static inline void dbgArgsInit(DbgArgs *a)
+{
+    a->len  = 0;
+    a->full = 0;
+}
+
+/* Arguments that don't fit are left off; the decoder prints "?" */
+static inline void dbgArgU32(DbgArgs *a, uint32_t v)
+{
+    if (a->full || a->len + 4 > DBG_ARGS_MAX) { a->full = 1; return; }
+    for (int i = 0; i < 4; i++) a->buf[a->len++] = (uint8_t)(v >> (8 * i));
+}
+
+static inline void dbgArgF32(DbgArgs *a, float f)
+{
+    uint32_t v;
+    memcpy(&v, &f, sizeof(v));
+    dbgArgU32(a, v);
+}
+
+static inline void dbgArgStr(DbgArgs *a, const char *s)
+{
+    if (!s) s = "(null)";
+    size_t n = strlen(s);
+    if (n > DBG_STR_MAX) n = DBG_STR_MAX;
+    if (a->full || a->len + 1 + n > DBG_ARGS_MAX) { a->full = 1; return; }
+    a->buf[a->len++] = (uint8_t)n;
+    memcpy(&a->buf[a->len], s, n);
+    a->len = (uint8_t)(a->len + n);
+}
+
+/* ─── Ring ───────────────────────────────────────────────────────────────── */
+
+/*
+ * Queue one record ([len][id_lo][id_hi][args]) whole or not at all, so
+ * the ring never holds a torn record.  Records that don't fit are
+ * counted in *dropped; the next one that does is preceded by a
+ * DBG_ID_DROPPED record, keeping the gap in order in the stream.
+ */
+static inline bool dbgLogPut(RingBuf *r, uint32_t *dropped, uint16_t id,
+                             const DbgArgs *a)
+{
+    uint16_t need = (uint16_t)(3 + a->len + (*dropped ? 7 : 0));
+    if (ringCapacity(r) - ringCount(r) < need) {
+        (*dropped)++;
+        return false;
+    }
+    if (*dropped) {
+        DbgArgs d;
+        dbgArgsInit(&d);
+        dbgArgU32(&d, *dropped);
+        *dropped = 0;
+        dbgLogPut(r, dropped, DBG_ID_DROPPED, &d);
+    }
+    ringPush(r, a->len);
+    ringPush(r, (uint8_t)id);
+    ringPush(r, (uint8_t)(id >> 8));
+    for (uint8_t i = 0; i < a->len; i++) ringPush(r, a->buf[i]);
+    return true;
+}
+
+/*
+ * Pop the next record into a wire frame (out holds DBG_FRAME_MAX).
+ * Returns the frame length, or 0 when there is nothing to send.  An
+ * outstanding drop count is reported once the ring has emptied.
+ */
+static inline int dbgLogFrame(RingBuf *r, uint32_t *dropped, uint8_t *out)
+{
+    uint8_t len, lo, hi;
+    if (!ringPop(r, &len)) {
+        if (!*dropped) return 0;
+        DbgArgs d;
+        dbgArgsInit(&d);
+        dbgArgU32(&d, *dropped);
+        *dropped = 0;
+        len = d.len;
+        lo = hi = 0;
+        memcpy(&out[4], d.buf, len);
+    } else {
+        ringPop(r, &lo);
+        ringPop(r, &hi);
+        for (uint8_t i = 0; i < len; i++) ringPop(r, &out[4 + i]);
+    }
+
+    out[0] = DBG_FRAME_SYNC;
+    out[1] = len;
+    out[2] = lo;
+    out[3] = hi;
+    uint8_t sum = 0;
+    for (int i = 1; i < 4 + len; i++) sum = (uint8_t)(sum + out[i]);
+    out[4 + len] = sum;
+    return 5 + len;
+}
+
+/* ─── Macros ─────────────────────────────────────────────────────────────── */
+
+#if DBG_TOKENIZE && defined(__cplusplus)
+
+#ifndef DBG_FILE_ID
+#error "define DBG_FILE_ID (see dbg.h) before including dbg.h when DBG_TOKENIZE=1"
+#endif
+
+extern RingBuf  dbgRing;
+extern uint32_t dbgDropped;
+
+#ifdef DBG_IMPL
+static uint8_t dbgRingStore[DBG_RING_SIZE];
+RingBuf  dbgRing = { dbgRingStore, DBG_RING_SIZE - 1, 0, 0, 0, 0 };
+uint32_t dbgDropped = 0;
+#endif
+
+/* Overloads pick the packing from the argument's type; narrower
+ * integers, bool and enums promote to int */
+static inline void dbgArg(DbgArgs &a, int v)           { dbgArgU32(&a, (uint32_t)v); }
+static inline void dbgArg(DbgArgs &a, unsigned v)      { dbgArgU32(&a, (uint32_t)v); }
+static inline void dbgArg(DbgArgs &a, long v)          { dbgArgU32(&a, (uint32_t)v); }
+static inline void dbgArg(DbgArgs &a, unsigned long v) { dbgArgU32(&a, (uint32_t)v); }
+static inline void dbgArg(DbgArgs &a, double v)        { dbgArgF32(&a, (float)v); }
+static inline void dbgArg(DbgArgs &a, const char *s)   { dbgArgStr(&a, s); }
+
+static inline void dbgPack(DbgArgs &) {}
+
+template <typename T, typename... Rest>
+static inline void dbgPack(DbgArgs &a, T v, Rest... rest)
+{
+    dbgArg(a, v);
+    dbgPack(a, rest...);
+}
+
+/* Format record: ID, then "file:line\0format\0" */
+#if defined(__arm__)
+/* '@' starts an ARM assembler comment, dropping GCC's "a" (allocated)
+ * flag: the section stays in the .elf but is never loaded to flash */
+#define DBG_SECTION __attribute__((section(".dbgfmt,\"\",%progbits @"), used, aligned(2)))
+#else
+#define DBG_SECTION __attribute__((section(".dbgfmt"), used, aligned(2)))
+#endif
+
+#define DBG_XSTR_(x) #x
+#define DBG_XSTR(x)  DBG_XSTR_(x)
+#define DBG_ID(n)    ((uint16_t)(((DBG_FILE_ID) << 11) | ((n) & 0x7FF)))
+
+#define DBG_LOG_AT(n, fmt, ...) do {                                        \
+        static const struct {                                               \
+            uint16_t id;                                                    \
+            char     s[sizeof(__FILE__ ":" DBG_XSTR(__LINE__) "\0" fmt)];    \
+        } dbgFmt_ DBG_SECTION =                                             \
+            { DBG_ID(n), __FILE__ ":" DBG_XSTR(__LINE__) "\0" fmt };         \
+        (void)dbgFmt_;                                                      \
+        DbgArgs dbgArgs_;                                                   \
+        dbgArgsInit(&dbgArgs_);                                             \
+        dbgPack(dbgArgs_, ##__VA_ARGS__);                                   \
+        dbgLogPut(&dbgRing, &dbgDropped, DBG_ID(n), &dbgArgs_);             \
+    } while (0)
+
+#define DBG_LOG(fmt, ...) DBG_LOG_AT(__COUNTER__, fmt, ##__VA_ARGS__)
+
+/* Send up to `budget` bytes of queued frames (whole frames only) */
+static inline void dbgDrain(int budget)
+{
+    uint8_t frame[DBG_FRAME_MAX];
+    while (budget > 0) {
+        int n = dbgLogFrame(&dbgRing, &dbgDropped, frame);
+        if (n == 0) break;
+        Serial.write(frame, (size_t)n);
+        budget -= n;
+    }
+}
+
+/* Send everything and wait for the UART: before sleep or reset */
+static inline void dbgFlush(void)
+{
+    dbgDrain(0x7FFF);
+    Serial.flush();
+}
+
+#if DEBUG
+  #define DBG(fmt, ...)  DBG_LOG(fmt, ##__VA_ARGS__)
+  #define DBGLN(msg)     DBG_LOG(msg "\n")
+  #define DBGP(msg)      DBG_LOG(msg)
+#endif
+
+#else /* direct Serial output */
+
+#define DBG_LOG(fmt, ...) Serial.printf(fmt, ##__VA_ARGS__)
+#define dbgDrain(budget)  ((void)0)
+#define dbgFlush()        ((void)0)
+
 #if DEBUG
-  #define DBG(fmt, ...)  Serial.printf(fmt, ##__VA_ARGS__)
+  #define DBG(fmt, ...)  DBG_LOG(fmt, ##__VA_ARGS__)
   #define DBGLN(msg)     Serial.println(msg)
   #define DBGP(msg)      Serial.print(msg)
-#else
+#endif
+
+#endif /* DBG_TOKENIZE */
+
+#if !DEBUG
   #define DBG(fmt, ...)  ((void)0)
   #define DBGLN(msg)     ((void)0)
   #define DBGP(msg)      ((void)0)
@@ -0,0 +1,256 @@
+#ifndef GPS_SERVICE_H
+#define GPS_SERVICE_H
+
+/*
+ * Header-only NEO-6M GPS service shared by the datalog and range test
+ * sketches.
+ *
+ * Wraps the wire-protocol parser with the bits both sketches need on top
+ * of it: draining the hardware UART (the AB01's only one — GPS owns
+ * Serial), noticing when the module goes quiet, and timestamping fixes.
+ * Values stay in fixed point until the caller converts them for a Reading.
+ *
+ * GPS_UBX=1 switches from NMEA (nmea.h) to UBX binary (ubx.h): the module
+ * is reconfigured for NAV-POSLLH/NAV-SOL only in power save mode, and
+ * gpsServiceSleep() can park it in backup between samples.  Config lives
+ * in the module's RAM, so it is re-sent whenever NMEA shows up again
+ * (cold boot, Vext power cycle).
+ *
+ * UART bytes are moved into a ring (ringbuf.h) by a TimerEvent that polls
+ * Serial every GPS_RING_POLL_MS — the core's UART RX buffer is filled by
+ * its own interrupt, but is too small to outlast a long loop pass on its
+ * own.  gpsServiceFeed() drains the ring into the parser whenever the
+ * main loop gets to it.  The timer only runs while the module is
+ * powered: gpsServiceSuspend() stops it, gpsServiceResume() restarts it.
+ *
+ * All functions are static — each sketch gets its own copy, same as led.h.
+ */
+
+#include "Arduino.h"
+#include "LoRaWan_APP.h"    /* TimerEvent_t */
+#include "nmea.h"
+#include "ringbuf.h"
+
+/* ─── Configuration ─────────────────────────────────────────────────────── */
+
+#ifndef GPS_UBX
+#define GPS_UBX 0
+#endif
+
+#define GPS_BAUD 9600
+
+/* If no UART chars arrive for this long, consider GPS disconnected */
+#define GPS_UART_TIMEOUT_MS 2000
+
+/* UART → ring poll period: ~10 bytes at 9600 baud */
+#define GPS_RING_POLL_MS 10
+
+/*
+ * Ring size (power of two), sized for the longest stretch the loop may go
+ * without feeding the GPS.  In data_log nothing blocks for long any more
+ * (TX is queued, LED patterns and reset delays run as tasks), so about
+ * 1 s is plenty: full NMEA peaks near 960 B/s, UBX NAV-POSLLH + NAV-SOL
+ * is ~100 B/s.  A sketch with longer blocking waits defines its own size
+ * before including this header.
+ */
+#ifndef GPS_RING_SIZE
+#if GPS_UBX
+#define GPS_RING_SIZE 256
+#else
+#define GPS_RING_SIZE 1024
+#endif
+#endif
+
+#if GPS_UBX
+#include "ubx.h"
+
+/* Minimum spacing between config bursts while NMEA keeps arriving */
+#define GPS_UBX_CONFIG_RETRY_MS 1000
+
+typedef UbxParser GpsParser;
+#define gpsParserInit   ubxInit
+#define gpsParserEncode ubxEncode
+#define gpsParserTake   ubxTakeUpdated
+#else
+typedef NmeaParser GpsParser;
+#define gpsParserInit   nmeaInit
+#define gpsParserEncode nmeaEncode
+#define gpsParserTake   nmeaTakeUpdated
+#endif
+
+/* ─── State ─────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    GpsParser     parser;           /* .fix, .chars, .passed, .failed       */
+    unsigned long lastCharTime;     /* millis() of last UART byte, 0 = never */
+    unsigned long lastFixTime;      /* millis() of last location, 0 = never  */
+    RingBuf       ring;             /* filled by the poll timer             */
+    uint8_t       ringStore[GPS_RING_SIZE];
+#if GPS_UBX
+    bool          needConfig;       /* module is talking NMEA               */
+    unsigned long lastConfigTime;
+    bool          asleep;           /* in RXM-PMREQ backup                  */
+    unsigned long sleepStart;
+    unsigned long sleepMs;
+#endif
+} GpsService;
+
+/* ─── UART Ring ─────────────────────────────────────────────────────────── */
+
+static TimerEvent_t gpsRingTimer;
+static GpsService  *gpsRingOwner;
+
+/* Producer: Serial → ring.  Timer callback, or main loop with IRQs masked. */
+static void gpsServiceFill(GpsService *g)
+{
+    while (Serial.available() > 0)
+        ringPush(&g->ring, (uint8_t)Serial.read());
+}
+
+static void gpsRingTick(void)
+{
+    if (gpsRingOwner) gpsServiceFill(gpsRingOwner);
+    TimerStart(&gpsRingTimer);      /* re-arm with the same period */
+}
+
+/* Stop polling while the module is unpowered (rail down, deep sleep) —
+ * the timer would keep waking the MCU for a UART with nothing on it */
+static void gpsServiceSuspend(GpsService *g)
+{
+    (void)g;
+    TimerStop(&gpsRingTimer);
+}
+
+/* ─── UBX Configuration ─────────────────────────────────────────────────── */
+
+#if GPS_UBX
+static void gpsServiceSend(const uint8_t *buf, int len)
+{
+    if (len > 0) Serial.write(buf, len);
+}
+
+/* NMEA off, NAV-POSLLH + NAV-SOL every 1 s epoch, power save mode */
+static void gpsServiceConfigure(GpsService *g)
+{
+    uint8_t buf[16];
+
+    /* GGA, GLL, GSA, GSV, RMC, VTG */
+    for (uint8_t id = 0; id <= 5; id++)
+        gpsServiceSend(buf, ubxCfgMsg(buf, sizeof(buf), UBX_CLASS_NMEA, id, 0));
+    gpsServiceSend(buf, ubxCfgMsg(buf, sizeof(buf), UBX_CLASS_NAV, UBX_NAV_POSLLH, 1));
+    gpsServiceSend(buf, ubxCfgMsg(buf, sizeof(buf), UBX_CLASS_NAV, UBX_NAV_SOL, 1));
+    gpsServiceSend(buf, ubxCfgRate(buf, sizeof(buf), 1000));
+    gpsServiceSend(buf, ubxCfgRxm(buf, sizeof(buf), UBX_RXM_POWER_SAVE));
+
+    g->needConfig     = false;
+    g->lastConfigTime = millis();
+}
+
+/*
+ * Put the module into backup for `ms`; it restarts itself (hot start)
+ * when the time is up.  UART silence meanwhile is expected.
+ */
+static void gpsServiceSleep(GpsService *g, unsigned long ms)
+{
+    uint8_t buf[16];
+    gpsServiceSend(buf, ubxRxmPmreq(buf, sizeof(buf), ms));
+    g->asleep     = true;
+    g->sleepStart = millis();
+    g->sleepMs    = ms;
+}
+#endif
+
+/* ─── Functions ─────────────────────────────────────────────────────────── */
+
+static void gpsServiceBegin(GpsService *g)
+{
+    memset(g, 0, sizeof(*g));
+    gpsParserInit(&g->parser);
+    ringInit(&g->ring, g->ringStore, GPS_RING_SIZE);
+    Serial.begin(GPS_BAUD);
+
+    gpsRingOwner = g;
+    TimerInit(&gpsRingTimer, gpsRingTick);
+    TimerSetValue(&gpsRingTimer, GPS_RING_POLL_MS);
+    TimerStart(&gpsRingTimer);
+#if GPS_UBX
+    gpsServiceConfigure(g);
+#endif
+}
+
+/* UART re-opened after the module was unpowered; parser state is kept */
+static void gpsServiceResume(GpsService *g)
+{
+    Serial.begin(GPS_BAUD);
+    TimerStart(&gpsRingTimer);
+#if GPS_UBX
+    g->asleep     = false;
+    g->needConfig = true;           /* power cycle lost the RAM config */
+#endif
+    /* Fresh UART timeout window — nothing arrived while it was off */
+    if (g->lastCharTime != 0)
+        g->lastCharTime = millis();
+}
+
+/* Drain the ring (and anything still in Serial) into the parser. */
+static void gpsServiceFeed(GpsService *g)
+{
+    noInterrupts();
+    gpsServiceFill(g);
+    interrupts();
+
+    bool got = false;
+    uint8_t c;
+    while (ringPop(&g->ring, &c)) {
+#if GPS_UBX
+        if (c == '$' && g->parser.state == UBX_ST_SYNC1)
+            g->needConfig = true;
+#endif
+        gpsParserEncode(&g->parser, c);
+        got = true;
+    }
+
+    unsigned long now = millis();
+    if (got)
+        g->lastCharTime = now;
+    if (gpsParserTake(&g->parser) & NMEA_HAVE_LOC)
+        g->lastFixTime = now;
+
+#if GPS_UBX
+    if (g->asleep && now - g->sleepStart >= g->sleepMs) {
+        g->asleep = false;
+        g->lastCharTime = now;      /* restart the silence window */
+    }
+    if (g->needConfig && now - g->lastConfigTime >= GPS_UBX_CONFIG_RETRY_MS)
+        gpsServiceConfigure(g);
+#endif
+}
+
+static bool gpsServiceUartActive(const GpsService *g)
+{
+#if GPS_UBX
+    if (g->asleep) return true;     /* quiet on request, not disconnected */
+#endif
+    return g->lastCharTime != 0 &&
+           (millis() - g->lastCharTime) < GPS_UART_TIMEOUT_MS;
+}
+
+static bool gpsServiceHasFix(const GpsService *g)
+{
+    return (g->parser.fix.valid & NMEA_HAVE_LOC) != 0;
+}
+
+/* Milliseconds since the last location update (0xFFFFFFFF if never) */
+static unsigned long gpsServiceFixAgeMs(const GpsService *g)
+{
+    if (g->lastFixTime == 0) return 0xFFFFFFFFUL;
+    return millis() - g->lastFixTime;
+}
+
+/* Fixed point → Reading units */
+static double gpsServiceLat(const GpsService *g)  { return g->parser.fix.lat_e7 / 1e7; }
+static double gpsServiceLon(const GpsService *g)  { return g->parser.fix.lon_e7 / 1e7; }
+static double gpsServiceAltM(const GpsService *g) { return g->parser.fix.alt_cm / 100.0; }
+static uint8_t gpsServiceSats(const GpsService *g) { return g->parser.fix.sats; }
+
+#endif /* GPS_SERVICE_H */
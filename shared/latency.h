@@ -0,0 +1,244 @@
+/*
+ * latency.h — Command turnaround histograms (RX done → ACK TX done)
+ *
+ * How long the gateway must wait before retrying a command is set by the
+ * node's worst turnaround, so each command is timed through its stages:
+ *
+ *   RX done ─parse─▶ parsed ─disp─▶ ACK queued ─q─▶ TX start ─air─▶ TX done
+ *   └──────────────────────────── tot ───────────────────────────────────┘
+ *
+ *   parse  wait in the RX queue + parse/CRC check
+ *   disp   dedup, handler lookup, ACK build; late-ACK handlers run here
+ *   q      TX queue: broadcast jitter hold, radio busy, channel switch
+ *   air    time on air until TX done
+ *
+ * Each stage keeps a log2 histogram of microseconds (bucket k counts
+ * 2^k..2^(k+1)-1 µs; the last one everything above) and its maximum;
+ * each registered command keeps its own count, last and max total.  One
+ * command is traced at a time: a command handled while the previous
+ * ACK is still queued starts a new trace, and a trace whose ACK is
+ * dropped or times out is abandoned.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef LATENCY_H
+#define LATENCY_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "packets.h"    /* CMD_REGISTRY_MAX */
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#define LAT_BUCKETS          24       /* 1 µs .. 8.4 s and up */
+
+typedef enum {
+    LAT_PARSE = 0,
+    LAT_DISPATCH,
+    LAT_QUEUE,
+    LAT_AIR,
+    LAT_TOTAL,
+    LAT_STAGES
+} LatStage;
+
+/* Names used by the "lat" command, indexed by LatStage */
+static const char *const latStageNames[LAT_STAGES] = {
+    "parse", "disp", "q", "air", "tot"
+};
+
+/* ─── State ──────────────────────────────────────────────────────────────── */
+
+/* Marks in stage order: RX done, parsed, ACK queued, TX start */
+#define LAT_MARKS            4
+
+typedef struct {
+    uint32_t at[LAT_MARKS];     /* micros() at each mark                 */
+    uint8_t  marks;             /* marks taken; 0 = no trace             */
+    int8_t   cmd;               /* registry index, -1 = unrecognized     */
+} LatTrace;
+
+typedef struct {
+    uint32_t n;
+    uint32_t lastUs;
+    uint32_t maxUs;
+} LatCmd;
+
+typedef struct {
+    uint16_t hist[LAT_STAGES][LAT_BUCKETS];   /* saturating counts */
+    uint32_t maxUs[LAT_STAGES];
+    uint32_t n;                               /* traces completed */
+    LatCmd   cmd[CMD_REGISTRY_MAX];
+} LatStats;
+
+/* ─── Recording ──────────────────────────────────────────────────────────── */
+
+static inline void latInit(LatStats *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+static inline int latBucket(uint32_t us)
+{
+    int k = 0;
+    while (us > 1 && k < LAT_BUCKETS - 1) {
+        us >>= 1;
+        k++;
+    }
+    return k;
+}
+
+static inline void latAdd(LatStats *s, int stage, uint32_t us)
+{
+    uint16_t *b = &s->hist[stage][latBucket(us)];
+    if (*b < 0xFFFF) (*b)++;
+    if (us > s->maxUs[stage]) s->maxUs[stage] = us;
+}
+
+/* Start a trace at the packet's RX-done time */
+static inline void latBegin(LatTrace *t, uint32_t rxUs)
+{
+    t->at[0] = rxUs;
+    t->marks = 1;
+    t->cmd   = -1;
+}
+
+/* Take mark `i` (1..3); ignored unless it is the next one expected */
+static inline void latMark(LatTrace *t, int i, uint32_t now)
+{
+    if (t->marks != i || i >= LAT_MARKS) return;
+    t->at[i] = now;
+    t->marks++;
+}
+
+static inline void latAbort(LatTrace *t)
+{
+    t->marks = 0;
+}
+
+/* ACK TX done: record every stage.  Returns false if the trace was incomplete. */
+static inline bool latFinish(LatStats *s, LatTrace *t, uint32_t now)
+{
+    if (t->marks != LAT_MARKS) {
+        t->marks = 0;
+        return false;
+    }
+    for (int i = 0; i < LAT_MARKS; i++) {
+        uint32_t end = (i + 1 < LAT_MARKS) ? t->at[i + 1] : now;
+        latAdd(s, i, end - t->at[i]);
+    }
+    uint32_t total = now - t->at[0];
+    latAdd(s, LAT_TOTAL, total);
+    s->n++;
+
+    if (t->cmd >= 0 && t->cmd < CMD_REGISTRY_MAX) {
+        LatCmd *c = &s->cmd[t->cmd];
+        c->n++;
+        c->lastUs = total;
+        if (total > c->maxUs) c->maxUs = total;
+    }
+    t->marks = 0;
+    return true;
+}
+
+/* ─── Reporting ──────────────────────────────────────────────────────────── */
+
+/*
+ * Upper bound (µs) of the bucket holding the pct-th percentile, capped
+ * at the stage maximum.  0 when nothing has been recorded.
+ */
+static inline uint32_t latPercentile(const LatStats *s, int stage, int pct)
+{
+    uint32_t total = 0;
+    for (int k = 0; k < LAT_BUCKETS; k++) total += s->hist[stage][k];
+    if (total == 0) return 0;
+
+    uint32_t want = (total * (uint32_t)pct + 99) / 100;
+    uint32_t seen = 0;
+    for (int k = 0; k < LAT_BUCKETS; k++) {
+        seen += s->hist[stage][k];
+        if (seen >= want && seen > 0) {
+            if (k == LAT_BUCKETS - 1) break;
+            uint32_t hi = (2UL << k) - 1;
+            return hi < s->maxUs[stage] ? hi : s->maxUs[stage];
+        }
+    }
+    return s->maxUs[stage];
+}
+
+/* Stage index by name, or -1 */
+static inline int latStageByName(const char *name)
+{
+    for (int i = 0; i < LAT_STAGES; i++)
+        if (strcmp(latStageNames[i], name) == 0) return i;
+    return -1;
+}
+
+/*
+ * p50 / p99 of every stage:
+ *   {"air":[p50,p99],"disp":[..],"n":N,"parse":[..],"q":[..],"tot":[..]}
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int latFmtSummary(const LatStats *s, char *buf, int bufSize)
+{
+    /* Keys in sorted order, "n" between disp and parse */
+    static const int8_t order[LAT_STAGES] = {
+        LAT_AIR, LAT_DISPATCH, LAT_PARSE, LAT_QUEUE, LAT_TOTAL
+    };
+    int pos = snprintf(buf, bufSize, "{");
+    for (int i = 0; i < LAT_STAGES && pos < bufSize; i++) {
+        int st = order[i];
+        if (st == LAT_PARSE)
+            pos += snprintf(buf + pos, bufSize - pos, ",\"n\":%lu",
+                            (unsigned long)s->n);
+        if (pos >= bufSize) break;
+        pos += snprintf(buf + pos, bufSize - pos, "%s\"%s\":[%lu,%lu]",
+                        i > 0 ? "," : "", latStageNames[st],
+                        (unsigned long)latPercentile(s, st, 50),
+                        (unsigned long)latPercentile(s, st, 99));
+    }
+    if (pos >= bufSize - 1) return 0;
+    buf[pos++] = '}';
+    buf[pos]   = '\0';
+    return pos;
+}
+
+/*
+ * One stage's non-empty buckets as [k,count] pairs, plus max and count:
+ *   {"b":[[9,3],[10,12]],"mx":1630,"n":15}
+ * Buckets that don't fit are left off and flagged with "t":1.
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int latFmtStage(const LatStats *s, int stage, char *buf, int bufSize)
+{
+    /* Longest close: ],"mx":4294967295,"n":4294967295,"t":1} + null */
+    const int closeMax = 40;
+    if (bufSize < 6 + closeMax) return 0;
+
+    int pos = snprintf(buf, bufSize, "{\"b\":[");
+    bool first = true, cut = false;
+    uint32_t n = 0;
+    for (int k = 0; k < LAT_BUCKETS; k++) {
+        uint16_t c = s->hist[stage][k];
+        if (c == 0) continue;
+        n += c;
+        char item[16];
+        int len = snprintf(item, sizeof(item), "%s[%d,%u]", first ? "" : ",",
+                           k, (unsigned)c);
+        if (pos + len + closeMax > bufSize) {
+            cut = true;
+            continue;
+        }
+        memcpy(buf + pos, item, len);
+        pos += len;
+        first = false;
+    }
+    pos += snprintf(buf + pos, bufSize - pos, "],\"mx\":%lu,\"n\":%lu%s}",
+                    (unsigned long)s->maxUs[stage], (unsigned long)n,
+                    cut ? ",\"t\":1" : "");
+    return pos;
+}
+
+#endif /* LATENCY_H */
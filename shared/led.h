@@ -7,12 +7,22 @@
  * All functions are static to provide internal linkage - each translation
  * unit (sketch) gets its own copy. This is the pragmatic approach for
  * Arduino's build model where sketches compile as single TUs.
+ *
+ * The NeoPixel object and the pattern queue are not: there is one LED,
+ * so one translation unit per program defines LED_IMPL before including
+ * this header and every other unit references the same instance.
+ *   data_log.ino, range_test.ino, gps_test.ino
+ *
+ * Timed patterns (ledBlink, ledTest) are queued and return at once;
+ * the sketch calls ledTick() from its loop to play them (see led_seq.h).
+ * A sketch that only ticks while a pattern plays sets ledOnQueue to be
+ * told when one is queued.
  */
 
 #include "Arduino.h"
 #include "CubeCell_NeoPixel.h"
 #include <string.h>
-#include "wdt.h"
+#include "led_seq.h"
 
 /* ─── Configuration ─────────────────────────────────────────────────────── */
 
@@ -46,9 +56,17 @@ typedef enum {
     LED_WHITE        /* All on */
 } LEDColor;
 
-/* ─── Static Instance ───────────────────────────────────────────────────── */
+/* ─── Shared Instance ───────────────────────────────────────────────────── */
 
-static CubeCell_NeoPixel _rgbLed(1, RGB, _LED_PIXEL_TYPE + NEO_KHZ800);
+extern CubeCell_NeoPixel _rgbLed;
+extern LedSeq            ledSeq;
+extern void            (*ledOnQueue)(void);   /* pattern queued, or NULL */
+
+#ifdef LED_IMPL
+CubeCell_NeoPixel _rgbLed(1, RGB, _LED_PIXEL_TYPE + NEO_KHZ800);
+LedSeq            ledSeq;
+void            (*ledOnQueue)(void) = NULL;
+#endif
 
 /* ─── Implementation ────────────────────────────────────────────────────── */
 
@@ -153,64 +171,91 @@ static LEDColor parseColor(const char *colorStr)
     return LED_OFF;
 }
 
+/* ─── Patterns ──────────────────────────────────────────────────────────── */
+
+static void ledQueued(void)
+{
+    if (ledOnQueue) ledOnQueue();
+}
+
 /**
  * Rapid blink: flash a color N times with the given on/off period.
- * Blocking — total time ≈ count * 2 * periodMs.
+ * Queued — plays over ≈ count * 2 * periodMs from the next ledTick().
  */
 static void ledBlink(LEDColor color, int count, unsigned long periodMs,
                      uint8_t brightness = LED_BRIGHTNESS)
 {
-    for (int i = 0; i < count; i++) {
-        ledSetColorBrightness(color, brightness);
-        sleepWdt(periodMs);
-        ledOff();
-        if (i < count - 1) sleepWdt(periodMs);
-    }
+    ledSeqBlink(&ledSeq, color, brightness, count, periodMs);
+    ledQueued();
+}
+
+/**
+ * Show one color for ms, then off.  Replaces any pattern playing.
+ */
+static void ledShowFor(LEDColor color, uint8_t brightness, unsigned long ms)
+{
+    ledSeqClear(&ledSeq);
+    ledSeqPush(&ledSeq, color, brightness, ms);
+    ledQueued();
 }
 
 /**
- * Cycle through all colors for diagnostic testing.
+ * Cycle through all colors for diagnostic testing, then the primaries
+ * at full brightness.  Queued like ledBlink().
  * @param delayMs  milliseconds per step (default 5000)
  */
 static void ledTest(unsigned long delayMs = 5000,
                     uint8_t brightness = LED_BRIGHTNESS)
 {
-    const unsigned long delayAmt = delayMs;
-
-    struct { LEDColor color; const char *name; } steps[] = {
-        { LED_RED,     "red"     },
-        { LED_GREEN,   "green"   },
-        { LED_BLUE,    "blue"    },
-        { LED_YELLOW,  "yellow"  },
-        { LED_CYAN,    "cyan"    },
-        { LED_MAGENTA, "magenta" },
-        { LED_WHITE,   "white"   },
+    static const uint8_t colors[] = {
+        LED_RED, LED_GREEN, LED_BLUE, LED_YELLOW, LED_CYAN, LED_MAGENTA, LED_WHITE,
     };
-    const int numSteps = sizeof(steps) / sizeof(steps[0]);
+    const int numSteps = sizeof(colors) / sizeof(colors[0]);
 
-    DBG("LED test: %d colors at brightness %d, %lu ms each\n",
-        numSteps, brightness, delayAmt);
-
-    for (int i = 0; i < numSteps; i++) {
-        DBG("  [%d/%d] %s\n", i + 1, numSteps, steps[i].name);
-        ledSetColorBrightness(steps[i].color, brightness);
-        sleepWdt(delayAmt);
-    }
+    ledSeqClear(&ledSeq);
+    for (int i = 0; i < numSteps; i++)
+        ledSeqPush(&ledSeq, colors[i], brightness, delayMs);
 
     /* Full-brightness primary test */
-    DBGLN("  Full-brightness RGB test");
-    DBGLN("    red 255");
-    ledSetRGB(255, 0, 0);
-    sleepWdt(delayAmt);
-    DBGLN("    green 255");
-    ledSetRGB(0, 255, 0);
-    sleepWdt(delayAmt);
-    DBGLN("    blue 255");
-    ledSetRGB(0, 0, 255);
-    sleepWdt(delayAmt);
-
-    ledOff();
-    DBGLN("LED test complete");
+    ledSeqPush(&ledSeq, LED_RED,   255, delayMs);
+    ledSeqPush(&ledSeq, LED_GREEN, 255, delayMs);
+    ledSeqPush(&ledSeq, LED_BLUE,  255, delayMs);
+    ledQueued();
+
+    DBG("LED test: %d colors at brightness %d + RGB at 255, %lu ms each\n",
+        numSteps, brightness, delayMs);
+}
+
+/* Drop any queued pattern without touching the pixel (rail going down) */
+static void ledStop(void)
+{
+    ledSeqClear(&ledSeq);
+}
+
+static bool ledBusy(void)
+{
+    return ledSeqActive(&ledSeq);
+}
+
+/* Milliseconds until ledTick() next changes the LED (see ledSeqDueIn) */
+static uint32_t ledDueIn(unsigned long now)
+{
+    return ledSeqDueIn(&ledSeq, now);
+}
+
+/**
+ * Play queued patterns — call every loop pass, or at ledDueIn().  Returns LED_SEQ_DONE
+ * once, when a pattern ends and the LED has been turned off.
+ */
+static LedSeqEvent ledTick(unsigned long now)
+{
+    LedStep step;
+    LedSeqEvent ev = ledSeqTick(&ledSeq, now, &step);
+    if (ev == LED_SEQ_SHOW)
+        ledSetColorBrightness((LEDColor)step.color, step.brightness);
+    else if (ev == LED_SEQ_DONE)
+        ledOff();
+    return ev;
 }
 
 #endif /* LED_H */
@@ -0,0 +1,146 @@
+/*
+ * led_seq.h — Non-blocking LED pattern queue
+ *
+ * A pattern is a short list of (color, brightness, duration) steps.
+ * Handlers queue one and return at once; the tick loop calls
+ * ledSeqTick() each pass, which says when to change the LED — so a
+ * blink or the full testled cycle plays while the radio keeps
+ * listening and the GPS keeps being fed.
+ *
+ * Each step's start is its predecessor's start plus its duration, not
+ * the pass that noticed it ended, so a slow pass doesn't stretch the
+ * rest of the pattern.  Queuing a new pattern replaces the old one.
+ *
+ * Colors are LEDColor values from led.h, kept as plain integers here so
+ * the queue has no Arduino deps and can be tested natively.
+ */
+
+#ifndef LED_SEQ_H
+#define LED_SEQ_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#ifndef LED_SEQ_MAX
+#define LED_SEQ_MAX          16       /* testled: 10 steps */
+#endif
+
+/* ─── State ──────────────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint32_t ms;            /* how long the step is shown */
+    uint8_t  color;         /* LEDColor */
+    uint8_t  brightness;
+} LedStep;
+
+typedef struct {
+    LedStep       s[LED_SEQ_MAX];
+    uint8_t       count;        /* steps queued                          */
+    uint8_t       cur;          /* step showing                          */
+    bool          active;       /* a pattern is queued or playing        */
+    bool          started;      /* step 0 shown yet                      */
+    uint32_t      stepStart;    /* millis() the current step began       */
+} LedSeq;
+
+/* ledSeqDueIn() result when nothing is queued */
+#define LED_SEQ_NO_DEADLINE  0xFFFFFFFFUL
+
+/* What ledSeqTick() asks of the caller */
+typedef enum {
+    LED_SEQ_IDLE = 0,           /* nothing to change                     */
+    LED_SEQ_SHOW,               /* show *step                            */
+    LED_SEQ_DONE                /* pattern over: LED off, release power  */
+} LedSeqEvent;
+
+/* ─── Functions ──────────────────────────────────────────────────────────── */
+
+static inline void ledSeqInit(LedSeq *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+/* Start building a new pattern (replaces whatever was playing) */
+static inline void ledSeqClear(LedSeq *q)
+{
+    q->count   = 0;
+    q->cur     = 0;
+    q->active  = false;
+    q->started = false;
+}
+
+/* Append a step.  Returns false when the pattern is full. */
+static inline bool ledSeqPush(LedSeq *q, uint8_t color, uint8_t brightness,
+                              uint32_t ms)
+{
+    if (q->count >= LED_SEQ_MAX) return false;
+    LedStep *st = &q->s[q->count++];
+    st->color      = color;
+    st->brightness = brightness;
+    st->ms         = ms;
+    q->active = true;
+    return true;
+}
+
+static inline bool ledSeqActive(const LedSeq *q)
+{
+    return q->active;
+}
+
+/*
+ * Advance the pattern to `now`.  The first tick after queuing shows
+ * step 0; later ones move on when a step's time is up.  Only one event
+ * per call — LED_SEQ_DONE comes on the tick after the last step ends.
+ */
+static inline LedSeqEvent ledSeqTick(LedSeq *q, unsigned long now, LedStep *step)
+{
+    if (!q->active) return LED_SEQ_IDLE;
+
+    if (!q->started) {
+        q->started   = true;
+        q->stepStart = (uint32_t)now;
+        *step = q->s[0];
+        return LED_SEQ_SHOW;
+    }
+    if ((uint32_t)now - q->stepStart < q->s[q->cur].ms) return LED_SEQ_IDLE;
+
+    q->stepStart += q->s[q->cur].ms;
+    q->cur++;
+    if (q->cur >= q->count) {
+        ledSeqClear(q);
+        return LED_SEQ_DONE;
+    }
+    *step = q->s[q->cur];
+    return LED_SEQ_SHOW;
+}
+
+/*
+ * Milliseconds until ledSeqTick() next has something to do: 0 before
+ * step 0 is shown or once the current step is over, LED_SEQ_NO_DEADLINE
+ * while nothing is queued.  Lets the tick loop sleep between steps.
+ */
+static inline uint32_t ledSeqDueIn(const LedSeq *q, unsigned long now)
+{
+    if (!q->active) return LED_SEQ_NO_DEADLINE;
+    if (!q->started) return 0;
+    uint32_t gone = (uint32_t)now - q->stepStart;
+    uint32_t ms   = q->s[q->cur].ms;
+    return gone < ms ? ms - gone : 0;
+}
+
+/* ─── Patterns ───────────────────────────────────────────────────────────── */
+
+/* count flashes of periodMs on / periodMs off */
+static inline void ledSeqBlink(LedSeq *q, uint8_t color, uint8_t brightness,
+                               int count, uint32_t periodMs)
+{
+    ledSeqClear(q);
+    for (int i = 0; i < count; i++) {
+        ledSeqPush(q, color, brightness, periodMs);
+        if (i < count - 1) ledSeqPush(q, 0 /* LED_OFF */, 0, periodMs);
+    }
+}
+
+#endif /* LED_SEQ_H */
@@ -0,0 +1,328 @@
+/*
+ * nmea.h — Incremental GGA/RMC NMEA parser (fixed-point, no heap, no libm)
+ *
+ * Replaces TinyGPS++ for the NEO-6M.  Bytes are fed one at a time from the
+ * UART; each field is folded into integer accumulators as it streams past,
+ * so no sentence buffer is kept.  Only GGA and RMC (any talker: GP, GN, …)
+ * are decoded — every other sentence is still checksummed and counted but
+ * its fields are skipped.  Values from a sentence are committed only when
+ * its checksum matches, with the same rules TinyGPS++ uses:
+ *
+ *   GGA → time, sats (always); location, altitude (only with a fix)
+ *   RMC → time, date (always); location, speed (only with status 'A')
+ *
+ * Units: lat/lon in 1e-7 degrees (± = N/E), altitude in cm, speed in
+ * 1/100 knot, time as hhmmsscc, date as ddmmyy — the same integer forms
+ * TinyGPS++ exposes via .value().
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef NMEA_H
+#define NMEA_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Limits ───────────────────────────────────────────────────────────── */
+
+/* Fraction digits kept per numeric field (NEO-6M sends 5 for lat/lon) */
+#define NMEA_MAX_FRAC 5
+
+/* ─── Fix Data ─────────────────────────────────────────────────────────── */
+
+/* NmeaFix.valid / NmeaParser.updated bits */
+#define NMEA_HAVE_LOC   0x01
+#define NMEA_HAVE_ALT   0x02
+#define NMEA_HAVE_SATS  0x04
+#define NMEA_HAVE_TIME  0x08
+#define NMEA_HAVE_DATE  0x10
+#define NMEA_HAVE_SPEED 0x20
+
+typedef struct {
+    int32_t  lat_e7;        /* degrees × 1e7, north positive           */
+    int32_t  lon_e7;        /* degrees × 1e7, east positive            */
+    int32_t  alt_cm;        /* altitude above MSL, centimetres          */
+    uint32_t time;          /* UTC hhmmsscc                             */
+    uint32_t date;          /* UTC ddmmyy                               */
+    uint32_t speed_ckn;     /* ground speed, 1/100 knot                 */
+    uint8_t  sats;          /* satellites in use                        */
+    uint8_t  valid;         /* NMEA_HAVE_* — ever received              */
+} NmeaFix;
+
+/* ─── Parser State ─────────────────────────────────────────────────────── */
+
+typedef enum {
+    NMEA_SENT_OTHER = 0,
+    NMEA_SENT_GGA,
+    NMEA_SENT_RMC
+} NmeaSentence;
+
+typedef enum {
+    NMEA_ST_IDLE = 0,       /* waiting for '$'                          */
+    NMEA_ST_DATA,           /* inside the sentence body                 */
+    NMEA_ST_CK_HI,          /* expecting first checksum hex digit       */
+    NMEA_ST_CK_LO           /* expecting second checksum hex digit      */
+} NmeaState;
+
+typedef struct {
+    NmeaFix  fix;           /* committed values                         */
+    uint8_t  updated;       /* NMEA_HAVE_* committed since last take    */
+
+    /* Counters (TinyGPS++ charsProcessed/passedChecksum/failedChecksum) */
+    uint32_t chars;
+    uint32_t passed;
+    uint32_t failed;
+
+    /* Sentence in progress */
+    uint8_t  state;         /* NmeaState                                */
+    uint8_t  sentence;      /* NmeaSentence                             */
+    uint8_t  field;         /* 0 = address field                        */
+    uint8_t  cksum;         /* running XOR                              */
+    uint8_t  ckRecv;        /* received checksum (high nibble first)    */
+    char     addr[5];       /* talker + type, e.g. "GPGGA"              */
+
+    /* Current field accumulator */
+    uint32_t acc;           /* digits so far, as an integer             */
+    uint8_t  frac;          /* digits after '.' kept in acc             */
+    uint8_t  len;           /* characters in the field                  */
+    bool     dot;
+    bool     neg;
+    char     first;         /* first character (hemisphere, status)     */
+
+    /* Pending values, committed on checksum match */
+    NmeaFix  pend;
+    uint8_t  pendHave;      /* NMEA_HAVE_* fields present               */
+    bool     pendFix;       /* GGA quality > 0 / RMC status 'A'         */
+} NmeaParser;
+
+/* ─── Helpers ──────────────────────────────────────────────────────────── */
+
+static inline void nmeaInit(NmeaParser *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+static inline int nmeaHexVal(char c)
+{
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+/* acc scaled to exactly `digits` fraction digits */
+static inline uint32_t nmeaScaled(const NmeaParser *p, uint8_t digits)
+{
+    uint32_t v = p->acc;
+    for (uint8_t f = p->frac; f < digits; f++) v *= 10;
+    for (uint8_t f = p->frac; f > digits; f--) v /= 10;
+    return v;
+}
+
+/*
+ * "ddmm.mmmmm" / "dddmm.mmmmm" → degrees × 1e7.  With 5 fraction digits
+ * the minutes are in 1e-5 units: deg = v / 1e7, min_e5 = v % 1e7, and
+ * min_e5 × 1e7 / (60 × 1e5) = min_e5 × 100 / 60 (rounded).
+ */
+static inline int32_t nmeaDegE7(const NmeaParser *p)
+{
+    uint32_t v     = nmeaScaled(p, 5);
+    uint32_t deg   = v / 10000000UL;
+    uint32_t minE5 = v % 10000000UL;
+    return (int32_t)(deg * 10000000UL + (minE5 * 100UL + 30UL) / 60UL);
+}
+
+/* Record a completed GGA/RMC field into the pending fix */
+static inline void nmeaEndField(NmeaParser *p)
+{
+    if (p->field == 0) {
+        /* Address: last three letters select the sentence, talker ignored */
+        p->sentence = NMEA_SENT_OTHER;
+        if (p->len == 5) {
+            const char *t = p->addr + 2;
+            if (t[0] == 'G' && t[1] == 'G' && t[2] == 'A')
+                p->sentence = NMEA_SENT_GGA;
+            else if (t[0] == 'R' && t[1] == 'M' && t[2] == 'C')
+                p->sentence = NMEA_SENT_RMC;
+        }
+        return;
+    }
+    if (p->sentence == NMEA_SENT_OTHER || p->len == 0) return;
+
+    NmeaFix *f = &p->pend;
+    bool gga = (p->sentence == NMEA_SENT_GGA);
+
+    /* Map field index to meaning (GGA / RMC layouts differ after time) */
+    switch (p->field) {
+    case 1:                                     /* hhmmss.ss */
+        f->time = nmeaScaled(p, 2);
+        p->pendHave |= NMEA_HAVE_TIME;
+        return;
+    default:
+        break;
+    }
+
+    if (gga) {
+        switch (p->field) {
+        case 2: f->lat_e7 = nmeaDegE7(p); p->pendHave |= NMEA_HAVE_LOC; break;
+        case 3: if (p->first == 'S') f->lat_e7 = -f->lat_e7; break;
+        case 4: f->lon_e7 = nmeaDegE7(p); break;
+        case 5: if (p->first == 'W') f->lon_e7 = -f->lon_e7; break;
+        case 6: p->pendFix = (p->acc > 0); break;          /* fix quality */
+        case 7: f->sats = (uint8_t)p->acc; p->pendHave |= NMEA_HAVE_SATS; break;
+        case 9: {
+            int32_t cm = (int32_t)nmeaScaled(p, 2);
+            f->alt_cm = p->neg ? -cm : cm;
+            p->pendHave |= NMEA_HAVE_ALT;
+            break;
+        }
+        default: break;
+        }
+    } else {
+        switch (p->field) {
+        case 2: p->pendFix = (p->first == 'A'); break;     /* status */
+        case 3: f->lat_e7 = nmeaDegE7(p); p->pendHave |= NMEA_HAVE_LOC; break;
+        case 4: if (p->first == 'S') f->lat_e7 = -f->lat_e7; break;
+        case 5: f->lon_e7 = nmeaDegE7(p); break;
+        case 6: if (p->first == 'W') f->lon_e7 = -f->lon_e7; break;
+        case 7: f->speed_ckn = nmeaScaled(p, 2); p->pendHave |= NMEA_HAVE_SPEED; break;
+        case 9: f->date = p->acc; p->pendHave |= NMEA_HAVE_DATE; break;
+        default: break;
+        }
+    }
+}
+
+/* Checksum matched: copy pending fields into the fix (TinyGPS++ rules) */
+static inline void nmeaCommit(NmeaParser *p)
+{
+    const NmeaFix *s = &p->pend;
+    NmeaFix *d = &p->fix;
+    uint8_t have = p->pendHave;
+    uint8_t take = have & NMEA_HAVE_TIME;
+
+    if (p->sentence == NMEA_SENT_GGA) {
+        take |= have & NMEA_HAVE_SATS;
+        if (p->pendFix) take |= have & (NMEA_HAVE_LOC | NMEA_HAVE_ALT);
+    } else if (p->sentence == NMEA_SENT_RMC) {
+        take |= have & NMEA_HAVE_DATE;
+        if (p->pendFix) take |= have & (NMEA_HAVE_LOC | NMEA_HAVE_SPEED);
+    } else {
+        return;
+    }
+
+    if (take & NMEA_HAVE_LOC)   { d->lat_e7 = s->lat_e7; d->lon_e7 = s->lon_e7; }
+    if (take & NMEA_HAVE_ALT)   d->alt_cm    = s->alt_cm;
+    if (take & NMEA_HAVE_SATS)  d->sats      = s->sats;
+    if (take & NMEA_HAVE_TIME)  d->time      = s->time;
+    if (take & NMEA_HAVE_DATE)  d->date      = s->date;
+    if (take & NMEA_HAVE_SPEED) d->speed_ckn = s->speed_ckn;
+
+    d->valid   |= take;
+    p->updated |= take;
+}
+
+static inline void nmeaStartField(NmeaParser *p)
+{
+    p->acc   = 0;
+    p->frac  = 0;
+    p->len   = 0;
+    p->dot   = false;
+    p->neg   = false;
+    p->first = 0;
+}
+
+/* ─── Public API ───────────────────────────────────────────────────────── */
+
+/*
+ * Feed one byte.  Returns true when it completed a sentence with a valid
+ * checksum (any type), like TinyGPS++ encode().
+ */
+static inline bool nmeaEncode(NmeaParser *p, char c)
+{
+    p->chars++;
+
+    if (c == '$') {
+        p->state    = NMEA_ST_DATA;
+        p->sentence = NMEA_SENT_OTHER;
+        p->field    = 0;
+        p->cksum    = 0;
+        p->pendHave = 0;
+        p->pendFix  = false;
+        nmeaStartField(p);
+        return false;
+    }
+
+    switch (p->state) {
+    case NMEA_ST_DATA:
+        if (c == '*') {
+            nmeaEndField(p);
+            p->state = NMEA_ST_CK_HI;
+            return false;
+        }
+        if (c == '\r' || c == '\n') {           /* no checksum — drop */
+            p->state = NMEA_ST_IDLE;
+            return false;
+        }
+        p->cksum ^= (uint8_t)c;
+        if (c == ',') {
+            nmeaEndField(p);
+            if (p->field < 255) p->field++;
+            nmeaStartField(p);
+            return false;
+        }
+        if (p->len == 0) p->first = c;
+        if (p->len < 255) p->len++;
+
+        if (p->field == 0) {
+            if (p->len <= sizeof(p->addr)) p->addr[p->len - 1] = c;
+        } else if (c >= '0' && c <= '9') {
+            /* Digits past NMEA_MAX_FRAC (or past uint32 range) are dropped */
+            if (!p->dot || p->frac < NMEA_MAX_FRAC) {
+                if (p->acc <= (0xFFFFFFFFUL - 9UL) / 10UL) {
+                    p->acc = p->acc * 10 + (uint32_t)(c - '0');
+                    if (p->dot) p->frac++;
+                }
+            }
+        } else if (c == '.') {
+            p->dot = true;
+        } else if (c == '-' && p->len == 1) {
+            p->neg = true;
+        }
+        return false;
+
+    case NMEA_ST_CK_HI: {
+        int v = nmeaHexVal(c);
+        if (v < 0) { p->state = NMEA_ST_IDLE; p->failed++; return false; }
+        p->ckRecv = (uint8_t)(v << 4);
+        p->state  = NMEA_ST_CK_LO;
+        return false;
+    }
+
+    case NMEA_ST_CK_LO: {
+        int v = nmeaHexVal(c);
+        p->state = NMEA_ST_IDLE;
+        if (v < 0 || (uint8_t)(p->ckRecv | v) != p->cksum) {
+            p->failed++;
+            return false;
+        }
+        p->passed++;
+        nmeaCommit(p);
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
+
+/* Return and clear the NMEA_HAVE_* bits committed since the last call. */
+static inline uint8_t nmeaTakeUpdated(NmeaParser *p)
+{
+    uint8_t u = p->updated;
+    p->updated = 0;
+    return u;
+}
+
+#endif /* NMEA_H */
@@ -7,6 +7,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "crc32.h"
+
 /* ─── Debug (no-op unless defined before include) ─────────────────────────── */
 #ifndef CDBG
 #define CDBG(fmt, ...) ((void)0)
@@ -18,87 +20,6 @@
 #define LORA_MAX_PAYLOAD 250
 #endif
 
-/* ─── CRC-32 ─────────────────────────────────────────────────────────────── */
-
-/*
- * Standard CRC-32 (ISO 3309 / ITU-T V.42) — identical to Python zlib.crc32().
- * Bit-reversed polynomial 0xEDB88320.
- */
-static const uint32_t CRC32_TABLE[256] = {
-    0x00000000u,0x77073096u,0xEE0E612Cu,0x990951BAu,
-    0x076DC419u,0x706AF48Fu,0xE963A535u,0x9E6495A3u,
-    0x0EDB8832u,0x79DCB8A4u,0xE0D5E91Eu,0x97D2D988u,
-    0x09B64C2Bu,0x7EB17CBDu,0xE7B82D07u,0x90BF1D91u,
-    0x1DB71064u,0x6AB020F2u,0xF3B97148u,0x84BE41DEu,
-    0x1ADAD47Du,0x6DDDE4EBu,0xF4D4B551u,0x83D385C7u,
-    0x136C9856u,0x646BA8C0u,0xFD62F97Au,0x8A65C9ECu,
-    0x14015C4Fu,0x63066CD9u,0xFA0F3D63u,0x8D080DF5u,
-    0x3B6E20C8u,0x4C69105Eu,0xD56041E4u,0xA2677172u,
-    0x3C03E4D1u,0x4B04D447u,0xD20D85FDu,0xA50AB56Bu,
-    0x35B5A8FAu,0x42B2986Cu,0xDBBBC9D6u,0xACBCF940u,
-    0x32D86CE3u,0x45DF5C75u,0xDCD60DCFu,0xABD13D59u,
-    0x26D930ACu,0x51DE003Au,0xC8D75180u,0xBFD06116u,
-    0x21B4F4B5u,0x56B3C423u,0xCFBA9599u,0xB8BDA50Fu,
-    0x2802B89Eu,0x5F058808u,0xC60CD9B2u,0xB10BE924u,
-    0x2F6F7C87u,0x58684C11u,0xC1611DABu,0xB6662D3Du,
-    0x76DC4190u,0x01DB7106u,0x98D220BCu,0xEFD5102Au,
-    0x71B18589u,0x06B6B51Fu,0x9FBFE4A5u,0xE8B8D433u,
-    0x7807C9A2u,0x0F00F934u,0x9609A88Eu,0xE10E9818u,
-    0x7F6A0DBBu,0x086D3D2Du,0x91646C97u,0xE6635C01u,
-    0x6B6B51F4u,0x1C6C6162u,0x856530D8u,0xF262004Eu,
-    0x6C0695EDu,0x1B01A57Bu,0x8208F4C1u,0xF50FC457u,
-    0x65B0D9C6u,0x12B7E950u,0x8BBEB8EAu,0xFCB9887Cu,
-    0x62DD1DDFu,0x15DA2D49u,0x8CD37CF3u,0xFBD44C65u,
-    0x4DB26158u,0x3AB551CEu,0xA3BC0074u,0xD4BB30E2u,
-    0x4ADFA541u,0x3DD895D7u,0xA4D1C46Du,0xD3D6F4FBu,
-    0x4369E96Au,0x346ED9FCu,0xAD678846u,0xDA60B8D0u,
-    0x44042D73u,0x33031DE5u,0xAA0A4C5Fu,0xDD0D7CC9u,
-    0x5005713Cu,0x270241AAu,0xBE0B1010u,0xC90C2086u,
-    0x5768B525u,0x206F85B3u,0xB966D409u,0xCE61E49Fu,
-    0x5EDEF90Eu,0x29D9C998u,0xB0D09822u,0xC7D7A8B4u,
-    0x59B33D17u,0x2EB40D81u,0xB7BD5C3Bu,0xC0BA6CADu,
-    0xEDB88320u,0x9ABFB3B6u,0x03B6E20Cu,0x74B1D29Au,
-    0xEAD54739u,0x9DD277AFu,0x04DB2615u,0x73DC1683u,
-    0xE3630B12u,0x94643B84u,0x0D6D6A3Eu,0x7A6A5AA8u,
-    0xE40ECF0Bu,0x9309FF9Du,0x0A00AE27u,0x7D079EB1u,
-    0xF00F9344u,0x8708A3D2u,0x1E01F268u,0x6906C2FEu,
-    0xF762575Du,0x806567CBu,0x196C3671u,0x6E6B06E7u,
-    0xFED41B76u,0x89D32BE0u,0x10DA7A5Au,0x67DD4ACCu,
-    0xF9B9DF6Fu,0x8EBEEFF9u,0x17B7BE43u,0x60B08ED5u,
-    0xD6D6A3E8u,0xA1D1937Eu,0x38D8C2C4u,0x4FDFF252u,
-    0xD1BB67F1u,0xA6BC5767u,0x3FB506DDu,0x48B2364Bu,
-    0xD80D2BDAu,0xAF0A1B4Cu,0x36034AF6u,0x41047A60u,
-    0xDF60EFC3u,0xA867DF55u,0x316E8EEFu,0x4669BE79u,
-    0xCB61B38Cu,0xBC66831Au,0x256FD2A0u,0x5268E236u,
-    0xCC0C7795u,0xBB0B4703u,0x220216B9u,0x5505262Fu,
-    0xC5BA3BBEu,0xB2BD0B28u,0x2BB45A92u,0x5CB36A04u,
-    0xC2D7FFA7u,0xB5D0CF31u,0x2CD99E8Bu,0x5BDEAE1Du,
-    0x9B64C2B0u,0xEC63F226u,0x756AA39Cu,0x026D930Au,
-    0x9C0906A9u,0xEB0E363Fu,0x72076785u,0x05005713u,
-    0x95BF4A82u,0xE2B87A14u,0x7BB12BAEu,0x0CB61B38u,
-    0x92D28E9Bu,0xE5D5BE0Du,0x7CDCEFB7u,0x0BDBDF21u,
-    0x86D3D2D4u,0xF1D4E242u,0x68DDB3F8u,0x1FDA836Eu,
-    0x81BE16CDu,0xF6B9265Bu,0x6FB077E1u,0x18B74777u,
-    0x88085AE6u,0xFF0F6A70u,0x66063BCAu,0x11010B5Cu,
-    0x8F659EFFu,0xF862AE69u,0x616BFFD3u,0x166CCF45u,
-    0xA00AE278u,0xD70DD2EEu,0x4E048354u,0x3903B3C2u,
-    0xA7672661u,0xD06016F7u,0x4969474Du,0x3E6E77DBu,
-    0xAED16A4Au,0xD9D65ADCu,0x40DF0B66u,0x37D83BF0u,
-    0xA9BCAE53u,0xDEBB9EC5u,0x47B2CF7Fu,0x30B5FFE9u,
-    0xBDBDF21Cu,0xCABAC28Au,0x53B39330u,0x24B4A3A6u,
-    0xBAD03605u,0xCDD70693u,0x54DE5729u,0x23D967BFu,
-    0xB3667A2Eu,0xC4614AB8u,0x5D681B02u,0x2A6F2B94u,
-    0xB40BBE37u,0xC30C8EA1u,0x5A05DF1Bu,0x2D02EF8Du,
-};
-
-static inline uint32_t crc32_compute(const char *data, size_t len)
-{
-    uint32_t crc = 0xFFFFFFFFu;
-    for (size_t i = 0; i < len; i++)
-        crc = CRC32_TABLE[(crc ^ (uint8_t)data[i]) & 0xFFu] ^ (crc >> 8);
-    return crc ^ 0xFFFFFFFFu;
-}
-
 /* ─── Sensor Reading Types ───────────────────────────────────────────────── */
 
 typedef struct {
@@ -128,6 +49,20 @@ static inline int fmtVal(char *buf, size_t cap, double val)
     return len;
 }
 
+/* Decimal uint32 without snprintf (hot RX/ACK path).  Returns length. */
+static inline int fmtU32(char *out, uint32_t v)
+{
+    char tmp[10];
+    int n = 0;
+    do {
+        tmp[n++] = (char)('0' + v % 10);
+        v /= 10;
+    } while (v);
+    for (int i = 0; i < n; i++) out[i] = tmp[n - 1 - i];
+    out[n] = '\0';
+    return n;
+}
+
 /*
  * Build one LoRa packet containing readings[0 .. count-1].
  *
@@ -308,6 +243,18 @@ static inline int extractJsonStringArray(const char *json, const char *key,
 
 /* ─── Command Packet Parser ──────────────────────────────────────────────── */
 
+/* Why parseCommandResult() rejected a packet (counted by the "stats" command) */
+typedef enum {
+    PARSE_OK = 0,
+    PARSE_FAIL_LEN,         /* empty or longer than a LoRa payload      */
+    PARSE_FAIL_NO_TYPE,     /* no "t":"cmd" — not a command packet      */
+    PARSE_FAIL_NO_CMD,
+    PARSE_FAIL_NO_CRC,
+    PARSE_FAIL_NO_TS,
+    PARSE_FAIL_CRC,         /* CRC mismatch                             */
+    PARSE_RESULT_COUNT
+} ParseResult;
+
 /*
  * Parse and verify a command packet.
  *
@@ -317,13 +264,15 @@ static inline int extractJsonStringArray(const char *json, const char *key,
  * CRC is computed over JSON with "c" field removed, keys sorted:
  *   {"a":[],"cmd":"...","n":"...","t":"cmd","ts":...}
  *
- * Returns true if valid command with matching CRC.
+ * Returns PARSE_OK for a valid command with matching CRC, else the
+ * first check that failed.
  */
-static inline bool parseCommand(const uint8_t *data, size_t len, CommandPacket *out)
+static inline ParseResult parseCommandResult(const uint8_t *data, size_t len,
+                                             CommandPacket *out)
 {
     if (len == 0 || len > LORA_MAX_PAYLOAD) {
         CDBG("PARSE_FAIL len=%zu\n", len);
-        return false;
+        return PARSE_FAIL_LEN;
     }
 
     /* Null-terminate for string operations.
@@ -338,18 +287,18 @@ static inline bool parseCommand(const uint8_t *data, size_t len, CommandPacket *
     /* Verify this is a command packet */
     if (!strstr(json, "\"t\":\"cmd\"")) {
         CDBG("PARSE_FAIL no_cmd_type\n");
-        return false;
+        return PARSE_FAIL_NO_TYPE;
     }
 
     /* Extract fields */
     if (!extractJsonString(json, "cmd", out->cmd, sizeof(out->cmd))) {
         CDBG("PARSE_FAIL no_cmd\n");
-        return false;
+        return PARSE_FAIL_NO_CMD;
     }
 
     if (!extractJsonString(json, "c", out->crc, sizeof(out->crc))) {
         CDBG("PARSE_FAIL no_crc\n");
-        return false;
+        return PARSE_FAIL_NO_CRC;
     }
 
     /* node_id can be empty string for broadcast */
@@ -360,7 +309,7 @@ static inline bool parseCommand(const uint8_t *data, size_t len, CommandPacket *
     int32_t ts;
     if (!extractJsonInt(json, "ts", &ts)) {
         CDBG("PARSE_FAIL no_ts\n");
-        return false;
+        return PARSE_FAIL_NO_TS;
     }
     out->timestamp = (uint32_t)ts;
 
@@ -372,41 +321,43 @@ static inline bool parseCommand(const uint8_t *data, size_t len, CommandPacket *
          out->cmd, out->node_id, out->timestamp, out->arg_count);
 
     /*
-     * Verify CRC: rebuild JSON with sorted keys (excluding "c")
-     * Key order: a < cmd < n < t < ts
+     * Verify CRC over the JSON with sorted keys (excluding "c"):
+     *   {"a":["..",..],"cmd":"..","n":"..","t":"cmd","ts":N}
+     * fed to crc32_update() piece by piece instead of being rebuilt
+     * in a buffer first.
      */
-    static char crcBuf[LORA_MAX_PAYLOAD];
-    int pos = 0;
-
-    /* Build args array string - must fit CMD_MAX_ARGS args of CMD_MAX_ARG_LEN each */
-    static char argsBuf[LORA_MAX_PAYLOAD];
-    int aLen = 0;
-    argsBuf[aLen++] = '[';
+    uint32_t crc = crc32_update(0, "{\"a\":[", 6);
     for (int i = 0; i < out->arg_count; i++) {
-        if (i > 0) argsBuf[aLen++] = ',';
-        aLen += snprintf(argsBuf + aLen, sizeof(argsBuf) - aLen,
-                         "\"%s\"", out->args[i]);
+        crc = crc32_update(crc, i > 0 ? ",\"" : "\"", i > 0 ? 2 : 1);
+        crc = crc32_update(crc, out->args[i], strlen(out->args[i]));
+        crc = crc32_update(crc, "\"", 1);
     }
-    argsBuf[aLen++] = ']';
-    argsBuf[aLen] = '\0';
-
-    pos = snprintf(crcBuf, sizeof(crcBuf),
-                   "{\"a\":%s,\"cmd\":\"%s\",\"n\":\"%s\",\"t\":\"cmd\",\"ts\":%u}",
-                   argsBuf, out->cmd, out->node_id, out->timestamp);
+    crc = crc32_update(crc, "],\"cmd\":\"", 9);
+    crc = crc32_update(crc, out->cmd, strlen(out->cmd));
+    crc = crc32_update(crc, "\",\"n\":\"", 7);
+    crc = crc32_update(crc, out->node_id, strlen(out->node_id));
+    crc = crc32_update(crc, "\",\"t\":\"cmd\",\"ts\":", 17);
+    char tsBuf[11];
+    crc = crc32_update(crc, tsBuf, fmtU32(tsBuf, out->timestamp));
+    crc = crc32_update(crc, "}", 1);
 
-    uint32_t computed = crc32_compute(crcBuf, pos);
     char computedHex[9];
-    snprintf(computedHex, sizeof(computedHex), "%08x", computed);
+    snprintf(computedHex, sizeof(computedHex), "%08x", (unsigned)crc);
 
-    CDBG("PARSE_CRC crcBuf=%s\n", crcBuf);
     CDBG("PARSE_CRC computed=%s expected=%s\n", computedHex, out->crc);
 
     if (strcmp(computedHex, out->crc) != 0) {
         CDBG("PARSE_FAIL crc_mismatch\n");
-        return false;
+        return PARSE_FAIL_CRC;
     }
 
-    return true;
+    return PARSE_OK;
+}
+
+/* Returns true if valid command with matching CRC (see parseCommandResult) */
+static inline bool parseCommand(const uint8_t *data, size_t len, CommandPacket *out)
+{
+    return parseCommandResult(data, len, out) == PARSE_OK;
 }
 
 /* ─── ACK Packet Builder ─────────────────────────────────────────────────── */
@@ -496,6 +447,267 @@ static inline int buildAckPacketWithPayload(char *buf, size_t bufCap,
     return pLen + 4;
 }
 
+/* ─── ACK Fast Path ──────────────────────────────────────────────────────── */
+
+/*
+ * Command ID "{timestamp}_{crc_first_4_chars}" (the dedup key and the
+ * ACK's "id") without snprintf.  out holds 16.  Returns length.
+ */
+static inline int ackFmtId(char *out, uint32_t cmdTimestamp, const char *cmdCrc)
+{
+    int n = fmtU32(out, cmdTimestamp);
+    out[n++] = '_';
+    for (int i = 0; i < 4 && cmdCrc[i]; i++) out[n++] = cmdCrc[i];
+    out[n] = '\0';
+    return n;
+}
+
+/*
+ * Plain ACK (no payload) from a per-node template: the part after the
+ * command ID — ","n":"<node>","t":"ack"} — is rendered once, and the CRC
+ * state over the constant {"id":" prefix is cached.  Each ACK is then
+ * two memcpys, two crc32_update() calls and the hex CRC, with no
+ * snprintf; the packet is byte-identical to buildAckPacket()'s.
+ */
+typedef struct {
+    char     tail[48];      /* ","n":"<node>","t":"ack"} */
+    uint8_t  tailLen;
+    uint32_t headCrc;       /* crc32_update() state after {"id":" */
+} AckTemplate;
+
+static inline bool ackTemplateInit(AckTemplate *t, const char *nodeId)
+{
+    int n = snprintf(t->tail, sizeof(t->tail), "\",\"n\":\"%s\",\"t\":\"ack\"}", nodeId);
+    if (n <= 0 || n >= (int)sizeof(t->tail)) {
+        t->tailLen = 0;
+        return false;
+    }
+    t->tailLen = (uint8_t)n;
+    t->headCrc = crc32_update(0, "{\"id\":\"", 7);
+    return true;
+}
+
+/* Returns length written to buf, or 0 on error (like buildAckPacket) */
+static inline int ackTemplateBuild(const AckTemplate *t, char *buf, size_t bufCap,
+                                   const char *id, int idLen)
+{
+    static const char hex[] = "0123456789abcdef";
+    /* 4 pad + {"c":" + 8 hex + ","id":" */
+    int need = 4 + 6 + 8 + 8 + idLen + t->tailLen;
+    if (t->tailLen == 0 || need >= (int)bufCap) return 0;
+
+    uint32_t crc = crc32_update(t->headCrc, id, (size_t)idLen);
+    crc = crc32_update(crc, t->tail, t->tailLen);
+
+    /* Padding for the ASR650x TX-FIFO workaround, then the packet */
+    memcpy(buf, "    {\"c\":\"", 10);
+    for (int i = 0; i < 8; i++) buf[10 + i] = hex[(crc >> (28 - 4 * i)) & 0xF];
+    memcpy(buf + 18, "\",\"id\":\"", 8);
+    memcpy(buf + 26, id, (size_t)idLen);
+    memcpy(buf + 26 + idLen, t->tail, t->tailLen);
+    buf[need] = '\0';
+    return need;
+}
+
+/* ─── Bulk Transfer ──────────────────────────────────────────────────────── */
+
+/*
+ * Windowed block transfer for payloads larger than one ACK response
+ * (logs, traces, config dumps).  Instead of one command/ACK round trip
+ * per CMD_RESPONSE_BUF_SIZE chunk, the node sends up to `window` numbered
+ * blocks back-to-back on N2G and the gateway answers once per window:
+ *
+ *   gateway                          node
+ *   open (command, late ACK)   ──▶   xferOpen()
+ *                              ◀──   ACK: block size, length, n, window, id
+ *                              ◀──   block 0 .. w-1
+ *   ack id base missing        ──▶   xferAck()
+ *                              ◀──   missing blocks, then new ones up to base+w
+ *   ...                              (base == n ends the session)
+ *
+ * `base` is the lowest block the gateway has not received (everything
+ * below it arrived); bit i of `missing` set means block base+i is still
+ * needed.  Blocks already sent that aren't flagged are taken as received,
+ * so only the flagged ones are retransmitted (selective repeat).
+ *
+ * The payload is pulled through a fill callback by byte offset, so the
+ * source never has to be held in RAM.  Block packet (keys sorted for CRC):
+ *
+ *   {"b":3,"c":"...","d":"<base64>","n":"ab01","t":"blk","x":7}
+ *
+ * CRC is computed over the JSON with "c" removed, as for ACKs.
+ */
+
+#define XFER_BLOCK_BYTES   120  /* multiple of 3: base64 without padding  */
+#define XFER_MAX_WINDOW    32   /* blocks per round (missing bitmap width) */
+
+/*
+ * Block packet size: 4 pad + {"b":65535,"c":"XXXXXXXX","d":" (31)
+ *   + base64 (160) + ","n":" (7) + NODE_ID_MAX_LEN + ","t":"blk","x":255} (20)
+ */
+#define XFER_BLOCK_PKT_MAX (4 + 31 + XFER_BLOCK_BYTES / 3 * 4 + 7 + NODE_ID_MAX_LEN + 20)
+
+typedef char xfer_block_fits_check[(XFER_BLOCK_PKT_MAX <= LORA_MAX_PAYLOAD) ? 1 : -1];
+
+/* Copy up to len payload bytes starting at offset into buf; returns bytes copied. */
+typedef int (*XferFill)(uint32_t offset, uint8_t *buf, int len, void *ctx);
+
+typedef struct {
+    bool      active;
+    uint8_t   id;           /* session ID, echoed in every block           */
+    uint8_t   window;       /* blocks per round                            */
+    bool      round;        /* blocks queued for transmission              */
+    uint32_t  totalLen;     /* payload bytes                               */
+    uint16_t  nBlocks;
+    uint16_t  base;         /* lowest block not yet acknowledged           */
+    uint16_t  next;         /* next block never sent                       */
+    uint32_t  resend;       /* bit i: resend block base+i this round       */
+    XferFill  fill;
+    void     *ctx;
+    uint32_t  sent;         /* blocks sent, first time                     */
+    uint32_t  resent;       /* blocks retransmitted                        */
+} XferSession;
+
+/* Base64 (RFC 4648, padded).  Returns output length, or 0 if it doesn't fit. */
+static inline int b64Encode(const uint8_t *in, int len, char *out, int outCap)
+{
+    static const char tbl[] =
+        "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    int need = (len + 2) / 3 * 4;
+    if (need + 1 > outCap) return 0;
+
+    int o = 0;
+    for (int i = 0; i < len; i += 3) {
+        uint32_t v = (uint32_t)in[i] << 16;
+        if (i + 1 < len) v |= (uint32_t)in[i + 1] << 8;
+        if (i + 2 < len) v |= in[i + 2];
+        out[o++] = tbl[(v >> 18) & 0x3F];
+        out[o++] = tbl[(v >> 12) & 0x3F];
+        out[o++] = (i + 1 < len) ? tbl[(v >> 6) & 0x3F] : '=';
+        out[o++] = (i + 2 < len) ? tbl[v & 0x3F] : '=';
+    }
+    out[o] = '\0';
+    return o;
+}
+
+/*
+ * Start a session over totalLen bytes and queue the first round.
+ * window is clamped to 1..XFER_MAX_WINDOW.  Replaces any open session.
+ */
+static inline void xferOpen(XferSession *s, uint8_t id, uint32_t totalLen,
+                            uint8_t window, XferFill fill, void *ctx)
+{
+    memset(s, 0, sizeof(*s));
+    if (window < 1) window = 1;
+    if (window > XFER_MAX_WINDOW) window = XFER_MAX_WINDOW;
+
+    uint32_t n = (totalLen + XFER_BLOCK_BYTES - 1) / XFER_BLOCK_BYTES;
+    if (n > 0xFFFF) {
+        n = 0xFFFF;
+        totalLen = n * XFER_BLOCK_BYTES;
+    }
+    s->active   = true;
+    s->id       = id;
+    s->window   = window;
+    s->totalLen = totalLen;
+    s->nBlocks  = (uint16_t)n;
+    s->fill     = fill;
+    s->ctx      = ctx;
+    s->round    = (n > 0);
+    if (n == 0) s->active = false;
+}
+
+/*
+ * Next block to transmit in the current round: flagged retransmits
+ * first, then new blocks up to base + window.  Returns false (and ends
+ * the round) when there is nothing more to send until the next ack.
+ */
+static inline bool xferNext(XferSession *s, uint16_t *blk)
+{
+    if (!s->active || !s->round) return false;
+
+    if (s->resend) {
+        int i = 0;
+        while (!(s->resend & (1UL << i))) i++;
+        s->resend &= ~(1UL << i);
+        *blk = (uint16_t)(s->base + i);
+        s->resent++;
+        return true;
+    }
+    if (s->next < s->nBlocks && s->next < (uint32_t)s->base + s->window) {
+        *blk = s->next++;
+        s->sent++;
+        return true;
+    }
+    s->round = false;
+    return false;
+}
+
+/*
+ * Apply the gateway's acknowledgement for session id.  Queues a round
+ * (retransmits + new blocks).  base == nBlocks completes the session.
+ * Returns false for a stale/unknown session or a base beyond what was sent.
+ */
+static inline bool xferAck(XferSession *s, uint8_t id, uint16_t base, uint32_t missing)
+{
+    if (!s->active || id != s->id || base > s->next) return false;
+
+    s->base = base;
+    if (base >= s->nBlocks) {
+        s->active = false;
+        s->round  = false;
+        s->resend = 0;
+        return true;
+    }
+
+    /* Only blocks actually sent can be missing; the rest go out as new */
+    uint32_t sentInWindow = (uint32_t)(s->next - base);
+    if (sentInWindow < XFER_MAX_WINDOW)
+        missing &= (1UL << sentInWindow) - 1;
+    if (s->window < XFER_MAX_WINDOW)
+        missing &= (1UL << s->window) - 1;
+    s->resend = missing;
+    s->round  = true;
+    return true;
+}
+
+/*
+ * Build the packet for block blk.  Returns length written to buf, or 0 on
+ * error.  buf should hold at least XFER_BLOCK_PKT_MAX + 1 bytes.
+ */
+static inline int xferBuildBlock(const XferSession *s, uint16_t blk,
+                                 const char *nodeId, char *buf, size_t bufCap)
+{
+    if (blk >= s->nBlocks) return 0;
+
+    uint32_t off = (uint32_t)blk * XFER_BLOCK_BYTES;
+    int len = (int)(s->totalLen - off < XFER_BLOCK_BYTES ? s->totalLen - off
+                                                         : XFER_BLOCK_BYTES);
+    uint8_t raw[XFER_BLOCK_BYTES];
+    int got = s->fill(off, raw, len, s->ctx);
+    if (got < len) memset(raw + got, 0, (size_t)(len - got));
+
+    char data[XFER_BLOCK_BYTES / 3 * 4 + 1];
+    if (b64Encode(raw, len, data, sizeof(data)) == 0 && len > 0) return 0;
+
+    /* CRC payload (sorted keys, no "c"): b < d < n < t < x */
+    char crcBuf[LORA_MAX_PAYLOAD];
+    int cLen = snprintf(crcBuf, sizeof(crcBuf),
+                        "{\"b\":%u,\"d\":\"%s\",\"n\":\"%s\",\"t\":\"blk\",\"x\":%u}",
+                        (unsigned)blk, data, nodeId, (unsigned)s->id);
+    if (cLen <= 0 || cLen >= (int)sizeof(crcBuf)) return 0;
+
+    uint32_t crc = crc32_compute(crcBuf, cLen);
+
+    /* Final packet with padding for ASR650x TX-FIFO workaround */
+    buf[0] = buf[1] = buf[2] = buf[3] = ' ';
+    int pLen = snprintf(buf + 4, bufCap - 4,
+                        "{\"b\":%u,\"c\":\"%08x\",\"d\":\"%s\",\"n\":\"%s\",\"t\":\"blk\",\"x\":%u}",
+                        (unsigned)blk, crc, data, nodeId, (unsigned)s->id);
+    if (pLen <= 0 || pLen >= (int)(bufCap - 4)) return 0;
+    return pLen + 4;
+}
+
 /* ─── Command Callback Registry ──────────────────────────────────────────── */
 
 typedef enum {
@@ -507,7 +719,7 @@ typedef enum {
 /* Callback signature: receives command name and args */
 typedef void (*CommandCallback)(const char *cmd, char args[][CMD_MAX_ARG_LEN], int arg_count);
 
-#define CMD_REGISTRY_MAX 32
+#define CMD_REGISTRY_MAX 40
 
 typedef struct {
     const char      *cmd;       /* Command name to match */
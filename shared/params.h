@@ -7,9 +7,11 @@
  *
  *   - paramGet()           Single param lookup → JSON response
  *   - paramSet()           Validate + set + optional callback → JSON response
- *   - paramsList()         Paginated param listing → JSON with "more" flag
- *   - cmdsList()           Paginated command name listing → JSON with "more" flag
+ *   - paramsListAt()       Cursor-paginated param listing → JSON with "more" flag
+ *   - cmdsListAt()         Cursor-paginated command name listing
+ *   - paramsList() / cmdsList()  Legacy page-number forms of the above
  *   - paramsSyncToConfig() Copy runtime params to NodeConfig for EEPROM persistence
+ *   - paramsLoadFromConfig() Copy a NodeConfig back into the params (profiles)
  *
  * All JSON output uses alphabetically-sorted keys for CRC compatibility
  * with Python's json.dumps(sort_keys=True).
@@ -43,6 +45,15 @@ typedef enum {
 /* Optional callback invoked after a param is updated via setparam. */
 typedef void (*ParamOnSet)(const char *name);
 
+/*
+ * Optional getter for computed (virtual) params: writes the current value
+ * to *out as the param's type (a null-terminated string for PARAM_STRING,
+ * at most PARAM_GETTER_STR_MAX bytes).  Such params are always read-only.
+ */
+typedef void (*ParamGetter)(void *out);
+
+#define PARAM_GETTER_STR_MAX 24
+
 /* Sentinel: param is not persisted to EEPROM. */
 #define CFG_OFFSET_NONE 0xFF
 
@@ -56,17 +67,30 @@ typedef struct {
     bool         writable;   /* false = read-only via setparam */
     ParamOnSet   onSet;      /* optional callback after set (NULL if none) */
     uint8_t      cfgOffset;  /* offsetof() into NodeConfig, or CFG_OFFSET_NONE */
+    ParamGetter  getter;     /* computed on read instead of *ptr (ptr unused), or NULL */
 } ParamDef;
 
 /* ─── Internal Helpers ───────────────────────────────────────────────────── */
 
 /*
- * Format a single param as a JSON key:value fragment (no braces).
+ * Format a single param's value as JSON (number, or quoted string).
  * Returns bytes written (excluding null), or 0 if buffer too small.
- *   e.g. "txpwr":14   or   "nodeid":"ab01"
  */
-static inline int paramFmtKV(const ParamDef *p, char *buf, int bufSize)
+static inline int paramFmtValue(const ParamDef *p, char *buf, int bufSize)
 {
+    /* Virtual params: fetch the value into scratch space first */
+    union {
+        uint32_t u32;
+        char     str[PARAM_GETTER_STR_MAX];
+    } scratch;
+    const void *src = p->ptr;
+    if (p->getter) {
+        memset(&scratch, 0, sizeof(scratch));
+        p->getter(&scratch);
+        scratch.str[PARAM_GETTER_STR_MAX - 1] = '\0';
+        src = &scratch;
+    }
+
     /*
      * Use memcpy to read values via void* — avoids unaligned-access HardFault
      * on Cortex-M0+ when ptr points into a packed struct (e.g. NodeConfig).
@@ -74,38 +98,50 @@ static inline int paramFmtKV(const ParamDef *p, char *buf, int bufSize)
     int n = 0;
     switch (p->type) {
         case PARAM_INT8: {
-            int8_t v; memcpy(&v, p->ptr, sizeof(v));
-            n = snprintf(buf, bufSize, "\"%s\":%d", p->name, (int)v);
+            int8_t v; memcpy(&v, src, sizeof(v));
+            n = snprintf(buf, bufSize, "%d", (int)v);
             break;
         }
         case PARAM_UINT8: {
-            uint8_t v; memcpy(&v, p->ptr, sizeof(v));
-            n = snprintf(buf, bufSize, "\"%s\":%u", p->name, (unsigned)v);
+            uint8_t v; memcpy(&v, src, sizeof(v));
+            n = snprintf(buf, bufSize, "%u", (unsigned)v);
             break;
         }
         case PARAM_INT16: {
-            int16_t v; memcpy(&v, p->ptr, sizeof(v));
-            n = snprintf(buf, bufSize, "\"%s\":%d", p->name, (int)v);
+            int16_t v; memcpy(&v, src, sizeof(v));
+            n = snprintf(buf, bufSize, "%d", (int)v);
             break;
         }
         case PARAM_UINT16: {
-            uint16_t v; memcpy(&v, p->ptr, sizeof(v));
-            n = snprintf(buf, bufSize, "\"%s\":%u", p->name, (unsigned)v);
+            uint16_t v; memcpy(&v, src, sizeof(v));
+            n = snprintf(buf, bufSize, "%u", (unsigned)v);
             break;
         }
         case PARAM_UINT32: {
-            uint32_t v; memcpy(&v, p->ptr, sizeof(v));
-            n = snprintf(buf, bufSize, "\"%s\":%lu", p->name, (unsigned long)v);
+            uint32_t v; memcpy(&v, src, sizeof(v));
+            n = snprintf(buf, bufSize, "%lu", (unsigned long)v);
             break;
         }
         case PARAM_STRING:
-            n = snprintf(buf, bufSize, "\"%s\":\"%s\"",
-                         p->name, (const char *)p->ptr);
+            n = snprintf(buf, bufSize, "\"%s\"", (const char *)src);
             break;
     }
     return (n > 0 && n < bufSize) ? n : 0;
 }
 
+/*
+ * Format a single param as a JSON key:value fragment (no braces).
+ * Returns bytes written (excluding null), or 0 if buffer too small.
+ *   e.g. "txpwr":14   or   "nodeid":"ab01"
+ */
+static inline int paramFmtKV(const ParamDef *p, char *buf, int bufSize)
+{
+    int n = snprintf(buf, bufSize, "\"%s\":", p->name);
+    if (n <= 0 || n >= bufSize) return 0;
+    int v = paramFmtValue(p, buf + n, bufSize - n);
+    return v ? n + v : 0;
+}
+
 /* Look up a param by name. Returns index or -1 if not found. */
 static inline int paramFind(const ParamDef *table, int count, const char *name)
 {
@@ -166,7 +202,7 @@ static inline int paramSet(const ParamDef *table, int count,
 
     const ParamDef *p = &table[idx];
 
-    if (!p->writable) {
+    if (!p->writable || p->getter) {
         int n = snprintf(buf, bufSize, "{\"e\":\"read-only: %s\"}", name);
         return (n > 0 && n < bufSize) ? n : 0;
     }
@@ -213,7 +249,8 @@ static inline int paramSet(const ParamDef *table, int count,
 /* ─── paramsList ─────────────────────────────────────────────────────────── */
 
 /*
- * List parameters with values, paginated.
+ * List parameters with values, paginated by page number (legacy; page p
+ * re-packs pages 0..p-1 to find its start — prefer paramsListAt()).
  *   {"m":0,"p":{"rxduty":90,"txpwr":14}}
  *   {"m":1,"p":{"nodeid":"ab01","nodev":1}}   (more pages remain)
  *
@@ -286,7 +323,8 @@ static inline int paramsList(const ParamDef *table, int count,
 /* ─── cmdsList ───────────────────────────────────────────────────────────── */
 
 /*
- * List command names, paginated.
+ * List command names, paginated by page number (legacy — prefer
+ * cmdsListAt()).
  *   {"c":["blink","discover","echo"],"m":0}
  *
  * cmdNames must be pre-sorted alphabetically.
@@ -349,6 +387,166 @@ static inline int cmdsList(const char **cmdNames, int cmdCount,
     return pos;
 }
 
+/* ─── Cursors ────────────────────────────────────────────────────────────── */
+
+/*
+ * Page cursors: the *ListAt() forms return an opaque token "n" naming where
+ * the next page starts, so a follow-up request resumes without formatting
+ * the earlier pages again.  The token is 8 hex chars, start index then a
+ * 16-bit hash of the table's names; a cursor issued against a different
+ * table (firmware updated, build options changed mid-sweep) is rejected
+ * rather than silently skipping or repeating entries.
+ */
+#define PARAM_CURSOR_LEN 8
+
+/* FNV-1a over the names (including terminators), folded to 16 bits */
+static inline uint32_t paramHashStr(uint32_t h, const char *s)
+{
+    do {
+        h ^= (uint8_t)*s;
+        h *= 16777619UL;
+    } while (*s++);
+    return h;
+}
+
+static inline uint16_t paramsTableHash(const ParamDef *table, int count)
+{
+    uint32_t h = 2166136261UL;
+    for (int i = 0; i < count; i++) h = paramHashStr(h, table[i].name);
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+static inline uint16_t cmdsTableHash(const char **cmdNames, int cmdCount)
+{
+    uint32_t h = 2166136261UL;
+    for (int i = 0; i < cmdCount; i++) h = paramHashStr(h, cmdNames[i]);
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+/* True if tok has the shape of a cursor (vs. a legacy page number) */
+static inline bool paramCursorIsToken(const char *tok)
+{
+    if (strlen(tok) != PARAM_CURSOR_LEN) return false;
+    for (int i = 0; i < PARAM_CURSOR_LEN; i++) {
+        char c = tok[i];
+        if (!((c >= '0' && c <= '9') || (c >= 'a' && c <= 'f'))) return false;
+    }
+    return true;
+}
+
+/*
+ * Decode a cursor for a table of `count` entries hashing to `hash`.
+ * Returns false if malformed, stale or out of range.
+ */
+static inline bool paramCursorParse(const char *tok, uint16_t hash, int count, int *start)
+{
+    if (!paramCursorIsToken(tok)) return false;
+    uint32_t v = (uint32_t)strtoul(tok, NULL, 16);
+    if ((uint16_t)(v & 0xFFFF) != hash) return false;
+    int idx = (int)(v >> 16);
+    if (idx > count) return false;
+    *start = idx;
+    return true;
+}
+
+/* ─── paramsListAt ───────────────────────────────────────────────────────── */
+
+/*
+ * List parameters from index `start`, packing as many as fit.
+ *   {"m":0,"p":{"rxduty":90,"txpwr":14}}
+ *   {"m":1,"n":"000c9f3a","p":{"autosleep":0,...}}   (more remain)
+ *
+ * Pass "n" back (via paramCursorParse) to get the next page.  Work is
+ * proportional to the page, not to how far into the table it starts.
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int paramsListAt(const ParamDef *table, int count, int start,
+                               uint16_t hash, char *buf, int bufSize)
+{
+    /* {"m":1,"n":"sssshhhh","p":{ = 27; short form {"m":0,"p":{ = 12 */
+    const int longPrefix  = 19 + PARAM_CURSOR_LEN;
+    const int shortPrefix = 12;
+    if (bufSize < longPrefix + 3) return 0;
+    if (start < 0) start = 0;
+
+    /* Pack items after room for the long prefix; shift down if it's not needed */
+    int pos = longPrefix;
+    bool first = true;
+    int i;
+    for (i = start; i < count; i++) {
+        char item[80];
+        int itemLen = paramFmtKV(&table[i], item, sizeof(item));
+        if (itemLen == 0) continue;
+
+        /* Space needed: item + optional comma + closing }} + null */
+        int need = itemLen + (first ? 0 : 1) + 2 + 1;
+        if (pos + need > bufSize) break;
+
+        if (!first) buf[pos++] = ',';
+        memcpy(buf + pos, item, itemLen);
+        pos += itemLen;
+        first = false;
+    }
+
+    if (i < count) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "{\"m\":1,\"n\":\"%04x%04x\",\"p\":{",
+                 (unsigned)i, (unsigned)hash);
+        memcpy(buf, prefix, longPrefix);
+    } else {
+        memmove(buf + shortPrefix, buf + longPrefix, pos - longPrefix);
+        pos -= longPrefix - shortPrefix;
+        memcpy(buf, "{\"m\":0,\"p\":{", shortPrefix);
+    }
+
+    buf[pos++] = '}';
+    buf[pos++] = '}';
+    buf[pos]   = '\0';
+    return pos;
+}
+
+/* ─── cmdsListAt ─────────────────────────────────────────────────────────── */
+
+/*
+ * List command names from index `start`.
+ *   {"c":["blink","discover"],"m":1,"n":"00029f3a"}
+ *   {"c":["echo"],"m":0}
+ *
+ * cmdNames must be pre-sorted alphabetically.
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int cmdsListAt(const char **cmdNames, int cmdCount, int start,
+                             uint16_t hash, char *buf, int bufSize)
+{
+    /* Longest close: ],"m":1,"n":"sssshhhh"} + null */
+    const int suffixLen = 15 + PARAM_CURSOR_LEN + 1;
+    if (bufSize < 6 + suffixLen) return 0;
+    if (start < 0) start = 0;
+
+    int pos = snprintf(buf, bufSize, "{\"c\":[");
+    bool first = true;
+    int i;
+    for (i = start; i < cmdCount; i++) {
+        int nameLen = strlen(cmdNames[i]);
+        int need = nameLen + 2 + (first ? 0 : 1) + suffixLen;
+        if (pos + need > bufSize) break;
+
+        if (!first) buf[pos++] = ',';
+        buf[pos++] = '"';
+        memcpy(buf + pos, cmdNames[i], nameLen);
+        pos += nameLen;
+        buf[pos++] = '"';
+        first = false;
+    }
+
+    if (i < cmdCount)
+        pos += snprintf(buf + pos, bufSize - pos, "],\"m\":1,\"n\":\"%04x%04x\"}",
+                        (unsigned)i, (unsigned)hash);
+    else
+        pos += snprintf(buf + pos, bufSize - pos, "],\"m\":0}");
+    return pos;
+}
+
 /* ─── paramsTableIsSorted ────────────────────────────────────────────────── */
 
 /*
@@ -414,4 +612,54 @@ static inline void paramsSyncToConfig(const ParamDef *table, int count,
     }
 }
 
+/* ─── paramsLoadFromConfig ───────────────────────────────────────────────── */
+
+/*
+ * Inverse of paramsSyncToConfig(): copy every persisted, writable param
+ * from *src to its setparam target, invoking onSet for values that change.
+ * Staged params land in their cfg field only — call paramsApplyStaged()
+ * (and reconfigure the radio) to make them live, as with setparam.
+ * Values outside the param's minVal..maxVal (a corrupt or stale profile)
+ * are skipped and the param keeps its value; UINT32 params have no
+ * range, as with setparam.
+ *
+ * Returns the number of params whose value changed.
+ */
+static inline int paramsLoadFromConfig(const ParamDef *table, int count,
+                                       const NodeConfig *src)
+{
+    int changed = 0;
+    for (int i = 0; i < count; i++) {
+        if (table[i].cfgOffset == CFG_OFFSET_NONE || !table[i].writable) continue;
+
+        const uint8_t *from = (const uint8_t *)src + table[i].cfgOffset;
+        size_t size = 0;
+        switch (table[i].type) {
+            case PARAM_INT8:   size = sizeof(int8_t);   break;
+            case PARAM_UINT8:  size = sizeof(uint8_t);  break;
+            case PARAM_INT16:  size = sizeof(int16_t);  break;
+            case PARAM_UINT16: size = sizeof(uint16_t); break;
+            case PARAM_UINT32: size = sizeof(uint32_t); break;
+            case PARAM_STRING: break;
+        }
+        if (size == 0 || memcmp(table[i].ptr, from, size) == 0) continue;
+
+        long val = 0;
+        switch (table[i].type) {
+            case PARAM_INT8:   { int8_t v;   memcpy(&v, from, sizeof(v)); val = v; break; }
+            case PARAM_UINT8:  { uint8_t v;  memcpy(&v, from, sizeof(v)); val = v; break; }
+            case PARAM_INT16:  { int16_t v;  memcpy(&v, from, sizeof(v)); val = v; break; }
+            case PARAM_UINT16: { uint16_t v; memcpy(&v, from, sizeof(v)); val = v; break; }
+            default: break;
+        }
+        if (table[i].type != PARAM_UINT32 &&
+            (val < table[i].minVal || val > table[i].maxVal)) continue;
+
+        memcpy(table[i].ptr, from, size);
+        changed++;
+        if (table[i].onSet) table[i].onSet(table[i].name);
+    }
+    return changed;
+}
+
 #endif /* PARAMS_H */
@@ -0,0 +1,84 @@
+/*
+ * ringbuf.h — Single-producer / single-consumer byte ring
+ *
+ * One side pushes from interrupt context, the other pops from the main
+ * loop; no locking is needed on a single-core MCU because each index is
+ * written by exactly one side (head by the producer, tail by the
+ * consumer).  Size must be a power of two; one slot is kept empty to tell
+ * full from empty.
+ *
+ * Bytes that arrive while the ring is full are dropped and counted, and
+ * the fill high-water mark is tracked, so the ring can be sized from
+ * field data rather than guesswork.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef RINGBUF_H
+#define RINGBUF_H
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* ─── Ring State ───────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t           *buf;
+    uint16_t           mask;         /* size − 1                            */
+    volatile uint16_t  head;         /* next write (producer)               */
+    volatile uint16_t  tail;         /* next read  (consumer)               */
+    volatile uint32_t  overflows;    /* bytes dropped because ring was full */
+    volatile uint16_t  highWater;    /* max bytes ever queued               */
+} RingBuf;
+
+/* ─── Functions ────────────────────────────────────────────────────────── */
+
+/* `size` must be a power of two (capacity is size − 1) */
+static inline void ringInit(RingBuf *r, uint8_t *storage, uint16_t size)
+{
+    r->buf       = storage;
+    r->mask      = (uint16_t)(size - 1);
+    r->head      = 0;
+    r->tail      = 0;
+    r->overflows = 0;
+    r->highWater = 0;
+}
+
+static inline uint16_t ringCount(const RingBuf *r)
+{
+    return (uint16_t)((r->head - r->tail) & r->mask);
+}
+
+static inline uint16_t ringCapacity(const RingBuf *r)
+{
+    return r->mask;
+}
+
+/* Producer side.  Returns false (and counts the drop) if full. */
+static inline bool ringPush(RingBuf *r, uint8_t c)
+{
+    uint16_t head = r->head;
+    uint16_t next = (uint16_t)((head + 1) & r->mask);
+    if (next == r->tail) {
+        r->overflows++;
+        return false;
+    }
+    r->buf[head] = c;
+    r->head = next;
+
+    uint16_t n = (uint16_t)((next - r->tail) & r->mask);
+    if (n > r->highWater) r->highWater = n;
+    return true;
+}
+
+/* Consumer side.  Returns false if empty. */
+static inline bool ringPop(RingBuf *r, uint8_t *c)
+{
+    uint16_t tail = r->tail;
+    if (tail == r->head) return false;
+    *c = r->buf[tail];
+    r->tail = (uint16_t)((tail + 1) & r->mask);
+    return true;
+}
+
+#endif /* RINGBUF_H */
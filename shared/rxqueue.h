@@ -0,0 +1,121 @@
+/*
+ * rxqueue.h — Received-packet queue between the radio callback and the loop
+ *
+ * onRxDone() pushes each packet (payload, length, RSSI, SNR, arrival
+ * time) into a slot; the tick loop handles every queued packet in order
+ * and then releases it.  A command that arrives while the previous one is still being
+ * handled — a late-ACK handler running, or its ACK on the air — waits in
+ * the next slot instead of overwriting the buffer, so the gateway has
+ * nothing to retry.
+ *
+ * Single producer / single consumer: head is written only by the
+ * producer, tail only by the consumer, and a slot is handed over by
+ * advancing the index after the copy, so no locking is needed on a
+ * single-core MCU.  The consumer works on the slot in place (no second
+ * copy) and pops it when done.  Indices run freely and wrap at 256;
+ * RXQ_DEPTH must be a power of two, and every slot is usable.
+ *
+ * Packets that arrive while all slots are full are dropped and counted,
+ * as are packets of an invalid size; the high-water mark shows whether
+ * the depth is right for the command traffic.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef RXQUEUE_H
+#define RXQUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#ifndef LORA_MAX_PAYLOAD
+#define LORA_MAX_PAYLOAD 250
+#endif
+
+#ifndef RXQ_DEPTH
+#define RXQ_DEPTH            4        /* ~1 KB of RAM */
+#endif
+
+#if (RXQ_DEPTH & (RXQ_DEPTH - 1)) != 0 || RXQ_DEPTH > 128
+#error "RXQ_DEPTH must be a power of two, at most 128"
+#endif
+
+/* ─── Queue State ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t  buf[LORA_MAX_PAYLOAD + 1];   /* +1: room for a terminating NUL */
+    uint8_t  len;
+    int16_t  rssi;
+    int8_t   snr;
+    uint32_t rxUs;                        /* micros() at RX done (latency.h) */
+} RxqEntry;
+
+typedef struct {
+    RxqEntry          e[RXQ_DEPTH];
+    volatile uint8_t  head;         /* next slot to fill (producer)        */
+    volatile uint8_t  tail;         /* next slot to handle (consumer)      */
+    volatile uint8_t  highWater;    /* most packets ever queued            */
+    volatile uint32_t received;     /* packets queued                      */
+    volatile uint32_t dropped;      /* all slots full                      */
+    volatile uint32_t invalid;      /* empty or oversized                  */
+} RxQueue;
+
+/* ─── Functions ──────────────────────────────────────────────────────────── */
+
+static inline void rxqInit(RxQueue *q)
+{
+    memset(q, 0, sizeof(*q));
+}
+
+static inline uint8_t rxqCount(const RxQueue *q)
+{
+    return (uint8_t)(q->head - q->tail);
+}
+
+/* Producer side.  Returns false (and counts why) if the packet wasn't queued. */
+static inline bool rxqPush(RxQueue *q, const uint8_t *payload, uint16_t size,
+                           int16_t rssi, int8_t snr, uint32_t rxUs)
+{
+    if (size == 0 || size > LORA_MAX_PAYLOAD) {
+        q->invalid++;
+        return false;
+    }
+    uint8_t head = q->head;
+    if ((uint8_t)(head - q->tail) >= RXQ_DEPTH) {
+        q->dropped++;
+        return false;
+    }
+
+    RxqEntry *e = &q->e[head & (RXQ_DEPTH - 1)];
+    memcpy(e->buf, payload, size);
+    e->buf[size] = '\0';
+    e->len  = (uint8_t)size;
+    e->rssi = rssi;
+    e->snr  = snr;
+    e->rxUs = rxUs;
+    q->head = (uint8_t)(head + 1);     /* publish after the copy */
+
+    q->received++;
+    uint8_t n = (uint8_t)(q->head - q->tail);
+    if (n > q->highWater) q->highWater = n;
+    return true;
+}
+
+/* Consumer side: oldest queued packet, or NULL if none.  Stays queued until rxqPop(). */
+static inline RxqEntry *rxqPeek(RxQueue *q)
+{
+    uint8_t tail = q->tail;
+    if (tail == q->head) return NULL;
+    return &q->e[tail & (RXQ_DEPTH - 1)];
+}
+
+/* Release the packet returned by rxqPeek() */
+static inline void rxqPop(RxQueue *q)
+{
+    if (q->tail != q->head) q->tail = (uint8_t)(q->tail + 1);
+}
+
+#endif /* RXQUEUE_H */
@@ -0,0 +1,173 @@
+/*
+ * sched.h — Cooperative task scheduler for the tick loop
+ *
+ * The tick loop is a list of tasks run in order, each when its deadline
+ * comes up: every pass (period 0), every periodMs, or — for one-shot
+ * work — whenever the task asks to run next.  Nothing is preempted; a
+ * task does a short slice of work and returns.
+ *
+ * Work that has to wait (a delayed reset, a multi-step sequence) is
+ * written as a protothread: the task's resume point is kept in its
+ * SchedTask, so it reads top to bottom and yields with PT_WAIT_MS()
+ * instead of blocking the loop in a delay.  As with any stackless
+ * coroutine, locals don't survive a wait — keep state in statics, and
+ * declare any locals before PT_BEGIN() (C++ won't jump past them).
+ *
+ * Between passes the loop can sleep for schedNextDueIn().  A task that
+ * reacts to interrupts (radio IRQs) sleeps itself until its own next
+ * deadline and is woken with schedWake() when the loop comes back.
+ *
+ * Tasks are caller-owned structs registered by pointer: no heap, and a
+ * module can own and start its own task.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef SCHED_H
+#define SCHED_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#ifndef SCHED_MAX_TASKS
+#define SCHED_MAX_TASKS      8
+#endif
+
+/* ─── Types ──────────────────────────────────────────────────────────────── */
+
+typedef struct SchedTask SchedTask;
+typedef void (*SchedFn)(SchedTask *t, uint32_t now);
+
+struct SchedTask {
+    const char *name;
+    SchedFn     fn;
+    uint32_t    periodMs;   /* 0 = every pass until it sleeps or stops  */
+    uint32_t    dueMs;      /* millis() of the next run                 */
+    uint16_t    pt;         /* protothread resume point, 0 = top        */
+    bool        active;
+    uint32_t    runs;
+};
+
+/* Static initializer: SchedTask t = SCHED_TASK("led", taskLed, 10, true); */
+#define SCHED_TASK(name, fn, periodMs, active) \
+    { (name), (fn), (periodMs), 0, 0, (active), 0 }
+
+typedef struct {
+    SchedTask *tasks[SCHED_MAX_TASKS];
+    uint8_t    count;
+} Scheduler;
+
+/* ─── Protothreads ───────────────────────────────────────────────────────── */
+
+/*
+ * Resume points are case labels on __LINE__ (one wait per line), so a
+ * switch statement can't enclose a wait inside the task body.
+ */
+#define PT_BEGIN(t)     switch ((t)->pt) { case 0:
+
+/* Run again no sooner than ms from now, continuing after this line */
+#define PT_WAIT_MS(t, now, ms) \
+    do { schedSleep((t), (now), (ms)); (t)->pt = __LINE__; return; \
+         case __LINE__:; } while (0)
+
+/* Give the other tasks a pass, continuing after this line */
+#define PT_YIELD(t) \
+    do { (t)->pt = __LINE__; return; case __LINE__:; } while (0)
+
+/* Body finished: the task stops until schedStart() */
+#define PT_END(t)       } schedStop(t)
+
+/* ─── Tasks ──────────────────────────────────────────────────────────────── */
+
+static inline void schedInit(Scheduler *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+/* Register a task (first run at `now` if active).  Tasks run in the
+ * order they were added.  Returns false when the table is full. */
+static inline bool schedAdd(Scheduler *s, SchedTask *t, uint32_t now)
+{
+    if (s->count >= SCHED_MAX_TASKS) return false;
+    t->dueMs = now;
+    t->pt    = 0;
+    s->tasks[s->count++] = t;
+    return true;
+}
+
+/* (Re)start a task from the top of its body on the next pass */
+static inline void schedStart(SchedTask *t, uint32_t now)
+{
+    t->pt     = 0;
+    t->dueMs  = now;
+    t->active = true;
+}
+
+static inline void schedStop(SchedTask *t)
+{
+    t->pt     = 0;
+    t->active = false;
+}
+
+/* Next run ms from now (overrides the period for this one run) */
+static inline void schedSleep(SchedTask *t, uint32_t now, uint32_t ms)
+{
+    t->dueMs = now + ms;
+}
+
+/* Run on the next pass, e.g. after an interrupt left it work.  Unlike
+ * schedStart() a protothread resumes where it was (ending a wait early);
+ * a stopped task stays stopped. */
+static inline void schedWake(SchedTask *t, uint32_t now)
+{
+    if (t->active) t->dueMs = now;
+}
+
+static inline bool schedDue(const SchedTask *t, uint32_t now)
+{
+    return t->active && (int32_t)(now - t->dueMs) >= 0;
+}
+
+/* ─── Running ────────────────────────────────────────────────────────────── */
+
+/*
+ * One pass: run every active task whose deadline has come, in order.
+ * A periodic task that fell more than a period behind skips the runs
+ * it missed rather than bursting to catch up.  Returns tasks run.
+ */
+static inline int schedRun(Scheduler *s, uint32_t now)
+{
+    int ran = 0;
+    for (int i = 0; i < s->count; i++) {
+        SchedTask *t = s->tasks[i];
+        if (!schedDue(t, now)) continue;
+        if (t->periodMs > 0) {
+            t->dueMs += t->periodMs;
+            if ((int32_t)(now - t->dueMs) >= 0) t->dueMs = now + t->periodMs;
+        }
+        t->runs++;
+        t->fn(t, now);
+        ran++;
+    }
+    return ran;
+}
+
+/* ms until the next active task is due: 0 if one is due now,
+ * UINT32_MAX if none is active */
+static inline uint32_t schedNextDueIn(const Scheduler *s, uint32_t now)
+{
+    uint32_t best = UINT32_MAX;
+    for (int i = 0; i < s->count; i++) {
+        const SchedTask *t = s->tasks[i];
+        if (!t->active) continue;
+        if (schedDue(t, now)) return 0;
+        uint32_t in = t->dueMs - now;
+        if (in < best) best = in;
+    }
+    return best;
+}
+
+#endif /* SCHED_H */
@@ -0,0 +1,174 @@
+/*
+ * stats.h — Per-node counters and the paged "stats" listing
+ *
+ * Counters the other modules don't already keep: why received packets
+ * were rejected (by ParseResult), packets for other nodes, duplicate
+ * and unrecognized commands, extra packets from split reading batches,
+ * and the longest gap between tick-loop passes — the figure to watch
+ * against the ~4 s watchdog.  TX/RX queue and sensor driver counters
+ * stay where they are; the "stats" handler gathers everything into a
+ * StatVal snapshot and pages it out with statsListAt().
+ *
+ * All counters run from boot (RAM, not saved) and wrap at 2^32.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef STATS_H
+#define STATS_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <string.h>
+#include "packets.h"    /* ParseResult */
+#include "params.h"     /* list cursors */
+
+/* ─── Counters ───────────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint32_t      parseFail[PARSE_RESULT_COUNT];  /* by reason; [PARSE_OK] unused */
+    uint32_t      notMe;        /* addressed to another node               */
+    uint32_t      dup;          /* retried command, cached ACK resent      */
+    uint32_t      unknownCmd;   /* no handler registered                   */
+    uint32_t      splitPkts;    /* reading packets beyond a batch's first  */
+    uint32_t      loopMaxMs;    /* longest gap between tick-loop passes    */
+    unsigned long loopLast;     /* millis() of the previous pass           */
+    bool          loopRunning;  /* false until the first pass after boot/sleep */
+} NodeStats;
+
+static inline void statsInit(NodeStats *s)
+{
+    memset(s, 0, sizeof(*s));
+}
+
+/* Call once per tick-loop pass, next to feedInnerWdt() */
+static inline void statsLoopMark(NodeStats *s, unsigned long now)
+{
+    if (s->loopRunning) {
+        uint32_t gap = (uint32_t)(now - s->loopLast);
+        if (gap > s->loopMaxMs) s->loopMaxMs = gap;
+    }
+    s->loopLast    = now;
+    s->loopRunning = true;
+}
+
+/* Deep sleep: the time asleep is not a stalled loop */
+static inline void statsLoopPause(NodeStats *s)
+{
+    s->loopRunning = false;
+}
+
+/* Packets rejected by parseCommandResult(), all reasons */
+static inline uint32_t statsParseFails(const NodeStats *s)
+{
+    uint32_t n = 0;
+    for (int i = PARSE_OK + 1; i < PARSE_RESULT_COUNT; i++) n += s->parseFail[i];
+    return n;
+}
+
+/* ─── Snapshot ───────────────────────────────────────────────────────────── */
+
+/* One listed counter: key + optional suffix (per-sensor "<name>_rf") */
+typedef struct {
+    const char *key;
+    const char *suffix;     /* NULL = none */
+    uint32_t    val;
+} StatVal;
+
+static inline int statKeyCmp(const StatVal *a, const StatVal *b)
+{
+    const char *sa = a->suffix ? a->suffix : "";
+    const char *sb = b->suffix ? b->suffix : "";
+    const char *pa = a->key, *pb = b->key;
+    for (;;) {
+        if (!*pa && sa) { pa = sa; sa = NULL; }
+        if (!*pb && sb) { pb = sb; sb = NULL; }
+        if (*pa != *pb || !*pa) return (uint8_t)*pa - (uint8_t)*pb;
+        pa++;
+        pb++;
+    }
+}
+
+/* Insertion sort by full key — alpha order for JSON CRC consistency */
+static inline void statsSort(StatVal *v, int count)
+{
+    for (int i = 1; i < count; i++) {
+        StatVal x = v[i];
+        int j = i - 1;
+        while (j >= 0 && statKeyCmp(&v[j], &x) > 0) {
+            v[j + 1] = v[j];
+            j--;
+        }
+        v[j + 1] = x;
+    }
+}
+
+/* Cursor hash over the full keys, so a sweep spanning a firmware update
+ * (or a sensor registered differently) is rejected as stale */
+static inline uint16_t statsHash(const StatVal *v, int count)
+{
+    uint32_t h = 2166136261UL;
+    for (int i = 0; i < count; i++) {
+        h = paramHashStr(h, v[i].key);
+        if (v[i].suffix) h = paramHashStr(h, v[i].suffix);
+    }
+    return (uint16_t)(h ^ (h >> 16));
+}
+
+/* ─── statsListAt ────────────────────────────────────────────────────────── */
+
+/*
+ * List counters from index `start` of a sorted snapshot, packing as
+ * many as fit — same paging and cursor as paramsListAt():
+ *   {"m":0,"s":{"tx":812,"tx_to":0}}
+ *   {"m":1,"n":"0009c41e","s":{"bme280_if":0,...}}   (more remain)
+ *
+ * Returns bytes written (excluding null), or 0 on buffer overflow.
+ */
+static inline int statsListAt(const StatVal *v, int count, int start,
+                              uint16_t hash, char *buf, int bufSize)
+{
+    const int longPrefix  = 19 + PARAM_CURSOR_LEN;
+    const int shortPrefix = 12;
+    if (bufSize < longPrefix + 3) return 0;
+    if (start < 0) start = 0;
+
+    int pos = longPrefix;
+    bool first = true;
+    int i;
+    for (i = start; i < count; i++) {
+        char item[48];
+        int itemLen = snprintf(item, sizeof(item), "\"%s%s\":%lu", v[i].key,
+                               v[i].suffix ? v[i].suffix : "",
+                               (unsigned long)v[i].val);
+        if (itemLen <= 0 || itemLen >= (int)sizeof(item)) continue;
+
+        /* Space needed: item + optional comma + closing }} + null */
+        int need = itemLen + (first ? 0 : 1) + 2 + 1;
+        if (pos + need > bufSize) break;
+
+        if (!first) buf[pos++] = ',';
+        memcpy(buf + pos, item, itemLen);
+        pos += itemLen;
+        first = false;
+    }
+
+    if (i < count) {
+        char prefix[32];
+        snprintf(prefix, sizeof(prefix), "{\"m\":1,\"n\":\"%04x%04x\",\"s\":{",
+                 (unsigned)i, (unsigned)hash);
+        memcpy(buf, prefix, longPrefix);
+    } else {
+        memmove(buf + shortPrefix, buf + longPrefix, pos - longPrefix);
+        pos -= longPrefix - shortPrefix;
+        memcpy(buf, "{\"m\":0,\"s\":{", shortPrefix);
+    }
+
+    buf[pos++] = '}';
+    buf[pos++] = '}';
+    buf[pos]   = '\0';
+    return pos;
+}
+
+#endif /* STATS_H */
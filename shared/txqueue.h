@@ -0,0 +1,230 @@
+/*
+ * txqueue.h — Prioritized LoRa transmit queue
+ *
+ * Packets are queued instead of sent with a blocking wait for TX done.
+ * The sketch starts the best queued packet whenever the radio is free,
+ * and the TxDone callback finishes it and starts the next one, so split
+ * sensor packets and bulk-transfer blocks go out back-to-back while the
+ * main loop keeps feeding the GPS, servicing RX and running the scheduler.
+ *
+ * Ordering: lower priority value first (ACKs before sensor data before
+ * bulk blocks), FIFO within a priority.  Each entry carries:
+ *   - its channel, so the queue can mix N2G traffic with anything else
+ *   - a hold time (broadcast ACK jitter) before which it isn't started
+ *   - a deadline past which it is dropped unsent — a late ACK or stale
+ *     reading only costs airtime
+ * When the queue is full a new packet evicts the oldest queued entry of
+ * the same or lower priority; if there is none it is dropped.
+ *
+ * Counters (depth high-water, sent, dropped, expired, TX timeouts and
+ * queue→TX-done latency) are kept for the "txq" command.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef TXQUEUE_H
+#define TXQUEUE_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+/* ─── Configuration ──────────────────────────────────────────────────────── */
+
+#ifndef LORA_MAX_PAYLOAD
+#define LORA_MAX_PAYLOAD 250
+#endif
+
+#ifndef TXQ_DEPTH
+#define TXQ_DEPTH            4        /* ~1 KB of RAM */
+#endif
+
+#define TXQ_NO_DEADLINE      0xFFFFFFFFUL
+
+/* Priorities, most urgent first */
+#define TXQ_PRIO_ACK         0
+#define TXQ_PRIO_DATA        1
+#define TXQ_PRIO_BULK        2
+
+/* ─── Queue State ────────────────────────────────────────────────────────── */
+
+typedef struct {
+    uint8_t       buf[LORA_MAX_PAYLOAD];
+    uint8_t       len;          /* 0 = free slot                         */
+    uint8_t       prio;
+    uint32_t      freqHz;       /* channel to transmit on                */
+    unsigned long queuedAt;
+    unsigned long notBefore;    /* held until then (ACK jitter)          */
+    unsigned long deadline;     /* dropped if not started by then        */
+    uint32_t      seq;          /* FIFO order within a priority          */
+} TxqEntry;
+
+typedef struct {
+    TxqEntry      e[TXQ_DEPTH];
+    int8_t        inFlight;     /* slot on the air, -1 = radio free      */
+    uint8_t       depth;        /* queued + in flight                    */
+    uint8_t       maxDepth;
+    uint32_t      seq;
+    unsigned long startedAt;
+
+    uint32_t      sent;
+    uint32_t      dropped;      /* queue full (evicted or rejected)      */
+    uint32_t      expired;      /* deadline passed before starting       */
+    uint32_t      timeouts;     /* no TX done from the radio             */
+    uint32_t      latLastMs;    /* queued → TX done                      */
+    uint32_t      latMaxMs;
+    uint32_t      latSumMs;     /* over `sent`, for the mean             */
+} TxQueue;
+
+/* ─── Functions ──────────────────────────────────────────────────────────── */
+
+static inline void txqInit(TxQueue *q)
+{
+    memset(q, 0, sizeof(*q));
+    q->inFlight = -1;
+}
+
+/* True if a slot a is to be sent before slot b */
+static inline bool txqBefore(const TxqEntry *a, const TxqEntry *b)
+{
+    if (a->prio != b->prio) return a->prio < b->prio;
+    return (int32_t)(a->seq - b->seq) < 0;
+}
+
+static inline void txqFree(TxQueue *q, int slot)
+{
+    q->e[slot].len = 0;
+    q->depth--;
+}
+
+/*
+ * Queue a packet.  holdMs delays its start; maxAgeMs (from when it may
+ * start) bounds how long it may wait.  Returns the slot, or -1 if it
+ * was dropped (too long, or queue full of more urgent traffic).
+ */
+static inline int txqPush(TxQueue *q, const void *buf, int len, uint8_t prio,
+                          uint32_t freqHz, unsigned long now,
+                          unsigned long holdMs, unsigned long maxAgeMs)
+{
+    if (len <= 0 || len > LORA_MAX_PAYLOAD) { q->dropped++; return -1; }
+
+    int slot = -1;
+    for (int i = 0; i < TXQ_DEPTH; i++)
+        if (q->e[i].len == 0) { slot = i; break; }
+
+    if (slot < 0) {
+        /* Full: evict the oldest entry that is no more urgent than this one */
+        for (int i = 0; i < TXQ_DEPTH; i++) {
+            if (i == q->inFlight || q->e[i].prio < prio) continue;
+            if (slot < 0 || q->e[i].prio > q->e[slot].prio ||
+                (q->e[i].prio == q->e[slot].prio && txqBefore(&q->e[i], &q->e[slot])))
+                slot = i;
+        }
+        q->dropped++;
+        if (slot < 0) return -1;
+        txqFree(q, slot);
+    }
+
+    TxqEntry *e = &q->e[slot];
+    memcpy(e->buf, buf, (size_t)len);
+    e->len       = (uint8_t)len;
+    e->prio      = prio;
+    e->freqHz    = freqHz;
+    e->queuedAt  = now;
+    e->notBefore = now + holdMs;
+    e->deadline  = now + holdMs + maxAgeMs;
+    e->seq       = q->seq++;
+    q->depth++;
+    if (q->depth > q->maxDepth) q->maxDepth = q->depth;
+    return slot;
+}
+
+/* Drop entries whose deadline has passed (never the one on the air) */
+static inline void txqExpire(TxQueue *q, unsigned long now)
+{
+    for (int i = 0; i < TXQ_DEPTH; i++) {
+        if (q->e[i].len == 0 || i == q->inFlight) continue;
+        if ((long)(now - q->e[i].deadline) > 0) {
+            txqFree(q, i);
+            q->expired++;
+        }
+    }
+}
+
+/*
+ * Pick the next packet to put on the air and mark it in flight.
+ * Returns its slot (send q->e[slot]), or -1 if the radio is busy or
+ * nothing is ready.
+ */
+static inline int txqStart(TxQueue *q, unsigned long now)
+{
+    if (q->inFlight >= 0) return -1;
+    txqExpire(q, now);
+
+    int best = -1;
+    for (int i = 0; i < TXQ_DEPTH; i++) {
+        const TxqEntry *e = &q->e[i];
+        if (e->len == 0 || (long)(now - e->notBefore) < 0) continue;
+        if (best < 0 || txqBefore(e, &q->e[best])) best = i;
+    }
+    if (best >= 0) {
+        q->inFlight  = (int8_t)best;
+        q->startedAt = now;
+    }
+    return best;
+}
+
+/*
+ * The packet on the air finished (ok = TX done) or was abandoned
+ * (ok = false: radio timeout).  Returns its priority, or -1 if nothing
+ * was in flight.
+ */
+static inline int txqFinish(TxQueue *q, unsigned long now, bool ok)
+{
+    int slot = q->inFlight;
+    if (slot < 0) return -1;
+    int prio = q->e[slot].prio;
+
+    if (ok) {
+        uint32_t lat = (uint32_t)(now - q->e[slot].queuedAt);
+        q->sent++;
+        q->latLastMs = lat;
+        q->latSumMs += lat;
+        if (lat > q->latMaxMs) q->latMaxMs = lat;
+    } else {
+        q->timeouts++;
+    }
+    txqFree(q, slot);
+    q->inFlight = -1;
+    return prio;
+}
+
+static inline bool txqBusy(const TxQueue *q)  { return q->inFlight >= 0; }
+static inline bool txqEmpty(const TxQueue *q) { return q->depth == 0; }
+
+/* ms the current packet has been on the air (0 if none) */
+static inline unsigned long txqAirMs(const TxQueue *q, unsigned long now)
+{
+    return q->inFlight >= 0 ? now - q->startedAt : 0;
+}
+
+/* ms until a queued packet may start: 0 if one can now, TXQ_NO_DEADLINE if empty */
+static inline unsigned long txqDueIn(const TxQueue *q, unsigned long now)
+{
+    unsigned long due = TXQ_NO_DEADLINE;
+    for (int i = 0; i < TXQ_DEPTH; i++) {
+        if (q->e[i].len == 0 || i == q->inFlight) continue;
+        long wait = (long)(q->e[i].notBefore - now);
+        unsigned long ms = wait > 0 ? (unsigned long)wait : 0;
+        if (ms < due) due = ms;
+    }
+    return due;
+}
+
+/* Mean queued → TX done latency (ms) */
+static inline uint32_t txqLatAvgMs(const TxQueue *q)
+{
+    return q->sent ? q->latSumMs / q->sent : 0;
+}
+
+#endif /* TXQUEUE_H */
@@ -0,0 +1,330 @@
+/*
+ * ubx.h — u-blox UBX binary protocol: frame builders and NAV parser
+ *
+ * Alternative to nmea.h for the NEO-6M.  At init the receiver is told to
+ * stop its NMEA stream and emit only NAV-POSLLH + NAV-SOL once per
+ * navigation epoch (~100 bytes/s instead of ~420), and to run in power
+ * save mode.  Between samples it can be put into backup with RXM-PMREQ.
+ *
+ * The NEO-6M predates NAV-PVT (u-blox 7+), so position comes from
+ * NAV-POSLLH and fix status / satellite count from NAV-SOL.  Both carry
+ * the epoch's iTOW; the location is committed when a NAV-SOL with
+ * gpsFixOk arrives for the same epoch as the pending NAV-POSLLH.
+ *
+ * Decoded values land in the same NmeaFix (and NMEA_HAVE_* bits) that
+ * nmea.h fills, so callers don't care which protocol is on the wire.
+ *
+ * Static inline with no Arduino deps so it can be tested natively.
+ */
+
+#ifndef UBX_H
+#define UBX_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include "nmea.h"
+
+/* ─── Protocol Constants ───────────────────────────────────────────────── */
+
+#define UBX_SYNC1           0xB5
+#define UBX_SYNC2           0x62
+#define UBX_OVERHEAD        8       /* sync(2) + class/id(2) + len(2) + ck(2) */
+
+#define UBX_CLASS_NAV       0x01
+#define UBX_CLASS_RXM       0x02
+#define UBX_CLASS_ACK       0x05
+#define UBX_CLASS_CFG       0x06
+#define UBX_CLASS_NMEA      0xF0    /* standard NMEA sentences, for CFG-MSG */
+
+#define UBX_NAV_POSLLH      0x02
+#define UBX_NAV_SOL         0x06
+#define UBX_RXM_PMREQ       0x41
+#define UBX_ACK_NAK         0x00
+#define UBX_ACK_ACK         0x01
+#define UBX_CFG_MSG         0x01
+#define UBX_CFG_RATE        0x08
+#define UBX_CFG_RXM         0x11
+
+#define UBX_NAV_POSLLH_LEN  28
+#define UBX_NAV_SOL_LEN     52
+
+/* CFG-RXM lpMode */
+#define UBX_RXM_CONTINUOUS  0
+#define UBX_RXM_POWER_SAVE  1
+
+/* Largest payload the parser keeps (NAV-SOL); longer messages are skipped */
+#define UBX_MAX_PAYLOAD     UBX_NAV_SOL_LEN
+
+/* ─── Frame Building ───────────────────────────────────────────────────── */
+
+/* 8-bit Fletcher over class, id, length and payload */
+static inline void ubxChecksum(const uint8_t *buf, uint16_t len,
+                               uint8_t *ckA, uint8_t *ckB)
+{
+    uint8_t a = 0, b = 0;
+    for (uint16_t i = 0; i < len; i++) {
+        a = (uint8_t)(a + buf[i]);
+        b = (uint8_t)(b + a);
+    }
+    *ckA = a;
+    *ckB = b;
+}
+
+/* Frame a message into buf.  Returns frame length, or 0 if it won't fit. */
+static inline int ubxBuild(uint8_t *buf, int max, uint8_t cls, uint8_t id,
+                           const uint8_t *payload, uint16_t len)
+{
+    if (max < (int)len + UBX_OVERHEAD) return 0;
+
+    buf[0] = UBX_SYNC1;
+    buf[1] = UBX_SYNC2;
+    buf[2] = cls;
+    buf[3] = id;
+    buf[4] = (uint8_t)(len & 0xFF);
+    buf[5] = (uint8_t)(len >> 8);
+    if (len) memcpy(buf + 6, payload, len);
+    ubxChecksum(buf + 2, (uint16_t)(len + 4), &buf[6 + len], &buf[7 + len]);
+    return len + UBX_OVERHEAD;
+}
+
+static inline void ubxPutU16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+}
+
+static inline void ubxPutU32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)v;
+    p[1] = (uint8_t)(v >> 8);
+    p[2] = (uint8_t)(v >> 16);
+    p[3] = (uint8_t)(v >> 24);
+}
+
+/* CFG-MSG: output rate of (cls, id) on the current port, per nav epoch */
+static inline int ubxCfgMsg(uint8_t *buf, int max, uint8_t cls, uint8_t id,
+                            uint8_t rate)
+{
+    uint8_t p[3] = { cls, id, rate };
+    return ubxBuild(buf, max, UBX_CLASS_CFG, UBX_CFG_MSG, p, sizeof(p));
+}
+
+/* CFG-RATE: navigation epoch period, GPS time reference */
+static inline int ubxCfgRate(uint8_t *buf, int max, uint16_t measMs)
+{
+    uint8_t p[6];
+    ubxPutU16(p, measMs);
+    ubxPutU16(p + 2, 1);        /* navRate: one solution per measurement */
+    ubxPutU16(p + 4, 1);        /* timeRef: GPS time */
+    return ubxBuild(buf, max, UBX_CLASS_CFG, UBX_CFG_RATE, p, sizeof(p));
+}
+
+/* CFG-RXM: continuous or power save (cyclic tracking) */
+static inline int ubxCfgRxm(uint8_t *buf, int max, uint8_t lpMode)
+{
+    uint8_t p[2] = { 8, lpMode };   /* reserved1 must be 8 */
+    return ubxBuild(buf, max, UBX_CLASS_CFG, UBX_CFG_RXM, p, sizeof(p));
+}
+
+/*
+ * RXM-PMREQ: enter backup for durationMs, then restart on its own
+ * (hot start while ephemeris is valid).  0 = until EXTINT / power cycle.
+ */
+static inline int ubxRxmPmreq(uint8_t *buf, int max, uint32_t durationMs)
+{
+    uint8_t p[8];
+    ubxPutU32(p, durationMs);
+    ubxPutU32(p + 4, 0x02);     /* flags: backup */
+    return ubxBuild(buf, max, UBX_CLASS_RXM, UBX_RXM_PMREQ, p, sizeof(p));
+}
+
+/* ─── Parser State ─────────────────────────────────────────────────────── */
+
+typedef enum {
+    UBX_ST_SYNC1 = 0,
+    UBX_ST_SYNC2,
+    UBX_ST_CLASS,
+    UBX_ST_ID,
+    UBX_ST_LEN1,
+    UBX_ST_LEN2,
+    UBX_ST_PAYLOAD,
+    UBX_ST_CK_A,
+    UBX_ST_CK_B
+} UbxState;
+
+typedef struct {
+    NmeaFix  fix;           /* committed values (nmea.h layout)         */
+    uint8_t  updated;       /* NMEA_HAVE_* committed since last take    */
+    uint8_t  fixType;       /* NAV-SOL gpsFix: 0 none … 3 3D            */
+
+    /* Counters (same meaning as NmeaParser) */
+    uint32_t chars;
+    uint32_t passed;
+    uint32_t failed;
+    uint32_t acks;
+    uint32_t naks;
+
+    /* Frame in progress */
+    uint8_t  state;         /* UbxState                                 */
+    uint8_t  cls;
+    uint8_t  id;
+    uint16_t len;
+    uint16_t idx;
+    uint8_t  ckA, ckB;
+    uint8_t  payload[UBX_MAX_PAYLOAD];
+
+    /* NAV-POSLLH waiting for its epoch's NAV-SOL */
+    uint32_t pendTow;
+    int32_t  pendLat, pendLon, pendAlt;
+    bool     pendHave;
+} UbxParser;
+
+/* ─── Helpers ──────────────────────────────────────────────────────────── */
+
+static inline void ubxInit(UbxParser *p)
+{
+    memset(p, 0, sizeof(*p));
+}
+
+static inline uint32_t ubxGetU32(const uint8_t *b)
+{
+    return (uint32_t)b[0] | ((uint32_t)b[1] << 8) |
+           ((uint32_t)b[2] << 16) | ((uint32_t)b[3] << 24);
+}
+
+static inline void ubxCkStep(UbxParser *p, uint8_t c)
+{
+    p->ckA = (uint8_t)(p->ckA + c);
+    p->ckB = (uint8_t)(p->ckB + p->ckA);
+}
+
+/* Checksum matched: decode the frame into the fix */
+static inline void ubxHandle(UbxParser *p)
+{
+    const uint8_t *b = p->payload;
+
+    if (p->cls == UBX_CLASS_ACK) {
+        if (p->id == UBX_ACK_ACK) p->acks++;
+        else if (p->id == UBX_ACK_NAK) p->naks++;
+        return;
+    }
+    if (p->cls != UBX_CLASS_NAV) return;
+
+    if (p->id == UBX_NAV_POSLLH && p->len == UBX_NAV_POSLLH_LEN) {
+        p->pendTow  = ubxGetU32(b);
+        p->pendLon  = (int32_t)ubxGetU32(b + 4);
+        p->pendLat  = (int32_t)ubxGetU32(b + 8);
+        p->pendAlt  = (int32_t)ubxGetU32(b + 16) / 10;   /* hMSL mm → cm */
+        p->pendHave = true;
+    } else if (p->id == UBX_NAV_SOL && p->len == UBX_NAV_SOL_LEN) {
+        uint32_t tow   = ubxGetU32(b);
+        uint8_t  gfix  = b[10];
+        bool     fixOk = (b[11] & 0x01) && gfix >= 2 && gfix <= 4;
+        uint8_t  take  = NMEA_HAVE_SATS;
+
+        p->fixType  = gfix;
+        p->fix.sats = b[47];
+
+        if (fixOk && p->pendHave && p->pendTow == tow) {
+            p->fix.lat_e7 = p->pendLat;
+            p->fix.lon_e7 = p->pendLon;
+            take |= NMEA_HAVE_LOC;
+            if (gfix != 2) {                /* 2D fix has no usable height */
+                p->fix.alt_cm = p->pendAlt;
+                take |= NMEA_HAVE_ALT;
+            }
+        }
+        p->pendHave = false;
+
+        p->fix.valid |= take;
+        p->updated   |= take;
+    }
+}
+
+/* ─── Public API ───────────────────────────────────────────────────────── */
+
+/*
+ * Feed one byte.  Returns true when it completed a frame with a valid
+ * checksum (any class), like nmeaEncode().
+ */
+static inline bool ubxEncode(UbxParser *p, uint8_t c)
+{
+    p->chars++;
+
+    switch (p->state) {
+    case UBX_ST_SYNC1:
+        if (c == UBX_SYNC1) p->state = UBX_ST_SYNC2;
+        return false;
+
+    case UBX_ST_SYNC2:
+        p->state = (c == UBX_SYNC2) ? UBX_ST_CLASS
+                 : (c == UBX_SYNC1) ? UBX_ST_SYNC2 : UBX_ST_SYNC1;
+        return false;
+
+    case UBX_ST_CLASS:
+        p->ckA = p->ckB = 0;
+        ubxCkStep(p, c);
+        p->cls   = c;
+        p->state = UBX_ST_ID;
+        return false;
+
+    case UBX_ST_ID:
+        ubxCkStep(p, c);
+        p->id    = c;
+        p->state = UBX_ST_LEN1;
+        return false;
+
+    case UBX_ST_LEN1:
+        ubxCkStep(p, c);
+        p->len   = c;
+        p->state = UBX_ST_LEN2;
+        return false;
+
+    case UBX_ST_LEN2:
+        ubxCkStep(p, c);
+        p->len  |= (uint16_t)c << 8;
+        p->idx   = 0;
+        p->state = p->len ? UBX_ST_PAYLOAD : UBX_ST_CK_A;
+        return false;
+
+    case UBX_ST_PAYLOAD:
+        ubxCkStep(p, c);
+        if (p->idx < UBX_MAX_PAYLOAD) p->payload[p->idx] = c;
+        if (++p->idx >= p->len) p->state = UBX_ST_CK_A;
+        return false;
+
+    case UBX_ST_CK_A:
+        if (c != p->ckA) {
+            p->failed++;
+            p->state = UBX_ST_SYNC1;
+            return false;
+        }
+        p->state = UBX_ST_CK_B;
+        return false;
+
+    case UBX_ST_CK_B:
+        p->state = UBX_ST_SYNC1;
+        if (c != p->ckB) {
+            p->failed++;
+            return false;
+        }
+        p->passed++;
+        if (p->len <= UBX_MAX_PAYLOAD) ubxHandle(p);
+        return true;
+
+    default:
+        p->state = UBX_ST_SYNC1;
+        return false;
+    }
+}
+
+/* Return and clear the NMEA_HAVE_* bits committed since the last call. */
+static inline uint8_t ubxTakeUpdated(UbxParser *p)
+{
+    uint8_t u = p->updated;
+    p->updated = 0;
+    return u;
+}
+
+#endif /* UBX_H */
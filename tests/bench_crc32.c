@@ -0,0 +1,98 @@
+/*
+ * bench_crc32.c — Throughput of each crc32.h table strategy
+ *
+ * Usage: make bench  (from tests/)  or  bench_crc32 [passes]
+ *
+ * Runs every strategy over packet-sized buffers (the node's real
+ * workload: one LoRa payload or flash row at a time) and over a large
+ * buffer, reports MB/s, and names the fastest.  The result on the build
+ * host is what CRC32_STRATEGY defaults to for native builds; on the MCU
+ * the default is CRC32_BYTE (flash, no RAM tables).  Table footprint is
+ * printed alongside so the speed can be weighed against flash/RAM.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define CRC32_IMPL
+#define CRC32_ALL_STRATEGIES
+#include "crc32.h"
+
+#define BENCH_DEFAULT_PASSES 200
+#define BENCH_BIG_BYTES      (1024 * 1024)
+#define BENCH_PKT_BYTES      250     /* LORA_MAX_PAYLOAD */
+
+/* ─── Strategies ───────────────────────────────────────────────────────── */
+
+typedef struct {
+    const char *name;
+    uint32_t  (*fn)(uint32_t, const void *, size_t);
+    unsigned    flashBytes;
+    unsigned    ramBytes;
+} Strategy;
+
+static const Strategy strategies[] = {
+    { "byte",   crc32_update_byte,   sizeof(CRC32_TABLE),        0         },
+    { "nibble", crc32_update_nibble, sizeof(CRC32_NIBBLE_TABLE), 0         },
+    { "slice4", crc32_update_slice4, sizeof(CRC32_TABLE),        4 * 1024  },
+    { "slice8", crc32_update_slice8, sizeof(CRC32_TABLE),        8 * 1024  },
+};
+#define STRATEGY_COUNT (int)(sizeof(strategies) / sizeof(strategies[0]))
+
+/* ─── Timing ───────────────────────────────────────────────────────────── */
+
+/* MB/s over `passes` runs of `len`-byte chunks through buf */
+static double runMBps(const Strategy *s, const uint8_t *buf, size_t total,
+                      size_t len, int passes, uint32_t *sink)
+{
+    clock_t t0 = clock();
+    for (int p = 0; p < passes; p++)
+        for (size_t off = 0; off + len <= total; off += len)
+            *sink += s->fn(0, buf + off, len);
+    double sec = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    double bytes = (double)passes * (double)(total / len * len);
+    return sec > 0 ? bytes / sec / 1e6 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    int passes = argc > 1 ? atoi(argv[1]) : BENCH_DEFAULT_PASSES;
+    if (passes < 1) passes = 1;
+
+    uint8_t *buf = malloc(BENCH_BIG_BYTES);
+    if (!buf) return 1;
+    uint32_t x = 0x12345678u;
+    for (size_t i = 0; i < BENCH_BIG_BYTES; i++) {
+        x = x * 1103515245u + 12345u;
+        buf[i] = (uint8_t)(x >> 16);
+    }
+
+    /* All strategies must agree before any timing means anything */
+    uint32_t ref = crc32_update_byte(0, buf, BENCH_BIG_BYTES);
+    for (int i = 1; i < STRATEGY_COUNT; i++) {
+        if (strategies[i].fn(0, buf, BENCH_BIG_BYTES) != ref) {
+            fprintf(stderr, "MISMATCH: %s\n", strategies[i].name);
+            return 1;
+        }
+    }
+
+    printf("%-8s %9s %9s %12s %12s\n", "strategy", "flash", "ram", "250B MB/s", "1MB MB/s");
+    uint32_t sink = 0;
+    int best = 0;
+    double bestPkt = 0;
+    for (int i = 0; i < STRATEGY_COUNT; i++) {
+        const Strategy *s = &strategies[i];
+        double pkt = runMBps(s, buf, BENCH_BIG_BYTES, BENCH_PKT_BYTES, passes / 4 + 1, &sink);
+        double big = runMBps(s, buf, BENCH_BIG_BYTES, BENCH_BIG_BYTES, passes / 4 + 1, &sink);
+        printf("%-8s %8uB %8uB %12.1f %12.1f\n", s->name, s->flashBytes, s->ramBytes, pkt, big);
+        if (pkt > bestPkt) { bestPkt = pkt; best = i; }
+    }
+
+    printf("\nfastest here: %s  (native default: %s; MCU default: byte)\n",
+           strategies[best].name, strategies[CRC32_STRATEGY - 1].name);
+    printf("(checksum %08x)\n", (unsigned)sink);
+    free(buf);
+    return 0;
+}
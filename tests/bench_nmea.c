@@ -0,0 +1,128 @@
+/*
+ * bench_nmea.c — Replay a captured NMEA log through nmea.h
+ *
+ * Usage: make bench  (from tests/)  or  bench_nmea [log.nmea] [passes]
+ *
+ * First pass checks every GGA/RMC fix against a double-precision
+ * reference decode (TinyGPS++ semantics: fix only with GGA quality > 0 /
+ * RMC status 'A', checksum must match).  Then the log is replayed
+ * `passes` times and parse throughput is reported in bytes/sec.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "nmea.h"
+
+#define BENCH_DEFAULT_LOG    "data/neo6m_walk.nmea"
+#define BENCH_DEFAULT_PASSES 2000
+
+/* ─── Reference Decode ─────────────────────────────────────────────────── */
+
+static double refDeg(const char *f, const char *hemi)
+{
+    double v   = strtod(f, NULL);
+    int    deg = (int)(v / 100.0);
+    double d   = deg + (v - deg * 100.0) / 60.0;
+    return (hemi[0] == 'S' || hemi[0] == 'W') ? -d : d;
+}
+
+/* Split a sentence body in place; returns field count */
+static int refSplit(char *s, char **fields, int max)
+{
+    int n = 0;
+    fields[n++] = s;
+    for (; *s && *s != '*'; s++) {
+        if (*s == ',' && n < max) { *s = '\0'; fields[n++] = s + 1; }
+    }
+    *s = '\0';
+    return n;
+}
+
+/* Check the parser's location after `line` passed; returns 0 on mismatch */
+static int refCheck(const NmeaParser *p, const char *line)
+{
+    char buf[128];
+    char *f[24];
+    strncpy(buf, line + 1, sizeof(buf) - 1);
+    buf[sizeof(buf) - 1] = '\0';
+    int n = refSplit(buf, f, 24);
+    if (n < 10 || strlen(f[0]) != 5) return 1;
+
+    const char *type = f[0] + 2;
+    int latIdx;
+    if (strcmp(type, "GGA") == 0) {
+        if (atoi(f[6]) == 0) return 1;
+        latIdx = 2;
+    } else if (strcmp(type, "RMC") == 0) {
+        if (f[2][0] != 'A') return 1;
+        latIdx = 3;
+    } else {
+        return 1;
+    }
+
+    double lat = refDeg(f[latIdx], f[latIdx + 1]);
+    double lon = refDeg(f[latIdx + 2], f[latIdx + 3]);
+    double dLat = p->fix.lat_e7 / 1e7 - lat;
+    double dLon = p->fix.lon_e7 / 1e7 - lon;
+    if (dLat > 1e-7 || dLat < -1e-7 || dLon > 1e-7 || dLon < -1e-7) {
+        fprintf(stderr, "mismatch: %s\n  got %.7f,%.7f want %.7f,%.7f\n",
+                line, p->fix.lat_e7 / 1e7, p->fix.lon_e7 / 1e7, lat, lon);
+        return 0;
+    }
+    return 1;
+}
+
+/* ─── Main ─────────────────────────────────────────────────────────────── */
+
+int main(int argc, char **argv)
+{
+    const char *path = argc > 1 ? argv[1] : BENCH_DEFAULT_LOG;
+    long passes = argc > 2 ? atol(argv[2]) : BENCH_DEFAULT_PASSES;
+
+    FILE *fp = fopen(path, "rb");
+    if (!fp) { perror(path); return 1; }
+    fseek(fp, 0, SEEK_END);
+    long size = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+    char *log = malloc((size_t)size + 1);
+    if (!log || fread(log, 1, (size_t)size, fp) != (size_t)size) {
+        fprintf(stderr, "%s: read failed\n", path);
+        return 1;
+    }
+    log[size] = '\0';
+    fclose(fp);
+
+    /* Correctness pass, sentence by sentence */
+    NmeaParser p;
+    nmeaInit(&p);
+    int checked = 0, bad = 0;
+    const char *line = log;
+    for (long i = 0; i < size; i++) {
+        if (log[i] == '$') line = log + i;
+        if (nmeaEncode(&p, log[i]) && (nmeaTakeUpdated(&p) & NMEA_HAVE_LOC)) {
+            checked++;
+            if (!refCheck(&p, line)) bad++;
+        }
+    }
+    printf("%s: %ld bytes, %lu passed, %lu failed checksum\n", path, size,
+           (unsigned long)p.passed, (unsigned long)p.failed);
+    printf("fixes checked: %d, mismatches: %d\n", checked, bad);
+
+    /* Throughput */
+    clock_t t0 = clock();
+    for (long r = 0; r < passes; r++) {
+        nmeaInit(&p);
+        for (long i = 0; i < size; i++) nmeaEncode(&p, log[i]);
+    }
+    double secs = (double)(clock() - t0) / CLOCKS_PER_SEC;
+    double bytes = (double)size * (double)passes;
+    printf("parsed %.0f bytes in %.3f s: %.1f MB/s (lat %ld lon %ld)\n",
+           bytes, secs, secs > 0 ? bytes / secs / 1e6 : 0.0,
+           (long)p.fix.lat_e7, (long)p.fix.lon_e7);
+
+    free(log);
+    return bad ? 1 : 0;
+}
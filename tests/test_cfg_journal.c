@@ -0,0 +1,361 @@
+/*
+ * test_cfg_journal.c — Unit tests for cfg_journal.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * The journal runs against a RAM byte array standing in for the EEPROM
+ * emulation, sized like the real region unless a test needs it small.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "config_types.h"
+#include "cfg_journal.h"
+#include "test_harness.h"
+
+/* ─── Mock EEPROM ───────────────────────────────────────────────────────── */
+
+static uint8_t  mockEe[CFG_JOURNAL_SIZE];
+static uint32_t mockEeWrites;
+
+static uint8_t mockEeRead(uint16_t addr)
+{
+    return mockEe[addr];
+}
+
+static void mockEeWrite(uint16_t addr, uint8_t val)
+{
+    mockEe[addr] = val;
+    mockEeWrites++;
+}
+
+static void mockEeErase(uint8_t fill)
+{
+    memset(mockEe, fill, sizeof(mockEe));
+    mockEeWrites = 0;
+}
+
+static void testCfgDefaults(NodeConfig *c)
+{
+    memset(c, 0, sizeof(*c));
+    c->txOutputPower  = 14;
+    c->rxDutyPercent  = 90;
+    c->spreadingFactor = 7;
+    c->n2gFrequencyHz = 915000000;
+    c->bme280RateSec  = 30;
+    c->logTxDiv       = 1;
+}
+
+/* ─── Tests ─────────────────────────────────────────────────────────────── */
+
+TEST(test_cfgj_crc8)
+{
+    /* CRC-8/SMBUS check value */
+    uint8_t crc = 0;
+    for (const char *p = "123456789"; *p; p++) crc = cfgjCrc8(crc, (uint8_t)*p);
+    ASSERT_INT_EQ(0xF4, crc);
+    TEST_PASS();
+}
+
+TEST(test_cfgj_blank_then_format)
+{
+    CfgJournal j;
+    NodeConfig c, r;
+
+    /* Both erased states read as "no journal" */
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, sizeof(mockEe));
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(-1, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    mockEeErase(0x00);
+    ASSERT_INT_EQ(-1, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+
+    /* First save formats the region with every field */
+    testCfgDefaults(&c);
+    c.spreadingFactor = 10;
+    ASSERT_TRUE(cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c) > 0);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT, j.records);
+
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    ASSERT_INT_EQ(10, r.spreadingFactor);
+    ASSERT_TRUE(memcmp(&c, &r, sizeof(c)) == 0);
+    ASSERT_INT_EQ(0xFF, mockEe[j.tail]);
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_appends_only_changes)
+{
+    CfgJournal j;
+    NodeConfig c, r;
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, sizeof(mockEe));
+    testCfgDefaults(&c);
+    cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c);
+    uint16_t tail = j.tail;
+
+    /* Unchanged: nothing written */
+    mockEeWrites = 0;
+    ASSERT_INT_EQ(0, cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c));
+    ASSERT_INT_EQ(0, (int)mockEeWrites);
+
+    /* One 4-byte field changed: one 7-byte record */
+    c.n2gFrequencyHz = 868100000;
+    ASSERT_INT_EQ(CFGJ_REC_OVERHEAD + 4, cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c));
+    ASSERT_INT_EQ(CFGJ_REC_OVERHEAD + 4, (int)mockEeWrites);
+    ASSERT_INT_EQ(tail + CFGJ_REC_OVERHEAD + 4, j.tail);
+
+    /* Last record wins */
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT + 1, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    ASSERT_INT_EQ(868100000, (long)r.n2gFrequencyHz);
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_compaction)
+{
+    CfgJournal j;
+    NodeConfig c, r;
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, sizeof(mockEe));
+    testCfgDefaults(&c);
+
+    /* Keep changing one field until the journal wraps several times */
+    int compactions = 0;
+    for (int i = 0; i < 500; i++) {
+        c.bme280RateSec = (uint16_t)(100 + i);
+        uint16_t before = j.tail;
+        ASSERT_TRUE(cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c) > 0);
+        if (j.tail <= before) compactions++;
+    }
+    ASSERT_TRUE(compactions >= 3);
+
+    testCfgDefaults(&r);
+    cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r);
+    ASSERT_INT_EQ(599, r.bme280RateSec);
+    ASSERT_TRUE(memcmp(&c, &r, sizeof(c)) == 0);
+
+    /* Fields that don't fit at all */
+    CfgJournal tiny;
+    cfgjInit(&tiny, mockEeRead, mockEeWrite, 0, 16);
+    ASSERT_INT_EQ(-1, cfgjSave(&tiny, cfgFields, CFG_FIELD_COUNT, &c));
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_torn_record)
+{
+    CfgJournal j;
+    NodeConfig c, r;
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, sizeof(mockEe));
+    testCfgDefaults(&c);
+    cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c);
+    c.rxDutyPercent = 50;
+    cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c);
+
+    /* Power lost mid-append: the last record's CRC byte never landed */
+    mockEe[j.tail - 1] ^= 0x5A;
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    ASSERT_INT_EQ(90, r.rxDutyPercent);             /* previous value */
+    ASSERT_TRUE(!j.clean);
+
+    /* Next save compacts, leaving nothing stale behind the tail */
+    c.rxDutyPercent = 60;
+    ASSERT_TRUE(cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c) > 0);
+    ASSERT_TRUE(j.clean);
+    for (uint16_t p = j.tail; p < sizeof(mockEe); p++)
+        ASSERT_INT_EQ(0xFF, mockEe[p]);
+    testCfgDefaults(&r);
+    cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r);
+    ASSERT_INT_EQ(60, r.rxDutyPercent);
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_layout_migration)
+{
+    /* "Old firmware": two fields, one of which later widens, plus one
+     * that is later removed */
+    typedef struct { uint8_t a; uint8_t gone; uint8_t narrow; } OldCfg;
+    typedef struct { uint16_t narrow; uint32_t added; uint8_t a; } NewCfg;
+    static const CfgjField oldFields[] = {
+        { 1, offsetof(OldCfg, a), 1 },
+        { 2, offsetof(OldCfg, gone), 1 },
+        { 3, offsetof(OldCfg, narrow), 1 },
+    };
+    static const CfgjField newFields[] = {
+        { 1, offsetof(NewCfg, a), 1 },
+        { 3, offsetof(NewCfg, narrow), 2 },
+        { 4, offsetof(NewCfg, added), 4 },
+    };
+
+    CfgJournal j;
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, sizeof(mockEe));
+    OldCfg o = { 42, 7, 9 };
+    cfgjSave(&j, oldFields, 3, &o);
+
+    /* New firmware: 'a' carries over; resized and new fields keep defaults */
+    NewCfg n = { 1000, 123456, 0 };
+    ASSERT_INT_EQ(1, cfgjReplay(&j, newFields, 3, &n));
+    ASSERT_INT_EQ(42, n.a);
+    ASSERT_INT_EQ(1000, n.narrow);
+    ASSERT_INT_EQ(123456, (long)n.added);
+
+    /* Saving then writes only what the journal lacks */
+    ASSERT_INT_EQ(2 * CFGJ_REC_OVERHEAD + 2 + 4, cfgjSave(&j, newFields, 3, &n));
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_legacy_import)
+{
+    /* A CFG_VERSION 8 image as pre-journal firmware wrote it (packed,
+     * little-endian, magic and version first) */
+    uint8_t old[CFG_LEGACY_MAX_SIZE];
+    NodeConfig c;
+    uint32_t g2n = 868500000;
+    uint16_t fastRate = 15, txdiv = 0;
+    memset(old, 0, sizeof(old));
+    old[0] = CFG_MAGIC;
+    old[1] = 8;
+    old[2] = (uint8_t)(int8_t)-3;               /* txOutputPower */
+    memcpy(old + 10, &g2n, 4);
+    memcpy(old + 30, &fastRate, 2);
+    memcpy(old + 32, &txdiv, 2);
+
+    testCfgDefaults(&c);
+    ASSERT_INT_EQ(16, cfgLegacyImport(old, &c));
+    ASSERT_INT_EQ(-3, c.txOutputPower);
+    ASSERT_INT_EQ(868500000, (long)c.g2nFrequencyHz);
+    ASSERT_INT_EQ(15, c.gpsFastRateSec);
+    ASSERT_INT_EQ(0, c.logTxDiv);
+
+    /* Not a struct image, or a version never released */
+    old[1] = 3;
+    ASSERT_INT_EQ(-1, cfgLegacyImport(old, &c));
+    old[1] = 8;
+    old[0] = 0xFF;
+    ASSERT_INT_EQ(-1, cfgLegacyImport(old, &c));
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_legacy_import_v4)
+{
+    /* The released CFG_VERSION 4 image at EEPROM offset 17, byte for byte:
+     * 14 dBm, 50% duty, SF9, 125 kHz, 915/916 MHz, 400 ms jitter,
+     * BME280 every 120 s, battery 600 s, GPS 30 s.  What follows it is
+     * whatever was erased or left over — here a stray 0x55 pattern. */
+    static const uint8_t v4[22] = {
+        0xCF, 0x04,                         /* magic, cfgVersion     */
+        0x0E, 0x32, 0x09, 0x00,             /* tx, rxduty, sf, bw    */
+        0xC0, 0xCA, 0x89, 0x36,             /* n2g 915000000         */
+        0x00, 0x0D, 0x99, 0x36,             /* g2n 916000000         */
+        0x90, 0x01,                         /* jitter 400            */
+        0x78, 0x00,                         /* bme280 120            */
+        0x58, 0x02,                         /* batt 600              */
+        0x1E, 0x00,                         /* gps 30                */
+    };
+    uint8_t ee[CFG_LEGACY_MAX_SIZE];
+    memset(ee, 0x55, sizeof(ee));
+    memcpy(ee, v4, sizeof(v4));
+
+    NodeConfig c, d;
+    testCfgDefaults(&c);
+    testCfgDefaults(&d);
+    ASSERT_INT_EQ(10, cfgLegacyImport(ee, &c));
+    ASSERT_INT_EQ(14, c.txOutputPower);
+    ASSERT_INT_EQ(50, c.rxDutyPercent);
+    ASSERT_INT_EQ(9, c.spreadingFactor);
+    ASSERT_INT_EQ(0, c.bandwidth);
+    ASSERT_INT_EQ(915000000, (long)c.n2gFrequencyHz);
+    ASSERT_INT_EQ(916000000, (long)c.g2nFrequencyHz);
+    ASSERT_INT_EQ(400, c.broadcastAckJitterMs);
+    ASSERT_INT_EQ(120, c.bme280RateSec);
+    ASSERT_INT_EQ(600, c.battRateSec);
+    ASSERT_INT_EQ(30, c.gpsRateSec);
+
+    /* Fields added after v4 keep their defaults, not the bytes past it */
+    ASSERT_INT_EQ(d.sensorSlackSec, c.sensorSlackSec);
+    ASSERT_INT_EQ(d.autoSleepSec, c.autoSleepSec);
+    ASSERT_INT_EQ(d.logTxDiv, c.logTxDiv);
+
+    /* Saved once, it replays from the journal like any other config */
+    CfgJournal j;
+    NodeConfig r;
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, CFG_JOURNAL_SIZE);
+    ASSERT_TRUE(cfgjSave(&j, cfgFields, CFG_FIELD_COUNT, &c) > 0);
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    ASSERT_TRUE(memcmp(&c, &r, sizeof(c)) == 0);
+
+    TEST_PASS();
+}
+
+TEST(test_cfgj_legacy_layouts)
+{
+    /* Each layout ends where its last field does */
+    for (size_t i = 0; i < sizeof(cfgLegacyLayouts) / sizeof(cfgLegacyLayouts[0]); i++) {
+        const CfgLegacyLayout *l = &cfgLegacyLayouts[i];
+        const CfgjField *last = &cfgLegacyFields[l->fields - 1];
+        ASSERT_INT_EQ(l->size, last->offset + last->size);
+        ASSERT_TRUE(l->size <= CFG_LEGACY_MAX_SIZE);
+        ASSERT_TRUE(cfgLegacyLayout(l->version) == l);
+    }
+    TEST_PASS();
+}
+
+TEST(test_cfgj_named_profile_slot)
+{
+    CfgJournal j;
+    NodeConfig c, r;
+    char name[CFG_PROFILE_NAME_MAX + 1];
+    mockEeErase(0xFF);
+    cfgjInit(&j, mockEeRead, mockEeWrite, 0, CFG_PROFILE_SLOT_SIZE);
+    ASSERT_TRUE(!cfgjName(&j, name));
+
+    /* Snapshot: every field, then the label, all in one slot */
+    testCfgDefaults(&c);
+    c.spreadingFactor = 10;
+    c.rxDutyPercent = 10;
+    ASSERT_TRUE(cfgjCompact(&j, cfgFields, CFG_FIELD_COUNT, &c));
+    ASSERT_TRUE(cfgjPutName(&j, "winter12"));
+    ASSERT_TRUE(!cfgjPutName(&j, "toolongname"));
+    ASSERT_TRUE(j.tail <= CFG_PROFILE_SLOT_SIZE);
+
+    ASSERT_TRUE(cfgjName(&j, name));
+    ASSERT_STR_EQ("winter12", name);
+
+    /* The label is skipped by replay */
+    testCfgDefaults(&r);
+    ASSERT_INT_EQ(CFG_FIELD_COUNT, cfgjReplay(&j, cfgFields, CFG_FIELD_COUNT, &r));
+    ASSERT_INT_EQ(10, r.spreadingFactor);
+    ASSERT_TRUE(memcmp(&c, &r, sizeof(c)) == 0);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_cfg_journal_tests(void)
+{
+    printf("cfg_journal.h tests:\n");
+
+    RUN_TEST(test_cfgj_crc8);
+    RUN_TEST(test_cfgj_blank_then_format);
+    RUN_TEST(test_cfgj_appends_only_changes);
+    RUN_TEST(test_cfgj_compaction);
+    RUN_TEST(test_cfgj_torn_record);
+    RUN_TEST(test_cfgj_layout_migration);
+    RUN_TEST(test_cfgj_legacy_import);
+    RUN_TEST(test_cfgj_legacy_import_v4);
+    RUN_TEST(test_cfgj_legacy_layouts);
+    RUN_TEST(test_cfgj_named_profile_slot);
+}
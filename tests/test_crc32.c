@@ -0,0 +1,104 @@
+/*
+ * test_crc32.c — Unit tests for crc32.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * test_main.c builds every strategy, so each is checked against the
+ * others and against zlib reference values.
+ */
+
+#include <stdint.h>
+#include <string.h>
+
+#include "crc32.h"
+#include "test_harness.h"
+
+/* ─── Helpers ───────────────────────────────────────────────────────────── */
+
+typedef uint32_t (*Crc32Fn)(uint32_t, const void *, size_t);
+
+static const Crc32Fn crc32Strategies[] = {
+    crc32_update_byte, crc32_update_nibble, crc32_update_slice4, crc32_update_slice8
+};
+#define CRC32_STRATEGY_COUNT (int)(sizeof(crc32Strategies) / sizeof(crc32Strategies[0]))
+
+/* ─── Tables ────────────────────────────────────────────────────────────── */
+
+TEST(test_crc32_generated_tables)
+{
+    /* Spot checks against the published table */
+    ASSERT_TRUE(CRC32_TABLE[0]   == 0x00000000u);
+    ASSERT_TRUE(CRC32_TABLE[1]   == 0x77073096u);
+    ASSERT_TRUE(CRC32_TABLE[128] == 0xEDB88320u);
+    ASSERT_TRUE(CRC32_TABLE[255] == 0x2D02EF8Du);
+
+    /* Nibble entry i is byte entry i << 4 */
+    for (int i = 0; i < 16; i++)
+        ASSERT_TRUE(CRC32_NIBBLE_TABLE[i] == CRC32_TABLE[i << 4]);
+    TEST_PASS();
+}
+
+/* ─── Vectors ───────────────────────────────────────────────────────────── */
+
+TEST(test_crc32_vectors)
+{
+    for (int s = 0; s < CRC32_STRATEGY_COUNT; s++) {
+        ASSERT_TRUE(crc32Strategies[s](0, "", 0) == 0x00000000u);
+        ASSERT_TRUE(crc32Strategies[s](0, "a", 1) == 0xE8B7BE43u);
+        ASSERT_TRUE(crc32Strategies[s](0, "123456789", 9) == 0xCBF43926u);
+        ASSERT_TRUE(crc32Strategies[s](0, "The quick brown fox jumps over the lazy dog", 43)
+                    == 0x414FA339u);
+    }
+    ASSERT_TRUE(crc32_compute("123456789", 9) == 0xCBF43926u);
+    TEST_PASS();
+}
+
+TEST(test_crc32_strategies_agree)
+{
+    /* Every length and alignment around the 4- and 8-byte steps */
+    static uint8_t data[300];
+    uint32_t x = 0x12345678u;
+    for (int i = 0; i < (int)sizeof(data); i++) {
+        x = x * 1103515245u + 12345u;
+        data[i] = (uint8_t)(x >> 16);
+    }
+    for (int off = 0; off < 8; off++)
+        for (int len = 0; len + off <= (int)sizeof(data); len += (len < 40) ? 1 : 37) {
+            uint32_t ref = crc32_update_byte(0, data + off, (size_t)len);
+            for (int s = 1; s < CRC32_STRATEGY_COUNT; s++)
+                ASSERT_TRUE(crc32Strategies[s](0, data + off, (size_t)len) == ref);
+        }
+    TEST_PASS();
+}
+
+TEST(test_crc32_incremental)
+{
+    const char *msg = "{\"c\":\"00000000\",\"n\":\"ab01\",\"r\":[]}";
+    size_t len = strlen(msg);
+    uint32_t whole = crc32_compute(msg, len);
+
+    for (int s = 0; s < CRC32_STRATEGY_COUNT; s++)
+        for (size_t cut = 0; cut <= len; cut++) {
+            uint32_t c = crc32Strategies[s](0, msg, cut);
+            c = crc32Strategies[s](c, msg + cut, len - cut);
+            ASSERT_TRUE(c == whole);
+        }
+
+    /* Chunks of any size, through the default strategy */
+    uint32_t c = 0;
+    for (size_t i = 0; i < len; i += 3)
+        c = crc32_update(c, msg + i, (len - i < 3) ? len - i : 3);
+    ASSERT_TRUE(c == whole);
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_crc32_tests(void)
+{
+    printf("crc32.h tests:\n");
+
+    RUN_TEST(test_crc32_generated_tables);
+    RUN_TEST(test_crc32_vectors);
+    RUN_TEST(test_crc32_strategies_agree);
+    RUN_TEST(test_crc32_incremental);
+}
@@ -0,0 +1,162 @@
+/*
+ * test_dbg.c — Unit tests for dbg.h's tokenized log ring and frames
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  Covers the C
+ * layer only (packing, ring, wire frames); the C++ call-site macros and
+ * Serial glue are exercised on the device with tools/dbgdecode.py.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "dbg.h"
+#include "test_harness.h"
+
+/* Queue a record carrying one u32 argument */
+static bool dbgPutU32(RingBuf *r, uint32_t *dropped, uint16_t id, uint32_t v)
+{
+    DbgArgs a;
+    dbgArgsInit(&a);
+    dbgArgU32(&a, v);
+    return dbgLogPut(r, dropped, id, &a);
+}
+
+/* Frame's record ID (after checking sync, length and checksum) */
+static int dbgFrameId(const uint8_t *f, int n)
+{
+    if (n < 5 || f[0] != DBG_FRAME_SYNC || n != 5 + f[1]) return -1;
+    uint8_t sum = 0;
+    for (int i = 1; i < n - 1; i++) sum = (uint8_t)(sum + f[i]);
+    if (sum != f[n - 1]) return -1;
+    return f[2] | (f[3] << 8);
+}
+
+static uint32_t dbgFrameU32(const uint8_t *f, int off)
+{
+    return (uint32_t)f[4 + off] | ((uint32_t)f[5 + off] << 8) |
+           ((uint32_t)f[6 + off] << 16) | ((uint32_t)f[7 + off] << 24);
+}
+
+/* ─── Packing ───────────────────────────────────────────────────────────── */
+
+TEST(test_dbg_record_round_trip)
+{
+    uint8_t store[128];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+    uint32_t dropped = 0;
+
+    DbgArgs a;
+    dbgArgsInit(&a);
+    dbgArgU32(&a, (uint32_t)-5);
+    dbgArgStr(&a, "bme");
+    dbgArgF32(&a, 1.5f);
+    ASSERT_INT_EQ(4 + 4 + 4, a.len);
+    ASSERT_TRUE(dbgLogPut(&r, &dropped, 0x0812, &a));
+
+    uint8_t f[DBG_FRAME_MAX];
+    int n = dbgLogFrame(&r, &dropped, f);
+    ASSERT_INT_EQ(5 + 12, n);
+    ASSERT_INT_EQ(0x0812, dbgFrameId(f, n));
+    ASSERT_TRUE(dbgFrameU32(f, 0) == (uint32_t)-5);
+    ASSERT_INT_EQ(3, f[8]);
+    ASSERT_TRUE(memcmp(&f[9], "bme", 3) == 0);
+    float x;
+    uint32_t bits = dbgFrameU32(f, 8);
+    memcpy(&x, &bits, sizeof(x));
+    ASSERT_TRUE(x == 1.5f);
+
+    ASSERT_INT_EQ(0, dbgLogFrame(&r, &dropped, f));
+    TEST_PASS();
+}
+
+TEST(test_dbg_args_truncated_not_torn)
+{
+    DbgArgs a;
+    dbgArgsInit(&a);
+    dbgArgStr(&a, "a string well past DBG_STR_MAX characters long");
+    ASSERT_INT_EQ(1 + DBG_STR_MAX, a.len);
+    dbgArgStr(&a, NULL);
+    ASSERT_INT_EQ(1 + DBG_STR_MAX + 1 + 6, a.len);
+
+    /* Once one argument doesn't fit, later (smaller) ones are left off
+     * too, so the decoder never reads an argument out of place */
+    int len = a.len;
+    ASSERT_INT_EQ(8, DBG_ARGS_MAX - len);
+    dbgArgStr(&a, "12345678");
+    ASSERT_TRUE(a.full);
+    dbgArgU32(&a, 1);
+    ASSERT_INT_EQ(len, a.len);
+    TEST_PASS();
+}
+
+/* ─── Ring Overflow ─────────────────────────────────────────────────────── */
+
+TEST(test_dbg_drops_whole_records_in_order)
+{
+    uint8_t store[32];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+    uint32_t dropped = 0;
+
+    /* 7-byte records: four fit in 31 bytes, the rest are dropped whole */
+    for (uint32_t i = 0; i < 6; i++) dbgPutU32(&r, &dropped, 0x0801, i);
+    ASSERT_INT_EQ(28, ringCount(&r));
+    ASSERT_INT_EQ(2, (int)dropped);
+
+    /* Room for one record isn't enough: the drop marker must go first */
+    uint8_t f[DBG_FRAME_MAX];
+    ASSERT_TRUE(dbgLogFrame(&r, &dropped, f) > 0);
+    ASSERT_TRUE(!dbgPutU32(&r, &dropped, 0x0801, 6));
+    ASSERT_INT_EQ(3, (int)dropped);
+    ASSERT_TRUE(dbgLogFrame(&r, &dropped, f) > 0);
+    ASSERT_TRUE(dbgPutU32(&r, &dropped, 0x0801, 7));
+    ASSERT_INT_EQ(0, (int)dropped);
+
+    /* Stream: 2, 3, [3 dropped], 7 */
+    uint32_t expectVal[] = { 2, 3, 3, 7 };
+    int expectId[]       = { 0x0801, 0x0801, DBG_ID_DROPPED, 0x0801 };
+    for (int i = 0; i < 4; i++) {
+        int n = dbgLogFrame(&r, &dropped, f);
+        ASSERT_INT_EQ(expectId[i], dbgFrameId(f, n));
+        ASSERT_TRUE(dbgFrameU32(f, 0) == expectVal[i]);
+    }
+    ASSERT_INT_EQ(0, dbgLogFrame(&r, &dropped, f));
+    TEST_PASS();
+}
+
+TEST(test_dbg_drop_reported_when_empty)
+{
+    uint8_t store[8];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+    uint32_t dropped = 0;
+
+    DbgArgs big;
+    dbgArgsInit(&big);
+    dbgArgStr(&big, "too big for this ring");
+    ASSERT_TRUE(!dbgLogPut(&r, &dropped, 0x0802, &big));
+    ASSERT_INT_EQ(1, (int)dropped);
+
+    /* Nothing else will arrive: the flush still reports the loss */
+    uint8_t f[DBG_FRAME_MAX];
+    int n = dbgLogFrame(&r, &dropped, f);
+    ASSERT_INT_EQ(DBG_ID_DROPPED, dbgFrameId(f, n));
+    ASSERT_INT_EQ(1, (int)dbgFrameU32(f, 0));
+    ASSERT_INT_EQ(0, (int)dropped);
+    ASSERT_INT_EQ(0, dbgLogFrame(&r, &dropped, f));
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_dbg_tests(void)
+{
+    printf("dbg.h tests:\n");
+
+    RUN_TEST(test_dbg_record_round_trip);
+    RUN_TEST(test_dbg_args_truncated_not_torn);
+    RUN_TEST(test_dbg_drops_whole_records_in_order);
+    RUN_TEST(test_dbg_drop_reported_when_empty);
+}
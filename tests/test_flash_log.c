@@ -0,0 +1,408 @@
+/*
+ * test_flash_log.c — Unit tests for flash_log.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * The flash region is a RAM array of rows; erased rows read as zeros,
+ * like the ASR650x.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdlib.h>
+
+#include "flash_log.h"
+#include "test_harness.h"
+
+/* ─── Mock Flash ───────────────────────────────────────────────────────── */
+
+#define MOCK_ROWS 4
+
+static FlogRow  mockFlash[MOCK_ROWS];
+static uint32_t mockRowWrites[MOCK_ROWS];
+static bool     mockWriteFail = false;
+
+static bool mockWrite(uint16_t row, const FlogRow *data)
+{
+    if (mockWriteFail) return false;
+    mockFlash[row] = *data;
+    mockRowWrites[row]++;
+    return true;
+}
+
+static void mockRead(uint16_t row, FlogRow *data)
+{
+    *data = mockFlash[row];
+}
+
+static void mockErase(void)
+{
+    memset(mockFlash, 0, sizeof(mockFlash));
+    memset(mockRowWrites, 0, sizeof(mockRowWrites));
+    mockWriteFail = false;
+}
+
+/* Append n records of sensor 0 channel 0 with values start, start+1, ... */
+static void appendSeq(FlashLog *l, int n, int start)
+{
+    for (int i = 0; i < n; i++)
+        flogAppend(l, 1000UL * (unsigned long)(start + i), 0, 0, (double)(start + i));
+}
+
+typedef struct {
+    int    count;
+    double first;
+    double last;
+    bool   inOrder;
+} VisitCtx;
+
+static bool visitCollect(uint32_t idx, const FlogRec *r, void *ctx)
+{
+    (void)idx;
+    VisitCtx *c = (VisitCtx *)ctx;
+    if (c->count == 0) c->first = r->v;
+    else if (r->v != c->last + 1) c->inOrder = false;
+    c->last = r->v;
+    c->count++;
+    return true;
+}
+
+/* ─── Ring ─────────────────────────────────────────────────────────────── */
+
+TEST(test_flog_append_and_read_back)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    ASSERT_INT_EQ(0, (int)flogLo(&l));
+    ASSERT_INT_EQ(0, (int)flogHi(&l));
+    ASSERT_INT_EQ(MOCK_ROWS * FLOG_RECS_PER_ROW, (int)flogCapacity(&l));
+
+    appendSeq(&l, 20, 0);
+    ASSERT_INT_EQ(20, (int)flogHi(&l));
+    ASSERT_INT_EQ(1, (int)l.rowWrites);         /* one full row programmed */
+    ASSERT_TRUE(l.dirty);                       /* five still in RAM */
+
+    /* Visits span the programmed row and the RAM head row */
+    VisitCtx c = { 0, 0, 0, true };
+    ASSERT_INT_EQ(20, (int)flogForEach(&l, 0, visitCollect, &c));
+    ASSERT_INT_EQ(20, c.count);
+    ASSERT_TRUE(c.inOrder);
+    ASSERT_TRUE(c.first == 0.0 && c.last == 19.0);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_wrap_levels_wear)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+
+    /* 10 full rows through a 4-row ring */
+    appendSeq(&l, 10 * FLOG_RECS_PER_ROW, 0);
+    ASSERT_INT_EQ(10, (int)l.rowWrites);
+    ASSERT_INT_EQ(150, (int)flogHi(&l));
+
+    /* Head row (seq 10) is empty in RAM; its slot's data is given up */
+    ASSERT_INT_EQ(7 * FLOG_RECS_PER_ROW, (int)flogLo(&l));
+
+    /* Every slot erased/programmed within one of the others */
+    for (int i = 0; i < MOCK_ROWS; i++)
+        ASSERT_TRUE(mockRowWrites[i] >= 2 && mockRowWrites[i] <= 3);
+
+    /* Reading from 0 clamps to the oldest held record */
+    VisitCtx c = { 0, 0, 0, true };
+    flogForEach(&l, 0, visitCollect, &c);
+    ASSERT_INT_EQ(45, c.count);
+    ASSERT_TRUE(c.inOrder);
+    ASSERT_TRUE(c.first == 105.0 && c.last == 149.0);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_recovers_after_reset)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+
+    appendSeq(&l, 70, 0);           /* 4 full rows + 10 in RAM, wrapped */
+    ASSERT_TRUE(flogFlush(&l));     /* partial row programmed and closed */
+    ASSERT_INT_EQ(75, (int)flogHi(&l));
+    appendSeq(&l, 3, 70);           /* lost on "reset" */
+
+    FlashLog r;
+    flogInit(&r, mockWrite, mockRead, MOCK_ROWS);
+    ASSERT_INT_EQ(75, (int)flogHi(&r));
+    ASSERT_INT_EQ(l.loSeq, r.loSeq);
+    ASSERT_TRUE(!r.dirty);
+
+    /* A new row after the flushed one; its unused tail is a gap */
+    appendSeq(&r, 10, 70);
+    ASSERT_INT_EQ(85, (int)flogHi(&r));
+    VisitCtx c = { 0, 0, 0, true };
+    flogForEach(&r, flogLo(&r), visitCollect, &c);
+    ASSERT_TRUE(c.inOrder);
+    ASSERT_TRUE(c.last == 79.0);
+    ASSERT_INT_EQ((int)(flogHi(&r) - flogLo(&r)) - 5, c.count);
+
+    FlogRec rec;
+    ASSERT_TRUE(flogGetRec(&r, 69, &rec) && rec.v == 69.0);
+    ASSERT_TRUE(!flogGetRec(&r, 70, &rec));
+    ASSERT_TRUE(flogGetRec(&r, 75, &rec) && rec.v == 70.0);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_flush_stale_bounds_loss)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    ASSERT_TRUE(!flogFlushStale(&l, 0, 60000));        /* nothing buffered */
+
+    /* First record at 5 s; the row is held until it is a minute old */
+    flogAppend(&l, 5000, 0, 0, 1.0);
+    flogAppend(&l, 50000, 0, 0, 2.0);
+    ASSERT_TRUE(!flogFlushStale(&l, 64999, 60000));
+    ASSERT_INT_EQ(0, (int)mockRowWrites[0]);
+    ASSERT_TRUE(flogFlushStale(&l, 65000, 60000));
+    ASSERT_INT_EQ(1, (int)mockRowWrites[0]);
+    ASSERT_TRUE(!flogFlushStale(&l, 200000, 60000));   /* clean now */
+
+    /* The age restarts with the next record, not the last flush; the
+     * record goes to a new row, the flushed one is never reprogrammed */
+    flogAppend(&l, 300000, 0, 0, 3.0);
+    ASSERT_TRUE(!flogFlushStale(&l, 359999, 60000));
+    ASSERT_TRUE(flogFlushStale(&l, 360000, 60000));
+    ASSERT_INT_EQ(1, (int)mockRowWrites[0]);
+    ASSERT_INT_EQ(1, (int)mockRowWrites[1]);
+
+    /* An unplanned reset now loses nothing */
+    FlashLog r;
+    flogInit(&r, mockWrite, mockRead, MOCK_ROWS);
+    ASSERT_INT_EQ(2 * FLOG_RECS_PER_ROW, (int)flogHi(&r));
+    VisitCtx c = { 0, 0, 0, true };
+    flogForEach(&r, 0, visitCollect, &c);
+    ASSERT_INT_EQ(3, c.count);
+    ASSERT_TRUE(c.inOrder);
+
+    /* millis() wrap */
+    flogAppend(&r, 0xFFFFF000UL, 0, 0, 4.0);
+    ASSERT_TRUE(!flogFlushStale(&r, 0x00000FFFUL, 60000));
+    ASSERT_TRUE(flogFlushStale(&r, 0x0000E000UL, 60000));
+
+    TEST_PASS();
+}
+
+TEST(test_flog_skips_corrupt_rows)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    appendSeq(&l, 3 * FLOG_RECS_PER_ROW, 0);
+
+    /* Torn write in the middle row */
+    ((uint8_t *)&mockFlash[1].rec[4])[9] ^= 0xFF;
+
+    VisitCtx c = { 0, 0, 0, true };
+    flogForEach(&l, 0, visitCollect, &c);
+    ASSERT_INT_EQ(2 * FLOG_RECS_PER_ROW, c.count);
+
+    /* Still found the head on re-scan */
+    FlashLog r;
+    flogInit(&r, mockWrite, mockRead, MOCK_ROWS);
+    ASSERT_INT_EQ(45, (int)flogHi(&r));
+
+    /* Write failures are counted, not fatal */
+    mockWriteFail = true;
+    appendSeq(&r, FLOG_RECS_PER_ROW, 45);
+    ASSERT_INT_EQ(1, (int)r.writeErrors);
+
+    TEST_PASS();
+}
+
+/* ─── Clock ────────────────────────────────────────────────────────────── */
+
+TEST(test_flog_timestamps)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+
+    flogAppend(&l, 42000, 3, 0, 4.1);
+    ASSERT_INT_EQ(42, (int)l.cur.rec[0].t);
+    ASSERT_INT_EQ(0, l.cur.rec[0].flags);
+
+    flogSetTime(&l, 12345, 50000);              /* not a Unix time: ignored */
+    ASSERT_TRUE(!l.synced);
+
+    flogSetTime(&l, 1760000000UL, 50000);
+    flogAppend(&l, 60000, 3, 0, 4.0);
+    ASSERT_TRUE(l.cur.rec[1].t == 1760000010UL);
+    ASSERT_INT_EQ(FLOG_F_EPOCH, l.cur.rec[1].flags);
+
+    TEST_PASS();
+}
+
+/* ─── Commands ─────────────────────────────────────────────────────────── */
+
+TEST(test_flog_summary_json)
+{
+    FlashLog l;
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    flogSetTime(&l, 1760000000UL, 0);
+
+    /* Two channels of one sensor, another sensor interleaved */
+    for (int i = 0; i < 10; i++) {
+        flogAppend(&l, 1000UL * i, 0, 0, 20.0 + i);
+        flogAppend(&l, 1000UL * i, 0, 1, 1000.0);
+        flogAppend(&l, 1000UL * i, 3, 0, 4.2);
+    }
+
+    flogFmtSum(&l, 0, 0, 0, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"avg\":24.5,\"max\":29,\"min\":20,\"n\":10,"
+                  "\"t0\":1760000000,\"t1\":1760000009}", buf);
+
+    /* From an index part way through */
+    flogFmtSum(&l, 0, 0, 15, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"avg\":27,\"max\":29,\"min\":25,\"n\":5,"
+                  "\"t0\":1760000005,\"t1\":1760000009}", buf);
+
+    /* No match */
+    flogFmtSum(&l, 9, 0, 0, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"avg\":0,\"max\":0,\"min\":0,\"n\":0,\"t0\":0,\"t1\":0}", buf);
+
+    flogFmtStat(&l, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"cap\":60,\"hi\":30,\"lo\":0,\"t0\":1760000000,"
+                  "\"t1\":1760000009,\"wr\":2}", buf);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_get_pages)
+{
+    FlashLog l;
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    flogSetTime(&l, 1760000000UL, 0);
+    appendSeq(&l, 20, 0);
+
+    int n = flogFmtGet(&l, 0, buf, sizeof(buf));
+    ASSERT_TRUE(n > 0 && n < (int)sizeof(buf));
+    ASSERT_TRUE(strncmp(buf, "{\"i\":0,\"m\":1,\"r\":[[1760000000,0,0,0],"
+                        "[1760000001,0,0,1],", 52) == 0);
+
+    /* Page until done; every record seen exactly once */
+    uint32_t from = 0;
+    int pages = 0, seen = 0;
+    for (;;) {
+        flogFmtGet(&l, from, buf, sizeof(buf));
+        int recs = 0;
+        for (const char *p = buf; *p; p++)
+            if (p[0] == '[' && p[1] == '1') recs++;
+        seen += recs;
+        from += (uint32_t)recs;
+        pages++;
+        if (strstr(buf, "\"m\":0")) break;
+        ASSERT_TRUE(recs > 0 && pages < 20);
+    }
+    ASSERT_INT_EQ(20, seen);
+    ASSERT_TRUE(pages > 1);
+
+    /* Past the head: empty page */
+    flogFmtGet(&l, 500, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"i\":500,\"m\":0,\"r\":[]}", buf);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_gap_pages_and_stat)
+{
+    FlashLog l;
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    flogSetTime(&l, 1760000000UL, 0);
+    appendSeq(&l, 20, 0);
+    flogFlush(&l);                  /* indices 20..29 become a gap */
+
+    /* Newest record is in the flushed row, not the empty head */
+    flogFmtStat(&l, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"cap\":60,\"hi\":30,\"lo\":0,\"t0\":1760000000,"
+                  "\"t1\":1760000019,\"wr\":2}", buf);
+
+    /* Pages stop at the gap, so i + len(r) never skips a record */
+    appendSeq(&l, 5, 20);
+    uint32_t from = 0;
+    int pages = 0, seen = 0;
+    for (;;) {
+        flogFmtGet(&l, from, buf, sizeof(buf));
+        int recs = 0;
+        for (const char *p = buf; *p; p++)
+            if (p[0] == '[' && p[1] == '1') recs++;
+        seen += recs;
+        from = (uint32_t)strtoul(buf + 5, NULL, 10) + (uint32_t)recs;
+        pages++;
+        if (strstr(buf, "\"m\":0")) break;
+        ASSERT_TRUE(pages < 20);
+    }
+    ASSERT_INT_EQ(25, seen);
+    ASSERT_INT_EQ(35, (int)from);
+
+    TEST_PASS();
+}
+
+TEST(test_flog_xfer_source)
+{
+    FlashLog l;
+    mockErase();
+    flogInit(&l, mockWrite, mockRead, MOCK_ROWS);
+    appendSeq(&l, 20, 0);
+
+    FlogRec r;
+    ASSERT_TRUE(flogGetRec(&l, 3, &r) && r.v == 3.0);     /* from flash */
+    ASSERT_TRUE(flogGetRec(&l, 17, &r) && r.v == 17.0);   /* from RAM */
+    ASSERT_TRUE(!flogGetRec(&l, 20, &r));
+
+    /* Bulk transfer blocks straddle records and rows */
+    FlogXferSrc src = { &l, 2 };
+    XferSession s;
+    uint8_t blk[XFER_BLOCK_BYTES];
+    xferOpen(&s, 1, 18 * FLOG_REC_SIZE, 8, flogXferFill, &src);
+    ASSERT_INT_EQ(3, s.nBlocks);
+
+    ASSERT_INT_EQ(XFER_BLOCK_BYTES, flogXferFill(XFER_BLOCK_BYTES, blk, XFER_BLOCK_BYTES, &src));
+
+    /* First value field in the second block, and the record it belongs to */
+    const int in   = XFER_BLOCK_BYTES % FLOG_REC_SIZE;
+    const int vAt  = (in <= 8) ? 8 - in : 24 - in;
+    const int recN = 2 + XFER_BLOCK_BYTES / FLOG_REC_SIZE + (in > 8);
+    double v;
+    memcpy(&v, blk + vAt, sizeof(v));
+    ASSERT_TRUE(v == (double)recN);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_flash_log_tests(void)
+{
+    printf("flash_log.h tests:\n");
+
+    RUN_TEST(test_flog_append_and_read_back);
+    RUN_TEST(test_flog_wrap_levels_wear);
+    RUN_TEST(test_flog_recovers_after_reset);
+    RUN_TEST(test_flog_flush_stale_bounds_loss);
+    RUN_TEST(test_flog_skips_corrupt_rows);
+    RUN_TEST(test_flog_timestamps);
+    RUN_TEST(test_flog_summary_json);
+    RUN_TEST(test_flog_get_pages);
+    RUN_TEST(test_flog_gap_pages_and_stat);
+    RUN_TEST(test_flog_xfer_source);
+}
@@ -0,0 +1,168 @@
+/*
+ * test_gps_motion.c — Unit tests for gps_motion.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * Distances are checked against the haversine value for the same pair of
+ * points (precomputed) with a 1% tolerance.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "gps_motion.h"
+#include "test_harness.h"
+
+/* ─── Helpers ───────────────────────────────────────────────────────────── */
+
+static bool withinPct(uint32_t got, uint32_t want, uint32_t pct)
+{
+    uint32_t diff = got > want ? got - want : want - got;
+    return diff * 100 <= want * pct;
+}
+
+/* Seattle-ish reference point */
+#define LAT0  476205123
+#define LON0 -1223493456
+
+/* ─── Geometry ──────────────────────────────────────────────────────────── */
+
+TEST(test_motion_cos_table)
+{
+    ASSERT_INT_EQ(32768, gpsMotionCosQ15(0));
+    ASSERT_INT_EQ(16384, gpsMotionCosQ15(600000000));
+    ASSERT_INT_EQ(16384, gpsMotionCosQ15(-600000000));
+    ASSERT_INT_EQ(0, gpsMotionCosQ15(900000000));
+
+    /* Interpolated: cos(47.62°) = 0.67384 → 22081 */
+    int c = gpsMotionCosQ15(LAT0);
+    ASSERT_TRUE(c > 22040 && c < 22120);
+
+    TEST_PASS();
+}
+
+TEST(test_motion_distance)
+{
+    /* 0.001° of latitude ≈ 111.2 m */
+    ASSERT_TRUE(withinPct(gpsMotionDistCm(LAT0, LON0, LAT0 + 10000, LON0), 11120, 1));
+
+    /* 0.001° of longitude at 47.62° ≈ 75.0 m */
+    ASSERT_TRUE(withinPct(gpsMotionDistCm(LAT0, LON0, LAT0, LON0 + 10000), 7496, 1));
+
+    /* Diagonal ~1.35 km */
+    ASSERT_TRUE(withinPct(gpsMotionDistCm(LAT0, LON0, LAT0 + 90000, LON0 + 120000),
+                          134547, 1));
+
+    /* Across the antimeridian: 0.002° apart, not 360° */
+    ASSERT_TRUE(withinPct(gpsMotionDistCm(0, 1799990000, 0, -1799990000), 22264, 1));
+
+    /* Far apart saturates rather than overflowing */
+    ASSERT_TRUE(gpsMotionDistCm(-800000000, 0, 800000000, 0) >= 100000000UL);
+
+    TEST_PASS();
+}
+
+/* ─── Reporting ─────────────────────────────────────────────────────────── */
+
+TEST(test_motion_suppresses_jitter)
+{
+    GpsMotion m;
+    gpsMotionInit(&m);
+
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0, LON0, 0, 25, 20));   /* first fix */
+
+    /* ±10 m of fix noise: suppressed */
+    ASSERT_TRUE(!gpsMotionUpdate(&m, LAT0 + 900, LON0, 60000, 25, 20));
+    ASSERT_TRUE(!gpsMotionUpdate(&m, LAT0 - 900, LON0 + 500, 120000, 25, 20));
+
+    /* 30 m from the last *reported* fix: reported */
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0 + 2700, LON0, 180000, 25, 20));
+    ASSERT_INT_EQ(LAT0 + 2700, m.refLat);
+
+    /* min_dist = 0 reports everything */
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0 + 2700, LON0, 240000, 0, 20));
+
+    TEST_PASS();
+}
+
+TEST(test_motion_stationary_backoff)
+{
+    GpsMotion m;
+    gpsMotionInit(&m);
+    unsigned long t = 0;
+
+    gpsMotionUpdate(&m, LAT0, LON0, t, 25, 20);
+    ASSERT_INT_EQ(60, gpsMotionIntervalSec(&m, 60, 10));
+
+    /* Each still sample doubles, capped at 8x */
+    const uint16_t expect[] = { 120, 240, 480, 480 };
+    for (int i = 0; i < 4; i++) {
+        t += 60000;
+        gpsMotionUpdate(&m, LAT0, LON0, t, 25, 20);
+        ASSERT_INT_EQ(expect[i], gpsMotionIntervalSec(&m, 60, 10));
+    }
+
+    /* Moving again (slowly) snaps back to the base rate */
+    t += 480000;
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0 + 5000, LON0, t, 25, 20));
+    ASSERT_TRUE(!m.fast);
+    ASSERT_INT_EQ(60, gpsMotionIntervalSec(&m, 60, 10));
+
+    /* Clamped to the param range */
+    m.stillCount = 3;
+    ASSERT_INT_EQ(32767, gpsMotionIntervalSec(&m, 30000, 10));
+
+    TEST_PASS();
+}
+
+TEST(test_motion_fast_rate)
+{
+    GpsMotion m;
+    gpsMotionInit(&m);
+
+    gpsMotionUpdate(&m, LAT0, LON0, 0, 25, 20);
+
+    /* 556 m in 60 s ≈ 33 km/h → fast */
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0 + 50000, LON0, 60000, 25, 20));
+    ASSERT_TRUE(m.fast);
+    ASSERT_INT_EQ(10, gpsMotionIntervalSec(&m, 60, 10));
+
+    /* 40 m in 10 s ≈ 14 km/h → normal */
+    gpsMotionUpdate(&m, LAT0 + 53600, LON0, 70000, 25, 20);
+    ASSERT_TRUE(!m.fast);
+    ASSERT_INT_EQ(60, gpsMotionIntervalSec(&m, 60, 10));
+
+    /* fast_kmh = 0 disables */
+    gpsMotionUpdate(&m, LAT0 + 150000, LON0, 80000, 25, 0);
+    ASSERT_TRUE(!m.fast);
+
+    TEST_PASS();
+}
+
+TEST(test_motion_keepalive)
+{
+    GpsMotion m;
+    gpsMotionInit(&m);
+
+    gpsMotionUpdate(&m, LAT0, LON0, 1000, 25, 20);
+    ASSERT_TRUE(!gpsMotionUpdate(&m, LAT0, LON0, GPS_MOTION_KEEPALIVE_MS, 25, 20));
+    ASSERT_TRUE(gpsMotionUpdate(&m, LAT0, LON0, GPS_MOTION_KEEPALIVE_MS + 1000, 25, 20));
+
+    /* Keep-alive doesn't reset the stationary backoff */
+    ASSERT_TRUE(m.stillCount >= 2);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_gps_motion_tests(void)
+{
+    printf("gps_motion.h tests:\n");
+
+    RUN_TEST(test_motion_cos_table);
+    RUN_TEST(test_motion_distance);
+    RUN_TEST(test_motion_suppresses_jitter);
+    RUN_TEST(test_motion_stationary_backoff);
+    RUN_TEST(test_motion_fast_rate);
+    RUN_TEST(test_motion_keepalive);
+}
@@ -0,0 +1,205 @@
+/*
+ * test_latency.c — Unit tests for latency.h and the ACK fast path
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  Traces are fed
+ * made-up micros() values; the ACK template is checked byte for byte
+ * against buildAckPacket(), which the gateway's parser already accepts.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "latency.h"
+#include "test_harness.h"
+
+/* Run one complete trace: stage durations in µs */
+static void latRun(LatStats *s, LatTrace *t, int cmd, uint32_t rx,
+                   uint32_t parse, uint32_t disp, uint32_t q, uint32_t air)
+{
+    latBegin(t, rx);
+    t->cmd = (int8_t)cmd;
+    latMark(t, 1, rx + parse);
+    latMark(t, 2, rx + parse + disp);
+    latMark(t, 3, rx + parse + disp + q);
+    latFinish(s, t, rx + parse + disp + q + air);
+}
+
+/* ─── Recording ─────────────────────────────────────────────────────────── */
+
+TEST(test_lat_buckets)
+{
+    ASSERT_INT_EQ(0, latBucket(0));
+    ASSERT_INT_EQ(0, latBucket(1));
+    ASSERT_INT_EQ(1, latBucket(2));
+    ASSERT_INT_EQ(1, latBucket(3));
+    ASSERT_INT_EQ(10, latBucket(1024));
+    ASSERT_INT_EQ(10, latBucket(2047));
+    ASSERT_INT_EQ(LAT_BUCKETS - 1, latBucket(0xFFFFFFFFUL));
+    TEST_PASS();
+}
+
+TEST(test_lat_trace_stages)
+{
+    LatStats s;
+    LatTrace t;
+    latInit(&s);
+
+    /* micros() wraps mid-trace */
+    latRun(&s, &t, 3, 0xFFFFFF00UL, 700, 300, 5000, 40000);
+    ASSERT_INT_EQ(1, (int)s.n);
+    ASSERT_INT_EQ(1, s.hist[LAT_PARSE][latBucket(700)]);
+    ASSERT_INT_EQ(1, s.hist[LAT_DISPATCH][latBucket(300)]);
+    ASSERT_INT_EQ(1, s.hist[LAT_QUEUE][latBucket(5000)]);
+    ASSERT_INT_EQ(1, s.hist[LAT_AIR][latBucket(40000)]);
+    ASSERT_INT_EQ(46000, (int)s.maxUs[LAT_TOTAL]);
+    ASSERT_INT_EQ(1, (int)s.cmd[3].n);
+    ASSERT_INT_EQ(46000, (int)s.cmd[3].lastUs);
+
+    latRun(&s, &t, 3, 100, 500, 200, 1000, 30000);
+    ASSERT_INT_EQ(2, (int)s.cmd[3].n);
+    ASSERT_INT_EQ(31700, (int)s.cmd[3].lastUs);
+    ASSERT_INT_EQ(46000, (int)s.cmd[3].maxUs);
+
+    /* Unrecognized commands count in the stages only */
+    latRun(&s, &t, -1, 100, 500, 200, 1000, 30000);
+    ASSERT_INT_EQ(3, (int)s.n);
+    ASSERT_INT_EQ(2, (int)s.cmd[3].n);
+    TEST_PASS();
+}
+
+TEST(test_lat_incomplete_trace_dropped)
+{
+    LatStats s;
+    LatTrace t;
+    latInit(&s);
+
+    /* ACK never started (dropped or expired): nothing recorded */
+    latBegin(&t, 0);
+    latMark(&t, 1, 100);
+    latMark(&t, 2, 200);
+    ASSERT_TRUE(!latFinish(&s, &t, 9000));
+    ASSERT_INT_EQ(0, (int)s.n);
+
+    /* Marks out of order are ignored, not recorded as negative spans */
+    latBegin(&t, 0);
+    latMark(&t, 2, 50);
+    ASSERT_INT_EQ(1, t.marks);
+    latMark(&t, 1, 100);
+    latMark(&t, 1, 150);
+    ASSERT_TRUE(t.at[1] == 100);
+
+    /* Aborted on TX timeout */
+    latMark(&t, 2, 200);
+    latMark(&t, 3, 300);
+    latAbort(&t);
+    ASSERT_TRUE(!latFinish(&s, &t, 400));
+    ASSERT_INT_EQ(0, (int)s.n);
+    TEST_PASS();
+}
+
+/* ─── Reporting ─────────────────────────────────────────────────────────── */
+
+TEST(test_lat_percentiles)
+{
+    LatStats s;
+    latInit(&s);
+    ASSERT_INT_EQ(0, (int)latPercentile(&s, LAT_TOTAL, 50));
+
+    /* 98 fast, 2 slow: p50 stays in the fast bucket, p99 finds the tail */
+    for (int i = 0; i < 98; i++) latAdd(&s, LAT_TOTAL, 1500);
+    latAdd(&s, LAT_TOTAL, 90000);
+    latAdd(&s, LAT_TOTAL, 70000);
+    ASSERT_INT_EQ(2047, (int)latPercentile(&s, LAT_TOTAL, 50));   /* bucket's top */
+    ASSERT_INT_EQ(90000, (int)latPercentile(&s, LAT_TOTAL, 99));  /* capped at max */
+    TEST_PASS();
+}
+
+TEST(test_lat_format)
+{
+    LatStats s;
+    LatTrace t;
+    latInit(&s);
+    latRun(&s, &t, 0, 0, 700, 300, 5000, 40000);
+
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    ASSERT_TRUE(latFmtSummary(&s, buf, sizeof(buf)) > 0);
+    ASSERT_STR_EQ("{\"air\":[40000,40000],\"disp\":[300,300],\"n\":1,"
+                  "\"parse\":[700,700],\"q\":[5000,5000],\"tot\":[46000,46000]}", buf);
+
+    latAdd(&s, LAT_PARSE, 3);
+    ASSERT_INT_EQ(LAT_PARSE, latStageByName("parse"));
+    ASSERT_INT_EQ(-1, latStageByName("ping"));
+    latFmtStage(&s, LAT_PARSE, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"b\":[[1,1],[9,1]],\"mx\":700,\"n\":2}", buf);
+
+    /* Every bucket used: the ones that don't fit are flagged, not torn */
+    for (int k = 0; k < LAT_BUCKETS; k++) latAdd(&s, LAT_AIR, 1UL << k);
+    int len = latFmtStage(&s, LAT_AIR, buf, 120);
+    ASSERT_TRUE(len > 0 && len < 120);
+    ASSERT_TRUE(strstr(buf, ",\"t\":1}") != NULL);
+    ASSERT_TRUE(buf[len - 1] == '}');
+    TEST_PASS();
+}
+
+/* ─── ACK Fast Path ─────────────────────────────────────────────────────── */
+
+TEST(test_ack_template_matches_builder)
+{
+    static const char *nodes[] = { "ab01", "", "node-with-16-chr" };
+    static const uint32_t stamps[] = { 0, 7, 1700000000UL, 4294967295UL };
+    for (int i = 0; i < 3; i++) {
+        AckTemplate t;
+        ASSERT_TRUE(ackTemplateInit(&t, nodes[i]));
+        for (int j = 0; j < 4; j++) {
+            char ref[LORA_MAX_PAYLOAD], fast[LORA_MAX_PAYLOAD], id[16];
+            int refLen = buildAckPacket(ref, sizeof(ref), stamps[j], "9f3a61c0", nodes[i]);
+            int idLen  = ackFmtId(id, stamps[j], "9f3a61c0");
+            int len    = ackTemplateBuild(&t, fast, sizeof(fast), id, idLen);
+            ASSERT_INT_EQ(refLen, len);
+            ASSERT_STR_EQ(ref, fast);
+        }
+    }
+
+    /* Short CRC strings and tiny buffers are handled like the builder */
+    char id[16];
+    ASSERT_INT_EQ(4, ackFmtId(id, 12, "a"));
+    ASSERT_STR_EQ("12_a", id);
+    AckTemplate t;
+    ackTemplateInit(&t, "ab01");
+    char small[32];
+    ASSERT_INT_EQ(0, ackTemplateBuild(&t, small, sizeof(small), id, 4));
+    TEST_PASS();
+}
+
+TEST(test_parse_crc_with_args)
+{
+    /* CRC over {"a":["1","x y"],"cmd":"setparam","n":"ab01","t":"cmd","ts":42} */
+    const char *body = "{\"a\":[\"1\",\"x y\"],\"cmd\":\"setparam\",\"n\":\"ab01\","
+                       "\"t\":\"cmd\",\"ts\":42}";
+    char pkt[200];
+    int n = snprintf(pkt, sizeof(pkt),
+                     "{\"a\":[\"1\",\"x y\"],\"c\":\"%08x\",\"cmd\":\"setparam\","
+                     "\"n\":\"ab01\",\"t\":\"cmd\",\"ts\":42}",
+                     (unsigned)crc32_compute(body, strlen(body)));
+    CommandPacket cmd;
+    ASSERT_INT_EQ(PARSE_OK, parseCommandResult((const uint8_t *)pkt, n, &cmd));
+    ASSERT_INT_EQ(2, cmd.arg_count);
+    ASSERT_STR_EQ("x y", cmd.args[1]);
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_latency_tests(void)
+{
+    printf("latency.h tests:\n");
+
+    RUN_TEST(test_lat_buckets);
+    RUN_TEST(test_lat_trace_stages);
+    RUN_TEST(test_lat_incomplete_trace_dropped);
+    RUN_TEST(test_lat_percentiles);
+    RUN_TEST(test_lat_format);
+    RUN_TEST(test_ack_template_matches_builder);
+    RUN_TEST(test_parse_crc_with_args);
+}
@@ -0,0 +1,132 @@
+/*
+ * test_led_seq.c — Unit tests for led_seq.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  Patterns are
+ * stepped with made-up millis() values, including a late tick and a
+ * wrap, the way the tick loop would drive them.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "led_seq.h"
+#include "test_harness.h"
+
+/* ─── Stepping ──────────────────────────────────────────────────────────── */
+
+TEST(test_led_seq_show_then_done)
+{
+    LedSeq q;
+    LedStep st;
+    ledSeqInit(&q);
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 100, &st));
+
+    ASSERT_TRUE(ledSeqPush(&q, 1, 128, 500));
+    ASSERT_TRUE(ledSeqActive(&q));
+    ASSERT_INT_EQ(LED_SEQ_SHOW, ledSeqTick(&q, 1000, &st));
+    ASSERT_INT_EQ(1, st.color);
+    ASSERT_INT_EQ(128, st.brightness);
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 1001, &st));
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 1499, &st));
+    ASSERT_INT_EQ(LED_SEQ_DONE, ledSeqTick(&q, 1500, &st));
+    ASSERT_TRUE(!ledSeqActive(&q));
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 1600, &st));
+    TEST_PASS();
+}
+
+TEST(test_led_seq_late_tick_keeps_cadence)
+{
+    LedSeq q;
+    LedStep st;
+    ledSeqInit(&q);
+    ledSeqPush(&q, 1, 10, 100);
+    ledSeqPush(&q, 2, 20, 100);
+    ledSeqPush(&q, 3, 30, 100);
+
+    ledSeqTick(&q, 0, &st);
+    ASSERT_INT_EQ(LED_SEQ_SHOW, ledSeqTick(&q, 130, &st));   /* 30 ms late */
+    ASSERT_INT_EQ(2, st.color);
+    /* Step 3 still starts at 200, not 230 */
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 199, &st));
+    ASSERT_INT_EQ(LED_SEQ_SHOW, ledSeqTick(&q, 200, &st));
+    ASSERT_INT_EQ(3, st.color);
+    ASSERT_INT_EQ(LED_SEQ_DONE, ledSeqTick(&q, 300, &st));
+    TEST_PASS();
+}
+
+TEST(test_led_seq_millis_wrap)
+{
+    LedSeq q;
+    LedStep st;
+    ledSeqInit(&q);
+    ledSeqPush(&q, 1, 10, 0x200);
+    ledSeqTick(&q, 0xFFFFFF00UL, &st);
+    ASSERT_INT_EQ(LED_SEQ_IDLE, ledSeqTick(&q, 0x000000FFUL, &st));
+    ASSERT_INT_EQ(LED_SEQ_DONE, ledSeqTick(&q, 0x00000100UL, &st));
+    TEST_PASS();
+}
+
+TEST(test_led_seq_due_in)
+{
+    LedSeq q;
+    LedStep st;
+    ledSeqInit(&q);
+    ASSERT_TRUE(ledSeqDueIn(&q, 0) == LED_SEQ_NO_DEADLINE);
+
+    ledSeqPush(&q, 1, 10, 100);
+    ledSeqPush(&q, 2, 20, 300);
+    ASSERT_INT_EQ(0, ledSeqDueIn(&q, 5));            /* step 0 not shown */
+    ledSeqTick(&q, 0xFFFFFFC0UL, &st);
+    ASSERT_INT_EQ(100, ledSeqDueIn(&q, 0xFFFFFFC0UL));
+    ASSERT_INT_EQ(24, ledSeqDueIn(&q, 0x0000000CUL)); /* across the wrap */
+    ASSERT_INT_EQ(0, ledSeqDueIn(&q, 0x00000030UL)); /* overdue */
+
+    ledSeqTick(&q, 0x00000030UL, &st);
+    ASSERT_INT_EQ(288, ledSeqDueIn(&q, 0x00000030UL)); /* 2nd began at 0x24 */
+    ledSeqTick(&q, 0x00000150UL, &st);
+    ASSERT_TRUE(ledSeqDueIn(&q, 0x00000150UL) == LED_SEQ_NO_DEADLINE);
+    TEST_PASS();
+}
+
+/* ─── Patterns ──────────────────────────────────────────────────────────── */
+
+TEST(test_led_seq_blink_and_replace)
+{
+    LedSeq q;
+    LedStep st;
+    ledSeqInit(&q);
+
+    /* 5 flashes: on/off x4, then a last on — 9 steps, ends off */
+    ledSeqBlink(&q, 1, 128, 5, 50);
+    ASSERT_INT_EQ(9, q.count);
+    ASSERT_INT_EQ(0, q.s[1].color);
+    ASSERT_INT_EQ(1, q.s[8].color);
+
+    /* A new pattern mid-blink starts over from its own first step */
+    ledSeqTick(&q, 0, &st);
+    ledSeqTick(&q, 50, &st);
+    ledSeqClear(&q);
+    ledSeqPush(&q, 4, 200, 1000);
+    ASSERT_INT_EQ(LED_SEQ_SHOW, ledSeqTick(&q, 60, &st));
+    ASSERT_INT_EQ(4, st.color);
+    ASSERT_INT_EQ(LED_SEQ_DONE, ledSeqTick(&q, 1060, &st));
+
+    /* Full queue refuses more steps */
+    for (int i = 0; i < LED_SEQ_MAX; i++) ASSERT_TRUE(ledSeqPush(&q, 1, 1, 1));
+    ASSERT_TRUE(!ledSeqPush(&q, 1, 1, 1));
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_led_seq_tests(void)
+{
+    printf("led_seq.h tests:\n");
+
+    RUN_TEST(test_led_seq_show_then_done);
+    RUN_TEST(test_led_seq_late_tick_keeps_cadence);
+    RUN_TEST(test_led_seq_millis_wrap);
+    RUN_TEST(test_led_seq_due_in);
+    RUN_TEST(test_led_seq_blink_and_replace);
+}
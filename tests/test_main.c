@@ -8,16 +8,52 @@
  * Run:     make test (from project root)
  */
 
+/* This unit owns the CRC-32 tables; every strategy is built for testing */
+#define CRC32_IMPL
+#define CRC32_ALL_STRATEGIES
+
 #include "test_harness.h"
 
 /* Include test suites directly (single translation unit) */
 #include "test_params.c"
 #include "test_sensors.c"
+#include "test_power.c"
+#include "test_nmea.c"
+#include "test_ubx.c"
+#include "test_ringbuf.c"
+#include "test_gps_motion.c"
+#include "test_flash_log.c"
+#include "test_xfer.c"
+#include "test_cfg_journal.c"
+#include "test_crc32.c"
+#include "test_txqueue.c"
+#include "test_rxqueue.c"
+#include "test_dbg.c"
+#include "test_stats.c"
+#include "test_latency.c"
+#include "test_led_seq.c"
+#include "test_sched.c"
 
 int main(void)
 {
     run_param_tests();
     run_sensor_tests();
+    run_power_tests();
+    run_nmea_tests();
+    run_ubx_tests();
+    run_ringbuf_tests();
+    run_gps_motion_tests();
+    run_flash_log_tests();
+    run_xfer_tests();
+    run_cfg_journal_tests();
+    run_crc32_tests();
+    run_txqueue_tests();
+    run_rxqueue_tests();
+    run_dbg_tests();
+    run_stats_tests();
+    run_latency_tests();
+    run_led_seq_tests();
+    run_sched_tests();
 
     TEST_SUMMARY();
     return TEST_EXIT_CODE();
@@ -0,0 +1,213 @@
+/*
+ * test_nmea.c — Unit tests for nmea.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * Sentences carry real checksums.  Coordinates are cross-checked against
+ * a double-precision ddmm.mmmm → degrees conversion, which is what
+ * TinyGPS++ location.lat()/lng() return.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdlib.h>
+
+#include "nmea.h"
+#include "test_harness.h"
+
+/* ─── Helpers ───────────────────────────────────────────────────────────── */
+
+/* Feed a string; returns the number of sentences that passed checksum */
+static int nmeaFeedStr(NmeaParser *p, const char *s)
+{
+    int n = 0;
+    while (*s) if (nmeaEncode(p, *s++)) n++;
+    return n;
+}
+
+/* TinyGPS++-style reference: "ddmm.mmmm" + hemisphere → double degrees */
+static double nmeaRefDeg(const char *field, char hemi)
+{
+    double v   = strtod(field, NULL);
+    int    deg = (int)(v / 100.0);
+    double d   = deg + (v - deg * 100.0) / 60.0;
+    return (hemi == 'S' || hemi == 'W') ? -d : d;
+}
+
+static bool nmeaNearE7(int32_t e7, double ref)
+{
+    double diff = e7 / 1e7 - ref;
+    return diff < 1e-7 && diff > -1e-7;
+}
+
+/* ─── Sentences ─────────────────────────────────────────────────────────── */
+
+#define GGA_FIX   "$GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"
+#define RMC_FIX   "$GPRMC,123519,A,4807.038,N,01131.000,E,022.4,084.4,230394,003.1,W*6A\r\n"
+#define GGA_SW    "$GNGGA,235959.50,3351.12345,S,15112.54321,W,2,12,0.8,-12.34,M,,M,,*44\r\n"
+#define GGA_NOFIX "$GPGGA,183000.00,,,,,0,03,99.99,,,,,,*6F\r\n"
+#define RMC_VOID  "$GPRMC,183001.00,V,,,,,,,181026,,,N*7A\r\n"
+#define GSV_OTHER "$GPGSV,2,2,08,24,71,098,44,25,12,255,22,29,05,170,,31,33,280,*76\r\n"
+
+/* ─── Tests ─────────────────────────────────────────────────────────────── */
+
+TEST(test_nmea_gga_fix)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    ASSERT_INT_EQ(1, nmeaFeedStr(&p, GGA_FIX));
+    ASSERT_INT_EQ(NMEA_HAVE_LOC | NMEA_HAVE_ALT | NMEA_HAVE_SATS | NMEA_HAVE_TIME,
+                  p.fix.valid);
+    ASSERT_INT_EQ(481173000, p.fix.lat_e7);
+    ASSERT_INT_EQ(115166667, p.fix.lon_e7);
+    ASSERT_INT_EQ(54540, p.fix.alt_cm);
+    ASSERT_INT_EQ(8, p.fix.sats);
+    ASSERT_INT_EQ(12351900, (int)p.fix.time);
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_rmc_fix)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    ASSERT_INT_EQ(1, nmeaFeedStr(&p, RMC_FIX));
+    ASSERT_INT_EQ(NMEA_HAVE_LOC | NMEA_HAVE_TIME | NMEA_HAVE_DATE | NMEA_HAVE_SPEED,
+                  p.fix.valid);
+    ASSERT_INT_EQ(481173000, p.fix.lat_e7);
+    ASSERT_INT_EQ(2240, (int)p.fix.speed_ckn);
+    ASSERT_INT_EQ(230394, (int)p.fix.date);
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_south_west_negative_alt)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    ASSERT_INT_EQ(1, nmeaFeedStr(&p, GGA_SW));
+    ASSERT_INT_EQ(-338520575, p.fix.lat_e7);
+    ASSERT_INT_EQ(-1512090535, p.fix.lon_e7);
+    ASSERT_INT_EQ(-1234, p.fix.alt_cm);
+    ASSERT_INT_EQ(12, p.fix.sats);
+    ASSERT_INT_EQ(23595950, (int)p.fix.time);
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_no_fix_keeps_location)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+    nmeaFeedStr(&p, GGA_FIX);
+    nmeaTakeUpdated(&p);
+
+    /* Fix lost: time/sats still update, last location is retained */
+    ASSERT_INT_EQ(2, nmeaFeedStr(&p, GGA_NOFIX RMC_VOID));
+    ASSERT_INT_EQ(NMEA_HAVE_TIME | NMEA_HAVE_SATS | NMEA_HAVE_DATE,
+                  nmeaTakeUpdated(&p));
+    ASSERT_INT_EQ(3, p.fix.sats);
+    ASSERT_INT_EQ(481173000, p.fix.lat_e7);
+    ASSERT_INT_EQ(54540, p.fix.alt_cm);
+
+    /* Never-fixed parser reports no location */
+    nmeaInit(&p);
+    nmeaFeedStr(&p, GGA_NOFIX);
+    ASSERT_TRUE(!(p.fix.valid & NMEA_HAVE_LOC));
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_bad_checksum_rejected)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    /* One digit of latitude corrupted; checksum unchanged */
+    ASSERT_INT_EQ(0, nmeaFeedStr(&p,
+        "$GPGGA,123519,4817.038,N,01131.000,E,1,08,0.9,545.4,M,46.9,M,,*47\r\n"));
+    ASSERT_INT_EQ(1, (int)p.failed);
+    ASSERT_INT_EQ(0, (int)p.passed);
+    ASSERT_INT_EQ(0, p.fix.valid);
+
+    /* Non-hex checksum and truncated sentences */
+    nmeaFeedStr(&p, "$GPGGA,1*G7\r\n");
+    ASSERT_INT_EQ(2, (int)p.failed);
+    nmeaFeedStr(&p, "$GPGGA,123519,48");
+    ASSERT_INT_EQ(1, nmeaFeedStr(&p, GGA_FIX));
+    ASSERT_INT_EQ(481173000, p.fix.lat_e7);
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_other_sentences_counted)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    ASSERT_INT_EQ(1, nmeaFeedStr(&p, GSV_OTHER));
+    ASSERT_INT_EQ(1, (int)p.passed);
+    ASSERT_INT_EQ(0, p.fix.valid);
+    ASSERT_INT_EQ((int)strlen(GSV_OTHER), (int)p.chars);
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_take_updated)
+{
+    NmeaParser p;
+    nmeaInit(&p);
+
+    nmeaFeedStr(&p, "noise" GGA_FIX);
+    ASSERT_TRUE(nmeaTakeUpdated(&p) & NMEA_HAVE_LOC);
+    ASSERT_INT_EQ(0, nmeaTakeUpdated(&p));
+
+    nmeaFeedStr(&p, GSV_OTHER);
+    ASSERT_INT_EQ(0, nmeaTakeUpdated(&p));
+
+    TEST_PASS();
+}
+
+TEST(test_nmea_matches_double_reference)
+{
+    static const struct {
+        const char *sentence;
+        const char *lat, *lon;
+        char ns, ew;
+    } cases[] = {
+        { GGA_FIX, "4807.038", "01131.000", 'N', 'E' },
+        { GGA_SW,  "3351.12345", "15112.54321", 'S', 'W' },
+        { "$GPGGA,183010.00,4737.25780,N,12220.98036,W,1,06,0.91,54.6,M,-17.3,M,,*5C\r\n",
+          "4737.25780", "12220.98036", 'N', 'W' },
+        { "$GPRMC,000000.00,A,0000.00001,N,17959.99999,E,0.0,0.0,010100,,,A*55\r\n",
+          "0000.00001", "17959.99999", 'N', 'E' },
+    };
+
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        NmeaParser p;
+        nmeaInit(&p);
+        ASSERT_INT_EQ(1, nmeaFeedStr(&p, cases[i].sentence));
+        ASSERT_TRUE(nmeaNearE7(p.fix.lat_e7, nmeaRefDeg(cases[i].lat, cases[i].ns)));
+        ASSERT_TRUE(nmeaNearE7(p.fix.lon_e7, nmeaRefDeg(cases[i].lon, cases[i].ew)));
+    }
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_nmea_tests(void)
+{
+    printf("nmea.h tests:\n");
+
+    RUN_TEST(test_nmea_gga_fix);
+    RUN_TEST(test_nmea_rmc_fix);
+    RUN_TEST(test_nmea_south_west_negative_alt);
+    RUN_TEST(test_nmea_no_fix_keeps_location);
+    RUN_TEST(test_nmea_bad_checksum_rejected);
+    RUN_TEST(test_nmea_other_sentences_counted);
+    RUN_TEST(test_nmea_take_updated);
+    RUN_TEST(test_nmea_matches_double_reference);
+}
@@ -12,6 +12,7 @@
 #include <stdbool.h>
 
 #include "config_types.h"
+#include "packets.h"      /* CMD_RESPONSE_BUF_SIZE */
 #include "params.h"
 #include "test_harness.h"
 
@@ -34,13 +35,13 @@ static void testOnSetRadio(const char *name) { (void)name; onSetCallCount++; }
 
 /* Standard param table (alpha-sorted by name) */
 static const ParamDef testTable[] = {
-    { "bme280_rate",     PARAM_UINT16, &testBme280RateSec,  NULL,  1, 32767, true,  NULL,            offsetof(NodeConfig, bme280RateSec)    },
-    { "bw",              PARAM_UINT8,  &testBW,             NULL,  0,    2, true,  testOnSetRadio,  offsetof(NodeConfig, bandwidth)        },
-    { "nodeid",          PARAM_STRING, testNodeId,          NULL,  0,    0, false, NULL,            CFG_OFFSET_NONE                        },
-    { "nodev",           PARAM_UINT16, &testNodeVersion,    NULL,  0,    0, false, NULL,            CFG_OFFSET_NONE                        },
-    { "rxduty",          PARAM_UINT8,  &testRxDuty,         NULL,  0,  100, true,  NULL,            offsetof(NodeConfig, rxDutyPercent)     },
-    { "sf",              PARAM_UINT8,  &testSF,             NULL,  7,   12, true,  testOnSetRadio,  offsetof(NodeConfig, spreadingFactor)   },
-    { "txpwr",           PARAM_INT8,   &testTxPwr,          NULL, -17,  22, true,  testOnSetTxPwr,  offsetof(NodeConfig, txOutputPower)     },
+    { "bme280_rate",     PARAM_UINT16, &testBme280RateSec,  NULL,  1, 32767, true,  NULL,            offsetof(NodeConfig, bme280RateSec),    NULL },
+    { "bw",              PARAM_UINT8,  &testBW,             NULL,  0,    2, true,  testOnSetRadio,  offsetof(NodeConfig, bandwidth),        NULL },
+    { "nodeid",          PARAM_STRING, testNodeId,          NULL,  0,    0, false, NULL,            CFG_OFFSET_NONE,                        NULL },
+    { "nodev",           PARAM_UINT16, &testNodeVersion,    NULL,  0,    0, false, NULL,            CFG_OFFSET_NONE,                        NULL },
+    { "rxduty",          PARAM_UINT8,  &testRxDuty,         NULL,  0,  100, true,  NULL,            offsetof(NodeConfig, rxDutyPercent),     NULL },
+    { "sf",              PARAM_UINT8,  &testSF,             NULL,  7,   12, true,  testOnSetRadio,  offsetof(NodeConfig, spreadingFactor),   NULL },
+    { "txpwr",           PARAM_INT8,   &testTxPwr,          NULL, -17,  22, true,  testOnSetTxPwr,  offsetof(NodeConfig, txOutputPower),     NULL },
 };
 #define TEST_TABLE_COUNT (sizeof(testTable) / sizeof(testTable[0]))
 
@@ -309,9 +310,9 @@ TEST(test_paramsTableIsSorted_valid)
 TEST(test_paramsTableIsSorted_unsorted)
 {
     static const ParamDef unsorted[] = {
-        { "bw",    PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
-        { "txpwr", PARAM_INT8,  NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
-        { "sf",    PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
+        { "bw",    PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
+        { "txpwr", PARAM_INT8,  NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
+        { "sf",    PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
     };
     ASSERT_TRUE(!paramsTableIsSorted(unsorted, 3));
     TEST_PASS();
@@ -320,8 +321,8 @@ TEST(test_paramsTableIsSorted_unsorted)
 TEST(test_paramsTableIsSorted_duplicates)
 {
     static const ParamDef dupes[] = {
-        { "bw", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
-        { "bw", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
+        { "bw", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
+        { "bw", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
     };
     ASSERT_TRUE(!paramsTableIsSorted(dupes, 2));
     TEST_PASS();
@@ -330,7 +331,7 @@ TEST(test_paramsTableIsSorted_duplicates)
 TEST(test_paramsTableIsSorted_single)
 {
     static const ParamDef single[] = {
-        { "x", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE },
+        { "x", PARAM_UINT8, NULL, NULL, 0, 0, false, NULL, CFG_OFFSET_NONE, NULL },
     };
     ASSERT_TRUE(paramsTableIsSorted(single, 1));
     TEST_PASS();
@@ -410,6 +411,201 @@ TEST(test_cmdsList_page_past_end)
     TEST_PASS();
 }
 
+/* ─── Cursor Tests ───────────────────────────────────────────────────────── */
+
+/* Pull the "n" cursor out of a list response; false if there is none */
+static bool cursorOf(const char *json, char *tok)
+{
+    const char *n = strstr(json, "\"n\":\"");
+    if (!n) return false;
+    memcpy(tok, n + 5, PARAM_CURSOR_LEN);
+    tok[PARAM_CURSOR_LEN] = '\0';
+    return true;
+}
+
+TEST(test_paramsListAt_all_fit_matches_legacy)
+{
+    resetFixtures();
+    char a[256], b[256];
+    uint16_t h = paramsTableHash(testTable, TEST_TABLE_COUNT);
+    int n = paramsListAt(testTable, TEST_TABLE_COUNT, 0, h, a, sizeof(a));
+    paramsList(testTable, TEST_TABLE_COUNT, 0, b, sizeof(b));
+    ASSERT_INT_EQ((int)strlen(a), n);
+    ASSERT_STR_EQ(b, a);
+
+    n = paramsListAt(testTable, 0, 0, h, a, sizeof(a));
+    ASSERT_STR_EQ("{\"m\":0,\"p\":{}}", a);
+    TEST_PASS();
+}
+
+TEST(test_paramsListAt_cursor_walk)
+{
+    resetFixtures();
+    char buf[60], tok[PARAM_CURSOR_LEN + 1];
+    char all[256] = "";
+    uint16_t h = paramsTableHash(testTable, TEST_TABLE_COUNT);
+    int start = 0, pages = 0;
+
+    for (;;) {
+        int n = paramsListAt(testTable, TEST_TABLE_COUNT, start, h, buf, sizeof(buf));
+        ASSERT_TRUE(n > 0 && n < (int)sizeof(buf));
+        ASSERT_TRUE(buf[0] == '{' && buf[n - 1] == '}');
+        pages++;
+
+        /* Collect the items between "p":{ and the closing }} */
+        const char *p = strstr(buf, "\"p\":{") + 5;
+        if (all[0] && p[0] != '}') strcat(all, ",");
+        strncat(all, p, strlen(p) - 2);
+
+        if (!cursorOf(buf, tok)) {
+            ASSERT_TRUE(strncmp(buf, "{\"m\":0,", 7) == 0);
+            break;
+        }
+        ASSERT_TRUE(strncmp(buf, "{\"m\":1,\"n\":", 11) == 0);
+        ASSERT_TRUE(paramCursorParse(tok, h, TEST_TABLE_COUNT, &start));
+        ASSERT_TRUE(pages < 10);
+    }
+
+    /* Every param exactly once, in order */
+    ASSERT_TRUE(pages > 1);
+    ASSERT_STR_EQ("\"bme280_rate\":5,\"bw\":0,\"nodeid\":\"ab01\",\"nodev\":1,"
+                  "\"rxduty\":90,\"sf\":7,\"txpwr\":14", all);
+    TEST_PASS();
+}
+
+TEST(test_paramCursor_rejects_stale_and_malformed)
+{
+    int start = -1;
+    uint16_t h = paramsTableHash(testTable, TEST_TABLE_COUNT);
+    char tok[16];
+
+    snprintf(tok, sizeof(tok), "%04x%04x", 3u, (unsigned)h);
+    ASSERT_TRUE(paramCursorParse(tok, h, TEST_TABLE_COUNT, &start));
+    ASSERT_INT_EQ(3, start);
+
+    /* A table with one name changed hashes differently */
+    ParamDef other[TEST_TABLE_COUNT];
+    memcpy(other, testTable, sizeof(other));
+    other[2].name = "nodeix";
+    ASSERT_TRUE(paramsTableHash(other, TEST_TABLE_COUNT) != h);
+    ASSERT_TRUE(!paramCursorParse(tok, paramsTableHash(other, TEST_TABLE_COUNT),
+                                  TEST_TABLE_COUNT, &start));
+    /* Dropping an entry changes it too */
+    ASSERT_TRUE(paramsTableHash(testTable, TEST_TABLE_COUNT - 1) != h);
+
+    /* Past the end, wrong length, non-hex, legacy page number */
+    snprintf(tok, sizeof(tok), "%04x%04x", 99u, (unsigned)h);
+    ASSERT_TRUE(!paramCursorParse(tok, h, TEST_TABLE_COUNT, &start));
+    ASSERT_TRUE(!paramCursorParse("0003", h, TEST_TABLE_COUNT, &start));
+    ASSERT_TRUE(!paramCursorParse("0003zzzz", h, TEST_TABLE_COUNT, &start));
+    ASSERT_TRUE(!paramCursorIsToken("2"));
+    TEST_PASS();
+}
+
+TEST(test_cmdsListAt_cursor_walk)
+{
+    char buf[60], tok[PARAM_CURSOR_LEN + 1];
+    uint16_t h = cmdsTableHash(testCmdNames, TEST_CMD_COUNT);
+    int start = 0, seen = 0, pages = 0;
+
+    for (;;) {
+        int n = cmdsListAt(testCmdNames, TEST_CMD_COUNT, start, h, buf, sizeof(buf));
+        ASSERT_TRUE(n > 0 && n < (int)sizeof(buf));
+        ASSERT_TRUE(buf[0] == '{' && buf[n - 1] == '}');
+        pages++;
+        for (int i = 0; i < (int)TEST_CMD_COUNT; i++) {
+            char q[24];
+            snprintf(q, sizeof(q), "\"%s\"", testCmdNames[i]);
+            if (strstr(buf, q)) {
+                ASSERT_TRUE(i >= start);    /* nothing from earlier pages */
+                seen++;
+            }
+        }
+        if (!cursorOf(buf, tok)) {
+            ASSERT_TRUE(strstr(buf, "],\"m\":0}") != NULL);
+            break;
+        }
+        ASSERT_TRUE(strstr(buf, "],\"m\":1,\"n\":\"") != NULL);
+        ASSERT_TRUE(paramCursorParse(tok, h, TEST_CMD_COUNT, &start));
+        ASSERT_TRUE(pages < 20);
+    }
+
+    /* "getparam" is a prefix of "getparams": the quoted match keeps them apart */
+    ASSERT_INT_EQ((int)TEST_CMD_COUNT, seen);
+    ASSERT_TRUE(pages > 1);
+
+    /* Stale once a command is added */
+    const char *more[TEST_CMD_COUNT + 1];
+    memcpy(more, testCmdNames, sizeof(testCmdNames));
+    more[TEST_CMD_COUNT] = "xopen";
+    ASSERT_TRUE(cmdsTableHash(more, TEST_CMD_COUNT + 1) != h);
+    TEST_PASS();
+}
+
+/*
+ * Benchmark: sweep a large synthetic table in response-sized pages.  A
+ * getter counts how many values are formatted; the legacy page-number
+ * form re-packs every earlier page (quadratic in the table), the cursor
+ * form formats each value about once.  Build with -DBENCH_VERBOSE to
+ * print the counts.
+ */
+#define BENCH_PARAMS 600
+
+static uint32_t benchFmtCount = 0;
+static void benchGet(void *out) { uint16_t v = 12345; benchFmtCount++; memcpy(out, &v, sizeof(v)); }
+
+TEST(test_paramsList_cursor_benchmark)
+{
+    static char names[BENCH_PARAMS][8];
+    static ParamDef big[BENCH_PARAMS];
+    for (int i = 0; i < BENCH_PARAMS; i++) {
+        snprintf(names[i], sizeof(names[i]), "p%04d", i);
+        ParamDef d = { names[i], PARAM_UINT16, NULL, NULL, 0, 0, false, NULL,
+                       CFG_OFFSET_NONE, benchGet };
+        big[i] = d;
+    }
+    ASSERT_TRUE(paramsTableIsSorted(big, BENCH_PARAMS));
+
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    char tok[PARAM_CURSOR_LEN + 1];
+    uint16_t h = paramsTableHash(big, BENCH_PARAMS);
+
+    /* Cursor sweep */
+    benchFmtCount = 0;
+    int start = 0, pages = 0, items = 0;
+    for (;;) {
+        paramsListAt(big, BENCH_PARAMS, start, h, buf, sizeof(buf));
+        pages++;
+        for (const char *p = buf; (p = strstr(p, "\"p0")) != NULL; p++) items++;
+        if (!cursorOf(buf, tok)) break;
+        ASSERT_TRUE(paramCursorParse(tok, h, BENCH_PARAMS, &start));
+    }
+    uint32_t cursorFmts = benchFmtCount;
+    ASSERT_INT_EQ(BENCH_PARAMS, items);
+    /* Each value once, plus the one that didn't fit at each page break */
+    ASSERT_TRUE(cursorFmts <= (uint32_t)(BENCH_PARAMS + pages));
+
+    /* Legacy sweep over the same pages */
+    benchFmtCount = 0;
+    int legacyPages = 0;
+    for (int pg = 0; ; pg++) {
+        paramsList(big, BENCH_PARAMS, pg, buf, sizeof(buf));
+        legacyPages++;
+        if (strncmp(buf, "{\"m\":0", 6) == 0) break;
+    }
+    uint32_t legacyFmts = benchFmtCount;
+
+    /* Denser first page (no cursor), so the legacy sweep may be shorter */
+    ASSERT_TRUE(legacyPages <= pages);
+    ASSERT_TRUE(legacyFmts > cursorFmts * (uint32_t)(pages / 4));
+
+#ifdef BENCH_VERBOSE
+    printf("[%d pages: cursor %lu fmts, legacy %lu fmts] ",
+           pages, (unsigned long)cursorFmts, (unsigned long)legacyFmts);
+#endif
+    TEST_PASS();
+}
+
 /* ─── paramsSyncToConfig Tests ───────────────────────────────────────────── */
 
 TEST(test_syncToConfig_copies_writable)
@@ -453,6 +649,85 @@ TEST(test_syncToConfig_skips_readonly)
     TEST_PASS();
 }
 
+/* ─── Virtual (getter) Param Tests ───────────────────────────────────────── */
+
+static uint32_t getterCalls = 0;
+static void testGetUptime(void *out) { uint32_t v = 86400; getterCalls++; memcpy(out, &v, sizeof(v)); }
+static void testGetMv(void *out)     { uint16_t v = 3712;  getterCalls++; memcpy(out, &v, sizeof(v)); }
+static void testGetFw(void *out)     { strcpy((char *)out, "1.2.3"); }
+
+static const ParamDef virtTable[] = {
+    { "batt_mv", PARAM_UINT16, NULL,         NULL, 0,   0, false, NULL, CFG_OFFSET_NONE,                    testGetMv     },
+    { "fw",      PARAM_STRING, NULL,         NULL, 0,   0, false, NULL, CFG_OFFSET_NONE,                    testGetFw     },
+    { "rxduty",  PARAM_UINT8,  &testRxDuty,  NULL, 0, 100, true,  NULL, offsetof(NodeConfig, rxDutyPercent), NULL          },
+    { "uptime",  PARAM_UINT32, NULL,         NULL, 0,   0, false, NULL, CFG_OFFSET_NONE,                    testGetUptime },
+};
+#define VIRT_TABLE_COUNT (sizeof(virtTable) / sizeof(virtTable[0]))
+
+TEST(test_virtual_get_and_list)
+{
+    resetFixtures();
+    char buf[128];
+    getterCalls = 0;
+
+    paramGet(virtTable, VIRT_TABLE_COUNT, "uptime", buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"uptime\":86400}", buf);
+    ASSERT_INT_EQ(1, (int)getterCalls);
+    paramGet(virtTable, VIRT_TABLE_COUNT, "fw", buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"fw\":\"1.2.3\"}", buf);
+
+    /* Listed in one sweep with the stored params */
+    paramsList(virtTable, VIRT_TABLE_COUNT, 0, buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"m\":0,\"p\":{\"batt_mv\":3712,\"fw\":\"1.2.3\",\"rxduty\":90,\"uptime\":86400}}", buf);
+
+    /* Value-only formatting for single-value replies */
+    ASSERT_INT_EQ(4, paramFmtValue(&virtTable[0], buf, sizeof(buf)));
+    ASSERT_STR_EQ("3712", buf);
+    TEST_PASS();
+}
+
+TEST(test_virtual_is_read_only)
+{
+    resetFixtures();
+    char buf[128];
+    paramSet(virtTable, VIRT_TABLE_COUNT, "uptime", "5", buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"e\":\"read-only: uptime\"}", buf);
+
+    /* Never persisted or loaded */
+    NodeConfig c;
+    memset(&c, 0xAA, sizeof(c));
+    paramsSyncToConfig(virtTable, VIRT_TABLE_COUNT, &c);
+    ASSERT_INT_EQ(90, c.rxDutyPercent);
+    ASSERT_INT_EQ(0, paramsLoadFromConfig(virtTable, VIRT_TABLE_COUNT, &c));
+    TEST_PASS();
+}
+
+/* ─── paramsLoadFromConfig Tests ─────────────────────────────────────────── */
+
+TEST(test_loadFromConfig_round_trip)
+{
+    resetFixtures();
+    NodeConfig profile;
+    memset(&profile, 0, sizeof(profile));
+    testRxDuty = 10;
+    testSF = 10;
+    paramsSyncToConfig(testTable, TEST_TABLE_COUNT, &profile);
+
+    /* Drift away, then restore the snapshot */
+    resetFixtures();
+    onSetCallCount = 0;
+    ASSERT_INT_EQ(2, paramsLoadFromConfig(testTable, TEST_TABLE_COUNT, &profile));
+    ASSERT_INT_EQ(10, testRxDuty);
+    ASSERT_INT_EQ(10, testSF);
+    ASSERT_INT_EQ(1, onSetCallCount);     /* sf's callback; rxduty has none */
+
+    /* Same values again: nothing changes, no callbacks */
+    ASSERT_INT_EQ(0, paramsLoadFromConfig(testTable, TEST_TABLE_COUNT, &profile));
+    ASSERT_INT_EQ(1, onSetCallCount);
+    ASSERT_STR_EQ("ab01", testNodeId);    /* read-only untouched */
+    TEST_PASS();
+}
+
 /* ─── paramsApplyStaged Tests ────────────────────────────────────────────── */
 
 /* Separate table with runtimePtr set for staged-param testing */
@@ -462,10 +737,10 @@ static int8_t  stagedTxPwr = 14;
 static NodeConfig stagedCfg;
 
 static const ParamDef stagedTable[] = {
-    { "bw",    PARAM_UINT8, &stagedCfg.bandwidth,        &stagedBW,    0,   2, true, NULL, offsetof(NodeConfig, bandwidth)       },
-    { "rxduty", PARAM_UINT8, &stagedBW,                  NULL,         0, 100, true, NULL, offsetof(NodeConfig, rxDutyPercent)    },
-    { "sf",    PARAM_UINT8, &stagedCfg.spreadingFactor,  &stagedSF,    7,  12, true, NULL, offsetof(NodeConfig, spreadingFactor)  },
-    { "txpwr", PARAM_INT8,  &stagedCfg.txOutputPower,    &stagedTxPwr, -17, 22, true, NULL, offsetof(NodeConfig, txOutputPower)   },
+    { "bw",    PARAM_UINT8, &stagedCfg.bandwidth,        &stagedBW,    0,   2, true, NULL, offsetof(NodeConfig, bandwidth),       NULL },
+    { "rxduty", PARAM_UINT8, &stagedBW,                  NULL,         0, 100, true, NULL, offsetof(NodeConfig, rxDutyPercent),    NULL },
+    { "sf",    PARAM_UINT8, &stagedCfg.spreadingFactor,  &stagedSF,    7,  12, true, NULL, offsetof(NodeConfig, spreadingFactor),  NULL },
+    { "txpwr", PARAM_INT8,  &stagedCfg.txOutputPower,    &stagedTxPwr, -17, 22, true, NULL, offsetof(NodeConfig, txOutputPower),   NULL },
 };
 #define STAGED_TABLE_COUNT (sizeof(stagedTable) / sizeof(stagedTable[0]))
 
@@ -492,6 +767,44 @@ TEST(test_paramsApplyStaged)
     TEST_PASS();
 }
 
+TEST(test_loadFromConfig_staged_needs_apply)
+{
+    memset(&stagedCfg, 0, sizeof(stagedCfg));
+    stagedSF = 7;
+    NodeConfig profile;
+    memset(&profile, 0, sizeof(profile));
+    profile.spreadingFactor = 10;
+
+    /* Lands in the staged cfg field; runtime waits for paramsApplyStaged */
+    paramsLoadFromConfig(stagedTable, STAGED_TABLE_COUNT, &profile);
+    ASSERT_INT_EQ(10, stagedCfg.spreadingFactor);
+    ASSERT_INT_EQ(7, stagedSF);
+    paramsApplyStaged(stagedTable, STAGED_TABLE_COUNT);
+    ASSERT_INT_EQ(10, stagedSF);
+    TEST_PASS();
+}
+
+TEST(test_loadFromConfig_skips_out_of_range)
+{
+    resetFixtures();
+    NodeConfig profile;
+    memset(&profile, 0, sizeof(profile));
+    profile.bme280RateSec   = 0;      /* below 1 */
+    profile.bandwidth       = 0;
+    profile.rxDutyPercent   = 200;    /* above 100 */
+    profile.spreadingFactor = 9;
+    profile.txOutputPower   = -40;    /* below -17 */
+
+    /* Only sf is in range; the rest keep their values, no onSet */
+    ASSERT_INT_EQ(1, paramsLoadFromConfig(testTable, TEST_TABLE_COUNT, &profile));
+    ASSERT_INT_EQ(9, testSF);
+    ASSERT_INT_EQ(5, testBme280RateSec);
+    ASSERT_INT_EQ(90, testRxDuty);
+    ASSERT_INT_EQ(14, testTxPwr);
+    ASSERT_INT_EQ(1, onSetCallCount);
+    TEST_PASS();
+}
+
 TEST(test_paramsApplyStaged_skips_immediate)
 {
     /* rxduty in stagedTable has runtimePtr = NULL (immediate param) */
@@ -553,6 +866,13 @@ void run_param_tests(void)
     RUN_TEST(test_cmdsList_page1);
     RUN_TEST(test_cmdsList_page_past_end);
 
+    /* Cursors */
+    RUN_TEST(test_paramsListAt_all_fit_matches_legacy);
+    RUN_TEST(test_paramsListAt_cursor_walk);
+    RUN_TEST(test_paramCursor_rejects_stale_and_malformed);
+    RUN_TEST(test_cmdsListAt_cursor_walk);
+    RUN_TEST(test_paramsList_cursor_benchmark);
+
     /* paramsSyncToConfig */
     RUN_TEST(test_syncToConfig_copies_writable);
     RUN_TEST(test_syncToConfig_skips_readonly);
@@ -560,4 +880,13 @@ void run_param_tests(void)
     /* paramsApplyStaged */
     RUN_TEST(test_paramsApplyStaged);
     RUN_TEST(test_paramsApplyStaged_skips_immediate);
+
+    /* Virtual params */
+    RUN_TEST(test_virtual_get_and_list);
+    RUN_TEST(test_virtual_is_read_only);
+
+    /* paramsLoadFromConfig */
+    RUN_TEST(test_loadFromConfig_round_trip);
+    RUN_TEST(test_loadFromConfig_staged_needs_apply);
+    RUN_TEST(test_loadFromConfig_skips_out_of_range);
 }
@@ -0,0 +1,252 @@
+/*
+ * test_power.c — Unit tests for power_rail.h and Vext gating in sensor_drv.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * Reuses the mock drivers and virtual clock from test_sensors.c (same
+ * translation unit) and adds mock rail callbacks.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "power_rail.h"
+#include "sensor_drv.h"
+#include "test_harness.h"
+
+/* ─── Mock Rail ─────────────────────────────────────────────────────────── */
+
+static int  railSets;
+static int  railPowered;
+static bool railHwOn;
+
+static void mockRailSet(bool on) { railSets++; railHwOn = on; }
+static void mockRailPowered(void) { railPowered++; }
+
+static unsigned long mockWarmup;
+static unsigned long mockWarmupMs(void) { return mockWarmup; }
+
+/* BME280-like: on the rail, usable as soon as resume() returns */
+static const SensorDriver railFastDrv = {
+    "rfast", mockInit, mockAlive, mockSyncRead, &mockRateSec,
+    NULL, NULL, NULL, mockResume, true, NULL
+};
+
+/* GPS-like: on the rail with a warm-up lead */
+static const SensorDriver railSlowDrv = {
+    "rslow", mockInit, mockAlive, mockSync2Read, &mockRate2Sec,
+    NULL, NULL, NULL, mockResume, true, mockWarmupMs
+};
+
+/* Two-phase sensor on the rail */
+static const SensorDriver railAsyncDrv = {
+    "rasync", mockInit, mockAlive, mockAsyncRead, &mockRateSec,
+    mockStart, mockReady, mockCollect, mockResume, true, NULL
+};
+
+static void resetRail(PowerRail *rail, bool on)
+{
+    railSets = 0;
+    railPowered = 0;
+    railHwOn = on;
+    mockWarmup = 0;
+    mockResumes = 0;
+    mockResumeOk = 1;
+    powerRailInit(rail, mockRailSet, mockRailPowered, on, 0);
+}
+
+/* ─── power_rail.h ──────────────────────────────────────────────────────── */
+
+TEST(test_rail_switch_and_accounting)
+{
+    PowerRail rail;
+    resetRail(&rail, false);
+
+    ASSERT_TRUE(powerRailSwitch(&rail, true, 1000));
+    ASSERT_TRUE(railHwOn);
+    ASSERT_INT_EQ(1, railPowered);
+    ASSERT_INT_EQ(1, (int)rail.on_count);
+
+    /* No-op when already in the requested state */
+    ASSERT_TRUE(!powerRailSwitch(&rail, true, 1500));
+    ASSERT_INT_EQ(1, railSets);
+
+    ASSERT_TRUE(powerRailOnMs(&rail, 1500) == 500);
+    ASSERT_TRUE(powerRailSwitch(&rail, false, 3000));
+    ASSERT_TRUE(!railHwOn);
+    ASSERT_TRUE(powerRailOnMs(&rail, 9000) == 2000);
+
+    TEST_PASS();
+}
+
+TEST(test_rail_hold_bits)
+{
+    PowerRail rail;
+    resetRail(&rail, false);
+
+    powerRailHold(&rail, POWER_HOLD_LED, true);
+    powerRailHold(&rail, POWER_HOLD_ALWAYS, true);
+    powerRailHold(&rail, POWER_HOLD_LED, false);
+    ASSERT_INT_EQ(POWER_HOLD_ALWAYS, rail.holds);
+
+    TEST_PASS();
+}
+
+/* ─── Sensor gating ─────────────────────────────────────────────────────── */
+
+TEST(test_gate_off_after_sample)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &railFastDrv, &mockSyncDrv };
+    resetMocks(slots, 2, drvs);
+    PowerRail rail;
+    resetRail(&rail, true);
+
+    Reading out[4];
+    sensorSlotsPowerUpdate(slots, 2, &rail, mockNow, 0);
+    ASSERT_TRUE(rail.on);
+    ASSERT_INT_EQ(2, sensorSlotsPoll(slots, 2, mockNow, 0, out, 4));
+
+    /* Nothing due — rail drops, rail slot marked unpowered */
+    sensorSlotsPowerUpdate(slots, 2, &rail, mockNow + 1, 0);
+    ASSERT_TRUE(!rail.on);
+    ASSERT_TRUE(!slots[0].powered);
+    ASSERT_TRUE(slots[1].powered);  /* unswitched slot untouched */
+
+    TEST_PASS();
+}
+
+TEST(test_gate_warmup_lead)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &railSlowDrv };
+    resetMocks(slots, 1, drvs);
+    PowerRail rail;
+    resetRail(&rail, false);
+    mockWarmup = 3000;
+    mockRate2Sec = 30;
+    slots[0].powered   = false;
+    slots[0].next_due  = 31000;
+    slots[0].scheduled = true;
+
+    /* Wake-up target is the start of the warm-up, not the deadline */
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, 20000) == 8000);
+
+    sensorSlotsPowerUpdate(slots, 1, &rail, 27999, 0);
+    ASSERT_TRUE(!rail.on);
+
+    sensorSlotsPowerUpdate(slots, 1, &rail, 28000, 0);
+    ASSERT_TRUE(rail.on);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, 28000) == 3000);
+
+    /* Warming: due by the deadline only once the warm-up has elapsed */
+    Reading out[4];
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, 30999, 0, out, 4));
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, 31000, 0, out, 4));
+
+    TEST_PASS();
+}
+
+TEST(test_gate_powerup_resumes)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &railFastDrv, &mockWarmDrv };
+    resetMocks(slots, 2, drvs);
+    PowerRail rail;
+    resetRail(&rail, true);
+
+    sensorSlotsPowerSet(slots, 2, &rail, false, 1000);
+    sensorSlotsPowerSet(slots, 2, &rail, true, 2000);
+
+    /* Only the rail slot is resumed; no full init needed */
+    ASSERT_INT_EQ(1, mockResumes);
+    ASSERT_INT_EQ(1, railPowered);
+    ASSERT_TRUE(slots[0].alive);
+    ASSERT_INT_EQ(0, mockInits);
+
+    TEST_PASS();
+}
+
+TEST(test_gate_hold_keeps_rail)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &railFastDrv };
+    resetMocks(slots, 1, drvs);
+    PowerRail rail;
+    resetRail(&rail, true);
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+
+    powerRailHold(&rail, POWER_HOLD_LED, true);
+    sensorSlotsPowerUpdate(slots, 1, &rail, mockNow + 1, 0);
+    ASSERT_TRUE(rail.on);
+    ASSERT_TRUE(!rail.demand);
+
+    powerRailHold(&rail, POWER_HOLD_LED, false);
+    sensorSlotsPowerUpdate(slots, 1, &rail, mockNow + 2, 0);
+    ASSERT_TRUE(!rail.on);
+
+    TEST_PASS();
+}
+
+TEST(test_gate_joins_group_within_slack)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &mockSyncDrv, &railFastDrv };
+    resetMocks(slots, 2, drvs);
+    PowerRail rail;
+    resetRail(&rail, false);
+    slots[0].next_due = 31000; slots[0].scheduled = true;
+    slots[1].next_due = 33000; slots[1].scheduled = true;
+    slots[1].powered  = false;
+
+    /* Unswitched slot is due; rail slot within slack gets powered to join */
+    sensorSlotsPowerUpdate(slots, 2, &rail, 31000, 5000);
+    ASSERT_TRUE(rail.on);
+
+    Reading out[4];
+    ASSERT_INT_EQ(2, sensorSlotsPoll(slots, 2, 31000, 5000, out, 4));
+
+    TEST_PASS();
+}
+
+TEST(test_gate_conversion_keeps_rail)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &railAsyncDrv };
+    resetMocks(slots, 1, drvs);
+    PowerRail rail;
+    resetRail(&rail, true);
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(1, sensorSlotsPending(slots, 1));
+
+    sensorSlotsPowerUpdate(slots, 1, &rail, mockNow + 5, 0);
+    ASSERT_TRUE(rail.on);
+
+    mockNow += 10;
+    sensorSlotsCollect(slots, 1, mockNow, out, 4);
+    sensorSlotsPowerUpdate(slots, 1, &rail, mockNow, 0);
+    ASSERT_TRUE(!rail.on);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_power_tests(void)
+{
+    printf("power_rail.h tests:\n");
+
+    RUN_TEST(test_rail_switch_and_accounting);
+    RUN_TEST(test_rail_hold_bits);
+
+    /* Sensor gating */
+    RUN_TEST(test_gate_off_after_sample);
+    RUN_TEST(test_gate_warmup_lead);
+    RUN_TEST(test_gate_powerup_resumes);
+    RUN_TEST(test_gate_hold_keeps_rail);
+    RUN_TEST(test_gate_joins_group_within_slack);
+    RUN_TEST(test_gate_conversion_keeps_rail);
+}
@@ -0,0 +1,86 @@
+/*
+ * test_ringbuf.c — Unit tests for ringbuf.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ringbuf.h"
+#include "test_harness.h"
+
+/* ─── Tests ─────────────────────────────────────────────────────────────── */
+
+TEST(test_ring_fifo_order_and_wrap)
+{
+    uint8_t store[8];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+    uint8_t c;
+
+    ASSERT_TRUE(!ringPop(&r, &c));
+
+    /* Several laps around the 8-byte ring */
+    uint8_t next = 0, expect = 0;
+    for (int lap = 0; lap < 5; lap++) {
+        for (int i = 0; i < 5; i++) ASSERT_TRUE(ringPush(&r, next++));
+        ASSERT_INT_EQ(5, ringCount(&r));
+        for (int i = 0; i < 5; i++) {
+            ASSERT_TRUE(ringPop(&r, &c));
+            ASSERT_INT_EQ(expect++, c);
+        }
+    }
+    ASSERT_INT_EQ(0, ringCount(&r));
+
+    TEST_PASS();
+}
+
+TEST(test_ring_overflow_counted)
+{
+    uint8_t store[8];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+
+    /* Capacity is size - 1; the rest are dropped, oldest data kept */
+    for (int i = 0; i < 10; i++) ringPush(&r, (uint8_t)i);
+    ASSERT_INT_EQ(7, ringCapacity(&r));
+    ASSERT_INT_EQ(7, ringCount(&r));
+    ASSERT_INT_EQ(3, (int)r.overflows);
+
+    uint8_t c;
+    ringPop(&r, &c);
+    ASSERT_INT_EQ(0, c);
+    ASSERT_TRUE(ringPush(&r, 99));
+    ASSERT_INT_EQ(3, (int)r.overflows);
+
+    TEST_PASS();
+}
+
+TEST(test_ring_high_water)
+{
+    uint8_t store[16];
+    RingBuf r;
+    ringInit(&r, store, sizeof(store));
+    uint8_t c;
+
+    for (int i = 0; i < 6; i++) ringPush(&r, 1);
+    while (ringPop(&r, &c)) {}
+    for (int i = 0; i < 3; i++) ringPush(&r, 1);
+
+    ASSERT_INT_EQ(6, r.highWater);
+    ASSERT_INT_EQ(3, ringCount(&r));
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_ringbuf_tests(void)
+{
+    printf("ringbuf.h tests:\n");
+
+    RUN_TEST(test_ring_fifo_order_and_wrap);
+    RUN_TEST(test_ring_overflow_counted);
+    RUN_TEST(test_ring_high_water);
+}
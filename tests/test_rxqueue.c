@@ -0,0 +1,142 @@
+/*
+ * test_rxqueue.c — Unit tests for rxqueue.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  The radio
+ * callback is played by direct rxqPush() calls, including ones made
+ * while the loop is part-way through handling a packet.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "rxqueue.h"
+#include "test_harness.h"
+
+/* Queue a text packet as onRxDone() would */
+static bool rxqPushStr(RxQueue *q, const char *s, int16_t rssi)
+{
+    return rxqPush(q, (const uint8_t *)s, (uint16_t)strlen(s), rssi, 7, 1000);
+}
+
+/* ─── Ordering ──────────────────────────────────────────────────────────── */
+
+TEST(test_rxq_fifo_in_place)
+{
+    RxQueue q;
+    rxqInit(&q);
+    ASSERT_TRUE(rxqPeek(&q) == NULL);
+
+    ASSERT_TRUE(rxqPushStr(&q, "{\"c\":\"ping\"}", -40));
+    ASSERT_TRUE(rxqPushStr(&q, "{\"c\":\"getparam\"}", -90));
+    ASSERT_INT_EQ(2, rxqCount(&q));
+
+    RxqEntry *e = rxqPeek(&q);
+    ASSERT_STR_EQ("{\"c\":\"ping\"}", (const char *)e->buf);   /* NUL-terminated */
+    ASSERT_INT_EQ(12, e->len);
+    ASSERT_INT_EQ(-40, e->rssi);
+    ASSERT_INT_EQ(7, e->snr);
+    ASSERT_INT_EQ(1000, (int)e->rxUs);
+    ASSERT_TRUE(rxqPeek(&q) == e);                     /* stays until popped */
+    rxqPop(&q);
+
+    e = rxqPeek(&q);
+    ASSERT_STR_EQ("{\"c\":\"getparam\"}", (const char *)e->buf);
+    ASSERT_INT_EQ(-90, e->rssi);
+    rxqPop(&q);
+    ASSERT_TRUE(rxqPeek(&q) == NULL);
+    rxqPop(&q);                                        /* harmless when empty */
+    ASSERT_INT_EQ(0, rxqCount(&q));
+    TEST_PASS();
+}
+
+TEST(test_rxq_arrival_during_handling)
+{
+    RxQueue q;
+    rxqInit(&q);
+    rxqPushStr(&q, "first", -50);
+
+    /* A second command lands while the first is being handled: the
+     * slot being read must not be touched */
+    RxqEntry *e = rxqPeek(&q);
+    rxqPushStr(&q, "second", -60);
+    ASSERT_STR_EQ("first", (const char *)e->buf);
+    rxqPop(&q);
+
+    /* The loop drains everything queued in one pass */
+    int handled = 0;
+    while ((e = rxqPeek(&q)) != NULL) {
+        ASSERT_STR_EQ("second", (const char *)e->buf);
+        handled++;
+        rxqPop(&q);
+    }
+    ASSERT_INT_EQ(1, handled);
+    ASSERT_INT_EQ(2, (int)q.received);
+    ASSERT_INT_EQ(0, (int)q.dropped);
+    TEST_PASS();
+}
+
+/* ─── Overflow ──────────────────────────────────────────────────────────── */
+
+TEST(test_rxq_full_drops_newest)
+{
+    RxQueue q;
+    rxqInit(&q);
+    char pkt[4] = "p0";
+    for (int i = 0; i < RXQ_DEPTH + 2; i++) {
+        pkt[1] = (char)('0' + i);
+        ASSERT_TRUE(rxqPushStr(&q, pkt, 0) == (i < RXQ_DEPTH));
+    }
+    ASSERT_INT_EQ(RXQ_DEPTH, rxqCount(&q));           /* every slot usable */
+    ASSERT_INT_EQ(2, (int)q.dropped);
+    ASSERT_INT_EQ(RXQ_DEPTH, q.highWater);
+
+    /* Queued packets are kept; the late ones were lost */
+    ASSERT_STR_EQ("p0", (const char *)rxqPeek(&q)->buf);
+    rxqPop(&q);
+    ASSERT_TRUE(rxqPushStr(&q, "pz", 0));
+    for (int i = 1; i < RXQ_DEPTH; i++) rxqPop(&q);
+    ASSERT_STR_EQ("pz", (const char *)rxqPeek(&q)->buf);
+    TEST_PASS();
+}
+
+TEST(test_rxq_invalid_size_and_wrap)
+{
+    RxQueue q;
+    rxqInit(&q);
+    uint8_t big[LORA_MAX_PAYLOAD + 1];
+    memset(big, 'x', sizeof(big));
+
+    ASSERT_TRUE(!rxqPush(&q, big, 0, 0, 0, 0));
+    ASSERT_TRUE(!rxqPush(&q, big, sizeof(big), 0, 0, 0));
+    ASSERT_INT_EQ(2, (int)q.invalid);
+    ASSERT_INT_EQ(0, rxqCount(&q));
+
+    /* A full-size payload still has room for its terminator */
+    ASSERT_TRUE(rxqPush(&q, big, LORA_MAX_PAYLOAD, 0, 0, 0));
+    ASSERT_INT_EQ(LORA_MAX_PAYLOAD, (int)strlen((const char *)rxqPeek(&q)->buf));
+    rxqPop(&q);
+
+    /* Free-running 8-bit indices wrap cleanly */
+    for (int i = 0; i < 600; i++) {
+        uint8_t b = (uint8_t)i;
+        ASSERT_TRUE(rxqPush(&q, &b, 1, 0, 0, 0));
+        ASSERT_INT_EQ(1, rxqCount(&q));
+        ASSERT_INT_EQ(b, rxqPeek(&q)->buf[0]);
+        rxqPop(&q);
+    }
+    ASSERT_INT_EQ(601, (int)q.received);
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_rxqueue_tests(void)
+{
+    printf("rxqueue.h tests:\n");
+
+    RUN_TEST(test_rxq_fifo_in_place);
+    RUN_TEST(test_rxq_arrival_during_handling);
+    RUN_TEST(test_rxq_full_drops_newest);
+    RUN_TEST(test_rxq_invalid_size_and_wrap);
+}
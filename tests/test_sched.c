@@ -0,0 +1,246 @@
+/*
+ * test_sched.c — Unit tests for sched.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  The scheduler
+ * is driven under virtual time: each pass advances a fake millis() by
+ * a fixed step, so task order and deadlines are fully deterministic.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "sched.h"
+#include "test_harness.h"
+
+/* Order tasks ran in, as their names' first letters */
+static char schedTrace[64];
+static int  schedTraceLen;
+
+static void schedTraceReset(void)
+{
+    schedTraceLen = 0;
+    schedTrace[0] = '\0';
+}
+
+static void schedLog(SchedTask *t)
+{
+    if (schedTraceLen < (int)sizeof(schedTrace) - 1) {
+        schedTrace[schedTraceLen++] = t->name[0];
+        schedTrace[schedTraceLen]   = '\0';
+    }
+}
+
+static void taskLog(SchedTask *t, uint32_t now)
+{
+    (void)now;
+    schedLog(t);
+}
+
+/* Run passes from `from` to `to` (exclusive), one every stepMs */
+static uint32_t schedRunFor(Scheduler *s, uint32_t from, uint32_t to, uint32_t stepMs)
+{
+    uint32_t now = from;
+    while ((int32_t)(to - now) > 0) {
+        schedRun(s, now);
+        now += stepMs;
+    }
+    return now;
+}
+
+/* ─── Deadlines ─────────────────────────────────────────────────────────── */
+
+TEST(test_task_order_and_periods)
+{
+    Scheduler s;
+    SchedTask a = SCHED_TASK("a", taskLog, 0,   true);
+    SchedTask b = SCHED_TASK("b", taskLog, 20,  true);
+    SchedTask c = SCHED_TASK("c", taskLog, 50,  true);
+    SchedTask d = SCHED_TASK("d", taskLog, 0,   false);
+    schedInit(&s);
+    ASSERT_TRUE(schedAdd(&s, &a, 1000));
+    ASSERT_TRUE(schedAdd(&s, &b, 1000));
+    ASSERT_TRUE(schedAdd(&s, &c, 1000));
+    ASSERT_TRUE(schedAdd(&s, &d, 1000));
+
+    schedTraceReset();
+    schedRunFor(&s, 1000, 1060, 10);
+    /* Every pass runs "a"; b at 0/20/40; c at 0/50; d never */
+    ASSERT_STR_EQ("abcaabaabac", schedTrace);
+    ASSERT_INT_EQ(6, (int)a.runs);
+    ASSERT_INT_EQ(3, (int)b.runs);
+    ASSERT_INT_EQ(2, (int)c.runs);
+    ASSERT_INT_EQ(0, (int)d.runs);
+    TEST_PASS();
+}
+
+TEST(test_task_late_pass_skips_missed_runs)
+{
+    Scheduler s;
+    SchedTask b = SCHED_TASK("b", taskLog, 20, true);
+    schedInit(&s);
+    schedAdd(&s, &b, 0);
+
+    schedRun(&s, 0);
+    schedRun(&s, 95);                  /* a slow pass: 4 periods late */
+    ASSERT_INT_EQ(2, (int)b.runs);
+    ASSERT_INT_EQ(115, (int)b.dueMs);  /* next period from now, no burst */
+    schedRun(&s, 100);
+    ASSERT_INT_EQ(2, (int)b.runs);
+
+    /* On time: the period keeps its phase */
+    schedRun(&s, 117);
+    ASSERT_INT_EQ(135, (int)b.dueMs);
+    TEST_PASS();
+}
+
+TEST(test_task_next_due_and_wrap)
+{
+    Scheduler s;
+    SchedTask b = SCHED_TASK("b", taskLog, 100, true);
+    SchedTask d = SCHED_TASK("d", taskLog, 0,   false);
+    schedInit(&s);
+    schedAdd(&s, &b, 0xFFFFFFC0UL);
+    schedAdd(&s, &d, 0xFFFFFFC0UL);
+
+    ASSERT_INT_EQ(0, (int)schedNextDueIn(&s, 0xFFFFFFC0UL));
+    schedRun(&s, 0xFFFFFFC0UL);
+    ASSERT_INT_EQ(100, (int)schedNextDueIn(&s, 0xFFFFFFC0UL));
+    ASSERT_INT_EQ(36, (int)schedNextDueIn(&s, 0x00000000UL));   /* across the wrap */
+    schedRun(&s, 0x00000010UL);
+    ASSERT_INT_EQ(1, (int)b.runs);
+    schedRun(&s, 0x00000024UL);
+    ASSERT_INT_EQ(2, (int)b.runs);
+
+    schedStop(&b);
+    ASSERT_TRUE(schedNextDueIn(&s, 0) == UINT32_MAX);
+    TEST_PASS();
+}
+
+/* ─── Protothreads ──────────────────────────────────────────────────────── */
+
+static uint32_t ptMarks[4];
+static int      ptStep;
+
+/* Blink-like sequence: mark, wait 100, mark, yield, mark, wait 50, mark */
+static void taskSeq(SchedTask *t, uint32_t now)
+{
+    PT_BEGIN(t);
+    ptMarks[ptStep++] = now;
+    PT_WAIT_MS(t, now, 100);
+    ptMarks[ptStep++] = now;
+    PT_YIELD(t);
+    ptMarks[ptStep++] = now;
+    PT_WAIT_MS(t, now, 50);
+    ptMarks[ptStep++] = now;
+    PT_END(t);
+}
+
+TEST(test_task_protothread_resumes)
+{
+    Scheduler s;
+    SchedTask a   = SCHED_TASK("a", taskLog, 0, true);
+    SchedTask seq = SCHED_TASK("s", taskSeq, 0, false);
+    schedInit(&s);
+    schedAdd(&s, &a, 0);
+    schedAdd(&s, &seq, 0);
+    ptStep = 0;
+
+    /* Idle until started; the loop keeps running around it */
+    schedRunFor(&s, 0, 100, 10);
+    ASSERT_INT_EQ(0, ptStep);
+
+    schedStart(&seq, 100);
+    schedRunFor(&s, 100, 400, 10);
+    ASSERT_INT_EQ(4, ptStep);
+    ASSERT_INT_EQ(100, (int)ptMarks[0]);
+    ASSERT_INT_EQ(200, (int)ptMarks[1]);
+    ASSERT_INT_EQ(210, (int)ptMarks[2]);   /* one pass later */
+    ASSERT_INT_EQ(260, (int)ptMarks[3]);
+    ASSERT_TRUE(!seq.active);
+    ASSERT_INT_EQ(40, (int)a.runs);        /* never held up */
+
+    /* Restart mid-wait: back to the top */
+    ptStep = 0;
+    schedStart(&seq, 400);
+    schedRun(&s, 400);
+    schedStart(&seq, 420);
+    schedRun(&s, 420);
+    ASSERT_INT_EQ(2, ptStep);
+    ASSERT_INT_EQ(420, (int)ptMarks[1]);
+    TEST_PASS();
+}
+
+/* Sleeps itself for 500 ms after each run, like an IRQ-driven task */
+static void taskNap(SchedTask *t, uint32_t now)
+{
+    schedLog(t);
+    schedSleep(t, now, 500);
+}
+
+TEST(test_task_wake_early)
+{
+    Scheduler s;
+    SchedTask n   = SCHED_TASK("n", taskNap, 0, true);
+    SchedTask l   = SCHED_TASK("l", taskLog, 10, true);
+    SchedTask seq = SCHED_TASK("s", taskSeq, 0, false);
+    schedInit(&s);
+    schedAdd(&s, &n, 0);
+    schedAdd(&s, &l, 0);
+    schedAdd(&s, &seq, 0);
+    ptStep = 0;
+
+    /* The loop may sleep until the periodic task, not the napping one */
+    schedRun(&s, 0);
+    ASSERT_INT_EQ(10, (int)schedNextDueIn(&s, 0));
+    schedStop(&l);
+    ASSERT_INT_EQ(500, (int)schedNextDueIn(&s, 0));
+
+    /* Woken (an interrupt came in): runs on the next pass, then naps again */
+    schedWake(&n, 120);
+    ASSERT_INT_EQ(0, (int)schedNextDueIn(&s, 120));
+    schedRun(&s, 120);
+    ASSERT_INT_EQ(2, (int)n.runs);
+    ASSERT_INT_EQ(500, (int)schedNextDueIn(&s, 120));
+
+    /* A protothread resumes where it was (its wait cut short), not from
+     * the top; a stopped task stays stopped */
+    schedStart(&seq, 130);
+    schedRun(&s, 130);
+    ASSERT_INT_EQ(1, ptStep);
+    schedWake(&seq, 140);
+    schedRun(&s, 140);
+    ASSERT_INT_EQ(2, ptStep);
+    ASSERT_INT_EQ(140, (int)ptMarks[1]);
+    schedWake(&l, 140);
+    ASSERT_TRUE(!schedDue(&l, 140));
+    TEST_PASS();
+}
+
+TEST(test_task_table_full)
+{
+    Scheduler s;
+    SchedTask t[SCHED_MAX_TASKS + 1];
+    schedInit(&s);
+    for (int i = 0; i < SCHED_MAX_TASKS; i++) {
+        SchedTask init = SCHED_TASK("t", taskLog, 0, true);
+        t[i] = init;
+        ASSERT_TRUE(schedAdd(&s, &t[i], 0));
+    }
+    ASSERT_TRUE(!schedAdd(&s, &t[SCHED_MAX_TASKS], 0));
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_sched_tests(void)
+{
+    printf("sched.h tests:\n");
+
+    RUN_TEST(test_task_order_and_periods);
+    RUN_TEST(test_task_late_pass_skips_missed_runs);
+    RUN_TEST(test_task_next_due_and_wrap);
+    RUN_TEST(test_task_protothread_resumes);
+    RUN_TEST(test_task_wake_early);
+    RUN_TEST(test_task_table_full);
+}
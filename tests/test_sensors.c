@@ -1,8 +1,11 @@
 /*
- * test_sensors.c — Unit tests for sensorPack() in sensors.h
+ * test_sensors.c — Unit tests for sensorPack() and slot polling in sensor_drv.h
  *
  * Compiled natively with gcc — no Arduino dependencies.
- * Tests packet building and auto-splitting when readings exceed payload.
+ * Tests packet building and auto-splitting when readings exceed payload,
+ * the two-phase (start/poll_ready/collect) poller, the deadline scheduler's
+ * slack coalescing, warm resume and dead-sensor backoff against mock
+ * drivers on a virtual clock.
  */
 
 #include <stdint.h>
@@ -328,6 +331,664 @@ TEST(test_sensorPack_tiny_buffer)
     TEST_PASS();
 }
 
+/* ─── Mock Drivers (virtual clock) ──────────────────────────────────────── */
+
+static unsigned long mockNow;        /* virtual millis() */
+static uint16_t      mockRateSec;    /* shared interval for all mocks */
+
+/* Two-phase mock: conversion completes mockConvMs after start() */
+static unsigned long mockConvMs;
+static unsigned long mockStartedAt;
+static int           mockStarts;
+static int           mockInits;
+static bool          mockHung;       /* poll_ready() never completes */
+
+static int mockInit(void)    { mockInits++; return 1; }
+static int mockAlive(void)   { return 1; }
+static int mockStart(void)   { mockStarts++; mockStartedAt = mockNow; return 1; }
+static int mockReady(void)
+{
+    return !mockHung && (mockNow - mockStartedAt >= mockConvMs);
+}
+static int mockCollect(Reading *out, int max)
+{
+    if (max < 1) return 0;
+    Reading r = { "Slow", 9, "u", (double)mockStartedAt };
+    out[0] = r;
+    return 1;
+}
+static int mockAsyncRead(Reading *out, int max) { (void)out; (void)max; return 0; }
+
+/* Synchronous mock: read() returns one reading immediately */
+static int mockSyncReads;
+static int mockSyncRead(Reading *out, int max)
+{
+    if (max < 1) return 0;
+    mockSyncReads++;
+    Reading r = { "Fast", 8, "u", 1.0 };
+    out[0] = r;
+    return 1;
+}
+
+static const SensorDriver mockAsyncDrv = {
+    "slow", mockInit, mockAlive, mockAsyncRead, &mockRateSec,
+    mockStart, mockReady, mockCollect, NULL, false, NULL
+};
+
+static const SensorDriver mockSyncDrv = {
+    "fast", mockInit, mockAlive, mockSyncRead, &mockRateSec,
+    NULL, NULL, NULL, NULL, false, NULL
+};
+
+/* Second synchronous mock with its own interval (scheduler tests) */
+static uint16_t mockRate2Sec;
+static int mockSync2Read(Reading *out, int max)
+{
+    if (max < 1) return 0;
+    Reading r = { "Other", 7, "u", 2.0 };
+    out[0] = r;
+    return 1;
+}
+
+static const SensorDriver mockSync2Drv = {
+    "other", mockInit, mockAlive, mockSync2Read, &mockRate2Sec,
+    NULL, NULL, NULL, NULL, false, NULL
+};
+
+/* Synchronous mock that samples but has nothing to report (or, with
+ * mockQuietRet changed, has no data yet or fails) */
+static int mockQuietReads;
+static int mockQuietRet;
+static int mockQuietRead(Reading *out, int max)
+{
+    (void)out; (void)max;
+    mockQuietReads++;
+    return mockQuietRet;
+}
+
+static const SensorDriver mockQuietDrv = {
+    "quiet", mockInit, mockAlive, mockQuietRead, &mockRate2Sec,
+    NULL, NULL, NULL, NULL, false, NULL
+};
+
+static void resetMocks(SensorSlot *slots, int count, const SensorDriver *const *drvs)
+{
+    mockNow = 1000;
+    mockRateSec = 5;
+    mockRate2Sec = 5;
+    mockConvMs = 10;
+    mockStartedAt = 0;
+    mockStarts = 0;
+    mockInits = 0;
+    mockHung = false;
+    mockSyncReads = 0;
+    mockQuietReads = 0;
+    mockQuietRet = SENSOR_READ_NONE;
+    for (int i = 0; i < count; i++) {
+        sensorSlotInit(&slots[i], drvs[i]);
+        slots[i].alive = true;
+    }
+}
+
+/* ─── Two-phase polling ─────────────────────────────────────────────────── */
+
+TEST(test_async_poll_does_not_block)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+
+    Reading out[4];
+    int n = sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+
+    /* Conversion started, nothing ready yet */
+    ASSERT_INT_EQ(0, n);
+    ASSERT_INT_EQ(1, mockStarts);
+    ASSERT_INT_EQ(1, sensorSlotsPending(slots, 1));
+
+    TEST_PASS();
+}
+
+TEST(test_async_collect_after_conversion)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+
+    mockNow += 5;   /* half-way through the conversion */
+    ASSERT_INT_EQ(0, sensorSlotsCollect(slots, 1, mockNow, out, 4));
+    ASSERT_INT_EQ(1, sensorSlotsPending(slots, 1));
+
+    mockNow += 5;   /* conversion done */
+    ASSERT_INT_EQ(1, sensorSlotsCollect(slots, 1, mockNow, out, 4));
+    ASSERT_STR_EQ("Slow", out[0].name);
+    ASSERT_INT_EQ(0, sensorSlotsPending(slots, 1));
+
+    /* Not restarted — interval has not elapsed */
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(1, mockStarts);
+
+    TEST_PASS();
+}
+
+TEST(test_async_not_restarted_while_converting)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+    mockConvMs = 8000;  /* longer than the sample interval */
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    mockNow += 6000;    /* interval elapsed, conversion still running */
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(1, mockStarts);
+
+    TEST_PASS();
+}
+
+TEST(test_async_instant_ready_same_pass)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+    mockConvMs = 0;
+
+    Reading out[4];
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(0, sensorSlotsPending(slots, 1));
+
+    TEST_PASS();
+}
+
+TEST(test_async_mixed_with_sync)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &mockAsyncDrv, &mockSyncDrv };
+    resetMocks(slots, 2, drvs);
+
+    /* Sync driver reads immediately even while the async one converts */
+    Reading out[4];
+    int n = sensorSlotsPoll(slots, 2, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(1, n);
+    ASSERT_STR_EQ("Fast", out[0].name);
+    ASSERT_INT_EQ(1, mockSyncReads);
+
+    mockNow += 10;
+    n = sensorSlotsPoll(slots, 2, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(1, n);
+    ASSERT_STR_EQ("Slow", out[0].name);
+    ASSERT_INT_EQ(1, mockSyncReads);  /* sync slot not due again */
+
+    TEST_PASS();
+}
+
+TEST(test_async_timeout_forces_reinit)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+    mockHung = true;
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    mockNow += SENSOR_CONVERT_TIMEOUT_MS;
+    ASSERT_INT_EQ(0, sensorSlotsCollect(slots, 1, mockNow, out, 4));
+    ASSERT_INT_EQ(0, sensorSlotsPending(slots, 1));
+    ASSERT_TRUE(!slots[0].alive);
+    ASSERT_INT_EQ(1, (int)slots[0].readFails);      /* counted for "stats" */
+
+    /* Next due poll re-runs init() before starting again */
+    mockHung = false;
+    mockNow += 5000;
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(1, mockInits);
+    ASSERT_INT_EQ(2, mockStarts);
+
+    TEST_PASS();
+}
+
+TEST(test_async_prefetch_ready_at_tx_slot)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &mockAsyncDrv, &mockSyncDrv };
+    resetMocks(slots, 2, drvs);
+
+    /* First sample at t=1000 */
+    Reading out[4];
+    sensorSlotsPoll(slots, 2, mockNow, 0, out, 4);
+    mockNow += 10;
+    sensorSlotsCollect(slots, 2, mockNow, out, 4);
+
+    /* 100 ms before the next due time: only the async slot starts */
+    mockNow = 5900;
+    sensorSlotsPrefetch(slots, 2, mockNow, 100, 0);
+    ASSERT_INT_EQ(2, mockStarts);
+    ASSERT_INT_EQ(1, mockSyncReads);
+
+    /* At the TX slot both readings are available in one poll */
+    mockNow = 6000;
+    int n = sensorSlotsPoll(slots, 2, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(2, n);
+
+    /* Prefetch kept the sampling phase: next due at 11000, not 10900 */
+    ASSERT_TRUE(!sensorSlotDue(&slots[0], 10950, 0));
+    ASSERT_TRUE(sensorSlotDue(&slots[0], 11000, 0));
+
+    TEST_PASS();
+}
+
+TEST(test_async_prefetch_skips_not_due)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockAsyncDrv };
+    resetMocks(slots, 1, drvs);
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    mockNow += 10;
+    sensorSlotsCollect(slots, 1, mockNow, out, 4);
+
+    mockNow = 3000;   /* next due at 6000, outside the 100 ms lead */
+    sensorSlotsPrefetch(slots, 1, mockNow, 100, 0);
+    ASSERT_INT_EQ(1, mockStarts);
+
+    TEST_PASS();
+}
+
+/* ─── Warm Resume ───────────────────────────────────────────────────────── */
+
+static int mockResumes;
+static int mockResumeOk;
+static int mockResume(void) { mockResumes++; return mockResumeOk; }
+
+static const SensorDriver mockWarmDrv = {
+    "warm", mockInit, mockAlive, mockSyncRead, &mockRateSec,
+    NULL, NULL, NULL, mockResume, false, NULL
+};
+
+static const SensorDriver mockWarmAsyncDrv = {
+    "warmslow", mockInit, mockAlive, mockAsyncRead, &mockRateSec,
+    mockStart, mockReady, mockCollect, mockResume, false, NULL
+};
+
+TEST(test_resume_keeps_state_and_deadline)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockWarmDrv };
+    resetMocks(slots, 1, drvs);
+    mockResumes = 0;
+    mockResumeOk = 1;
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    unsigned long due = slots[0].next_due;
+
+    sensorSlotsResume(slots, 1);
+    ASSERT_INT_EQ(1, mockResumes);
+    ASSERT_TRUE(slots[0].alive);
+    ASSERT_TRUE(slots[0].next_due == due);
+
+    /* Next due poll reads without a full init() */
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, due, 0, out, 4));
+    ASSERT_INT_EQ(0, mockInits);
+
+    TEST_PASS();
+}
+
+TEST(test_resume_without_hook_reinits)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockSyncDrv };
+    resetMocks(slots, 1, drvs);
+
+    sensorSlotsResume(slots, 1);
+    ASSERT_TRUE(!slots[0].alive);
+
+    Reading out[4];
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(1, mockInits);
+
+    TEST_PASS();
+}
+
+TEST(test_resume_failure_reinits)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockWarmDrv };
+    resetMocks(slots, 1, drvs);
+    mockResumes = 0;
+    mockResumeOk = 0;
+
+    sensorSlotsResume(slots, 1);
+    ASSERT_TRUE(!slots[0].alive);
+    ASSERT_INT_EQ(1, (int)slots[0].initFails);
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(1, mockInits);
+    ASSERT_INT_EQ(1, (int)slots[0].initFails);      /* reinit succeeded */
+    ASSERT_INT_EQ(0, (int)slots[0].readFails);
+
+    TEST_PASS();
+}
+
+TEST(test_resume_drops_inflight_conversion)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockWarmAsyncDrv };
+    resetMocks(slots, 1, drvs);
+    mockResumes = 0;
+    mockResumeOk = 1;
+
+    /* Prefetched conversion in flight when the node went to sleep */
+    Reading out[4];
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    mockNow += 10;
+    sensorSlotsCollect(slots, 1, mockNow, out, 4);
+    mockNow = 5900;
+    sensorSlotsPrefetch(slots, 1, mockNow, 100, 0);
+    ASSERT_INT_EQ(1, sensorSlotsPending(slots, 1));
+
+    sensorSlotsResume(slots, 1);
+    ASSERT_INT_EQ(0, sensorSlotsPending(slots, 1));
+
+    /* Prefetch already advanced the deadline — restarted on the next due */
+    mockNow = 11000;
+    sensorSlotsPoll(slots, 1, mockNow, 0, out, 4);
+    ASSERT_INT_EQ(3, mockStarts);
+    ASSERT_INT_EQ(0, mockInits);
+
+    TEST_PASS();
+}
+
+/* ─── Deadline Scheduler ────────────────────────────────────────────────── */
+
+/* Two sync slots: "fast" every 30 s due at 31000, "other" every 60 s at 33000 */
+static void setupDrifted(SensorSlot *slots)
+{
+    const SensorDriver *drvs[] = { &mockSyncDrv, &mockSync2Drv };
+    resetMocks(slots, 2, drvs);
+    mockRateSec  = 30;
+    mockRate2Sec = 60;
+    sensorSlotReschedule(&slots[0], 1000);
+    slots[1].next_due  = 33000;
+    slots[1].scheduled = true;
+}
+
+TEST(test_sched_coalesces_within_slack)
+{
+    SensorSlot slots[2];
+    setupDrifted(slots);
+
+    Reading out[4];
+    int n = sensorSlotsPoll(slots, 2, 31000, 5000, out, 4);
+    ASSERT_INT_EQ(2, n);
+    ASSERT_STR_EQ("Fast", out[0].name);
+    ASSERT_STR_EQ("Other", out[1].name);
+
+    /* Both rescheduled from the shared sample time — now in phase */
+    ASSERT_TRUE(slots[0].next_due == 61000);
+    ASSERT_TRUE(slots[1].next_due == 91000);
+
+    TEST_PASS();
+}
+
+TEST(test_sched_strict_without_slack)
+{
+    SensorSlot slots[2];
+    setupDrifted(slots);
+
+    Reading out[4];
+    int n = sensorSlotsPoll(slots, 2, 31000, 0, out, 4);
+    ASSERT_INT_EQ(1, n);
+    ASSERT_STR_EQ("Fast", out[0].name);
+
+    n = sensorSlotsPoll(slots, 2, 33000, 0, out, 4);
+    ASSERT_INT_EQ(1, n);
+    ASSERT_STR_EQ("Other", out[0].name);
+
+    TEST_PASS();
+}
+
+TEST(test_sched_slack_alone_does_not_fire)
+{
+    SensorSlot slots[2];
+    setupDrifted(slots);
+
+    /* Both within 5 s of due, but neither has reached its deadline */
+    Reading out[4];
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 2, 29000, 5000, out, 4));
+    ASSERT_INT_EQ(0, mockSyncReads);
+
+    TEST_PASS();
+}
+
+TEST(test_sched_next_due_in)
+{
+    SensorSlot slots[2];
+    setupDrifted(slots);
+
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 2, 21000) == 10000);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 2, 32000) == 0);   /* overdue */
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 0, 32000) == SENSOR_NO_DEADLINE);
+
+    /* Reset makes everything due immediately */
+    sensorSlotsReset(slots, 2);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 2, 21000) == 0);
+    Reading out[4];
+    ASSERT_INT_EQ(2, sensorSlotsPoll(slots, 2, 21000, 0, out, 4));
+
+    TEST_PASS();
+}
+
+TEST(test_sched_rollover_safe)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockSyncDrv };
+    resetMocks(slots, 1, drvs);
+
+    /* Sample 2 s before millis() wraps; deadline lands after the wrap */
+    unsigned long t0 = 0xFFFFFFFFUL - 2000UL;
+    Reading out[4];
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, t0, 0, out, 4));
+
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, t0 + 4999UL, 0, out, 4));
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, t0 + 4000UL) == 1000);
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, t0 + 5000UL, 0, out, 4));
+
+    TEST_PASS();
+}
+
+TEST(test_sched_prefetch_joins_group)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &mockAsyncDrv, &mockSync2Drv };
+    resetMocks(slots, 2, drvs);
+    mockRateSec  = 30;
+    mockRate2Sec = 60;
+    sensorSlotReschedule(&slots[0], 3000);   /* async due 33000 */
+    slots[1].next_due  = 31000;              /* sync due 31000 */
+    slots[1].scheduled = true;
+
+    /* Poll at 31000 will fire the sync slot; async is within slack */
+    mockNow = 30900;
+    sensorSlotsPrefetch(slots, 2, mockNow, 100, 5000);
+    ASSERT_INT_EQ(1, mockStarts);
+    ASSERT_TRUE(slots[0].next_due == 61000);
+
+    mockNow = 31000;
+    Reading out[4];
+    ASSERT_INT_EQ(2, sensorSlotsPoll(slots, 2, mockNow, 5000, out, 4));
+
+    TEST_PASS();
+}
+
+TEST(test_sched_read_none_reschedules)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockQuietDrv };
+    resetMocks(slots, 1, drvs);
+
+    /* Suppressed sample: no readings, but not retried until next due */
+    Reading out[4];
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow + 100, 0, out, 4));
+    ASSERT_INT_EQ(1, mockQuietReads);
+    ASSERT_TRUE(sensorSlotDue(&slots[0], mockNow + 5000, 0));
+
+    TEST_PASS();
+}
+
+TEST(test_sched_read_wait_stays_due)
+{
+    SensorSlot slots[1];
+    const SensorDriver *drvs[] = { &mockQuietDrv };
+    resetMocks(slots, 1, drvs);
+    mockQuietRet = SENSOR_READ_WAIT;
+
+    /* No fix yet: retried every poll, never counted as a failure */
+    Reading out[4];
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow, 0, out, 4));
+    ASSERT_INT_EQ(0, sensorSlotsPoll(slots, 1, mockNow + 100, 0, out, 4));
+    ASSERT_INT_EQ(2, mockQuietReads);
+    ASSERT_TRUE(sensorSlotDue(&slots[0], mockNow + 100, 0));
+    ASSERT_INT_EQ(0, (int)slots[0].readFails);
+
+    /* A real failure still counts */
+    mockQuietRet = 0;
+    sensorSlotsPoll(slots, 1, mockNow + 200, 0, out, 4);
+    ASSERT_INT_EQ(1, (int)slots[0].readFails);
+
+    TEST_PASS();
+}
+
+/* ─── Dead-Sensor Backoff ───────────────────────────────────────────────── */
+
+/* Unplugged sensor: init() fails until mockDeadBack is set */
+static int  mockDeadInits;
+static bool mockDeadBack;
+static int mockDeadInit(void) { mockDeadInits++; return mockDeadBack ? 1 : 0; }
+
+static const SensorDriver mockDeadDrv = {
+    "dead", mockDeadInit, mockAlive, mockSyncRead, &mockRateSec,
+    NULL, NULL, NULL, NULL, false, NULL
+};
+
+static void setupDead(SensorSlot *slots)
+{
+    const SensorDriver *drvs[] = { &mockDeadDrv };
+    resetMocks(slots, 1, drvs);
+    slots[0].alive = false;
+    mockDeadInits = 0;
+    mockDeadBack  = false;
+}
+
+TEST(test_dead_backoff_doubles)
+{
+    SensorSlot slots[1];
+    setupDead(slots);
+    Reading out[4];
+
+    /* 5 s interval: probes at 1000, then +5 s, +10 s, +20 s */
+    sensorSlotsPoll(slots, 1, 1000, 0, out, 4);
+    ASSERT_INT_EQ(1, mockDeadInits);
+    ASSERT_INT_EQ(1, slots[0].failStreak);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, 1000) == 5000);
+
+    sensorSlotsPoll(slots, 1, 2000, 0, out, 4);      /* not due: no probe */
+    ASSERT_INT_EQ(1, mockDeadInits);
+    sensorSlotsPoll(slots, 1, 6000, 0, out, 4);
+    ASSERT_INT_EQ(2, mockDeadInits);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, 6000) == 10000);
+    sensorSlotsPoll(slots, 1, 16000, 0, out, 4);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, 16000) == 20000);
+    ASSERT_INT_EQ(3, (int)slots[0].initFails);
+
+    /* Capped, then quarantined */
+    mockRateSec = 60;
+    slots[0].failStreak = SENSOR_QUARANTINE_FAILS - 1;
+    ASSERT_TRUE(sensorSlotBackoffMs(&slots[0]) == SENSOR_BACKOFF_MAX_MS);
+    ASSERT_TRUE(!sensorSlotQuarantined(&slots[0]));
+    slots[0].failStreak = SENSOR_QUARANTINE_FAILS;
+    ASSERT_TRUE(sensorSlotBackoffMs(&slots[0]) == SENSOR_QUARANTINE_MS);
+
+    /* An interval longer than the cap is never shortened */
+    mockRateSec = 3600;
+    slots[0].failStreak = 1;
+    ASSERT_TRUE(sensorSlotBackoffMs(&slots[0]) == 3600000UL);
+    TEST_PASS();
+}
+
+TEST(test_dead_quarantine_then_reconnect)
+{
+    SensorSlot slots[1];
+    setupDead(slots);
+    Reading out[4];
+
+    unsigned long t = 1000;
+    for (int i = 0; i < SENSOR_QUARANTINE_FAILS; i++) {
+        t += sensorSlotsNextDueIn(slots, 1, t);
+        sensorSlotsPoll(slots, 1, t, 0, out, 4);
+    }
+    ASSERT_INT_EQ(SENSOR_QUARANTINE_FAILS, mockDeadInits);
+    ASSERT_TRUE(sensorSlotQuarantined(&slots[0]));
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, t) == SENSOR_QUARANTINE_MS);
+
+    /* Plugged back in: picked up at the next probe, normal cadence again */
+    mockDeadBack = true;
+    t += SENSOR_QUARANTINE_MS;
+    ASSERT_INT_EQ(1, sensorSlotsPoll(slots, 1, t, 0, out, 4));
+    ASSERT_TRUE(slots[0].alive);
+    ASSERT_INT_EQ(0, slots[0].failStreak);
+    ASSERT_TRUE(sensorSlotsNextDueIn(slots, 1, t) == 5000);
+    TEST_PASS();
+}
+
+TEST(test_dead_sample_probes_now)
+{
+    SensorSlot slots[1];
+    setupDead(slots);
+    Reading out[4];
+
+    slots[0].failStreak = SENSOR_QUARANTINE_FAILS;
+    sensorSlotsPoll(slots, 1, 1000, 0, out, 4);
+    ASSERT_INT_EQ(1, mockDeadInits);
+
+    /* "sample" resets timers: the quarantined sensor is probed at once */
+    sensorSlotsReset(slots, 1);
+    sensorSlotsPoll(slots, 1, 2000, 0, out, 4);
+    ASSERT_INT_EQ(2, mockDeadInits);
+    TEST_PASS();
+}
+
+TEST(test_dead_health_format)
+{
+    SensorSlot slots[2];
+    const SensorDriver *drvs[] = { &mockSyncDrv, &mockDeadDrv };
+    resetMocks(slots, 2, drvs);
+    slots[1].alive = false;
+    mockDeadInits = 0;
+    mockDeadBack  = false;
+
+    Reading out[4];
+    sensorSlotsPoll(slots, 2, 1000, 0, out, 4);
+
+    char buf[CMD_RESPONSE_BUF_SIZE];
+    ASSERT_TRUE(sensorSlotsFmtHealth(slots, 2, 3000, buf, sizeof(buf)) > 0);
+    ASSERT_STR_EQ("{\"s\":[{\"a\":1,\"f\":0,\"n\":\"fast\",\"q\":0,\"w\":3},"
+                  "{\"a\":0,\"f\":1,\"n\":\"dead\",\"q\":0,\"w\":3}]}", buf);
+
+    /* Too small for the second entry: cut and flagged */
+    int len = sensorSlotsFmtHealth(slots, 2, 3000, buf, 60);
+    ASSERT_TRUE(len > 0 && len < 60);
+    ASSERT_STR_EQ("{\"s\":[{\"a\":1,\"f\":0,\"n\":\"fast\",\"q\":0,\"w\":3}],\"t\":1}", buf);
+    TEST_PASS();
+}
+
 /* ─── Test Runner ────────────────────────────────────────────────────────── */
 
 void run_sensor_tests(void)
@@ -355,4 +1016,36 @@ void run_sensor_tests(void)
     /* Edge cases */
     RUN_TEST(test_sensorPack_empty);
     RUN_TEST(test_sensorPack_tiny_buffer);
+
+    /* Two-phase polling */
+    RUN_TEST(test_async_poll_does_not_block);
+    RUN_TEST(test_async_collect_after_conversion);
+    RUN_TEST(test_async_not_restarted_while_converting);
+    RUN_TEST(test_async_instant_ready_same_pass);
+    RUN_TEST(test_async_mixed_with_sync);
+    RUN_TEST(test_async_timeout_forces_reinit);
+    RUN_TEST(test_async_prefetch_ready_at_tx_slot);
+    RUN_TEST(test_async_prefetch_skips_not_due);
+
+    /* Deadline scheduler */
+    RUN_TEST(test_sched_coalesces_within_slack);
+    RUN_TEST(test_sched_strict_without_slack);
+    RUN_TEST(test_sched_slack_alone_does_not_fire);
+    RUN_TEST(test_sched_next_due_in);
+    RUN_TEST(test_sched_rollover_safe);
+    RUN_TEST(test_sched_prefetch_joins_group);
+    RUN_TEST(test_sched_read_none_reschedules);
+    RUN_TEST(test_sched_read_wait_stays_due);
+
+    /* Warm resume */
+    RUN_TEST(test_resume_keeps_state_and_deadline);
+    RUN_TEST(test_resume_without_hook_reinits);
+    RUN_TEST(test_resume_failure_reinits);
+    RUN_TEST(test_resume_drops_inflight_conversion);
+
+    /* Dead-sensor backoff */
+    RUN_TEST(test_dead_backoff_doubles);
+    RUN_TEST(test_dead_quarantine_then_reconnect);
+    RUN_TEST(test_dead_sample_probes_now);
+    RUN_TEST(test_dead_health_format);
 }
@@ -0,0 +1,191 @@
+/*
+ * test_stats.c — Unit tests for stats.h and parseCommandResult()
+ *
+ * Compiled natively with gcc — no Arduino dependencies.  Command
+ * packets are built here the way the gateway builds them, so each
+ * rejection reason the "stats" command counts can be hit on purpose.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "stats.h"
+#include "test_harness.h"
+
+/* {"a":[],"c":"<crc>","cmd":"<cmd>","n":"<node>","t":"cmd","ts":<ts>} */
+static int statsBuildCmd(char *buf, int size, const char *cmd,
+                         const char *node, uint32_t ts)
+{
+    char body[128];
+    int n = snprintf(body, sizeof(body),
+                     "{\"a\":[],\"cmd\":\"%s\",\"n\":\"%s\",\"t\":\"cmd\",\"ts\":%u}",
+                     cmd, node, (unsigned)ts);
+    return snprintf(buf, size,
+                    "{\"a\":[],\"c\":\"%08x\",\"cmd\":\"%s\",\"n\":\"%s\",\"t\":\"cmd\",\"ts\":%u}",
+                    (unsigned)crc32_compute(body, n), cmd, node, (unsigned)ts);
+}
+
+static ParseResult statsParse(const char *json)
+{
+    CommandPacket cmd;
+    return parseCommandResult((const uint8_t *)json, strlen(json), &cmd);
+}
+
+/* ─── Parse Reasons ─────────────────────────────────────────────────────── */
+
+TEST(test_parse_result_reasons)
+{
+    char pkt[200];
+    int n = statsBuildCmd(pkt, sizeof(pkt), "ping", "ab01", 1700000000);
+    ASSERT_INT_EQ(PARSE_OK, statsParse(pkt));
+    ASSERT_TRUE(parseCommand((const uint8_t *)pkt, n, &(CommandPacket){0}));
+
+    ASSERT_INT_EQ(PARSE_FAIL_LEN, parseCommandResult((const uint8_t *)pkt, 0,
+                                                     &(CommandPacket){0}));
+    ASSERT_INT_EQ(PARSE_FAIL_NO_TYPE,
+                  statsParse("{\"n\":\"ab01\",\"r\":[],\"t\":\"data\"}"));
+    ASSERT_INT_EQ(PARSE_FAIL_NO_CMD,
+                  statsParse("{\"a\":[],\"c\":\"00000000\",\"t\":\"cmd\",\"ts\":1}"));
+    ASSERT_INT_EQ(PARSE_FAIL_NO_CRC,
+                  statsParse("{\"a\":[],\"cmd\":\"ping\",\"t\":\"cmd\",\"ts\":1}"));
+    ASSERT_INT_EQ(PARSE_FAIL_NO_TS,
+                  statsParse("{\"a\":[],\"c\":\"00000000\",\"cmd\":\"ping\",\"t\":\"cmd\"}"));
+
+    /* One byte changed in transit: the CRC catches it */
+    char *p = strstr(pkt, "ping");
+    p[1] = 'o';
+    ASSERT_INT_EQ(PARSE_FAIL_CRC, statsParse(pkt));
+    ASSERT_TRUE(!parseCommand((const uint8_t *)pkt, n, &(CommandPacket){0}));
+    TEST_PASS();
+}
+
+/* ─── Loop Latency ──────────────────────────────────────────────────────── */
+
+TEST(test_stats_loop_max_gap)
+{
+    NodeStats s;
+    statsInit(&s);
+
+    statsLoopMark(&s, 1000);
+    ASSERT_INT_EQ(0, (int)s.loopMaxMs);        /* first pass: no gap yet */
+    statsLoopMark(&s, 1002);
+    statsLoopMark(&s, 1350);                   /* a slow handler */
+    statsLoopMark(&s, 1351);
+    ASSERT_INT_EQ(348, (int)s.loopMaxMs);
+
+    /* Time spent in deep sleep doesn't count as a stall */
+    statsLoopPause(&s);
+    statsLoopMark(&s, 601351);
+    statsLoopMark(&s, 601360);
+    ASSERT_INT_EQ(348, (int)s.loopMaxMs);
+
+    /* millis() wrap */
+    statsLoopPause(&s);
+    statsLoopMark(&s, 0xFFFFFF00UL);
+    statsLoopMark(&s, 0x00000100UL);
+    ASSERT_INT_EQ(0x200, (int)s.loopMaxMs);
+    TEST_PASS();
+}
+
+TEST(test_stats_parse_fail_sum)
+{
+    NodeStats s;
+    statsInit(&s);
+    s.parseFail[PARSE_FAIL_CRC] = 3;
+    s.parseFail[PARSE_FAIL_NO_TYPE] = 2;
+    ASSERT_INT_EQ(5, (int)statsParseFails(&s));
+    TEST_PASS();
+}
+
+/* ─── Listing ───────────────────────────────────────────────────────────── */
+
+TEST(test_stats_sort_with_suffix)
+{
+    StatVal v[] = {
+        { "tx",     NULL,  1 },
+        { "bme280", "_rf", 2 },
+        { "batt",   "_if", 3 },
+        { "bme280", "_if", 4 },
+        { "tx_to",  NULL,  5 },
+        { "batt",   NULL,  6 },
+    };
+    statsSort(v, 6);
+    int expect[] = { 6, 3, 4, 2, 1, 5 };   /* batt, batt_if, bme280_if, bme280_rf, tx, tx_to */
+    for (int i = 0; i < 6; i++) ASSERT_INT_EQ(expect[i], (int)v[i].val);
+    TEST_PASS();
+}
+
+TEST(test_stats_list_pages_with_cursor)
+{
+    static const char *keys[] = {
+        "dup", "loop_max", "notme", "pf_crc", "pf_len", "pf_nocmd", "pf_nocrc",
+        "pf_nots", "pf_type", "rx", "rx_drop", "split", "tx", "tx_to", "unk",
+    };
+    StatVal v[17];
+    int n = 0;
+    for (int i = 0; i < 15; i++) {
+        v[n].key = keys[i];
+        v[n].suffix = NULL;
+        v[n].val = 4000000000UL - (uint32_t)i;   /* widest values */
+        n++;
+    }
+    v[n].key = "bme280"; v[n].suffix = "_if"; v[n].val = 1; n++;
+    v[n].key = "bme280"; v[n].suffix = "_rf"; v[n].val = 2; n++;
+    statsSort(v, n);
+    uint16_t hash = statsHash(v, n);
+
+    /* Walk the cursors as the gateway would, at the real response size */
+    char buf[171];
+    int start = 0, pages = 0, seen = 0;
+    for (;;) {
+        int len = statsListAt(v, n, start, hash, buf, sizeof(buf));
+        ASSERT_TRUE(len > 0 && len < (int)sizeof(buf));
+        ASSERT_INT_EQ(len, (int)strlen(buf));
+        pages++;
+        const char *p = strstr(buf, "\"s\":{") + 4;
+        while ((p = strchr(p + 1, ':')) != NULL) seen++;
+        if (strncmp(buf, "{\"m\":0,\"s\":{", 12) == 0) break;
+
+        char tok[PARAM_CURSOR_LEN + 1];
+        ASSERT_TRUE(strncmp(buf, "{\"m\":1,\"n\":\"", 12) == 0);
+        memcpy(tok, buf + 12, PARAM_CURSOR_LEN);
+        tok[PARAM_CURSOR_LEN] = '\0';
+        ASSERT_TRUE(paramCursorParse(tok, hash, n, &start));
+        ASSERT_TRUE(pages < 10);
+    }
+    ASSERT_TRUE(pages > 1);
+    ASSERT_INT_EQ(n, seen);
+    ASSERT_TRUE(strstr(buf, "\"unk\":3999999986") != NULL);   /* last key, last page */
+
+    /* A cursor from another key set is stale */
+    char stale[PARAM_CURSOR_LEN + 1];
+    snprintf(stale, sizeof(stale), "%04x%04x", 2u, (unsigned)statsHash(v, n - 1));
+    ASSERT_TRUE(statsHash(v, n - 1) != hash);
+    ASSERT_TRUE(!paramCursorParse(stale, hash, n, &start));
+    TEST_PASS();
+}
+
+TEST(test_stats_list_short_form)
+{
+    StatVal v[] = { { "rx", NULL, 12 }, { "tx", NULL, 34 } };
+    char buf[64];
+    statsListAt(v, 2, 0, statsHash(v, 2), buf, sizeof(buf));
+    ASSERT_STR_EQ("{\"m\":0,\"s\":{\"rx\":12,\"tx\":34}}", buf);
+    ASSERT_INT_EQ(0, statsListAt(v, 2, 0, 0, buf, 20));
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_stats_tests(void)
+{
+    printf("stats.h tests:\n");
+
+    RUN_TEST(test_parse_result_reasons);
+    RUN_TEST(test_stats_loop_max_gap);
+    RUN_TEST(test_stats_parse_fail_sum);
+    RUN_TEST(test_stats_sort_with_suffix);
+    RUN_TEST(test_stats_list_pages_with_cursor);
+    RUN_TEST(test_stats_list_short_form);
+}
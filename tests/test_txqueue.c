@@ -0,0 +1,198 @@
+/*
+ * test_txqueue.c — Unit tests for txqueue.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * Time is passed in explicitly, so holds, deadlines and latency are
+ * exercised without a real radio.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "txqueue.h"
+#include "test_harness.h"
+
+#define N2G 915000000UL
+
+/* Queue a one-byte packet tagged `tag` */
+static int txqPushTag(TxQueue *q, char tag, uint8_t prio, unsigned long now,
+                      unsigned long holdMs, unsigned long maxAgeMs)
+{
+    return txqPush(q, &tag, 1, prio, N2G, now, holdMs, maxAgeMs);
+}
+
+/* Start the next packet and return its tag (0 if none) */
+static char txqStartTag(TxQueue *q, unsigned long now)
+{
+    int slot = txqStart(q, now);
+    return slot < 0 ? 0 : (char)q->e[slot].buf[0];
+}
+
+/* ─── Ordering ──────────────────────────────────────────────────────────── */
+
+TEST(test_txq_priority_then_fifo)
+{
+    TxQueue q;
+    txqInit(&q);
+    txqPushTag(&q, 'a', TXQ_PRIO_DATA, 0, 0, 1000);
+    txqPushTag(&q, 'b', TXQ_PRIO_DATA, 0, 0, 1000);
+    txqPushTag(&q, 'K', TXQ_PRIO_ACK,  1, 0, 1000);
+    txqPushTag(&q, 'x', TXQ_PRIO_BULK, 1, 0, 1000);
+    ASSERT_INT_EQ(4, q.depth);
+
+    const char *expect = "Kabx";
+    for (int i = 0; i < 4; i++) {
+        ASSERT_INT_EQ(expect[i], txqStartTag(&q, 10));
+        ASSERT_TRUE(txqBusy(&q));
+        ASSERT_INT_EQ(0, txqStartTag(&q, 10));       /* radio busy */
+        txqFinish(&q, 20, true);
+    }
+    ASSERT_TRUE(txqEmpty(&q) && !txqBusy(&q));
+    ASSERT_INT_EQ(4, (int)q.sent);
+    TEST_PASS();
+}
+
+TEST(test_txq_ack_jumps_queue_not_air)
+{
+    TxQueue q;
+    txqInit(&q);
+    txqPushTag(&q, 'a', TXQ_PRIO_DATA, 0, 0, 1000);
+    txqPushTag(&q, 'b', TXQ_PRIO_DATA, 0, 0, 1000);
+    ASSERT_INT_EQ('a', txqStartTag(&q, 0));
+
+    /* An ACK arriving mid-TX goes next, ahead of the queued reading */
+    txqPushTag(&q, 'K', TXQ_PRIO_ACK, 5, 0, 1000);
+    ASSERT_INT_EQ(TXQ_PRIO_DATA, txqFinish(&q, 40, true));
+    ASSERT_INT_EQ('K', txqStartTag(&q, 40));
+    ASSERT_INT_EQ(TXQ_PRIO_ACK, txqFinish(&q, 80, true));
+    ASSERT_INT_EQ('b', txqStartTag(&q, 80));
+    TEST_PASS();
+}
+
+/* ─── Hold and Deadline ─────────────────────────────────────────────────── */
+
+TEST(test_txq_hold_for_jitter)
+{
+    TxQueue q;
+    txqInit(&q);
+    txqPushTag(&q, 'K', TXQ_PRIO_ACK, 100, 250, 1000);
+    ASSERT_TRUE(txqDueIn(&q, 100) == 250);
+    ASSERT_INT_EQ(0, txqStartTag(&q, 200));          /* still held */
+
+    /* Lower-priority traffic isn't blocked behind a held ACK */
+    txqPushTag(&q, 'a', TXQ_PRIO_DATA, 200, 0, 1000);
+    ASSERT_TRUE(txqDueIn(&q, 200) == 0);
+    ASSERT_INT_EQ('a', txqStartTag(&q, 200));
+    txqFinish(&q, 300, true);
+
+    ASSERT_INT_EQ('K', txqStartTag(&q, 350));
+    txqFinish(&q, 400, true);
+    ASSERT_TRUE(txqDueIn(&q, 400) == TXQ_NO_DEADLINE);
+    TEST_PASS();
+}
+
+TEST(test_txq_drop_by_age)
+{
+    TxQueue q;
+    txqInit(&q);
+    txqPushTag(&q, 'a', TXQ_PRIO_DATA, 0, 0, 500);
+    txqPushTag(&q, 'K', TXQ_PRIO_ACK, 0, 100, 500);  /* deadline 600 */
+    txqPushTag(&q, 'b', TXQ_PRIO_DATA, 0, 0, 5000);
+
+    /* Radio stuck on 'K' well past everyone's deadline */
+    ASSERT_INT_EQ('K', txqStartTag(&q, 150));
+    ASSERT_INT_EQ(0, txqStartTag(&q, 2000));
+    ASSERT_TRUE(txqAirMs(&q, 2000) == 1850);
+    txqFinish(&q, 2000, false);                      /* abandoned, not expired */
+    ASSERT_INT_EQ(1, (int)q.timeouts);
+
+    /* 'a' expired waiting; 'b' is still fresh */
+    ASSERT_INT_EQ('b', txqStartTag(&q, 2000));
+    ASSERT_INT_EQ(1, (int)q.expired);
+    txqFinish(&q, 2050, true);
+    ASSERT_TRUE(txqEmpty(&q));
+    TEST_PASS();
+}
+
+/* ─── Overflow ──────────────────────────────────────────────────────────── */
+
+TEST(test_txq_full_evicts_less_urgent)
+{
+    TxQueue q;
+    txqInit(&q);
+    for (int i = 0; i < TXQ_DEPTH; i++)
+        ASSERT_TRUE(txqPushTag(&q, (char)('a' + i), TXQ_PRIO_DATA, (unsigned long)i, 0, 1000) >= 0);
+    ASSERT_INT_EQ('a', txqStartTag(&q, 10));         /* 'a' on the air */
+
+    /* An ACK evicts the oldest queued reading, never the one on the air */
+    ASSERT_TRUE(txqPushTag(&q, 'K', TXQ_PRIO_ACK, 11, 0, 1000) >= 0);
+    ASSERT_INT_EQ(1, (int)q.dropped);
+    /* A new reading replaces the oldest queued reading */
+    ASSERT_TRUE(txqPushTag(&q, 'z', TXQ_PRIO_DATA, 12, 0, 1000) >= 0);
+    ASSERT_INT_EQ(2, (int)q.dropped);
+    /* Bulk can't displace anything more urgent */
+    ASSERT_TRUE(txqPushTag(&q, 'x', TXQ_PRIO_BULK, 13, 0, 1000) < 0);
+    ASSERT_INT_EQ(3, (int)q.dropped);
+
+    txqFinish(&q, 20, true);
+    const char *expect = "K" "d" "z";
+    for (int i = 0; i < 3; i++) {
+        ASSERT_INT_EQ(expect[i], txqStartTag(&q, 20));
+        txqFinish(&q, 30, true);
+    }
+    ASSERT_TRUE(txqEmpty(&q));
+    ASSERT_INT_EQ(TXQ_DEPTH, q.maxDepth);
+
+    /* Oversized and empty packets are refused outright */
+    uint8_t big[LORA_MAX_PAYLOAD + 1];
+    memset(big, 0, sizeof(big));
+    ASSERT_TRUE(txqPush(&q, big, sizeof(big), TXQ_PRIO_ACK, N2G, 0, 0, 1000) < 0);
+    ASSERT_TRUE(txqPush(&q, big, 0, TXQ_PRIO_ACK, N2G, 0, 0, 1000) < 0);
+    TEST_PASS();
+}
+
+/* ─── Back-to-Back ──────────────────────────────────────────────────────── */
+
+TEST(test_txq_back_to_back_and_latency)
+{
+    /* Split reading packets, each 60 ms on air, started from the
+     * previous TX-done as the sketch's onTxDone() does */
+    TxQueue q;
+    txqInit(&q);
+    unsigned long now = 1000;
+    for (int i = 0; i < 3; i++)
+        txqPushTag(&q, (char)('a' + i), TXQ_PRIO_DATA, now, 0, 10000);
+
+    unsigned long lastStart = 0;
+    int starts = 0;
+    ASSERT_TRUE(txqStart(&q, now) >= 0);
+    while (txqBusy(&q)) {
+        if (starts++ > 0) ASSERT_TRUE(now == lastStart + 60);   /* no gap */
+        lastStart = now;
+        now += 60;
+        txqFinish(&q, now, true);
+        txqStart(&q, now);
+    }
+    ASSERT_INT_EQ(3, starts);
+    ASSERT_INT_EQ(3, (int)q.sent);
+    ASSERT_INT_EQ(180, (int)q.latLastMs);
+    ASSERT_INT_EQ(180, (int)q.latMaxMs);
+    ASSERT_INT_EQ(120, (int)txqLatAvgMs(&q));       /* (60 + 120 + 180) / 3 */
+    ASSERT_INT_EQ(-1, txqFinish(&q, now, true));     /* nothing in flight */
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_txqueue_tests(void)
+{
+    printf("txqueue.h tests:\n");
+
+    RUN_TEST(test_txq_priority_then_fifo);
+    RUN_TEST(test_txq_ack_jumps_queue_not_air);
+    RUN_TEST(test_txq_hold_for_jitter);
+    RUN_TEST(test_txq_drop_by_age);
+    RUN_TEST(test_txq_full_evicts_less_urgent);
+    RUN_TEST(test_txq_back_to_back_and_latency);
+}
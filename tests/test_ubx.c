@@ -0,0 +1,188 @@
+/*
+ * test_ubx.c — Unit tests for ubx.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * Config frames are checked against byte sequences from the u-blox 6
+ * protocol spec / u-center; NAV messages are built with ubxBuild() and
+ * fed back through the parser.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+
+#include "ubx.h"
+#include "test_harness.h"
+
+/* ─── Helpers ───────────────────────────────────────────────────────────── */
+
+static int ubxFeed(UbxParser *p, const uint8_t *buf, int len)
+{
+    int n = 0;
+    for (int i = 0; i < len; i++) if (ubxEncode(p, buf[i])) n++;
+    return n;
+}
+
+static int ubxMakePosllh(uint8_t *buf, uint32_t tow, int32_t lat, int32_t lon,
+                         int32_t hMslMm)
+{
+    uint8_t p[UBX_NAV_POSLLH_LEN] = {0};
+    ubxPutU32(p, tow);
+    ubxPutU32(p + 4, (uint32_t)lon);
+    ubxPutU32(p + 8, (uint32_t)lat);
+    ubxPutU32(p + 12, (uint32_t)(hMslMm + 17000));   /* ellipsoid height */
+    ubxPutU32(p + 16, (uint32_t)hMslMm);
+    return ubxBuild(buf, 64, UBX_CLASS_NAV, UBX_NAV_POSLLH, p, sizeof(p));
+}
+
+static int ubxMakeSol(uint8_t *buf, uint32_t tow, uint8_t gpsFix, bool fixOk,
+                      uint8_t numSV)
+{
+    uint8_t p[UBX_NAV_SOL_LEN] = {0};
+    ubxPutU32(p, tow);
+    p[10] = gpsFix;
+    p[11] = fixOk ? 0x0D : 0x0C;
+    p[47] = numSV;
+    return ubxBuild(buf, 64, UBX_CLASS_NAV, UBX_NAV_SOL, p, sizeof(p));
+}
+
+/* ─── Frame Building ────────────────────────────────────────────────────── */
+
+TEST(test_ubx_cfg_frames_match_spec)
+{
+    uint8_t buf[16];
+
+    static const uint8_t rate[] = {
+        0xB5, 0x62, 0x06, 0x08, 0x06, 0x00, 0xE8, 0x03,
+        0x01, 0x00, 0x01, 0x00, 0x01, 0x39
+    };
+    ASSERT_INT_EQ((int)sizeof(rate), ubxCfgRate(buf, sizeof(buf), 1000));
+    ASSERT_TRUE(memcmp(buf, rate, sizeof(rate)) == 0);
+
+    /* Disable GGA */
+    static const uint8_t gga[] = {
+        0xB5, 0x62, 0x06, 0x01, 0x03, 0x00, 0xF0, 0x00, 0x00, 0xFA, 0x0F
+    };
+    ASSERT_INT_EQ((int)sizeof(gga), ubxCfgMsg(buf, sizeof(buf), UBX_CLASS_NMEA, 0, 0));
+    ASSERT_TRUE(memcmp(buf, gga, sizeof(gga)) == 0);
+
+    /* Too small a buffer is refused */
+    ASSERT_INT_EQ(0, ubxRxmPmreq(buf, 15, 1000));
+    ASSERT_INT_EQ(16, ubxRxmPmreq(buf, 16, 1000));
+
+    TEST_PASS();
+}
+
+/* ─── Parser ────────────────────────────────────────────────────────────── */
+
+TEST(test_ubx_posllh_sol_commit)
+{
+    UbxParser p;
+    ubxInit(&p);
+    uint8_t buf[64];
+    int n;
+
+    n = ubxMakePosllh(buf, 5000, 476205123, -1223493456, 54300);
+    ASSERT_INT_EQ(1, ubxFeed(&p, buf, n));
+    ASSERT_INT_EQ(0, p.fix.valid);          /* waits for NAV-SOL */
+
+    n = ubxMakeSol(buf, 5000, 3, true, 9);
+    ASSERT_INT_EQ(1, ubxFeed(&p, buf, n));
+    ASSERT_INT_EQ(NMEA_HAVE_LOC | NMEA_HAVE_ALT | NMEA_HAVE_SATS,
+                  ubxTakeUpdated(&p));
+    ASSERT_INT_EQ(476205123, p.fix.lat_e7);
+    ASSERT_INT_EQ(-1223493456, p.fix.lon_e7);
+    ASSERT_INT_EQ(5430, p.fix.alt_cm);
+    ASSERT_INT_EQ(9, p.fix.sats);
+    ASSERT_INT_EQ(2, (int)p.passed);
+
+    TEST_PASS();
+}
+
+TEST(test_ubx_no_fix_or_stale_epoch)
+{
+    UbxParser p;
+    ubxInit(&p);
+    uint8_t buf[64];
+    int n;
+
+    /* gpsFixOk clear: only sats update */
+    n = ubxMakePosllh(buf, 1000, 1, 2, 3);
+    ubxFeed(&p, buf, n);
+    n = ubxMakeSol(buf, 1000, 3, false, 2);
+    ubxFeed(&p, buf, n);
+    ASSERT_INT_EQ(NMEA_HAVE_SATS, ubxTakeUpdated(&p));
+
+    /* NAV-SOL from a different epoch than the position */
+    n = ubxMakePosllh(buf, 2000, 1, 2, 3);
+    ubxFeed(&p, buf, n);
+    n = ubxMakeSol(buf, 3000, 3, true, 7);
+    ubxFeed(&p, buf, n);
+    ASSERT_TRUE(!(p.fix.valid & NMEA_HAVE_LOC));
+
+    /* 2D fix: location but no altitude */
+    n = ubxMakePosllh(buf, 4000, 10, 20, 30000);
+    ubxFeed(&p, buf, n);
+    n = ubxMakeSol(buf, 4000, 2, true, 4);
+    ubxFeed(&p, buf, n);
+    ASSERT_INT_EQ(NMEA_HAVE_LOC | NMEA_HAVE_SATS, ubxTakeUpdated(&p));
+
+    TEST_PASS();
+}
+
+TEST(test_ubx_bad_checksum_and_resync)
+{
+    UbxParser p;
+    ubxInit(&p);
+    uint8_t buf[64];
+    int n = ubxMakeSol(buf, 1, 3, true, 5);
+
+    buf[20] ^= 0x40;
+    ASSERT_INT_EQ(0, ubxFeed(&p, buf, n));
+    ASSERT_INT_EQ(1, (int)p.failed);
+    buf[20] ^= 0x40;
+
+    /* NMEA noise and a repeated sync byte ahead of a good frame */
+    static const uint8_t noise[] = { '$', 'G', 'P', 0xB5, 0xB5 };
+    ubxFeed(&p, noise, sizeof(noise));
+    ASSERT_INT_EQ(1, ubxFeed(&p, buf + 1, n - 1));
+    ASSERT_INT_EQ(5, p.fix.sats);
+
+    TEST_PASS();
+}
+
+TEST(test_ubx_ack_and_long_messages)
+{
+    UbxParser p;
+    ubxInit(&p);
+    uint8_t buf[128];
+    uint8_t payload[80] = {0};
+    int n;
+
+    uint8_t ack[2] = { UBX_CLASS_CFG, UBX_CFG_RATE };
+    n = ubxBuild(buf, sizeof(buf), UBX_CLASS_ACK, UBX_ACK_ACK, ack, 2);
+    ubxFeed(&p, buf, n);
+    n = ubxBuild(buf, sizeof(buf), UBX_CLASS_ACK, UBX_ACK_NAK, ack, 2);
+    ubxFeed(&p, buf, n);
+    ASSERT_INT_EQ(1, (int)p.acks);
+    ASSERT_INT_EQ(1, (int)p.naks);
+
+    /* Longer than UBX_MAX_PAYLOAD: checksummed, counted, not decoded */
+    n = ubxBuild(buf, sizeof(buf), UBX_CLASS_NAV, UBX_NAV_SOL, payload, sizeof(payload));
+    ASSERT_INT_EQ(1, ubxFeed(&p, buf, n));
+    ASSERT_INT_EQ(0, p.fix.valid);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_ubx_tests(void)
+{
+    printf("ubx.h tests:\n");
+
+    RUN_TEST(test_ubx_cfg_frames_match_spec);
+    RUN_TEST(test_ubx_posllh_sol_commit);
+    RUN_TEST(test_ubx_no_fix_or_stale_epoch);
+    RUN_TEST(test_ubx_bad_checksum_and_resync);
+    RUN_TEST(test_ubx_ack_and_long_messages);
+}
@@ -0,0 +1,246 @@
+/*
+ * test_xfer.c — Unit tests for the bulk transfer protocol in packets.h
+ *
+ * Compiled natively with gcc — no Arduino dependencies.
+ * The end-to-end test runs a node session against a simple gateway model
+ * over a channel that drops packets on a fixed pattern.
+ */
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "packets.h"
+#include "test_harness.h"
+
+/* ─── Helpers ───────────────────────────────────────────────────────────── */
+
+/* Payload source: byte i of the payload is (i * 7 + 3) & 0xFF */
+static int xferPatternFill(uint32_t offset, uint8_t *buf, int len, void *ctx)
+{
+    (void)ctx;
+    for (int i = 0; i < len; i++) buf[i] = (uint8_t)((offset + (uint32_t)i) * 7 + 3);
+    return len;
+}
+
+static int b64Val(char c)
+{
+    if (c >= 'A' && c <= 'Z') return c - 'A';
+    if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+    if (c >= '0' && c <= '9') return c - '0' + 52;
+    if (c == '+') return 62;
+    if (c == '/') return 63;
+    return -1;
+}
+
+/* Decode the "d" field of a block packet; returns byte count */
+static int blockDecode(const char *pkt, uint8_t *out)
+{
+    const char *d = strstr(pkt, "\"d\":\"") + 5;
+    int n = 0;
+    uint32_t acc = 0;
+    int bits = 0;
+    for (; *d != '"'; d++) {
+        int v = b64Val(*d);
+        if (v < 0) break;
+        acc = (acc << 6) | (uint32_t)v;
+        bits += 6;
+        if (bits >= 8) {
+            bits -= 8;
+            out[n++] = (uint8_t)(acc >> bits);
+        }
+    }
+    return n;
+}
+
+/* ─── Base64 ────────────────────────────────────────────────────────────── */
+
+TEST(test_b64_vectors)
+{
+    char out[16];
+    ASSERT_INT_EQ(0, b64Encode((const uint8_t *)"", 0, out, sizeof(out)));
+    ASSERT_STR_EQ("", out);
+    b64Encode((const uint8_t *)"f", 1, out, sizeof(out));
+    ASSERT_STR_EQ("Zg==", out);
+    b64Encode((const uint8_t *)"fo", 2, out, sizeof(out));
+    ASSERT_STR_EQ("Zm8=", out);
+    b64Encode((const uint8_t *)"foo", 3, out, sizeof(out));
+    ASSERT_STR_EQ("Zm9v", out);
+    ASSERT_INT_EQ(8, b64Encode((const uint8_t *)"foobar", 6, out, sizeof(out)));
+    ASSERT_STR_EQ("Zm9vYmFy", out);
+
+    /* Doesn't fit (needs 8 + null) */
+    ASSERT_INT_EQ(0, b64Encode((const uint8_t *)"foobar", 6, out, 8));
+
+    TEST_PASS();
+}
+
+/* ─── Session ───────────────────────────────────────────────────────────── */
+
+TEST(test_xfer_first_round)
+{
+    XferSession s;
+    uint16_t blk;
+    xferOpen(&s, 1, 20 * XFER_BLOCK_BYTES - 5, 8, xferPatternFill, NULL);
+    ASSERT_TRUE(s.active);
+    ASSERT_INT_EQ(20, s.nBlocks);
+
+    for (int i = 0; i < 8; i++) {
+        ASSERT_TRUE(xferNext(&s, &blk));
+        ASSERT_INT_EQ(i, blk);
+    }
+    ASSERT_TRUE(!xferNext(&s, &blk));       /* window full: wait for ack */
+    ASSERT_TRUE(!xferNext(&s, &blk));
+
+    /* Window is clamped; empty payload has nothing to send */
+    xferOpen(&s, 2, 100000, 200, xferPatternFill, NULL);
+    ASSERT_INT_EQ(XFER_MAX_WINDOW, s.window);
+    xferOpen(&s, 3, 0, 8, xferPatternFill, NULL);
+    ASSERT_TRUE(!s.active);
+    ASSERT_TRUE(!xferNext(&s, &blk));
+
+    TEST_PASS();
+}
+
+TEST(test_xfer_selective_resend)
+{
+    XferSession s;
+    uint16_t blk;
+    xferOpen(&s, 1, 20 * XFER_BLOCK_BYTES, 8, xferPatternFill, NULL);
+    while (xferNext(&s, &blk)) {}
+
+    /* Got 0, 1, 3, 5, 6, 7: base 2, missing 2 and 4 (bits 0 and 2).
+     * Bits beyond what was sent are ignored. */
+    ASSERT_TRUE(xferAck(&s, 1, 2, 0x05 | 0x80000000UL));
+
+    uint16_t expect[] = { 2, 4, 8, 9 };     /* resends, then up to base+8 */
+    for (int i = 0; i < 4; i++) {
+        ASSERT_TRUE(xferNext(&s, &blk));
+        ASSERT_INT_EQ(expect[i], blk);
+    }
+    ASSERT_TRUE(!xferNext(&s, &blk));
+    ASSERT_INT_EQ(10, (int)s.sent);
+    ASSERT_INT_EQ(2, (int)s.resent);
+
+    TEST_PASS();
+}
+
+TEST(test_xfer_ack_validation_and_done)
+{
+    XferSession s;
+    uint16_t blk;
+    xferOpen(&s, 9, 3 * XFER_BLOCK_BYTES, 8, xferPatternFill, NULL);
+    while (xferNext(&s, &blk)) {}
+
+    ASSERT_TRUE(!xferAck(&s, 8, 0, 0));     /* other session */
+    ASSERT_TRUE(!xferAck(&s, 9, 4, 0));     /* beyond what was sent */
+    ASSERT_TRUE(s.active);
+
+    ASSERT_TRUE(xferAck(&s, 9, 3, 0));      /* all received */
+    ASSERT_TRUE(!s.active);
+    ASSERT_TRUE(!xferNext(&s, &blk));
+    ASSERT_TRUE(!xferAck(&s, 9, 3, 0));     /* closed */
+
+    TEST_PASS();
+}
+
+/* ─── Packets ───────────────────────────────────────────────────────────── */
+
+TEST(test_xfer_block_packet)
+{
+    XferSession s;
+    char pkt[LORA_MAX_PAYLOAD + 1];
+    uint8_t data[XFER_BLOCK_BYTES];
+    xferOpen(&s, 7, XFER_BLOCK_BYTES + 10, 8, xferPatternFill, NULL);
+
+    /* Full block with a maximum-length node ID still fits */
+    int len = xferBuildBlock(&s, 0, "abcdefghijklmno", pkt, sizeof(pkt));
+    ASSERT_TRUE(len > 0 && len <= LORA_MAX_PAYLOAD);
+    ASSERT_TRUE(strncmp(pkt, "    {\"b\":0,\"c\":\"", 16) == 0);
+    ASSERT_INT_EQ(XFER_BLOCK_BYTES, blockDecode(pkt, data));
+    ASSERT_INT_EQ(3, data[0]);
+    ASSERT_INT_EQ(((XFER_BLOCK_BYTES - 1) * 7 + 3) & 0xFF, data[XFER_BLOCK_BYTES - 1]);
+
+    /* Short last block; CRC is over the JSON without "c" */
+    len = xferBuildBlock(&s, 1, "ab01", pkt, sizeof(pkt));
+    ASSERT_INT_EQ(10, blockDecode(pkt, data));
+    ASSERT_INT_EQ((XFER_BLOCK_BYTES * 7 + 3) & 0xFF, data[0]);
+
+    char body[LORA_MAX_PAYLOAD];
+    const char *crcStart = strstr(pkt, "\"c\":\"") + 5;
+    const char *afterC = crcStart + 10;      /* 8 hex + '",' */
+    int n = snprintf(body, sizeof(body), "{\"b\":1,%.*s", (int)(pkt + len - afterC), afterC);
+    ASSERT_TRUE(n > 0);
+    char crcHex[9];
+    snprintf(crcHex, sizeof(crcHex), "%08x", crc32_compute(body, strlen(body)));
+    ASSERT_TRUE(strncmp(crcStart, crcHex, 8) == 0);
+
+    /* Out of range */
+    ASSERT_INT_EQ(0, xferBuildBlock(&s, 2, "ab01", pkt, sizeof(pkt)));
+
+    TEST_PASS();
+}
+
+/* ─── End to End ────────────────────────────────────────────────────────── */
+
+TEST(test_xfer_lossy_channel)
+{
+    enum { NBLK = 40, WIN = 8 };
+    const uint32_t total = NBLK * XFER_BLOCK_BYTES - 33;
+
+    static uint8_t rx[NBLK * XFER_BLOCK_BYTES];
+    bool got[NBLK] = { false };
+    XferSession s;
+    char pkt[LORA_MAX_PAYLOAD + 1];
+    uint16_t blk;
+    int txCount = 0, rounds = 0;
+
+    memset(rx, 0, sizeof(rx));
+    xferOpen(&s, 5, total, WIN, xferPatternFill, NULL);
+
+    while (s.active && rounds < 100) {
+        /* Node: one round, every 3rd transmission lost */
+        while (xferNext(&s, &blk)) {
+            int len = xferBuildBlock(&s, blk, "ab01", pkt, sizeof(pkt));
+            ASSERT_TRUE(len > 0);
+            if (++txCount % 3 == 0) continue;
+            blockDecode(pkt, rx + (uint32_t)blk * XFER_BLOCK_BYTES);
+            got[blk] = true;
+        }
+        rounds++;
+
+        /* Gateway: lowest missing block + bitmap of the ones after it */
+        uint16_t base = 0;
+        while (base < NBLK && got[base]) base++;
+        uint32_t missing = 0;
+        for (int i = 0; i < WIN && base + i < NBLK; i++)
+            if (!got[base + i]) missing |= 1UL << i;
+        ASSERT_TRUE(xferAck(&s, 5, base, missing));
+    }
+
+    ASSERT_TRUE(!s.active);
+    for (uint32_t i = 0; i < total; i++)
+        ASSERT_INT_EQ((uint8_t)(i * 7 + 3), rx[i]);
+
+    /* A third of the traffic was lost, yet far fewer round trips than
+     * the 40+ a stop-and-wait exchange would need */
+    ASSERT_INT_EQ(NBLK, (int)s.sent);
+    ASSERT_TRUE(s.resent > 0);
+    ASSERT_TRUE(rounds < 15);
+
+    TEST_PASS();
+}
+
+/* ─── Test Runner ────────────────────────────────────────────────────────── */
+
+static void run_xfer_tests(void)
+{
+    printf("packets.h bulk transfer tests:\n");
+
+    RUN_TEST(test_b64_vectors);
+    RUN_TEST(test_xfer_first_round);
+    RUN_TEST(test_xfer_selective_resend);
+    RUN_TEST(test_xfer_ack_validation_and_done);
+    RUN_TEST(test_xfer_block_packet);
+    RUN_TEST(test_xfer_lossy_channel);
+}
@@ -0,0 +1,211 @@
+#!/usr/bin/env python3
+"""
+dbgdecode.py — Decode tokenized debug output (DBG_TOKENIZE=1, see shared/dbg.h)
+
+Usage:
+    tools/dbgdecode.py ELF [INPUT]      INPUT: serial port, capture file, or stdin
+    tools/dbgdecode.py ELF --list       dump the format table
+
+The format strings come from the .dbgfmt section of the same build's
+.elf (build/data_log/data_log.ino.elf); a stale .elf decodes to the
+wrong text, so keep it in step with what was flashed.  Serial ports are
+opened raw at 115200 with stty (Linux/macOS); no third-party modules.
+
+Record layout in .dbgfmt (2-aligned, one per call site):
+    u16 id, "file:line\\0", "format\\0"
+Wire frame:
+    A5 len id_lo id_hi args[len] sum    (sum = low byte of len+id+args)
+Arguments: ints 4 bytes LE, floats as f32, strings u8 length + bytes.
+"""
+
+import os
+import re
+import struct
+import subprocess
+import sys
+
+FRAME_SYNC = 0xA5
+ID_DROPPED = 0
+CONV_RE = re.compile(r"%([-+ #0]*)(\d+|\*)?(?:\.(\d+|\*))?(hh|h|ll|l|z|j|t)?([diouxXcsfFeEgG%])")
+
+
+# ─── ELF ──────────────────────────────────────────────────────────────────────
+
+def elf_section(path, name):
+    """Raw bytes of section `name` (ELF32/64, either byte order)."""
+    with open(path, "rb") as f:
+        data = f.read()
+    if data[:4] != b"\x7fELF":
+        sys.exit(f"{path}: not an ELF file")
+    is64 = data[4] == 2
+    end = "<" if data[5] == 1 else ">"
+    if is64:
+        shoff, = struct.unpack_from(end + "Q", data, 0x28)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x3A)
+        sh_fmt = end + "IIQQQQIIQQ"
+    else:
+        shoff, = struct.unpack_from(end + "I", data, 0x20)
+        shentsize, shnum, shstrndx = struct.unpack_from(end + "HHH", data, 0x2E)
+        sh_fmt = end + "IIIIIIIIII"
+
+    def header(i):
+        h = struct.unpack_from(sh_fmt, data, shoff + i * shentsize)
+        return h[0], h[4], h[5]            # name, offset, size
+
+    _, stroff, _ = header(shstrndx)
+    for i in range(shnum):
+        nameoff, off, size = header(i)
+        end_ = data.index(b"\0", stroff + nameoff)
+        if data[stroff + nameoff:end_].decode() == name:
+            return data[off:off + size]
+    sys.exit(f"{path}: no {name} section — built without DBG_TOKENIZE=1?")
+
+
+def load_formats(path):
+    """id -> (location, format)"""
+    sec = elf_section(path, ".dbgfmt")
+    table = {}
+    i = 0
+    while i + 2 < len(sec):
+        if i & 1:
+            i += 1
+            continue
+        fid, = struct.unpack_from("<H", sec, i)
+        j = sec.index(b"\0", i + 2)
+        k = sec.index(b"\0", j + 1)
+        loc = sec[i + 2:j].decode(errors="replace")
+        fmt = sec[j + 1:k].decode(errors="replace")
+        if loc:
+            table[fid] = (loc, fmt)
+        i = k + 1
+    return table
+
+
+# ─── Formatting ───────────────────────────────────────────────────────────────
+
+def render(fmt, args):
+    """printf `fmt` with values unpacked from the packed `args` bytes."""
+    pos = 0
+
+    def take_int(signed):
+        nonlocal pos
+        if pos + 4 > len(args):
+            return None
+        v, = struct.unpack_from("<i" if signed else "<I", args, pos)
+        pos += 4
+        return v
+
+    def take_float():
+        nonlocal pos
+        if pos + 4 > len(args):
+            return None
+        v, = struct.unpack_from("<f", args, pos)
+        pos += 4
+        return v
+
+    def take_str():
+        nonlocal pos
+        if pos >= len(args) or pos + 1 + args[pos] > len(args):
+            return None
+        n = args[pos]
+        s = args[pos + 1:pos + 1 + n].decode(errors="replace")
+        pos += 1 + n
+        return s
+
+    def conv(m):
+        flags, width, prec, _, c = m.groups()
+        if c == "%":
+            return "%"
+        if width == "*":
+            width = take_int(True)
+            width = "" if width is None else str(width)
+        if prec == "*":
+            prec = take_int(True)
+            prec = "" if prec is None else str(prec)
+        spec = "%" + flags + (width or "") + ("." + prec if prec else "")
+        if c in "fFeEgG":
+            v = take_float()
+        elif c == "s":
+            v = take_str()
+        elif c == "c":
+            v = take_int(False)
+            v = None if v is None else chr(v & 0xFF)
+            c = "s"
+        else:
+            v = take_int(c in "di")
+            c = "d" if c == "u" else c
+        return "?" if v is None else (spec + c) % v
+
+    return CONV_RE.sub(conv, fmt)
+
+
+def decode_record(table, fid, args):
+    if fid == ID_DROPPED:
+        n = struct.unpack_from("<I", args)[0] if len(args) >= 4 else "?"
+        return f"[dbg] {n} records dropped (ring full)\n"
+    if fid not in table:
+        return f"[dbg] unknown id 0x{fid:04x} ({len(args)} arg bytes) — stale ELF?\n"
+    return render(table[fid][1], args)
+
+
+# ─── Stream ───────────────────────────────────────────────────────────────────
+
+def frames(stream):
+    """Yield (id, args) from the byte stream, resyncing on bad frames."""
+    read = getattr(stream, "read1", stream.read)      # return what's there
+    buf = bytearray()
+    while True:
+        chunk = read(4096)
+        if not chunk:
+            return
+        buf += chunk
+        while True:
+            start = buf.find(FRAME_SYNC)
+            if start < 0:
+                buf.clear()
+                break
+            del buf[:start]
+            if len(buf) < 5 or len(buf) < 5 + buf[1]:
+                break
+            n = buf[1]
+            body = buf[1:4 + n]
+            if sum(body) & 0xFF != buf[4 + n]:
+                del buf[:1]                        # not a frame start
+                continue
+            yield buf[2] | (buf[3] << 8), bytes(buf[4:4 + n])
+            del buf[:5 + n]
+
+
+def open_input(path):
+    if path in (None, "-"):
+        return sys.stdin.buffer
+    if path.startswith("/dev/"):
+        flag = "-f" if sys.platform == "darwin" else "-F"
+        subprocess.run(["stty", flag, path, "115200", "raw", "-echo"], check=True)
+        return open(path, "rb", buffering=0)
+    return open(path, "rb")
+
+
+def main(argv):
+    if len(argv) < 2 or argv[1] in ("-h", "--help"):
+        sys.exit(__doc__.strip())
+    table = load_formats(argv[1])
+
+    if len(argv) > 2 and argv[2] == "--list":
+        for fid in sorted(table):
+            loc, fmt = table[fid]
+            print(f"0x{fid:04x}  {os.path.basename(loc):28s} {fmt!r}")
+        return
+
+    for fid, args in frames(open_input(argv[2] if len(argv) > 2 else None)):
+        sys.stdout.write(decode_record(table, fid, args))
+        sys.stdout.flush()
+
+
+if __name__ == "__main__":
+    try:
+        main(sys.argv)
+    except KeyboardInterrupt:
+        pass
+    except BrokenPipeError:
+        os._exit(0)